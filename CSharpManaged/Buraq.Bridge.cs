@@ -1,7 +1,12 @@
 using System;
+using System.Collections.Generic;
 using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.IO.Pipes;
 using System.Net;
 using System.Net.Sockets;
+using System.Text;
+using System.Text.Json;
 using System.Threading.Tasks;
 using Buraq.PS; // Your namespace containing PowerShellManager
 
@@ -9,38 +14,293 @@ namespace Buraq.Bridge
 {
     class Program
     {
+        static readonly byte[] NewLine = { (byte)'\n' };
+
         static async Task Main(string[] args)
         {
-            var listener = new TcpListener(IPAddress.Loopback, 12345);
-            listener.Start();
-            Console.WriteLine("PowerShell Host Server is listening on port 12345...");
+            // --pipe <name>: local pipe chosen by the app; --port <n>: TCP fallback port.
+            string? pipeName = null;
+            int port = 12345;
+            for (int i = 0; i + 1 < args.Length; i += 2)
+            {
+                if (args[i] == "--pipe") pipeName = args[i + 1];
+                else if (args[i] == "--port") port = int.Parse(args[i + 1]);
+            }
 
             // Create a single instance of your PowerShell manager.
             var psManager = new PowerShellManager();
 
+            if (pipeName != null)
+            {
+                _ = Task.Run(() => ServePipe(pipeName, psManager));
+                Console.WriteLine($"PowerShell Host Server is listening on pipe {pipeName}...");
+            }
+
+            TcpListener? listener = null;
+            try
+            {
+                listener = new TcpListener(IPAddress.Loopback, port);
+                listener.Start();
+                Console.WriteLine($"PowerShell Host Server is listening on port {port}...");
+            }
+            catch (SocketException ex) when (pipeName != null)
+            {
+                // e.g. the port is taken by another tool; the pipe is enough.
+                Console.Error.WriteLine($"TCP fallback unavailable: {ex.Message}");
+                listener = null;
+            }
+
+            // Handshake frame: tells the supervising app (BridgeSupervisor) that scripts can be run.
+            WriteFrame(new { type = "hello", protocol = 1, pid = Environment.ProcessId });
+
+            // Pings and shutdown requests arrive on stdin.
+            _ = Task.Run(ControlLoop);
+
+            if (listener == null)
+            {
+                await Task.Delay(Timeout.Infinite);
+                return;
+            }
+
             while (true)
             {
-                using (TcpClient client = await listener.AcceptTcpClientAsync())
+                TcpClient client = await listener.AcceptTcpClientAsync();
+                client.NoDelay = true;
+                _ = Task.Run(async () =>
                 {
-                    await using (NetworkStream stream = client.GetStream())
-                    using (var reader = new StreamReader(stream))
-                    using (var writer = new StreamWriter(stream))
+                    using (client)
                     {
-                        string? script = await reader.ReadLineAsync();
-                        if (script != null)
-                        {
-                            // Use the PowerShellManager to run the script.
-                            string result = psManager.RunScript(script);
+                        await ServeClient(client.GetStream(), psManager);
+                    }
+                });
+            }
+        }
+
+        // Off Windows the app passes an absolute socket path, which .NET uses as it is (and
+        // replaces a stale socket file left there); a bare name would become /tmp/CoreFxPipe_<name>,
+        // where the app's QLocalSocket does not look.
+        static async Task ServePipe(string pipeName, PowerShellManager psManager)
+        {
+            while (true)
+            {
+                var pipe = new NamedPipeServerStream(pipeName, PipeDirection.InOut,
+                    NamedPipeServerStream.MaxAllowedServerInstances, PipeTransmissionMode.Byte, PipeOptions.Asynchronous);
+                await pipe.WaitForConnectionAsync();
+                _ = Task.Run(async () =>
+                {
+                    await using (pipe)
+                    {
+                        await ServeClient(pipe, psManager);
+                    }
+                });
+            }
+        }
+
+        // One connection carries any number of runs: {"type":"run","id":n,"script":"..."} lines in,
+        // {"type":"result","id":n,"output":"...","error":"...","had_errors":b,"records":{...}} lines
+        // out, in the same order.
+        // A "shm" frame offers a shared memory ring for large result bodies (see SharedMemoryRing.h).
+        static async Task ServeClient(Stream stream, PowerShellManager psManager)
+        {
+            using var reader = new StreamReader(stream);
+            using var writer = new StreamWriter(stream) { NewLine = "\n" };
+            using var ring = new RingWriter();
 
-                            Console.WriteLine("TcpClient: ", result);
+            string? line;
+            while ((line = await reader.ReadLineAsync()) != null)
+            {
+                long id;
+                string script;
+                try
+                {
+                    using var frame = JsonDocument.Parse(line);
+                    var type = frame.RootElement.GetProperty("type").GetString();
+                    if (type == "shm")
+                    {
+                        ring.Attach(frame.RootElement.GetProperty("key").GetString()!,
+                            frame.RootElement.GetProperty("threshold").GetInt64());
+                        continue;
+                    }
+                    if (type == "ack")
+                    {
+                        ring.Release(frame.RootElement.GetProperty("end").GetInt64());
+                        continue;
+                    }
+                    if (type != "run")
+                    {
+                        continue;
+                    }
+                    id = frame.RootElement.GetProperty("id").GetInt64();
+                    script = frame.RootElement.GetProperty("script").GetString() ?? "";
+                }
+                catch (Exception ex) when (ex is JsonException || ex is KeyNotFoundException || ex is InvalidOperationException)
+                {
+                    Console.Error.WriteLine($"Ignoring malformed frame: {ex.Message}");
+                    continue;
+                }
 
-                            // Send the result back to the C++ client.
-                            await writer.WriteLineAsync(result);
-                            await writer.FlushAsync();
-                        }
+                RunResult run;
+                try
+                {
+                    // A single runspace manager is shared by all connections.
+                    lock (psManager)
+                    {
+                        run = psManager.RunScript(script);
                     }
                 }
+                catch (Exception ex)
+                {
+                    run = new RunResult { Error = ex.ToString(), HadErrors = true };
+                }
+
+                var body = new Dictionary<string, object?>
+                {
+                    ["output"] = run.Output,
+                    ["error"] = run.Error,
+                    ["had_errors"] = run.HadErrors,
+                };
+                if (run.Records != null)
+                {
+                    body["records"] = new { columns = run.Records.Columns, values = run.Records.Values };
+                }
+
+                // Send the result back to the C++ client; large bodies go through shared memory.
+                // Serialized once: inline these bytes are the frame, through shared memory the app
+                // reads the same object, type and id included.
+                body["type"] = "result";
+                body["id"] = id;
+                byte[] result = JsonSerializer.SerializeToUtf8Bytes(body);
+                if (ring.TryWrite(result) is (long offset, long length))
+                {
+                    await writer.WriteLineAsync(JsonSerializer.Serialize(
+                        new { type = "result", id, shm_offset = offset, shm_length = length }));
+                    await writer.FlushAsync();
+                }
+                else
+                {
+                    // Already UTF-8, so past the writer, which is flushed after every frame.
+                    await stream.WriteAsync(result);
+                    await stream.WriteAsync(NewLine);
+                    await stream.FlushAsync();
+                }
+            }
+        }
+
+        static async Task ControlLoop()
+        {
+            string? line;
+            while ((line = await Console.In.ReadLineAsync()) != null)
+            {
+                try
+                {
+                    using var frame = JsonDocument.Parse(line);
+                    var type = frame.RootElement.GetProperty("type").GetString();
+
+                    if (type == "ping")
+                    {
+                        WriteFrame(new { type = "pong", seq = frame.RootElement.GetProperty("seq").GetInt64() });
+                    }
+                    else if (type == "shutdown")
+                    {
+                        break;
+                    }
+                }
+                catch (Exception ex) when (ex is JsonException || ex is KeyNotFoundException || ex is InvalidOperationException)
+                {
+                    Console.Error.WriteLine($"Ignoring malformed control frame: {ex.Message}");
+                }
             }
+
+            // stdin closed (the app went away) or shutdown was requested.
+            Environment.Exit(0);
+        }
+
+        static void WriteFrame(object frame)
+        {
+            Console.Out.WriteLine(JsonSerializer.Serialize(frame));
+            Console.Out.Flush();
+        }
+    }
+
+    // Writer half of the app's SharedMemoryRing: a 16 byte header (magic, version, capacity)
+    // followed by the payload area. Payloads never wrap; space comes back through "ack" frames.
+    sealed class RingWriter : IDisposable
+    {
+        const uint Magic = 0x52515242; // "BRQR"
+        const int HeaderSize = 16;
+
+        MemoryMappedFile? _file;
+        MemoryMappedViewAccessor? _view;
+        long _capacity;
+        long _threshold;
+        long _written;
+        long _released;
+
+        public void Attach(string key, long threshold)
+        {
+            try
+            {
+                // Named mappings only exist on Windows. Elsewhere the key is a POSIX shm_open() name,
+                // which Linux keeps as a file in /dev/shm; macOS has no such file, so it answers inline.
+                _file = OperatingSystem.IsWindows()
+                    ? MemoryMappedFile.OpenExisting(key, MemoryMappedFileRights.ReadWrite)
+                    : MemoryMappedFile.CreateFromFile("/dev/shm/" + key.TrimStart('/'), FileMode.Open, null, 0,
+                        MemoryMappedFileAccess.ReadWrite);
+                _view = _file.CreateViewAccessor();
+                if (_view.ReadUInt32(0) != Magic || _view.ReadUInt32(4) != 1)
+                {
+                    Dispose();
+                    return;
+                }
+                _capacity = _view.ReadInt64(8);
+                _threshold = threshold;
+                _written = _released = 0;
+            }
+            catch (Exception ex) when (ex is IOException || ex is PlatformNotSupportedException || ex is UnauthorizedAccessException)
+            {
+                Console.Error.WriteLine($"Shared memory unavailable, answering inline: {ex.Message}");
+                Dispose();
+            }
+        }
+
+        public void Release(long end)
+        {
+            _released = Math.Clamp(end, _released, _written);
+        }
+
+        public (long Offset, long Length)? TryWrite(byte[] payload)
+        {
+            if (_view == null)
+            {
+                return null;
+            }
+
+            long length = payload.Length;
+            if (length < _threshold || length > _capacity)
+            {
+                return null;
+            }
+
+            long position = _written % _capacity;
+            long padding = position + length > _capacity ? _capacity - position : 0;
+            if (_written + padding + length - _released > _capacity)
+            {
+                return null; // the app has not caught up yet
+            }
+
+            long offset = _written + padding;
+            _view.WriteArray(HeaderSize + offset % _capacity, payload, 0, payload.Length);
+            _view.Flush();
+            _written = offset + length;
+            return (offset, length);
+        }
+
+        public void Dispose()
+        {
+            _view?.Dispose();
+            _file?.Dispose();
+            _view = null;
+            _file = null;
         }
     }
 }
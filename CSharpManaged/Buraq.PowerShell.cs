@@ -1,13 +1,29 @@
 ﻿// Create an alias for the PowerShell class
 using System;
+using System.Text;
 using PowerShell = System.Management.Automation.PowerShell;
 using System.Management.Automation;
 
 namespace Buraq.PS
 {
+    // Columnar objects: Values[c][r] is column c of row r, kept as JSON-friendly primitives.
+    public class RecordSet
+    {
+        public List<string> Columns { get; } = new();
+        public List<List<object?>> Values { get; } = new();
+    }
+
+    public class RunResult
+    {
+        public string Output { get; set; } = "";
+        public string Error { get; set; } = "";
+        public bool HadErrors { get; set; }
+        public RecordSet? Records { get; set; }
+    }
+
     public class PowerShellManager
     {
-        public string RunScript(string script)
+        public RunResult RunScript(string script)
         {
             // Use the PowerShell class directly
             using (PowerShell ps = PowerShell.Create())
@@ -15,18 +31,93 @@ namespace Buraq.PS
                 ps.AddScript(script);
                 var results = ps.Invoke();
 
+                var output = new StringBuilder();
+                var objects = new List<PSObject>();
                 foreach (var item in results)
                 {
-                    Console.WriteLine(item.ToString());                    
+                    if (item == null)
+                    {
+                        continue;
+                    }
+
+                    // Strings and primitives are text; anything with properties becomes a record.
+                    if (item.BaseObject is string || item.BaseObject.GetType().IsPrimitive)
+                    {
+                        output.AppendLine(item.ToString());
+                    }
+                    else
+                    {
+                        objects.Add(item);
+                    }
                 }
-                
-                // 2. Added logic to process and return results
-                if (results.Count > 0)
+
+                var errors = new StringBuilder();
+                foreach (var error in ps.Streams.Error)
+                {
+                    errors.AppendLine(error.ToString());
+                }
+
+                return new RunResult
+                {
+                    Output = output.ToString().TrimEnd(),
+                    Error = errors.ToString().TrimEnd(),
+                    HadErrors = ps.HadErrors,
+                    Records = objects.Count > 0 ? ToRecords(objects) : null,
+                };
+            }
+        }
+
+        // Uses the columns PowerShell itself would show for the first object.
+        static RecordSet ToRecords(List<PSObject> objects)
+        {
+            var records = new RecordSet();
+            records.Columns.AddRange(DisplayProperties(objects[0]));
+
+            foreach (var column in records.Columns)
+            {
+                var values = new List<object?>(objects.Count);
+                foreach (var item in objects)
                 {
-                    return results[0]?.ToString() ?? "null";
+                    values.Add(ToValue(item, column));
                 }
-                return "No output";
+                records.Values.Add(values);
             }
+
+            return records;
+        }
+
+        static IEnumerable<string> DisplayProperties(PSObject item)
+        {
+            if (item.Members["PSStandardMembers"]?.Value is PSMemberSet standard &&
+                standard.Members["DefaultDisplayPropertySet"]?.Value is PSPropertySet display)
+            {
+                return display.ReferencedPropertyNames;
+            }
+
+            return item.Properties.Select(p => p.Name).Take(32).ToList();
+        }
+
+        static object? ToValue(PSObject item, string column)
+        {
+            object? value;
+            try
+            {
+                value = item.Properties[column]?.Value;
+            }
+            catch (Exception)
+            {
+                return null; // some getters throw, e.g. for processes of other users
+            }
+
+            value = value is PSObject wrapped ? wrapped.BaseObject : value;
+            return value switch
+            {
+                null => null,
+                string or bool => value,
+                byte or sbyte or short or ushort or int or uint or long or ulong or float or double or decimal => value,
+                DateTime date => date.ToString("o"),
+                _ => value.ToString(),
+            };
         }
     }
 }
@@ -0,0 +1,254 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "BridgeSupervisor.h"
+
+#include <algorithm>
+#include <QDebug>
+#include <QJsonObject>
+
+#include "buraq.h"
+#include "clients/PSClient/BridgeProtocol.h"
+#include "Metrics/Metrics.h"
+#include "Trace/Trace.h"
+
+BridgeSupervisor::BridgeSupervisor(std::filesystem::path executablePath, QObject* parent)
+    : QObject(parent), m_executablePath(std::move(executablePath))
+{
+    m_pingTimer.setInterval(PING_INTERVAL_MS);
+    connect(&m_pingTimer, &QTimer::timeout, this, &BridgeSupervisor::sendPing);
+
+    m_handshakeTimer.setSingleShot(true);
+    m_handshakeTimer.setInterval(HANDSHAKE_TIMEOUT_MS);
+    connect(&m_handshakeTimer, &QTimer::timeout, this, &BridgeSupervisor::onHandshakeTimeout);
+
+    m_restartTimer.setSingleShot(true);
+    connect(&m_restartTimer, &QTimer::timeout, this, &BridgeSupervisor::launch);
+}
+
+BridgeSupervisor::~BridgeSupervisor()
+{
+    stop();
+}
+
+void BridgeSupervisor::start()
+{
+    if (m_state != State::Stopped)
+    {
+        return;
+    }
+
+    m_restartAttempts = 0;
+    launch();
+}
+
+void BridgeSupervisor::stop()
+{
+    m_state = State::Stopped;
+    m_pingTimer.stop();
+    m_handshakeTimer.stop();
+    m_restartTimer.stop();
+
+    if (m_process == nullptr)
+    {
+        return;
+    }
+
+    if (m_process->state() != QProcess::NotRunning)
+    {
+        // Give the bridge a chance to exit on its own before forcing it.
+        m_process->write(bridge::makeFrame(bridge::FRAME_SHUTDOWN));
+        m_process->closeWriteChannel();
+        if (!m_process->waitForFinished(2000))
+        {
+            m_process->kill();
+            m_process->waitForFinished(1000);
+        }
+    }
+
+    delete m_process;
+    m_process = nullptr;
+}
+
+void BridgeSupervisor::launch()
+{
+    TraceSpan span("BridgeSupervisor::launch");
+
+    if (!std::filesystem::exists(m_executablePath))
+    {
+        // Nothing to supervise; restarting would not help either.
+        file_utils::file_log(LogLevel::Error, "Bridge executable not found: " + m_executablePath.string());
+        emit statusMessage("PowerShell Support is not installed.", 10000);
+        m_state = State::Stopped;
+        return;
+    }
+
+    m_state = State::Starting;
+    m_missedPings = 0;
+    m_stdoutBuffer.clear();
+
+    delete m_process;
+    m_process = new QProcess(this);
+    m_process->setProgram(QString::fromStdString(m_executablePath.string()));
+    m_process->setArguments({"--pipe", bridge::localServerName()});
+    m_process->setWorkingDirectory(QString::fromStdString(m_executablePath.parent_path().string()));
+    // Diagnostics on stderr are not part of the protocol; keep them out of our pipes.
+    m_process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+
+    connect(m_process, &QProcess::started, this, &BridgeSupervisor::onStarted);
+    connect(m_process, &QProcess::readyReadStandardOutput, this, &BridgeSupervisor::onReadyReadStandardOutput);
+    connect(m_process, &QProcess::finished, this, &BridgeSupervisor::onFinished);
+    connect(m_process, &QProcess::errorOccurred, this, &BridgeSupervisor::onErrorOccurred);
+
+    m_launchClock.start();
+    m_handshakeTimer.start();
+    m_process->start(QIODevice::ReadWrite);
+}
+
+void BridgeSupervisor::onStarted()
+{
+    qDebug() << "Bridge process started with PID:" << m_process->processId();
+    emit statusMessage("Starting PowerShell Support..", 5000);
+}
+
+void BridgeSupervisor::onReadyReadStandardOutput()
+{
+    m_stdoutBuffer.append(m_process->readAllStandardOutput());
+
+    qsizetype newline;
+    while ((newline = m_stdoutBuffer.indexOf('\n')) >= 0)
+    {
+        const QByteArray line = m_stdoutBuffer.left(newline);
+        m_stdoutBuffer.remove(0, newline + 1);
+
+        if (const auto frame = bridge::decodeFrame(line); frame.has_value())
+        {
+            handleFrame(frame.value());
+        }
+    }
+}
+
+void BridgeSupervisor::handleFrame(const QJsonObject& frame)
+{
+    const QString type = frame.value("type").toString();
+
+    if (type == bridge::FRAME_HELLO && m_state == State::Starting)
+    {
+        m_handshakeTimer.stop();
+        m_state = State::Ready;
+
+        const qint64 elapsed = m_launchClock.elapsed();
+        Metrics::singleton().record("bridge.time_to_ready_ms", static_cast<double>(elapsed));
+        if (Trace& trace = Trace::singleton(); trace.enabled())
+        {
+            const std::int64_t now = trace.now();
+            trace.complete("bridge.time_to_ready", now - m_launchClock.nsecsElapsed(), now);
+        }
+
+        emit statusMessage(QString("PowerShell Support Ready (%1 ms)").arg(elapsed), 30000);
+        emit ready(elapsed);
+
+        m_pingTimer.start();
+    }
+    else if (type == bridge::FRAME_PONG)
+    {
+        if (frame.value("seq").toInteger() == m_pingSeq)
+        {
+            m_missedPings = 0;
+
+            // Up and answering for a while: a later crash starts the backoff over. Not on hello,
+            // or a bridge that dies right after its handshake would restart every 0.5 s forever.
+            if (m_restartAttempts > 0 && m_launchClock.elapsed() >= STABLE_UPTIME_MS)
+            {
+                m_restartAttempts = 0;
+            }
+        }
+    }
+}
+
+void BridgeSupervisor::sendPing()
+{
+    if (m_state != State::Ready || m_process == nullptr)
+    {
+        return;
+    }
+
+    if (m_missedPings >= MAX_MISSED_PINGS)
+    {
+        file_utils::file_log(LogLevel::Warning, "Bridge stopped answering pings; restarting it.");
+        Metrics::singleton().increment("bridge.unresponsive");
+        // onFinished() takes care of the restart.
+        killProcess();
+        return;
+    }
+
+    m_missedPings++;
+    m_process->write(bridge::encodeFrame(QJsonObject{
+        {"type", bridge::FRAME_PING},
+        {"seq", ++m_pingSeq},
+    }));
+}
+
+void BridgeSupervisor::onHandshakeTimeout()
+{
+    if (m_state != State::Starting)
+    {
+        return;
+    }
+
+    file_utils::file_log(LogLevel::Warning, "Bridge did not complete its handshake in time; restarting it.");
+    killProcess();
+}
+
+void BridgeSupervisor::onFinished(const int exitCode, const QProcess::ExitStatus exitStatus)
+{
+    if (m_state == State::Stopped)
+    {
+        return;
+    }
+
+    scheduleRestart(QString("exit code %1%2").arg(exitCode).arg(
+        exitStatus == QProcess::CrashExit ? ", crashed" : ""));
+}
+
+void BridgeSupervisor::onErrorOccurred(const QProcess::ProcessError error)
+{
+    // Crashes and timeouts are followed by finished(); only a failed start is not.
+    if (error == QProcess::FailedToStart && m_state != State::Stopped)
+    {
+        scheduleRestart("failed to start: " + m_process->errorString());
+    }
+}
+
+void BridgeSupervisor::scheduleRestart(const QString& reason)
+{
+    if (m_state == State::Restarting)
+    {
+        return;
+    }
+
+    m_state = State::Restarting;
+    m_pingTimer.stop();
+    m_handshakeTimer.stop();
+
+    // 0.5 s, 1 s, 2 s, ... capped at 30 s.
+    const int shift = std::min(m_restartAttempts, 16);
+    const int delay = std::min(RESTART_BASE_DELAY_MS << shift, RESTART_MAX_DELAY_MS);
+    m_restartAttempts++;
+
+    file_utils::file_log(LogLevel::Warning, "Bridge went down (" + reason.toStdString() + "); restarting in " +
+        std::to_string(delay) + " ms.");
+    Metrics::singleton().increment("bridge.restarts");
+
+    emit statusMessage("PowerShell Support stopped. Restarting..", delay);
+    m_restartTimer.start(delay);
+}
+
+void BridgeSupervisor::killProcess()
+{
+    if (m_process != nullptr && m_process->state() != QProcess::NotRunning)
+    {
+        m_process->kill();
+    }
+}
@@ -0,0 +1,91 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef BRIDGE_SUPERVISOR_H
+#define BRIDGE_SUPERVISOR_H
+
+#include <filesystem>
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QProcess>
+#include <QTimer>
+
+class QJsonObject;
+
+/**
+ * Keeps the PowerShell bridge (Buraq.Bridge) alive for the lifetime of the app.
+ *
+ * The bridge is started as a child QProcess. It is considered ready once it writes a
+ * hello frame on stdout (see BridgeProtocol.h); after that it is pinged over stdin and
+ * killed if it stops answering. Whenever the process exits it is relaunched with an
+ * exponential backoff.
+ */
+class BridgeSupervisor final : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BridgeSupervisor(std::filesystem::path executablePath, QObject* parent = nullptr);
+    ~BridgeSupervisor() override;
+
+    // Launches the bridge. Returns immediately; readiness is reported through ready().
+    void start();
+
+    // Stops the bridge and disables automatic restarts.
+    void stop();
+
+    [[nodiscard]] bool isReady() const { return m_state == State::Ready; }
+
+signals:
+    // Emitted every time the bridge completes its handshake.
+    void ready(qint64 timeToReadyMs);
+    void statusMessage(const QString& message, int timeout);
+
+private slots:
+    void onStarted();
+    void onReadyReadStandardOutput();
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onErrorOccurred(QProcess::ProcessError error);
+    void onHandshakeTimeout();
+    void sendPing();
+
+private:
+    enum class State
+    {
+        Stopped,
+        Starting,
+        Ready,
+        Restarting,
+    };
+
+    static constexpr int PING_INTERVAL_MS = 5000;
+    static constexpr int MAX_MISSED_PINGS = 3;
+    static constexpr int HANDSHAKE_TIMEOUT_MS = 30000;
+    static constexpr int RESTART_BASE_DELAY_MS = 500;
+    static constexpr int RESTART_MAX_DELAY_MS = 30000;
+    // Uptime after which the restart backoff is reset.
+    static constexpr int STABLE_UPTIME_MS = 60000;
+
+    void launch();
+    void scheduleRestart(const QString& reason);
+    void handleFrame(const QJsonObject& frame);
+    void killProcess();
+
+    std::filesystem::path m_executablePath;
+    QProcess* m_process{};
+    State m_state = State::Stopped;
+
+    QTimer m_pingTimer;
+    QTimer m_handshakeTimer;
+    QTimer m_restartTimer;
+    QElapsedTimer m_launchClock;
+    QByteArray m_stdoutBuffer;
+
+    int m_restartAttempts = 0;
+    int m_missedPings = 0;
+    qint64 m_pingSeq = 0;
+};
+
+#endif // BRIDGE_SUPERVISOR_H
@@ -5,7 +5,9 @@
 #ifndef APP_VERSION_H
 #define APP_VERSION_H
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include <version.h>
 
@@ -18,6 +20,25 @@ struct github_manifest_asset
     std::string sha;
 };
 
+// Turns an installed file whose content hashes to from into the new version's.
+struct manifest_patch
+{
+    std::string from;
+    std::string url;
+    std::int64_t size = 0;
+    std::string sha;
+};
+
+// One file of the new version, relative to the installation directory.
+struct manifest_file
+{
+    std::string path;
+    std::string url;
+    std::int64_t size = 0;
+    std::string sha;
+    std::vector<manifest_patch> patches;
+};
+
 struct UpdateInfo {
 	std::string latestVersion;
 	std::string currentVersion = "v" + std::to_string(APP_VERSION_MAJOR) + "." +
@@ -25,6 +46,8 @@ struct UpdateInfo {
 		std::to_string(APP_VERSION_PATCH);
 	std::string releaseNotes;
 	github_manifest_asset asset;
+	// Every file of the new version; empty if the manifest only has the installer.
+	std::vector<manifest_file> files;
 	bool isConnFailure = false;
 };
 
@@ -0,0 +1,46 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "BridgeBackend.h"
+
+#include "clients/PSClient/PSClient.h"
+
+BridgeBackend::BridgeBackend(QObject* parent)
+    : IExecutionBackend(parent), m_client(new PSClient(this))
+{
+    connect(m_client, &PSClient::scriptResultReceived, this, &BridgeBackend::onScriptResult);
+}
+
+void BridgeBackend::execute(const quint64 runId, const QString& script)
+{
+    // Results carry the request id, so runs can be handed to the bridge straight away;
+    // the bridge runs the scripts of one connection in order.
+    m_runs.insert(m_client->runScript(script), runId);
+}
+
+void BridgeBackend::onScriptResult(const quint64 requestId, const BridgeResult& result)
+{
+    const auto it = m_runs.constFind(requestId);
+    if (it == m_runs.cend())
+    {
+        return;
+    }
+
+    const quint64 runId = it.value();
+    m_runs.erase(it);
+
+    if (!result.delivered)
+    {
+        emit runFinished(runId, 1, "", "Error failed to execute task.");
+        return;
+    }
+
+    if (result.records)
+    {
+        emit recordsReady(runId, result.records);
+    }
+
+    // The bridge reports failures on the error stream; no need to guess from the output.
+    emit runFinished(runId, result.hadErrors ? 1 : 0, result.output, result.error);
+}
@@ -0,0 +1,33 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef BRIDGE_BACKEND_H
+#define BRIDGE_BACKEND_H
+
+#include <QHash>
+
+#include "IExecutionBackend.h"
+#include "clients/PSClient/PSClient.h"
+
+// Runs scripts through the C# PowerShell bridge (Buraq.Bridge) via PSClient.
+class BridgeBackend final : public IExecutionBackend
+{
+    Q_OBJECT
+
+public:
+    explicit BridgeBackend(QObject* parent = nullptr);
+
+    void execute(quint64 runId, const QString& script) override;
+    [[nodiscard]] QString name() const override { return "PowerShell bridge"; }
+
+private slots:
+    void onScriptResult(quint64 requestId, const BridgeResult& result);
+
+private:
+    PSClient* m_client;
+    // PSClient request id -> run id.
+    QHash<quint64, quint64> m_runs;
+};
+
+#endif // BRIDGE_BACKEND_H
@@ -0,0 +1,57 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "ExecutionBackendFactory.h"
+
+#include <QStandardPaths>
+
+#include "BridgeBackend.h"
+#include "PersistentProcessBackend.h"
+
+namespace execution
+{
+    QString defaultBackend()
+    {
+#ifdef _WIN32
+        return BACKEND_BRIDGE;
+#else
+        return BACKEND_PWSH;
+#endif
+    }
+
+    IExecutionBackend* createBackend(const QString& kind, QObject* parent)
+    {
+        using Dialect = PersistentProcessBackend::Dialect;
+
+        QString selected = qEnvironmentVariable("BURAQ_BACKEND", kind).trimmed().toLower();
+        if (selected.isEmpty())
+        {
+            selected = defaultBackend();
+        }
+
+        if (selected == BACKEND_BRIDGE)
+        {
+            return new BridgeBackend(parent);
+        }
+        if (selected == BACKEND_BASH)
+        {
+            return new PersistentProcessBackend(Dialect::Bash, {}, parent);
+        }
+        if (selected == BACKEND_PYTHON)
+        {
+            return new PersistentProcessBackend(Dialect::Python, {}, parent);
+        }
+
+        // pwsh: fall back to Windows PowerShell, then bash, when PowerShell 7 is not installed.
+        if (!QStandardPaths::findExecutable("pwsh").isEmpty())
+        {
+            return new PersistentProcessBackend(Dialect::PowerShell, "pwsh", parent);
+        }
+#ifdef _WIN32
+        return new PersistentProcessBackend(Dialect::PowerShell, "powershell", parent);
+#else
+        return new PersistentProcessBackend(Dialect::Bash, {}, parent);
+#endif
+    }
+}
@@ -0,0 +1,32 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef EXECUTION_BACKEND_FACTORY_H
+#define EXECUTION_BACKEND_FACTORY_H
+
+#include <QString>
+
+class IExecutionBackend;
+class QObject;
+
+namespace execution
+{
+    // Backend names accepted in UserSettings::executionBackend and $BURAQ_BACKEND.
+    constexpr auto BACKEND_BRIDGE = "bridge";
+    constexpr auto BACKEND_PWSH = "pwsh";
+    constexpr auto BACKEND_BASH = "bash";
+    constexpr auto BACKEND_PYTHON = "python";
+
+    /**
+     * Creates the backend called `kind`, owned by `parent`.
+     * The BURAQ_BACKEND environment variable, when set, takes precedence over `kind`.
+     * Unknown names fall back to the default backend for the platform.
+     */
+    IExecutionBackend* createBackend(const QString& kind, QObject* parent);
+
+    // "bridge" on Windows, where Buraq.Bridge ships; a local pwsh everywhere else.
+    QString defaultBackend();
+}
+
+#endif // EXECUTION_BACKEND_FACTORY_H
@@ -0,0 +1,53 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef I_EXECUTION_BACKEND_H
+#define I_EXECUTION_BACKEND_H
+
+#include <QObject>
+#include <QString>
+
+#include "RecordSet.h"
+
+/**
+ * Something that can run a script and report back its output.
+ *
+ * Runs are identified by the caller-chosen runId and are answered with exactly one
+ * runFinished() per execute(), in submission order. Backends that return objects rather
+ * than text emit recordsReady() for the run just before its runFinished(). Backends that can
+ * stream emit outputReady() with whole lines while the run is in progress; runFinished() then
+ * only carries the output that was not streamed yet. Implementations live on the GUI thread
+ * and must never block it.
+ */
+class IExecutionBackend : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit IExecutionBackend(QObject* parent = nullptr) : QObject(parent)
+    {
+    }
+
+    ~IExecutionBackend() override = default;
+
+    // Queues the script for execution.
+    virtual void execute(quint64 runId, const QString& script) = 0;
+
+    // Human-readable backend name for the status bar, e.g. "PowerShell bridge".
+    [[nodiscard]] virtual QString name() const = 0;
+
+    // Does ahead of the first run what that run would otherwise wait for, such as starting
+    // an interpreter. Called once the window is up.
+    virtual void warmUp()
+    {
+    }
+
+signals:
+    void recordsReady(quint64 runId, const RecordSetPtr& records);
+    // One or more complete lines, without the final newline.
+    void outputReady(quint64 runId, const QString& text, bool isError);
+    void runFinished(quint64 runId, int exitCode, const QString& output, const QString& error);
+};
+
+#endif // I_EXECUTION_BACKEND_H
@@ -0,0 +1,368 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "PersistentProcessBackend.h"
+
+#include <QDebug>
+#include <QProcessEnvironment>
+#include <QRandomGenerator>
+
+namespace
+{
+    // Reads "<sentinel> <base64 script>" lines and runs each script in one shared namespace.
+    constexpr auto PYTHON_DRIVER = R"PY(
+import base64, sys, traceback
+scope = {"__name__": "__main__"}
+for line in sys.stdin:
+    sentinel, _, payload = line.strip().partition(" ")
+    if not sentinel:
+        continue
+    rc = 0
+    try:
+        exec(compile(base64.b64decode(payload).decode("utf-8"), "<buraq>", "exec"), scope)
+    except SystemExit as e:
+        rc = e.code if isinstance(e.code, int) else int(e.code is not None)
+    except BaseException:
+        traceback.print_exc()
+        rc = 1
+    for stream in (sys.stdout, sys.stderr):
+        stream.write("\n%s%d\n" % (sentinel, rc))
+        stream.flush()
+)PY";
+
+    // pwsh 7.2+ drops colors when its output is redirected; the output panel renders them.
+    constexpr auto POWERSHELL_INIT =
+        "[Console]::OutputEncoding = [Text.Encoding]::UTF8; $ProgressPreference = 'SilentlyContinue'; "
+        "if ($PSStyle) { $PSStyle.OutputRendering = 'Ansi' }\n";
+
+    // Removes one trailing "\n" or "\r\n".
+    void chopNewline(QByteArray& buffer)
+    {
+        if (buffer.endsWith('\n'))
+        {
+            buffer.chop(buffer.endsWith("\r\n") ? 2 : 1);
+        }
+    }
+}
+
+PersistentProcessBackend::PersistentProcessBackend(const Dialect dialect, QString program, QObject* parent)
+    : IExecutionBackend(parent), m_dialect(dialect), m_program(std::move(program)),
+      m_sessionToken(QByteArray::number(QRandomGenerator::global()->generate64(), 16))
+{
+    if (m_program.isEmpty())
+    {
+        m_program = defaultProgram(dialect);
+    }
+}
+
+PersistentProcessBackend::~PersistentProcessBackend()
+{
+    if (m_process != nullptr && m_process->state() != QProcess::NotRunning)
+    {
+        // Closing stdin ends all three interpreters' read loops.
+        m_process->closeWriteChannel();
+        if (!m_process->waitForFinished(1000))
+        {
+            m_process->kill();
+            m_process->waitForFinished(1000);
+        }
+    }
+}
+
+QString PersistentProcessBackend::defaultProgram(const Dialect dialect)
+{
+    switch (dialect)
+    {
+    case Dialect::PowerShell:
+        return "pwsh";
+    case Dialect::Bash:
+        return "bash";
+    case Dialect::Python:
+#ifdef _WIN32
+        return "python";
+#else
+        return "python3";
+#endif
+    }
+    return {};
+}
+
+QString PersistentProcessBackend::name() const
+{
+    return m_program + " (persistent)";
+}
+
+QStringList PersistentProcessBackend::arguments() const
+{
+    switch (m_dialect)
+    {
+    case Dialect::PowerShell:
+        return {"-NoLogo", "-NoProfile", "-NonInteractive", "-Command", "-"};
+    case Dialect::Bash:
+        return {"--noprofile", "--norc"};
+    case Dialect::Python:
+        return {"-u", "-c", PYTHON_DRIVER};
+    }
+    return {};
+}
+
+QByteArray PersistentProcessBackend::commandFor(const QByteArray& sentinel, const QString& script) const
+{
+    const QString encoded = QString::fromLatin1(script.toUtf8().toBase64());
+    const QString marker = QString::fromLatin1(sentinel);
+
+    switch (m_dialect)
+    {
+    case Dialect::PowerShell:
+        return QString(
+            "$__buraqOk = $true; "
+            "try { . ([ScriptBlock]::Create([Text.Encoding]::UTF8.GetString([Convert]::FromBase64String('%1')))) "
+            "| Out-String -Stream } "
+            "catch { $__buraqOk = $false; [Console]::Error.WriteLine($_) }; "
+            "$__buraqRc = [int](-not $__buraqOk); "
+            "[Console]::Out.WriteLine(); [Console]::Out.WriteLine('%2' + $__buraqRc); "
+            "[Console]::Error.WriteLine(); [Console]::Error.WriteLine('%2' + $__buraqRc)\n"
+        ).arg(encoded, marker).toUtf8();
+    case Dialect::Bash:
+        // stdin is redirected so a script that reads input cannot swallow the next run.
+        return QString(
+            "eval \"$(printf '%s' '%1' | base64 -d)\" </dev/null; __buraq_rc=$?; "
+            "printf '\\n%2%d\\n' \"$__buraq_rc\"; printf '\\n%2%d\\n' \"$__buraq_rc\" >&2\n"
+        ).arg(encoded, marker).toUtf8();
+    case Dialect::Python:
+        return sentinel + ' ' + encoded.toLatin1() + '\n';
+    }
+    return {};
+}
+
+void PersistentProcessBackend::warmUp()
+{
+    ensureProcess();
+}
+
+bool PersistentProcessBackend::ensureProcess()
+{
+    if (m_process != nullptr && m_process->state() != QProcess::NotRunning)
+    {
+        return true;
+    }
+
+    if (m_process != nullptr)
+    {
+        m_process->deleteLater();
+    }
+
+    m_process = new QProcess(this);
+    m_process->setProgram(m_program);
+    m_process->setArguments(arguments());
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("PYTHONIOENCODING", "utf-8");
+    m_process->setProcessEnvironment(environment);
+
+    connect(m_process, &QProcess::readyReadStandardOutput, this, &PersistentProcessBackend::onReadyReadStandardOutput);
+    connect(m_process, &QProcess::readyReadStandardError, this, &PersistentProcessBackend::onReadyReadStandardError);
+    connect(m_process, &QProcess::finished, this, &PersistentProcessBackend::onFinished);
+    connect(m_process, &QProcess::errorOccurred, this, &PersistentProcessBackend::onErrorOccurred);
+
+    // Writes issued before the process is up are buffered by QProcess.
+    m_process->start();
+
+    if (m_dialect == Dialect::PowerShell)
+    {
+        m_process->write(POWERSHELL_INIT);
+    }
+
+    return true;
+}
+
+void PersistentProcessBackend::execute(const quint64 runId, const QString& script)
+{
+    m_pending.enqueue({runId, script});
+
+    if (!m_active.has_value())
+    {
+        startNext();
+    }
+}
+
+void PersistentProcessBackend::startNext()
+{
+    if (m_active.has_value() || m_pending.isEmpty() || !ensureProcess())
+    {
+        return;
+    }
+
+    const auto [runId, script] = m_pending.dequeue();
+
+    ActiveRun run{
+        .runId = runId,
+        .sentinel = "__BURAQ_DONE_" + m_sessionToken + "_" + QByteArray::number(runId) + "_",
+    };
+    const QByteArray command = commandFor(run.sentinel, script);
+    m_active = std::move(run);
+
+    m_process->write(command);
+}
+
+std::optional<int> PersistentProcessBackend::takeSentinel(QByteArray& buffer, const QByteArray& sentinel)
+{
+    const qsizetype at = buffer.indexOf(sentinel);
+    if (at < 0)
+    {
+        return std::nullopt;
+    }
+
+    const qsizetype codeStart = at + sentinel.size();
+    const qsizetype lineEnd = buffer.indexOf('\n', codeStart);
+    if (lineEnd < 0)
+    {
+        return std::nullopt; // exit status not fully received yet
+    }
+
+    bool ok = false;
+    const int exitCode = buffer.mid(codeStart, lineEnd - codeStart).trimmed().toInt(&ok);
+
+    // Drop the sentinel line and the newline that was printed in front of it.
+    buffer.truncate(at);
+    chopNewline(buffer);
+
+    return ok ? exitCode : 1;
+}
+
+void PersistentProcessBackend::streamLines(QByteArray& buffer, const bool isError, const bool complete)
+{
+    if (complete)
+    {
+        // The sentinel is cut off: what is left are the run's last lines, the final one
+        // possibly without its newline.
+        if (!buffer.isEmpty())
+        {
+            chopNewline(buffer);
+            emit outputReady(m_active->runId, QString::fromUtf8(buffer), isError);
+            buffer.clear();
+        }
+        return;
+    }
+
+    // What follows the last newline may be a partial line or the start of the sentinel.
+    const qsizetype lastNewline = buffer.lastIndexOf('\n');
+    if (lastNewline < 0)
+    {
+        return;
+    }
+
+    // An empty last line may be the end of the output plus the newline printed in front of the
+    // sentinel; it is held back until something other than the sentinel follows.
+    qsizetype end = lastNewline;
+    const qsizetype lineStart = lastNewline > 0 ? buffer.lastIndexOf('\n', lastNewline - 1) + 1 : 0;
+    if (lastNewline == lineStart || (lastNewline == lineStart + 1 && buffer.at(lineStart) == '\r'))
+    {
+        if (lineStart == 0)
+        {
+            return;
+        }
+        end = lineStart - 1;
+    }
+
+    const QString lines = QString::fromUtf8(buffer.constData(), end);
+    buffer.remove(0, end + 1);
+
+    emit outputReady(m_active->runId, lines, isError);
+}
+
+void PersistentProcessBackend::onReadyReadStandardOutput()
+{
+    const QByteArray data = m_process->readAllStandardOutput();
+    if (!m_active.has_value())
+    {
+        return; // e.g. banner text printed outside of a run
+    }
+
+    if (!m_active->stdoutExitCode.has_value())
+    {
+        m_active->stdoutData.append(data);
+        m_active->stdoutExitCode = takeSentinel(m_active->stdoutData, m_active->sentinel);
+        streamLines(m_active->stdoutData, false, m_active->stdoutExitCode.has_value());
+    }
+    completeIfDone();
+}
+
+void PersistentProcessBackend::onReadyReadStandardError()
+{
+    const QByteArray data = m_process->readAllStandardError();
+    if (!m_active.has_value())
+    {
+        return;
+    }
+
+    if (!m_active->stderrExitCode.has_value())
+    {
+        m_active->stderrData.append(data);
+        m_active->stderrExitCode = takeSentinel(m_active->stderrData, m_active->sentinel);
+        streamLines(m_active->stderrData, true, m_active->stderrExitCode.has_value());
+    }
+    completeIfDone();
+}
+
+void PersistentProcessBackend::completeIfDone()
+{
+    if (m_active.has_value() && m_active->stdoutExitCode.has_value() && m_active->stderrExitCode.has_value())
+    {
+        finishActiveRun(m_active->stdoutExitCode.value());
+    }
+}
+
+void PersistentProcessBackend::finishActiveRun(const int exitCode, const QString& extraError)
+{
+    if (!m_active.has_value())
+    {
+        return;
+    }
+
+    const ActiveRun run = std::move(m_active.value());
+    m_active.reset();
+
+    QString error = QString::fromUtf8(run.stderrData);
+    if (!extraError.isEmpty())
+    {
+        error += (error.isEmpty() ? "" : "\n") + extraError;
+    }
+
+    emit runFinished(run.runId, exitCode, QString::fromUtf8(run.stdoutData), error);
+
+    startNext();
+}
+
+void PersistentProcessBackend::onFinished(const int exitCode, const QProcess::ExitStatus exitStatus)
+{
+    qDebug() << m_program << "exited with code" << exitCode;
+
+    // e.g. the script called `exit`; the interpreter is restarted for the next run.
+    finishActiveRun(exitCode == 0 ? 1 : exitCode,
+                    exitStatus == QProcess::CrashExit
+                        ? m_program + " crashed."
+                        : m_program + " exited before the script completed.");
+}
+
+void PersistentProcessBackend::onErrorOccurred(const QProcess::ProcessError error)
+{
+    if (error != QProcess::FailedToStart)
+    {
+        return; // finished() follows
+    }
+
+    const QString message = "Could not start " + m_program + ": " + m_process->errorString();
+    qDebug() << message;
+
+    // Nothing queued can run either; fail everything rather than retrying in a loop.
+    QQueue<PendingRun> pending;
+    pending.swap(m_pending);
+
+    finishActiveRun(1, message);
+    for (const auto& run : pending)
+    {
+        emit runFinished(run.runId, 1, "", message);
+    }
+}
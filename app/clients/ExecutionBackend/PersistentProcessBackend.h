@@ -0,0 +1,93 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef PERSISTENT_PROCESS_BACKEND_H
+#define PERSISTENT_PROCESS_BACKEND_H
+
+#include <optional>
+#include <QProcess>
+#include <QQueue>
+
+#include "IExecutionBackend.h"
+
+/**
+ * Keeps a single interpreter (pwsh, bash or python) alive and feeds it one script per run
+ * over stdin, so interpreter startup is paid once instead of on every run.
+ *
+ * Each script is sent as a single base64-encoded line followed by a command that prints a
+ * per-run sentinel plus the exit status on both stdout and stderr. Everything read before
+ * the sentinel belongs to that run and is streamed through outputReady() line by line as it
+ * arrives. If the interpreter dies it is restarted on the next run.
+ */
+class PersistentProcessBackend final : public IExecutionBackend
+{
+    Q_OBJECT
+
+public:
+    enum class Dialect
+    {
+        PowerShell,
+        Bash,
+        Python,
+    };
+
+    PersistentProcessBackend(Dialect dialect, QString program, QObject* parent = nullptr);
+    ~PersistentProcessBackend() override;
+
+    void execute(quint64 runId, const QString& script) override;
+    [[nodiscard]] QString name() const override;
+
+    // Starts the interpreter ahead of the first run.
+    void warmUp() override;
+
+    // Interpreter executable used when none is configured, e.g. "pwsh".
+    static QString defaultProgram(Dialect dialect);
+
+private slots:
+    void onReadyReadStandardOutput();
+    void onReadyReadStandardError();
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onErrorOccurred(QProcess::ProcessError error);
+
+private:
+    struct PendingRun
+    {
+        quint64 runId;
+        QString script;
+    };
+
+    struct ActiveRun
+    {
+        quint64 runId;
+        QByteArray sentinel;
+        QByteArray stdoutData;
+        QByteArray stderrData;
+        std::optional<int> stdoutExitCode;
+        std::optional<int> stderrExitCode;
+    };
+
+    bool ensureProcess();
+    void startNext();
+    void completeIfDone();
+    void finishActiveRun(int exitCode, const QString& extraError = {});
+    [[nodiscard]] QStringList arguments() const;
+    [[nodiscard]] QByteArray commandFor(const QByteArray& sentinel, const QString& script) const;
+
+    // Cuts everything from the sentinel on out of buffer. Returns the exit status that
+    // followed the sentinel, or nothing if the sentinel has not fully arrived yet.
+    static std::optional<int> takeSentinel(QByteArray& buffer, const QByteArray& sentinel);
+
+    // Emits the complete lines at the front of buffer for the active run and removes them;
+    // with complete (the sentinel has been cut off), everything left.
+    void streamLines(QByteArray& buffer, bool isError, bool complete);
+
+    Dialect m_dialect;
+    QString m_program;
+    QProcess* m_process{};
+    QQueue<PendingRun> m_pending;
+    std::optional<ActiveRun> m_active;
+    QByteArray m_sessionToken;
+};
+
+#endif // PERSISTENT_PROCESS_BACKEND_H
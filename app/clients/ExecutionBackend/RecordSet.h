@@ -0,0 +1,63 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef RECORD_SET_H
+#define RECORD_SET_H
+
+#include <memory>
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QStringList>
+
+/**
+ * Objects returned by a run, as a table: one JSON array of values per column, all of the
+ * same length. Values keep their JSON type (number, bool, string, null), so they can be
+ * sorted properly; nothing is converted until a cell is actually shown.
+ *
+ * On the wire: {"columns":["Name","Id"],"values":[["pwsh","explorer"],[4242,17]]}
+ */
+struct RecordSet
+{
+    QStringList columns;
+    QList<QJsonArray> values;
+
+    [[nodiscard]] qsizetype rowCount() const { return values.isEmpty() ? 0 : values.first().size(); }
+    [[nodiscard]] qsizetype columnCount() const { return columns.size(); }
+
+    [[nodiscard]] QJsonValue value(const qsizetype row, const qsizetype column) const
+    {
+        return values[column][row];
+    }
+
+    // Returns nothing if the object is not a well-formed record set or has no rows.
+    static std::shared_ptr<const RecordSet> fromJson(const QJsonObject& json)
+    {
+        auto records = std::make_shared<RecordSet>();
+
+        const QJsonArray columns = json.value("columns").toArray();
+        const QJsonArray values = json.value("values").toArray();
+        if (columns.isEmpty() || columns.size() != values.size())
+        {
+            return nullptr;
+        }
+
+        for (qsizetype column = 0; column < columns.size(); ++column)
+        {
+            records->columns.append(columns[column].toString());
+            records->values.append(values[column].toArray());
+
+            if (records->values.last().size() != records->values.first().size())
+            {
+                return nullptr;
+            }
+        }
+
+        return records->rowCount() > 0 ? records : nullptr;
+    }
+};
+
+using RecordSetPtr = std::shared_ptr<const RecordSet>;
+
+#endif // RECORD_SET_H
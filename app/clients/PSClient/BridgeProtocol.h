@@ -0,0 +1,97 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef BRIDGE_PROTOCOL_H
+#define BRIDGE_PROTOCOL_H
+
+#include <optional>
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+
+// Frames exchanged with the PowerShell bridge (Buraq.Bridge).
+// A frame is a single line of compact JSON with a "type" member. Control frames travel over
+// the bridge's stdin/stdout; anything else it prints there (e.g. Console.WriteLine
+// diagnostics) is not a frame and is ignored. Script runs travel over a local socket, or
+// loopback TCP when that is not available (see BridgeTransport.h).
+namespace bridge
+{
+    constexpr int PROTOCOL_VERSION = 1;
+
+    constexpr auto DEFAULT_HOST = "127.0.0.1";
+    constexpr quint16 DEFAULT_PORT = 12345;
+
+    // bridge -> app: sent once the bridge is listening and able to run scripts.
+    constexpr auto FRAME_HELLO = "hello";
+    // app -> bridge: liveness probe; the bridge answers with a pong carrying the same seq.
+    constexpr auto FRAME_PING = "ping";
+    constexpr auto FRAME_PONG = "pong";
+    // app -> bridge: ask the bridge to exit cleanly.
+    constexpr auto FRAME_SHUTDOWN = "shutdown";
+
+    // app -> bridge: {"type":"run","id":<n>,"script":"..."}
+    constexpr auto FRAME_RUN = "run";
+    // bridge -> app: {"type":"result","id":<n>,"output":"...","error":"...","had_errors":<bool>,
+    //                 "records":{"columns":[...],"values":[[...],...]}}
+    // Results may arrive in any order; "id" ties them to their run. "output" is plain text,
+    // "error" the script's error stream, and "records" (optional, see RecordSet.h) the objects
+    // it returned. When the body was put in the shared memory ring, everything but type and
+    // id is replaced by "shm_offset" and "shm_length" and the ring holds the body as JSON.
+    constexpr auto FRAME_RESULT = "result";
+    // app -> bridge: {"type":"shm","key":"...","threshold":<bytes>}; result bodies of at least
+    // `threshold` bytes may be passed through the SharedMemoryRing with this native key.
+    constexpr auto FRAME_SHM = "shm";
+    // app -> bridge: {"type":"ack","end":<offset>}; ring space before `end` may be reused.
+    constexpr auto FRAME_ACK = "ack";
+
+    // Local socket the bridge serves for this app instance; passed to it as --pipe.
+    // Per-process, so two instances (or another tool) never fight over one name or port.
+    // Off Windows it is an absolute path: given a bare name, QLocalSocket looks in the temp
+    // directory while .NET's NamedPipeServerStream listens on /tmp/CoreFxPipe_<name>. Both use
+    // an absolute path as it is.
+    inline QString localServerName()
+    {
+        const QString name = QString("buraq-bridge-%1").arg(QCoreApplication::applicationPid());
+#ifdef _WIN32
+        return name;
+#else
+        return QDir::tempPath() + '/' + name;
+#endif
+    }
+
+    inline QByteArray encodeFrame(const QJsonObject& frame)
+    {
+        return QJsonDocument(frame).toJson(QJsonDocument::Compact) + '\n';
+    }
+
+    inline QByteArray makeFrame(const char* type)
+    {
+        return encodeFrame(QJsonObject{{"type", QString::fromLatin1(type)}});
+    }
+
+    // Returns the decoded frame, or nothing if the line is not a frame.
+    inline std::optional<QJsonObject> decodeFrame(const QByteArray& line)
+    {
+        const QByteArray trimmed = line.trimmed();
+        if (!trimmed.startsWith('{'))
+        {
+            return std::nullopt;
+        }
+
+        QJsonParseError error{};
+        const QJsonDocument doc = QJsonDocument::fromJson(trimmed, &error);
+        if (error.error != QJsonParseError::NoError || !doc.isObject() || !doc.object().contains("type"))
+        {
+            return std::nullopt;
+        }
+
+        return doc.object();
+    }
+}
+
+#endif // BRIDGE_PROTOCOL_H
@@ -0,0 +1,87 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "BridgeTransport.h"
+
+#include <QLocalSocket>
+#include <QTcpSocket>
+
+namespace
+{
+    class TcpTransport final : public BridgeTransport
+    {
+    public:
+        TcpTransport(QString host, const quint16 port, QObject* parent)
+            : BridgeTransport(parent), m_socket(new QTcpSocket(this)), m_host(std::move(host)), m_port(port)
+        {
+            m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+            connect(m_socket, &QTcpSocket::connected, this, [this] { m_wasOpened = true; });
+            connect(m_socket, &QTcpSocket::connected, this, &BridgeTransport::opened);
+            connect(m_socket, &QTcpSocket::readyRead, this, &BridgeTransport::readyRead);
+            connect(m_socket, &QTcpSocket::disconnected, this, &BridgeTransport::closed);
+            connect(m_socket, &QTcpSocket::errorOccurred, this, [this]
+            {
+                // Once connected, errors are followed by disconnected().
+                if (!m_wasOpened)
+                {
+                    emit failed(m_socket->errorString());
+                }
+            });
+        }
+
+        void open() override { m_socket->connectToHost(m_host, m_port); }
+        [[nodiscard]] bool isOpen() const override { return m_socket->state() == QAbstractSocket::ConnectedState; }
+        [[nodiscard]] QIODevice* device() const override { return m_socket; }
+
+    private:
+        QTcpSocket* m_socket;
+        QString m_host;
+        quint16 m_port;
+        bool m_wasOpened = false;
+    };
+
+    class LocalTransport final : public BridgeTransport
+    {
+    public:
+        LocalTransport(QString name, QObject* parent)
+            : BridgeTransport(parent), m_socket(new QLocalSocket(this)), m_name(std::move(name))
+        {
+            connect(m_socket, &QLocalSocket::connected, this, [this] { m_wasOpened = true; });
+            connect(m_socket, &QLocalSocket::connected, this, &BridgeTransport::opened);
+            connect(m_socket, &QLocalSocket::readyRead, this, &BridgeTransport::readyRead);
+            connect(m_socket, &QLocalSocket::disconnected, this, &BridgeTransport::closed);
+            connect(m_socket, &QLocalSocket::errorOccurred, this, [this]
+            {
+                if (!m_wasOpened)
+                {
+                    emit failed(m_socket->errorString());
+                }
+            });
+        }
+
+        void open() override { m_socket->connectToServer(m_name); }
+        [[nodiscard]] bool isOpen() const override { return m_socket->state() == QLocalSocket::ConnectedState; }
+        [[nodiscard]] QIODevice* device() const override { return m_socket; }
+
+    private:
+        QLocalSocket* m_socket;
+        QString m_name;
+        bool m_wasOpened = false;
+    };
+}
+
+QString BridgeEndpoint::toString() const
+{
+    return kind == Kind::Local ? "local:" + name : QString("tcp:%1:%2").arg(host).arg(port);
+}
+
+BridgeTransport* BridgeTransport::create(const BridgeEndpoint& endpoint, QObject* parent)
+{
+    if (endpoint.kind == BridgeEndpoint::Kind::Local)
+    {
+        return new LocalTransport(endpoint.name, parent);
+    }
+    return new TcpTransport(endpoint.host, endpoint.port, parent);
+}
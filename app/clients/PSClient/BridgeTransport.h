@@ -0,0 +1,63 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef BRIDGE_TRANSPORT_H
+#define BRIDGE_TRANSPORT_H
+
+#include <QObject>
+#include <QString>
+
+class QIODevice;
+
+// Where a bridge can be reached.
+struct BridgeEndpoint
+{
+    enum class Kind
+    {
+        // Loopback TCP; kept as the fallback.
+        Tcp,
+        // QLocalSocket: a named pipe on Windows, a Unix domain socket elsewhere.
+        Local,
+    };
+
+    Kind kind = Kind::Tcp;
+    QString host;
+    quint16 port = 0;
+    // Server name for Kind::Local.
+    QString name;
+
+    static BridgeEndpoint tcp(const QString& host, const quint16 port) { return {Kind::Tcp, host, port, {}}; }
+    static BridgeEndpoint local(const QString& name) { return {Kind::Local, {}, 0, name}; }
+
+    [[nodiscard]] QString toString() const;
+};
+
+/**
+ * A byte stream to the bridge. Frames are read and written through device(); the
+ * transport only hides how the connection is made and how it reports going away.
+ */
+class BridgeTransport : public QObject
+{
+    Q_OBJECT
+
+public:
+    using QObject::QObject;
+    ~BridgeTransport() override = default;
+
+    virtual void open() = 0;
+    [[nodiscard]] virtual bool isOpen() const = 0;
+    [[nodiscard]] virtual QIODevice* device() const = 0;
+
+    static BridgeTransport* create(const BridgeEndpoint& endpoint, QObject* parent = nullptr);
+
+    signals:
+        void opened();
+        void readyRead();
+        // The connection was up and went away.
+        void closed();
+        // The connection could not be made.
+        void failed(const QString& error);
+};
+
+#endif // BRIDGE_TRANSPORT_H
@@ -3,51 +3,225 @@
 //
 
 #include "PSClient.h"
+
+#include <utility>
+
+#include "BridgeProtocol.h"
+#include "SharedMemoryRing.h"
 #include <QDebug>
+#include <QIODevice>
+#include <QJsonDocument>
+
+PSClient::PSClient(QObject *parent)
+    : QObject(parent),
+      m_endpoints{
+          BridgeEndpoint::local(bridge::localServerName()),
+          BridgeEndpoint::tcp(bridge::DEFAULT_HOST, bridge::DEFAULT_PORT),
+      }
+{
+}
+
+PSClient::~PSClient() = default;
+
+void PSClient::setEndpoints(const QList<BridgeEndpoint> &endpoints)
+{
+    m_endpoints = endpoints;
+}
 
-PSClient::PSClient(QObject *parent) : QObject(parent)
+void PSClient::setSharedMemoryThreshold(const qint64 bytes)
 {
-    m_socket = new QTcpSocket(this);
+    m_shmThreshold = bytes;
+}
 
-    // Connect signals to handle socket events.
-    connect(m_socket, &QTcpSocket::connected, this, &PSClient::onConnected);
-    connect(m_socket, &QTcpSocket::readyRead, this, &PSClient::onReadyRead);
+QString PSClient::connectedEndpoint() const
+{
+    if (m_transport == nullptr || !m_transport->isOpen())
+    {
+        return {};
+    }
+    return m_endpoints.value(m_endpointIndex).toString();
 }
 
-void PSClient::runScript(const QString &script)
+quint64 PSClient::runScript(const QString &script)
 {
-    qDebug() << "Attempting to connect to server...";
-    m_socket->connectToHost("127.0.0.1", 12345);
+    const quint64 id = ++m_nextId;
+    m_outstanding.insert(id);
+
+    const QByteArray frame = bridge::encodeFrame(QJsonObject{
+        {"type", bridge::FRAME_RUN},
+        {"id", static_cast<qint64>(id)},
+        {"script", script},
+    });
+
+    if (m_transport != nullptr && m_transport->isOpen())
+    {
+        m_transport->device()->write(frame);
+        return id;
+    }
 
-    // Wait for the connection to be established.
-    if(m_socket->waitForConnected())
+    m_queuedFrames.append(frame);
+    if (m_transport == nullptr)
     {
-        qDebug() << "Connected! Sending script...";
-        // Send the script text, followed by a newline character.
-        m_socket->write((script + "\n").toUtf8());
-        m_socket->flush();
+        m_endpointIndex = 0;
+        connectToNextEndpoint();
     }
-    else
+
+    return id;
+}
+
+void PSClient::connectToNextEndpoint()
+{
+    if (m_endpointIndex >= m_endpoints.size())
     {
-        qDebug() << "Connection failed:" << m_socket->errorString();
+        return;
     }
+
+    qDebug() << "Attempting to connect to server at" << m_endpoints[m_endpointIndex].toString();
+
+    m_transport = BridgeTransport::create(m_endpoints[m_endpointIndex], this);
+    connect(m_transport, &BridgeTransport::opened, this, &PSClient::onOpened);
+    connect(m_transport, &BridgeTransport::readyRead, this, &PSClient::onReadyRead);
+    connect(m_transport, &BridgeTransport::closed, this, &PSClient::onClosed);
+    connect(m_transport, &BridgeTransport::failed, this, &PSClient::onFailed);
+    m_transport->open();
 }
 
-void PSClient::onConnected()
+void PSClient::dropTransport()
 {
-    qDebug() << "Successfully connected to the C# server.";
+    if (m_transport != nullptr)
+    {
+        m_transport->disconnect(this);
+        m_transport->deleteLater();
+        m_transport = nullptr;
+    }
+    m_ring.reset();
+    m_readBuffer.clear();
+}
+
+void PSClient::onOpened()
+{
+    qDebug() << "Successfully connected to the bridge at" << connectedEndpoint();
+
+    QIODevice *device = m_transport->device();
+
+    // A fresh ring per connection, so both sides start counting offsets at zero.
+    if (m_shmThreshold > 0)
+    {
+        m_ring = std::make_unique<SharedMemoryRing>();
+        if (m_ring->create(SharedMemoryRing::uniqueKey(), RING_CAPACITY))
+        {
+            device->write(bridge::encodeFrame(QJsonObject{
+                {"type", bridge::FRAME_SHM},
+                {"key", m_ring->nativeKey()},
+                {"threshold", m_shmThreshold},
+            }));
+        }
+        else
+        {
+            qDebug() << "Shared memory unavailable, results stay inline:" << m_ring->errorString();
+            m_ring.reset();
+        }
+    }
+
+    device->write(m_queuedFrames);
+    m_queuedFrames.clear();
+}
+
+QJsonObject PSClient::takeBody(const QJsonObject &frame)
+{
+    if (!frame.contains("shm_offset"))
+    {
+        return frame;
+    }
+
+    const qint64 offset = frame.value("shm_offset").toInteger();
+    const qint64 length = frame.value("shm_length").toInteger();
+    const auto payload = m_ring ? m_ring->read(offset, length) : std::nullopt;
+
+    // Hand the space back straight away; the payload has been copied out.
+    m_transport->device()->write(bridge::encodeFrame(QJsonObject{
+        {"type", bridge::FRAME_ACK},
+        {"end", offset + length},
+    }));
+
+    if (!payload.has_value())
+    {
+        return QJsonObject{{"error", "Result could not be read from shared memory."}, {"had_errors", true}};
+    }
+    m_sharedMemoryResults++;
+    return QJsonDocument::fromJson(payload.value()).object();
 }
 
 void PSClient::onReadyRead()
 {
-    // Read the response from the server.
-    QByteArray data = m_socket->readAll();
-    QString result = QString::fromUtf8(data).trimmed();
-    qDebug() << "Received result from C#:" << result;
+    // A result may arrive split over several reads, or several results in one read.
+    m_readBuffer.append(m_transport->device()->readAll());
+
+    qsizetype newline;
+    while ((newline = m_readBuffer.indexOf('\n')) >= 0)
+    {
+        const auto frame = bridge::decodeFrame(m_readBuffer.left(newline));
+        m_readBuffer.remove(0, newline + 1);
+
+        if (!frame.has_value() || frame->value("type").toString() != bridge::FRAME_RESULT)
+        {
+            continue;
+        }
 
-    // Emit a signal so other parts of your GUI can use the result.
-    emit scriptResultReceived(QVariant::fromValue(result));
+        const auto id = static_cast<quint64>(frame->value("id").toInteger());
+        const QJsonObject body = takeBody(frame.value());
+        if (m_outstanding.erase(id) == 0)
+        {
+            continue;
+        }
 
-    // Close the connection after receiving the result.
-    m_socket->close();
+        BridgeResult result;
+        result.delivered = true;
+        result.output = body.value("output").toString();
+        result.error = body.value("error").toString();
+        result.hadErrors = body.value("had_errors").toBool(!result.error.isEmpty());
+        if (body.contains("records"))
+        {
+            result.records = RecordSet::fromJson(body.value("records").toObject());
+        }
+
+        // Emit a signal so other parts of your GUI can use the result.
+        emit scriptResultReceived(id, result);
+    }
+}
+
+void PSClient::onClosed()
+{
+    dropTransport();
+    m_queuedFrames.clear();
+    failOutstanding();
+}
+
+void PSClient::onFailed(const QString &error)
+{
+    qDebug() << "Connection failed:" << error;
+    dropTransport();
+
+    // Fall back to the next endpoint, e.g. TCP when the local socket is not there.
+    if (++m_endpointIndex < m_endpoints.size())
+    {
+        qWarning() << "Bridge unreachable at" << m_endpoints[m_endpointIndex - 1].toString() << "(" << error
+            << "); falling back to" << m_endpoints[m_endpointIndex].toString();
+        connectToNextEndpoint();
+        return;
+    }
+
+    m_queuedFrames.clear();
+    failOutstanding();
+}
+
+void PSClient::failOutstanding()
+{
+    // Let the callers know these scripts will never produce a result, oldest first, as
+    // IExecutionBackend promises.
+    const std::set<quint64> outstanding = std::exchange(m_outstanding, {});
+    for (const quint64 id : outstanding)
+    {
+        emit scriptResultReceived(id, BridgeResult{});
+    }
 }
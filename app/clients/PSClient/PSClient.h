@@ -5,25 +5,86 @@
 #ifndef POWERSHELL_CLIENT_H
 #define POWERSHELL_CLIENT_H
 
+#include <memory>
+#include <set>
+
+#include <QJsonObject>
+#include <QList>
 #include <QObject>
-#include <QTcpSocket>
 
+#include "BridgeTransport.h"
+#include "clients/ExecutionBackend/RecordSet.h"
+
+class SharedMemoryRing;
+
+// What came back for one script.
+struct BridgeResult
+{
+    // False when the script could not be run at all (e.g. the connection failed).
+    bool delivered = false;
+    QString output;
+    QString error;
+    bool hadErrors = false;
+    // Objects the script returned, if any.
+    RecordSetPtr records;
+};
+
+// Client side of the bridge protocol (see BridgeProtocol.h).
+// Keeps one connection open and never blocks the calling thread.
 class PSClient final : public QObject
 {
     Q_OBJECT
 public:
     explicit PSClient(QObject *parent = nullptr);
-    void runScript(const QString &script);
+    ~PSClient() override;
+
+    // Endpoints tried in order on every (re)connect. Defaults to this instance's local
+    // socket, then 127.0.0.1:12345.
+    void setEndpoints(const QList<BridgeEndpoint> &endpoints);
+
+    // Outputs of at least this many bytes travel through shared memory; 0 turns that off.
+    void setSharedMemoryThreshold(qint64 bytes);
+
+    // Sends the script and returns the id its result will carry.
+    quint64 runScript(const QString &script);
+
+    // Endpoint of the current connection, if any.
+    [[nodiscard]] QString connectedEndpoint() const;
+
+    // Results that were read out of shared memory rather than the socket, so far.
+    [[nodiscard]] quint64 sharedMemoryResults() const { return m_sharedMemoryResults; }
 
     signals:
-        void scriptResultReceived(const QVariant &result);
+        void scriptResultReceived(quint64 requestId, const BridgeResult &result);
 
 private slots:
-    void onConnected();
+    void onOpened();
     void onReadyRead();
+    void onClosed();
+    void onFailed(const QString &error);
 
 private:
-    QTcpSocket *m_socket;
+    void connectToNextEndpoint();
+    void dropTransport();
+    void failOutstanding();
+    // The result body, read out of shared memory if that is where it was put.
+    [[nodiscard]] QJsonObject takeBody(const QJsonObject &frame);
+
+    static constexpr qint64 RING_CAPACITY = 64 * 1024 * 1024;
+
+    QList<BridgeEndpoint> m_endpoints;
+    qsizetype m_endpointIndex = 0;
+    BridgeTransport *m_transport = nullptr;
+    qint64 m_shmThreshold = 256 * 1024;
+    std::unique_ptr<SharedMemoryRing> m_ring;
+    quint64 m_sharedMemoryResults = 0;
+    quint64 m_nextId = 0;
+
+    // Frames written before the connection is up; flushed in onOpened().
+    QByteArray m_queuedFrames;
+    QByteArray m_readBuffer;
+    // Ordered, so failOutstanding() reports them in submission order.
+    std::set<quint64> m_outstanding;
 };
 
 #endif // POWERSHELL_CLIENT_H
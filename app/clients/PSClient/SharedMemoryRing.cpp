@@ -0,0 +1,124 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "SharedMemoryRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include <QCoreApplication>
+#include <QNativeIpcKey>
+
+namespace
+{
+    // The key as the bridge opens it: a named file mapping on Windows, a shm_open() name
+    // elsewhere. QSharedMemory would otherwise treat a Unix key as a System V ftok() path.
+    QNativeIpcKey ipcKey(const QString& nativeKey)
+    {
+#ifdef _WIN32
+        return QNativeIpcKey(nativeKey, QNativeIpcKey::Type::Windows);
+#else
+        return QNativeIpcKey(nativeKey, QNativeIpcKey::Type::PosixRealtime);
+#endif
+    }
+}
+
+bool SharedMemoryRing::create(const QString& nativeKey, const qint64 capacity)
+{
+    m_memory.setNativeKey(ipcKey(nativeKey));
+    if (!m_memory.create(static_cast<qsizetype>(sizeof(Header) + capacity)))
+    {
+        return false;
+    }
+
+    const Header header{MAGIC, VERSION, capacity};
+    std::memcpy(m_memory.data(), &header, sizeof(header));
+
+    m_capacity = capacity;
+    m_written = m_released = 0;
+    return true;
+}
+
+bool SharedMemoryRing::attach(const QString& nativeKey)
+{
+    m_memory.setNativeKey(ipcKey(nativeKey));
+    if (!m_memory.attach())
+    {
+        return false;
+    }
+
+    Header header{};
+    std::memcpy(&header, m_memory.constData(), sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION ||
+        header.capacity <= 0 || header.capacity > m_memory.size() - static_cast<qint64>(sizeof(Header)))
+    {
+        m_memory.detach();
+        return false;
+    }
+
+    m_capacity = header.capacity;
+    m_written = m_released = 0;
+    return true;
+}
+
+char* SharedMemoryRing::data() const
+{
+    return static_cast<char*>(const_cast<void*>(m_memory.constData())) + sizeof(Header);
+}
+
+std::optional<QByteArray> SharedMemoryRing::read(const qint64 offset, const qint64 length) const
+{
+    const qint64 start = m_capacity > 0 ? offset % m_capacity : 0;
+    if (!m_memory.isAttached() || offset < 0 || length < 0 || start + length > m_capacity)
+    {
+        return std::nullopt;
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return QByteArray(data() + start, static_cast<qsizetype>(length));
+}
+
+std::optional<qint64> SharedMemoryRing::write(const QByteArray& data)
+{
+    const qint64 length = data.size();
+    if (!m_memory.isAttached() || length > m_capacity)
+    {
+        return std::nullopt;
+    }
+
+    // Skip the tail if the payload would not fit before the end of the ring.
+    const qint64 position = m_written % m_capacity;
+    const qint64 padding = position + length > m_capacity ? m_capacity - position : 0;
+    if (m_written + padding + length - m_released > m_capacity)
+    {
+        return std::nullopt; // the reader has not caught up yet
+    }
+
+    const qint64 offset = m_written + padding;
+    std::memcpy(this->data() + offset % m_capacity, data.constData(), static_cast<size_t>(length));
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_written = offset + length;
+    return offset;
+}
+
+void SharedMemoryRing::release(const qint64 end)
+{
+    m_released = std::clamp(end, m_released, m_written);
+}
+
+QString SharedMemoryRing::uniqueKey()
+{
+    static std::atomic_int counter{0};
+    const QString name = QString("buraq-ring-%1-%2").arg(QCoreApplication::applicationPid()).arg(++counter);
+
+#ifdef _WIN32
+    return "Local\\" + name;
+#else
+    // shm_open() names are one leading slash and no other; Linux keeps the segment as
+    // /dev/shm/<name>, which is where the bridge maps it from.
+    return "/" + name;
+#endif
+}
@@ -0,0 +1,72 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef SHARED_MEMORY_RING_H
+#define SHARED_MEMORY_RING_H
+
+#include <optional>
+
+#include <QByteArray>
+#include <QSharedMemory>
+#include <QString>
+
+/**
+ * Single-producer ring buffer in a shared memory segment, used to hand large results from the
+ * bridge to the app without pushing them through the socket.
+ *
+ * The app creates the segment and announces its key with a "shm" frame. The bridge writes a
+ * payload with write() and sends its offset/length in the result frame; the app copies it
+ * out with read() and returns the space with an "ack" frame, which the bridge passes to
+ * release(). Synchronisation rides on those frames, so no lock is taken on the segment.
+ *
+ * Offsets are absolute byte counts since the ring was created; a payload never wraps, the
+ * tail of the ring is skipped instead.
+ */
+class SharedMemoryRing
+{
+public:
+    SharedMemoryRing() = default;
+
+    // App side: creates a new segment with room for `capacity` bytes of payload.
+    bool create(const QString& nativeKey, qint64 capacity);
+
+    // Bridge side: attaches to a segment made by create().
+    bool attach(const QString& nativeKey);
+
+    // Copies `length` bytes at `offset` out of the ring.
+    [[nodiscard]] std::optional<QByteArray> read(qint64 offset, qint64 length) const;
+
+    // Stores data and returns its offset, or nothing if the ring has no room for it right now.
+    std::optional<qint64> write(const QByteArray& data);
+
+    // Everything before `end` has been read and may be overwritten.
+    void release(qint64 end);
+
+    [[nodiscard]] QString nativeKey() const { return m_memory.nativeKey(); }
+    [[nodiscard]] qint64 capacity() const { return m_capacity; }
+    [[nodiscard]] QString errorString() const { return m_memory.errorString(); }
+
+    // Segment name unique to this process, e.g. for SharedMemoryRing::create().
+    static QString uniqueKey();
+
+private:
+    struct Header
+    {
+        quint32 magic;
+        quint32 version;
+        qint64 capacity;
+    };
+
+    static constexpr quint32 MAGIC = 0x52515242; // "BRQR"
+    static constexpr quint32 VERSION = 1;
+
+    [[nodiscard]] char* data() const;
+
+    QSharedMemory m_memory;
+    qint64 m_capacity = 0;
+    qint64 m_written = 0;
+    qint64 m_released = 0;
+};
+
+#endif // SHARED_MEMORY_RING_H
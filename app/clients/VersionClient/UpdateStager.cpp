@@ -0,0 +1,257 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "UpdateStager.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+#include "buraq.h"
+#include "file_delta.h"
+#include "ranged_download.h"
+#include "sha256.h"
+
+namespace
+{
+    // Files fetched at once; small files are mostly round trips, so they overlap.
+    constexpr std::size_t FILE_WORKERS = 4;
+
+    std::string normalizedSha(std::string sha)
+    {
+        if (sha.starts_with("sha256:"))
+        {
+            sha.erase(0, 7);
+        }
+        std::ranges::transform(sha, sha.begin(), [](const unsigned char c) { return std::tolower(c); });
+        return sha;
+    }
+}
+
+UpdateStager::UpdateStager(std::filesystem::path installation, std::filesystem::path staging,
+                           std::vector<manifest_file> files)
+    : m_installation(std::move(installation)), m_staging(std::move(staging)), m_files(std::move(files))
+{
+    m_patches = m_staging / ".patches";
+}
+
+std::string UpdateStager::hashFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return {};
+    }
+
+    Sha256 hasher;
+    std::vector<char> block(1 << 20);
+    while (file.read(block.data(), static_cast<std::streamsize>(block.size())) || file.gcount() > 0)
+    {
+        hasher.update(block.data(), static_cast<std::size_t>(file.gcount()));
+    }
+    return file.bad() ? std::string() : hasher.hexDigest();
+}
+
+StagingResult UpdateStager::run(const std::stop_token stop,
+                                const std::function<void(const TransferProgress&)>& progress)
+{
+    StagingResult result;
+    std::error_code error;
+    std::filesystem::create_directories(m_staging, error);
+    if (error)
+    {
+        result.error = "Cannot create " + m_staging.string() + ": " + error.message();
+        return result;
+    }
+
+    // What each file needs; hashing the installation is local and quick next to any download.
+    std::vector<Work> work;
+    for (const manifest_file& file : m_files)
+    {
+        if (stop.stop_requested())
+        {
+            result.error = "cancelled";
+            return result;
+        }
+
+        const std::filesystem::path target = m_staging / file.path;
+        const std::string sha = normalizedSha(file.sha);
+        if (hashFile(target) == sha)
+        {
+            continue; // staged by an earlier run
+        }
+
+        const std::filesystem::path installed = m_installation / file.path;
+        const std::string installedSha = hashFile(installed);
+        if (installedSha == sha)
+        {
+            std::filesystem::create_directories(target.parent_path(), error);
+            if (std::filesystem::copy_file(installed, target, std::filesystem::copy_options::overwrite_existing, error))
+            {
+                result.unchanged++;
+                continue;
+            }
+            file_utils::file_log(LogLevel::Warning,
+                                 "Update: cannot copy " + installed.string() + ", downloading it: " + error.message());
+        }
+
+        Work item{.file = &file, .bytes = file.size};
+        if (const auto patch = std::ranges::find_if(file.patches, [&installedSha](const manifest_patch& p)
+            {
+                return !installedSha.empty() && normalizedSha(p.from) == installedSha;
+            }); patch != file.patches.end())
+        {
+            item.source = Source::Patch;
+            item.patch = &*patch;
+            item.bytes = patch->size;
+        }
+        result.changedBytes += file.size;
+        work.push_back(item);
+    }
+
+    // One failure stops the rest.
+    std::stop_source failed;
+    std::stop_callback forward(stop, [&failed] { failed.request_stop(); });
+
+    std::mutex mutex;
+    std::size_t next = 0;
+    std::vector<std::int64_t> arrived(work.size());
+    std::vector<std::int64_t> expected(work.size());
+    std::ranges::transform(work, expected.begin(), &Work::bytes);
+    const auto worker = [&]
+    {
+        while (true)
+        {
+            std::size_t index;
+            {
+                std::lock_guard lock(mutex);
+                if (next == work.size() || failed.stop_requested())
+                {
+                    return;
+                }
+                index = next++;
+            }
+
+            const auto onBytes = [&, index](const std::int64_t bytes, const std::int64_t bytesExpected)
+            {
+                std::lock_guard lock(mutex);
+                arrived[index] = bytes;
+                expected[index] = bytesExpected;
+                if (progress)
+                {
+                    progress({
+                        .downloaded = std::accumulate(arrived.begin(), arrived.end(), std::int64_t{0}),
+                        .total = std::accumulate(expected.begin(), expected.end(), std::int64_t{0}),
+                    });
+                }
+            };
+            const Fetched fetched = fetch(work[index], failed.get_token(), onBytes);
+
+            std::lock_guard lock(mutex);
+            if (!fetched.error.empty())
+            {
+                if (result.error.empty())
+                {
+                    result.error = fetched.error;
+                }
+                failed.request_stop();
+                return;
+            }
+            result.downloadedBytes += fetched.bytes;
+            (fetched.patched ? result.patched : result.downloaded)++;
+        }
+    };
+    {
+        std::vector<std::jthread> workers;
+        for (std::size_t i = 0; i < std::min(FILE_WORKERS, work.size()); ++i)
+        {
+            workers.emplace_back(worker);
+        }
+    }
+
+    if (result.ok() && stop.stop_requested())
+    {
+        result.error = "cancelled";
+    }
+    if (result.ok())
+    {
+        std::filesystem::remove_all(m_patches, error);
+    }
+    return result;
+}
+
+UpdateStager::Fetched UpdateStager::fetch(const Work& work, const std::stop_token& stop,
+                                          const std::function<void(std::int64_t, std::int64_t)>& onBytes) const
+{
+    const manifest_file& file = *work.file;
+    const std::filesystem::path target = m_staging / file.path;
+    Fetched fetched;
+
+    if (work.source == Source::Patch)
+    {
+        const std::string patchSha = normalizedSha(work.patch->sha);
+        const std::filesystem::path patchPath = m_patches / (patchSha.substr(0, 16) + ".zst");
+        RangedDownload download({
+            .url = work.patch->url,
+            .path = patchPath,
+            .size = work.patch->size,
+            .sha256 = patchSha,
+            .onProgress = [&onBytes, &work](const TransferProgress& progress)
+            {
+                onBytes(progress.downloaded, work.bytes);
+            },
+        });
+        const DownloadResult downloaded = download.run(stop);
+        if (!downloaded.ok() && stop.stop_requested())
+        {
+            fetched.error = downloaded.error;
+            return fetched;
+        }
+
+        std::string sha, error = downloaded.error;
+        if (downloaded.ok())
+        {
+            std::error_code ignored;
+            std::filesystem::create_directories(target.parent_path(), ignored);
+            if (file_delta::apply_patch(m_installation / file.path, patchPath, target, sha, error) &&
+                sha == normalizedSha(file.sha))
+            {
+                std::filesystem::remove(patchPath, ignored);
+                fetched.patched = true;
+                fetched.bytes = downloaded.resumedBytes + downloaded.downloadedBytes;
+                return fetched;
+            }
+            if (error.empty())
+            {
+                error = "patched file does not match the manifest";
+            }
+        }
+        // The whole file still gets there.
+        file_utils::file_log(LogLevel::Warning,
+                             "Update: patch for " + file.path + " failed (" + error + "), downloading it whole.");
+        fetched.bytes = downloaded.downloadedBytes;
+    }
+
+    RangedDownload download({
+        .url = file.url,
+        .path = target,
+        .size = file.size,
+        .sha256 = file.sha,
+        .onProgress = [&onBytes, &fetched, &file](const TransferProgress& progress)
+        {
+            onBytes(fetched.bytes + progress.downloaded, fetched.bytes + file.size);
+        },
+    });
+    const DownloadResult downloaded = download.run(stop);
+    if (!downloaded.ok())
+    {
+        fetched.error = file.path + ": " + downloaded.error;
+        return fetched;
+    }
+    fetched.bytes += downloaded.downloadedBytes;
+    return fetched;
+}
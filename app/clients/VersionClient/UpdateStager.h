@@ -0,0 +1,86 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef UPDATE_STAGER_H
+#define UPDATE_STAGER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+#include "app_version.h"
+#include "network.h"
+
+struct StagingResult
+{
+    // Empty on success.
+    std::string error;
+    // Files taken from the installation, rebuilt from a patch, and downloaded whole.
+    int unchanged = 0;
+    int patched = 0;
+    int downloaded = 0;
+    // Fetched, against what the changed files weigh in full.
+    std::int64_t downloadedBytes = 0;
+    std::int64_t changedBytes = 0;
+
+    [[nodiscard]] bool ok() const { return error.empty(); }
+};
+
+/**
+ * Builds the new version of the installation in a staging directory, from the manifest's file
+ * list: files whose content did not change are copied from the installation, changed ones are
+ * rebuilt from a patch against the installed copy when the manifest has one (file_delta.h), and
+ * only the rest is downloaded. Every file is checked against its SHA-256.
+ *
+ * The installation is only read; the updater switches to the staging directory once the app has
+ * exited. Staging again after an interruption keeps the files already staged, and resumes
+ * partial downloads.
+ */
+class UpdateStager
+{
+public:
+    UpdateStager(std::filesystem::path installation, std::filesystem::path staging,
+                 std::vector<manifest_file> files);
+
+    // Blocks; progress is called from worker threads, with bytes to fetch as the total.
+    StagingResult run(std::stop_token stop, const std::function<void(const TransferProgress&)>& progress);
+
+    // Lower-case hex SHA-256 of a file, or empty if it cannot be read.
+    static std::string hashFile(const std::filesystem::path& path);
+
+private:
+    enum class Source { Patch, Download };
+
+    struct Work
+    {
+        const manifest_file* file = nullptr;
+        Source source = Source::Download;
+        // From the manifest, for Source::Patch.
+        const manifest_patch* patch = nullptr;
+        std::int64_t bytes = 0;
+    };
+
+    struct Fetched
+    {
+        std::string error;
+        bool patched = false;
+        std::int64_t bytes = 0;
+    };
+
+    // Patches or downloads one file. onBytes gets how much of it has arrived, and how much is
+    // expected in all, which grows if a patch fails and the whole file follows.
+    Fetched fetch(const Work& work, const std::stop_token& stop,
+                  const std::function<void(std::int64_t arrived, std::int64_t expected)>& onBytes) const;
+
+    std::filesystem::path m_installation;
+    std::filesystem::path m_staging;
+    // Downloaded patches, until they are applied.
+    std::filesystem::path m_patches;
+    std::vector<manifest_file> m_files;
+};
+
+#endif // UPDATE_STAGER_H
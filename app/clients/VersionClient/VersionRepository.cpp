@@ -3,135 +3,264 @@
 //
 
 #include "VersionRepository.h"
-#include <thread>
-#include <mutex>
 #include <vector>
+#include <cstdlib>
 #include <filesystem> // Requires C++17. For older C++, use platform-specific directory iteration.
 #include <qlogging.h>
 #include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QPointer>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QUrl>
+#include <algorithm>
 #include <iostream>
-#include <ranges>
-#include <boost/property_tree/json_parser.hpp>
+#include <tuple>
 
 #include "../include/version.h"
 #include "../include/network.h"
+#include "../include/ranged_download.h"
+#include "UpdateStager.h"
 
-// Global mutex to protect access to the Network singleton's methods
-std::mutex network_mutex;
+namespace
+{
+    std::filesystem::path manifestCachePath()
+    {
+        return std::filesystem::temp_directory_path() / "Buraq" / ".data" / "manifest-cache.json";
+    }
 
+    // The last manifest downloaded from url with its validators, or an empty object.
+    QJsonObject readManifestCache(const std::string& url)
+    {
+        QFile file(QString::fromStdString(manifestCachePath().string()));
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            return {};
+        }
 
-VersionRepository::VersionRepository(buraq::buraq_api* api_context) :
-    api_context(api_context),
-    endpoint("https://raw.githubusercontent.com/tkasozi/buraq/refs/heads/main/manifest.json"),
-    network(Network::singleton())
-{
-}
+        const QJsonObject cache = QJsonDocument::fromJson(file.readAll()).object();
+        if (cache.value("url").toString().toStdString() != url || !cache.value("manifest").isObject())
+        {
+            return {};
+        }
+        return cache;
+    }
 
-static std::string get(const boost::property_tree::basic_ptree<std::string, std::string>& a, const char* path)
-{
-    try
+    void writeManifestCache(const std::string& url, const HttpResponse& response, const QJsonObject& manifest)
     {
-        return a.get<std::string>(path);
+        const std::filesystem::path path = manifestCachePath();
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+
+        // Replaced in one step, so a crash leaves the old cache rather than half a new one.
+        QSaveFile file(QString::fromStdString(path.string()));
+        if (!file.open(QIODevice::WriteOnly))
+        {
+            qDebug() << "Cannot write the manifest cache: " << file.errorString();
+            return;
+        }
+        file.write(QJsonDocument(QJsonObject{
+            {"url", QString::fromStdString(url)},
+            {"etag", QString::fromStdString(response.etag)},
+            {"lastModified", QString::fromStdString(response.lastModified)},
+            {"manifest", manifest},
+        }).toJson(QJsonDocument::Compact));
+        file.commit();
     }
-    catch (const std::exception& e)
+
+    std::string toStdString(const QJsonValue& value)
     {
-        qDebug() << "property_tree " << e.what();
-        return "";
+        if (value.isDouble())
+        {
+            return std::to_string(value.toInteger());
+        }
+        return value.toString().toStdString();
     }
 }
 
-void VersionRepository::get_manifest_json(const std::string& endpoint, UpdateInfo& info)
+VersionRepository::VersionRepository(buraq::buraq_api* api_context) :
+    api_context(api_context),
+    endpoint("https://raw.githubusercontent.com/tkasozi/buraq/refs/heads/main/manifest.json")
 {
-    namespace pt = boost::property_tree;
+    // For testing against a local manifest (file://) or server.
+    if (const char* url = std::getenv("BURAQ_UPDATE_MANIFEST_URL"); url != nullptr && *url != '\0')
+    {
+        endpoint = url;
+    }
+}
 
-    std::filesystem::path manifest_json = std::filesystem::temp_directory_path() / "Buraq" / "manifest.json";
+VersionRepository::~VersionRepository()
+{
+    downloadStop.request_stop();
+}
 
-    try
+bool VersionRepository::parse_manifest(const QJsonObject& manifest, UpdateInfo& info)
+{
+    if (!manifest.value("version").isString())
     {
-        pt::ptree loadPtreeRoot;
-        {
-            std::string response;
-            // Create a scope for the lock_guard
-            std::lock_guard<std::mutex> lock(network_mutex); // Lock before accessing network methods
+        qDebug() << "Related to the manifest.json file: no version";
+        return false;
+    }
 
-            Network& net = Network::singleton(); // Get the singleton instance
-            response = net.http_get(endpoint); // Call the method
-            std::ofstream outputFile(manifest_json, std::ios::out);
-            outputFile << response;
-            outputFile.close();
-            // Mutex is released when 'lock' goes out of scope
-        } // network_mutex is unlocked here
+    info.latestVersion = manifest.value("version").toString().toStdString();
+    info.releaseNotes = manifest.value("notes").toString().toStdString();
 
-        pt::read_json(manifest_json.string(), loadPtreeRoot);
+    for (const QJsonValue& value : manifest.value("assets").toArray())
+    {
+        const QJsonObject asset = value.toObject();
+        info.asset = {
+            .name = asset.value("name").toString().toStdString(),
+            .downloadUrl = asset.value("download_url").toString().toStdString(),
+            .size = toStdString(asset.value("size")),
+            .contentType = asset.value("content_type").toString().toStdString(),
+            .sha = asset.value("sha").toString().toStdString(),
+        };
+    }
 
-        if (loadPtreeRoot.empty())
+    // Per file URLs are relative to base_url.
+    const QJsonObject files = manifest.value("files").toObject();
+    const QUrl baseUrl = QUrl(files.value("base_url").toString());
+    for (const QJsonValue& value : files.value("entries").toArray())
+    {
+        const QJsonObject entry = value.toObject();
+        manifest_file file{
+            .path = entry.value("path").toString().toStdString(),
+            .url = baseUrl.resolved(QUrl(entry.value("url").toString())).toString().toStdString(),
+            .size = entry.value("size").toInteger(),
+            .sha = entry.value("sha").toString().toStdString(),
+        };
+        for (const QJsonValue& patchValue : entry.value("patches").toArray())
         {
-            throw std::runtime_error("Failed to download update manifest.");
+            const QJsonObject patch = patchValue.toObject();
+            file.patches.push_back({
+                .from = patch.value("from").toString().toStdString(),
+                .url = baseUrl.resolved(QUrl(patch.value("url").toString())).toString().toStdString(),
+                .size = patch.value("size").toInteger(),
+                .sha = patch.value("sha").toString().toStdString(),
+            });
         }
 
-        info.isConnFailure = false;
-
-        auto latest_version_node = loadPtreeRoot.get_child("version");
-        info.latestVersion = latest_version_node.get_value<std::string>();
-
-        auto release_notes_node = loadPtreeRoot.get_child("notes");
-        info.releaseNotes = release_notes_node.get_value<std::string>();
-
-        for (auto& asset : loadPtreeRoot.get_child("assets") | std::views::values)
+        // Nothing may land outside the installation directory.
+        const std::filesystem::path path(file.path);
+        if (file.path.empty() || path.is_absolute() || path.has_root_name() ||
+            std::ranges::any_of(path, [](const std::filesystem::path& part) { return part == ".."; }) ||
+            file.sha.empty())
         {
-            info.asset = {
-                .name = asset.get<std::string>("name"),
-                .downloadUrl = asset.get<std::string>("download_url"),
-                .size = asset.get<std::string>("size"),
-                // .sha = asset.get<std::string>("sha"),
-                .sha = get(asset, "sha"),
-            };
+            qDebug() << "Related to the manifest.json file: bad entry in files, ignoring the list";
+            info.files.clear();
+            break;
         }
+        info.files.push_back(std::move(file));
+    }
+    return true;
+}
+
+UpdateInfo VersionRepository::get_manifest_json(const std::string& endpoint)
+{
+    UpdateInfo info;
+
+    const QJsonObject cache = readManifestCache(endpoint);
+    std::vector<std::string> headers;
+    if (const QString etag = cache.value("etag").toString(); !etag.isEmpty())
+    {
+        headers.push_back("If-None-Match: " + etag.toStdString());
+    }
+    if (const QString lastModified = cache.value("lastModified").toString(); !lastModified.isEmpty())
+    {
+        headers.push_back("If-Modified-Since: " + lastModified.toStdString());
     }
-    catch (const pt::ptree_error& e)
+
+    HttpResponse response;
+    try
     {
-        qDebug() << "Related to the manifest.json file: " << e.what();
+        response = Network::singleton().get(endpoint, headers);
     }
     catch (const std::exception& e)
     {
         info.isConnFailure = true;
         qDebug() << "Other Error (ie. Network): " << e.what();
+        return info;
     }
-}
 
-UpdateInfo VersionRepository::main_version_logic()
-{
-    if (std::thread thread(get_manifest_json, endpoint, std::ref(versionInfo)); thread.joinable())
+    QJsonObject manifest;
+    if (response.status == 304 && !cache.isEmpty())
     {
-        thread.join();
+        manifest = cache.value("manifest").toObject();
     }
+    else if (response.status == 200)
+    {
+        // Parsed in memory; nothing is written but the cache.
+        QJsonParseError error{};
+        const QJsonDocument document = QJsonDocument::fromJson(QByteArray::fromStdString(response.body), &error);
+        if (!document.isObject())
+        {
+            qDebug() << "Related to the manifest.json file: " << error.errorString();
+            return info;
+        }
+        manifest = document.object();
+        writeManifestCache(endpoint, response, manifest);
+    }
+    else
+    {
+        info.isConnFailure = true;
+        qDebug() << "Manifest request returned HTTP " << response.status;
+        return info;
+    }
+
+    parse_manifest(manifest, info);
+    return info;
+}
+
+void VersionRepository::checkForUpdate(QObject* context, std::function<void(const UpdateInfo&)> done)
+{
+    QThreadPool::globalInstance()->start(
+        [this, endpoint = endpoint, context = QPointer(context), done = std::move(done)]() mutable
+        {
+            UpdateInfo info = newer_version_only(get_manifest_json(endpoint));
+            if (context.isNull())
+            {
+                return;
+            }
+
+            // this lives as long as context (its owner) does.
+            QMetaObject::invokeMethod(context.data(), [this, info = std::move(info), done = std::move(done)]
+            {
+                versionInfo = info;
+                done(versionInfo);
+            }, Qt::QueuedConnection);
+        });
+}
 
+UpdateInfo VersionRepository::newer_version_only(const UpdateInfo& info)
+{
     try
     {
-        if (versionInfo.latestVersion.empty())
+        if (info.latestVersion.empty())
         {
             std::cerr << "No version" << std::endl;
 
             // no version
-            return versionInfo;
+            return info;
         }
 
-        const std::vector<std::string> ver = split_version(versionInfo.latestVersion);
+        const std::vector<std::string> ver = split_version(info.latestVersion);
 
         if (ver.size() != 3)
         {
             std::cerr << "Bad version format" << std::endl;
 
             // invalid version
-            return {.isConnFailure = versionInfo.isConnFailure};
+            return {.isConnFailure = info.isConnFailure};
         }
 
-        if (std::stoi(ver[0]) > APP_VERSION_MAJOR || std::stoi(ver[1]) > APP_VERSION_MINOR || std::stoi(ver[2]) >
-            APP_VERSION_PATCH)
+        if (std::make_tuple(std::stoi(ver[0]), std::stoi(ver[1]), std::stoi(ver[2])) >
+            std::make_tuple(APP_VERSION_MAJOR, APP_VERSION_MINOR, APP_VERSION_PATCH))
         {
-            std::cout << "A new version " << versionInfo.latestVersion << " is available!" << std::endl;
-            std::cout << "Release notes: " << versionInfo.releaseNotes << std::endl;
-            return versionInfo;
+            std::cout << "A new version " << info.latestVersion << " is available!" << std::endl;
+            std::cout << "Release notes: " << info.releaseNotes << std::endl;
+            return info;
         }
         else
         {
@@ -143,7 +272,7 @@ UpdateInfo VersionRepository::main_version_logic()
     {
         std::cerr << "Exception while comparing versions" << std::endl;
         // exceptions
-        return {.isConnFailure = versionInfo.isConnFailure};
+        return {.isConnFailure = info.isConnFailure};
     }
 }
 
@@ -175,34 +304,94 @@ std::vector<std::string> VersionRepository::split_version(const std::string& str
     return tokens;
 }
 
-std::filesystem::path VersionRepository::downloadNewVersion() const
+void VersionRepository::downloadNewVersion(
+    QObject* context, std::function<void(const TransferProgress&)> progress,
+    std::function<void(const std::filesystem::path& package, const std::string& error)> done)
 {
     if (versionInfo.latestVersion.empty())
     {
-        return {}; // No version available, exit the application
-    };
+        done({}, "No new version to download.");
+        return;
+    }
 
-    std::filesystem::path latestRelease = std::filesystem::temp_directory_path() / "Buraq" / versionInfo.asset.name;
+    DownloadRequest request{
+        .url = versionInfo.asset.downloadUrl,
+        .path = std::filesystem::temp_directory_path() / "Buraq" / versionInfo.asset.name,
+        .size = std::strtoll(versionInfo.asset.size.c_str(), nullptr, 10),
+        .sha256 = versionInfo.asset.sha,
+    };
 
-    bool has_errors = false;
+    // Next to the installation, so the updater can move the files over without copying them.
+    std::filesystem::path installation = api_context->searchPath.lexically_normal();
+    if (!installation.has_filename())
     {
-        // Create a scope for the lock_guard
-        std::lock_guard<std::mutex> lock(network_mutex); // Lock before accessing network methods
+        installation = installation.parent_path(); // searchPath ends in a separator
+    }
+    std::filesystem::path staging = installation;
+    staging += ".staging-" + versionInfo.latestVersion;
 
-        const Network& net = Network::singleton(); // Get the singleton instance
-        if (const auto response = net.downloadFile(versionInfo.asset.downloadUrl, latestRelease.string().c_str());
-            response != 0)
+    QThreadPool::globalInstance()->start(
+        [request = std::move(request), files = versionInfo.files, installation, staging = std::move(staging),
+            stop = downloadStop.get_token(), context = QPointer(context),
+            progress = std::move(progress), done = std::move(done)]() mutable
         {
-            has_errors = true;
-            std::cout << "Failed to download" << std::endl;
-        }
-        // Mutex is released when 'lock' goes out of scope
-    } // network_mutex is unlocked here
-
-    if (has_errors)
-    {
-        return std::filesystem::temp_directory_path() / "Buraq";
-    }
+            const auto onProgress = [context, progress](const TransferProgress& transferProgress)
+            {
+                if (!context.isNull())
+                {
+                    QMetaObject::invokeMethod(context.data(), [progress, transferProgress]
+                    {
+                        progress(transferProgress);
+                    }, Qt::QueuedConnection);
+                }
+            };
+            const auto finish = [context, done](const std::filesystem::path& package, const std::string& error)
+            {
+                if (!context.isNull())
+                {
+                    QMetaObject::invokeMethod(context.data(), [done, package, error]
+                    {
+                        done(package, error);
+                    }, Qt::QueuedConnection);
+                }
+            };
 
-    return latestRelease;
+            // Only what changed, when the manifest lists the files; the installer otherwise.
+            if (!files.empty())
+            {
+                UpdateStager stager(installation, staging, std::move(files));
+                const StagingResult staged = stager.run(stop, onProgress);
+                if (staged.ok())
+                {
+                    qDebug() << "Staged the update in" << staging.string().c_str() << ":" << staged.unchanged
+                        << "unchanged," << staged.patched << "patched," << staged.downloaded << "downloaded files,"
+                        << staged.downloadedBytes << "of" << staged.changedBytes << "changed bytes fetched.";
+                    finish(staging, {});
+                    return;
+                }
+                if (stop.stop_requested())
+                {
+                    finish({}, staged.error);
+                    return;
+                }
+                qDebug() << "Failed to stage the update, downloading the installer:" << staged.error.c_str();
+                std::error_code ignored;
+                std::filesystem::remove_all(staging, ignored);
+            }
+
+            request.onProgress = onProgress;
+            const std::filesystem::path installer = request.path;
+            RangedDownload download(std::move(request));
+            const DownloadResult result = download.run(stop);
+            if (result.ok())
+            {
+                qDebug() << "Downloaded" << installer.string().c_str() << "in" << result.seconds << "s, resumed"
+                    << result.resumedBytes << "bytes," << result.retries << "retries.";
+            }
+            else
+            {
+                qDebug() << "Failed to download the update: " << result.error.c_str();
+            }
+            finish(result.ok() ? installer : std::filesystem::path(), result.error);
+        });
 }
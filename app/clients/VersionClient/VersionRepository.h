@@ -7,11 +7,15 @@
 
 #include <string>
 #include <filesystem> // Requires C++17. For older C++, use platform-specific directory iteration.
+#include <functional>
+#include <stop_token>
 #include <vector>
 
+#include <QJsonObject>
+#include <QObject>
+
 #include "network.h"
 #include "app_version.h"
-#include "VersionRepository.h"
 #include "buraq.h"
 
 class VersionRepository {
@@ -19,30 +23,48 @@ class VersionRepository {
 public:
 	explicit VersionRepository(buraq::buraq_api *api_context);
 
-	~VersionRepository() = default;
+	// Stops a download in progress; it resumes next time.
+	~VersionRepository();
 
 	/**
-	 * Determines if there is a new version
-	 * @return Returns the new version object or an empty version object otherwise.
+	 * Determines if there is a new version, off the GUI thread. done is called on context's
+	 * thread with the new version, or an UpdateInfo without latestVersion otherwise.
+	 *
+	 * The manifest is revalidated against the copy cached by the last check (ETag,
+	 * Last-Modified), so an unchanged one is not downloaded again. $BURAQ_UPDATE_MANIFEST_URL
+	 * replaces the endpoint, e.g. with a file:// URL or tools/http_stub.
 	 */
-	[[nodiscard]] UpdateInfo main_version_logic();
-	[[nodiscard]] std::filesystem::path downloadNewVersion() const;
+	void checkForUpdate(QObject *context, std::function<void(const UpdateInfo &)> done);
+
+	/**
+	 * Downloads the version checkForUpdate found, off the GUI thread, resuming an earlier
+	 * attempt. If the manifest lists the files, only the changed ones are fetched (as patches
+	 * where it has them) into a staging directory next to the installation; otherwise, or if
+	 * that fails, the installer is downloaded in parallel ranges and checked against its sha.
+	 * progress and done are called on context's thread; done gets the staging directory or the
+	 * installer for the updater, or an empty path and the reason.
+	 */
+	void downloadNewVersion(QObject *context, std::function<void(const TransferProgress &)> progress,
+	                        std::function<void(const std::filesystem::path &package, const std::string &error)> done);
 
 
 private:
 	buraq::buraq_api *api_context;
 	std::string endpoint;
 	UpdateInfo versionInfo;
-	Network &network;
+	std::stop_source downloadStop;
 
 	static std::string getCurrentAppVersion();
 	static std::vector<std::string> split_version(const std::string &str);
 
 	/**
- * Fetches the application manifestJson file.
- * @return File path to where the manifestJson was downloaded.
- */
-	static void get_manifest_json(const std::string& endpoint, UpdateInfo& info);
+	 * Fetches the application manifest, or takes the cached one if it has not changed.
+	 * @return The manifest's version details; isConnFailure if there is no manifest.
+	 */
+	static UpdateInfo get_manifest_json(const std::string &endpoint);
+	static bool parse_manifest(const QJsonObject &manifest, UpdateInfo &info);
+	// info if it is newer than this build, an empty UpdateInfo otherwise.
+	static UpdateInfo newer_version_only(const UpdateInfo &info);
 };
 
 
@@ -0,0 +1,226 @@
+# Turns main_config.xml into a header of constexpr values, so the app does not parse XML
+# at startup. Run in script mode:
+#   cmake -DINPUT=main_config.xml -DOUTPUT=GeneratedConfig.h -P GenerateConfig.cmake
+#
+# The stylesheet strings are joined here exactly as Config::processStyleBlock joins them for
+# an override file; keep the two in step.
+
+if (NOT INPUT OR NOT OUTPUT)
+    message(FATAL_ERROR "GenerateConfig.cmake: INPUT and OUTPUT are required")
+endif ()
+
+file(READ "${INPUT}" xml)
+# Comments would otherwise be matched like elements.
+string(REGEX REPLACE "<!--([^-]|-[^-])*-->" "" xml "${xml}")
+
+function(xml_unescape value out)
+    string(REPLACE "&lt;" "<" value "${value}")
+    string(REPLACE "&gt;" ">" value "${value}")
+    string(REPLACE "&quot;" "\"" value "${value}")
+    string(REPLACE "&apos;" "'" value "${value}")
+    string(REPLACE "&amp;" "&" value "${value}")
+    string(STRIP "${value}" value)
+    set(${out} "${value}" PARENT_SCOPE)
+endfunction()
+
+# As a C++ string literal.
+function(cxx_string value out)
+    string(REPLACE "\\" "\\\\" value "${value}")
+    string(REPLACE "\"" "\\\"" value "${value}")
+    set(${out} "\"${value}\"" PARENT_SCOPE)
+endfunction()
+
+# Text of the first <tag> in text.
+function(element_text text tag out)
+    if (NOT text MATCHES "<${tag}>([^<]*)</${tag}>")
+        message(FATAL_ERROR "${INPUT}: missing <${tag}>")
+    endif ()
+    xml_unescape("${CMAKE_MATCH_1}" value)
+    set(${out} "${value}" PARENT_SCOPE)
+endfunction()
+
+# Everything between <tag ...> and </tag>; the attributes go to ${out}_ATTRIBUTES.
+function(element_body text tag out)
+    if (NOT text MATCHES "<${tag}([^>]*)>(.*)</${tag}>")
+        message(FATAL_ERROR "${INPUT}: missing <${tag}>")
+    endif ()
+    set(${out} "${CMAKE_MATCH_2}" PARENT_SCOPE)
+    set(${out}_ATTRIBUTES "${CMAKE_MATCH_1}" PARENT_SCOPE)
+endfunction()
+
+function(attribute attributes name out)
+    set(value "")
+    if (attributes MATCHES "[ \t\r\n]${name}=\"([^\"]*)\"")
+        xml_unescape("${CMAKE_MATCH_1}" value)
+    endif ()
+    set(${out} "${value}" PARENT_SCOPE)
+endfunction()
+
+# Like QString::toInt(): 0 unless the whole value is a number.
+function(to_int value out)
+    if (value MATCHES "^[-+]?[0-9]+$")
+        math(EXPR value "${value}")
+    else ()
+        set(value 0)
+    endif ()
+    set(${out} "${value}" PARENT_SCOPE)
+endfunction()
+
+string(REGEX MATCH "<configuration>.*</configuration>" root "${xml}")
+if (NOT root)
+    message(FATAL_ERROR "${INPUT}: the root element must be <configuration>")
+endif ()
+
+element_text("${root}" Title title)
+element_text("${root}" Version version)
+element_text("${root}" AppLogo appLogo)
+
+if (NOT root MATCHES "<window([^>]*)/?>")
+    message(FATAL_ERROR "${INPUT}: missing <window>")
+endif ()
+set(windowAttributes "${CMAKE_MATCH_1}")
+foreach (name minWidth minHeight normalSize)
+    attribute("${windowAttributes}" ${name} value)
+    to_int("${value}" window_${name})
+endforeach ()
+foreach (name minimizeIcon maximizeIcon restoreIcon closeIcon)
+    attribute("${windowAttributes}" ${name} value)
+    cxx_string("${value}" window_${name})
+endforeach ()
+
+element_body("${root}" AppIcons appIcons)
+foreach (name settings folder terminal playCode execute executeSelected addFile)
+    set(value "")
+    if (appIcons MATCHES "<${name}>([^<]*)</${name}>")
+        xml_unescape("${CMAKE_MATCH_1}" value)
+    endif ()
+    cxx_string("${value}" icon_${name})
+endforeach ()
+
+# Style fields, in the order the stylesheet joins them. <color> is not read, as in
+# Config::processStyleBlock; <borderTop> fills the borderBottom slot.
+set(styleFields backgroundColor padding color border height borderColor borderBottom)
+
+element_body("${root}" Styles styles)
+foreach (block commonStyle controlToolBar toolBar statusToolBar toolBarHover)
+    foreach (field ${styleFields})
+        set(${block}_${field} "")
+    endforeach ()
+
+    if (NOT styles MATCHES "<${block}([^>]*)>(.*)</${block}>")
+        set(${block}_styleSheet "")
+        continue()
+    endif ()
+    set(body "${CMAKE_MATCH_2}")
+    attribute("${CMAKE_MATCH_1}" inherits inherits)
+
+    if (inherits STREQUAL "commonStyle")
+        foreach (field color backgroundColor padding border height)
+            set(${block}_${field} "${commonStyle_${field}}")
+        endforeach ()
+    endif ()
+
+    string(REGEX MATCHALL "<[A-Za-z]+>[^<]*</[A-Za-z]+>" children "${body}")
+    foreach (child ${children})
+        string(REGEX MATCH "^<([A-Za-z]+)>([^<]*)<" _ "${child}")
+        set(tag "${CMAKE_MATCH_1}")
+        xml_unescape("${CMAKE_MATCH_2}" text)
+        if (tag STREQUAL "backgroundColor")
+            set(${block}_backgroundColor "background-color:${text};")
+        elseif (tag STREQUAL "border")
+            set(${block}_border "border: ${text};")
+        elseif (tag STREQUAL "borderBottom")
+            set(${block}_borderBottom "border-bottom:${text};")
+        elseif (tag STREQUAL "borderTop")
+            set(${block}_borderBottom "border-top:${text};")
+        elseif (tag STREQUAL "borderColor")
+            set(${block}_borderColor "border-color:${text};")
+        elseif (tag STREQUAL "padding")
+            set(${block}_padding "padding:${text};")
+        elseif (tag STREQUAL "height")
+            set(${block}_height "height:${text};")
+        endif ()
+    endforeach ()
+
+    set(${block}_styleSheet "")
+    if (children)
+        foreach (field ${styleFields})
+            string(APPEND ${block}_styleSheet "${${block}_${field}}")
+        endforeach ()
+    endif ()
+endforeach ()
+
+cxx_string("${title}" title)
+cxx_string("${version}" version)
+cxx_string("${appLogo}" appLogo)
+
+set(styleDefinitions "")
+foreach (block commonStyle controlToolBar toolBar statusToolBar toolBarHover)
+    # Not a list: the values end in ';'.
+    set(values "")
+    set(separator "")
+    foreach (field color backgroundColor padding border height borderColor borderBottom styleSheet)
+        cxx_string("${${block}_${field}}" value)
+        string(APPEND values "${separator}${value}")
+        set(separator ", ")
+    endforeach ()
+    string(APPEND styleDefinitions "    inline constexpr Style ${block}{${values}};\n")
+endforeach ()
+
+set(content "// Generated from main_config.xml by cmake/GenerateConfig.cmake. Do not edit.
+
+#ifndef GENERATED_CONFIG_H
+#define GENERATED_CONFIG_H
+
+namespace generated_config
+{
+    struct Window
+    {
+        int minWidth;
+        int minHeight;
+        int normalSize;
+        const char* minimizeIcon;
+        const char* maximizeIcon;
+        const char* restoreIcon;
+        const char* closeIcon;
+    };
+
+    struct Icons
+    {
+        const char* settings;
+        const char* folder;
+        const char* terminal;
+        const char* playCode;
+        const char* execute;
+        const char* executeSelected;
+        const char* addFile;
+    };
+
+    // As StyleSheetStruct, with styleSheet already joined.
+    struct Style
+    {
+        const char* color;
+        const char* backgroundColor;
+        const char* padding;
+        const char* border;
+        const char* height;
+        const char* borderColor;
+        const char* borderBottom;
+        const char* styleSheet;
+    };
+
+    inline constexpr const char* title = ${title};
+    inline constexpr const char* version = ${version};
+    inline constexpr const char* appLogo = ${appLogo};
+
+    inline constexpr Window window{${window_minWidth}, ${window_minHeight}, ${window_normalSize}, ${window_minimizeIcon}, ${window_maximizeIcon}, ${window_restoreIcon}, ${window_closeIcon}};
+
+    inline constexpr Icons icons{${icon_settings}, ${icon_folder}, ${icon_terminal}, ${icon_playCode}, ${icon_execute}, ${icon_executeSelected}, ${icon_addFile}};
+
+${styleDefinitions}}
+
+#endif // GENERATED_CONFIG_H
+")
+
+# Rewritten only when it changes, so a touched but equal XML rebuilds nothing.
+file(CONFIGURE OUTPUT "${OUTPUT}" CONTENT "${content}" @ONLY)
@@ -5,84 +5,74 @@
 #include <QMessageBox>
 #include <QCoreApplication>
 #include <filesystem> // Requires C++17. For older C++, use platform-specific directory iteration.
-#include <fstream>
 
 #include "../../include/buraq.h"
 
 #include "./db_conn.h"
+#include "./db_worker.h"
 
 namespace database
 {
-    QVariant insertFile(const QString& filePath, const QString& title)
+    void insertFile(const QString& filePath, const QString& title, QObject* context, std::function<void(bool inserted)> done)
     {
-        QSqlQuery query;
-        if (!query.prepare(INSERT_FILE_SQL))
+        // A read, to hand the result back; it commits what was queued before it itself.
+        DbWorker::singleton().read<bool>([filePath, title](Connection& connection)
         {
-            // "Error executing query:" << query.lastError().text();
-        }
-
-        query.addBindValue(filePath);
-        query.addBindValue(title);
-        query.exec();
-
-        return query.lastInsertId();
+            QSqlQuery& query = connection.statement(INSERT_FILE_SQL);
+            query.addBindValue(filePath);
+            query.addBindValue(title);
+            return Connection::exec(query);
+        }, context, std::move(done));
     }
 
-    QVariant deleteRow(const QString& filePath)
+    void deleteRow(const QString& filePath)
     {
-        QSqlQuery query;
-        if (!query.prepare(DELETE_BY_FILE_PATH_SQL))
+        DbWorker::singleton().write([filePath](Connection& connection)
         {
-            // "Error executing query:" << query.lastError().text();
-        }
-
-        query.addBindValue(filePath);
-        query.exec();
-
-        return query.lastInsertId();
+            QSqlQuery& query = connection.statement(DELETE_BY_FILE_PATH_SQL);
+            query.addBindValue(filePath);
+            Connection::exec(query);
+        });
     }
 
-    QList<FileObject*> findPreviouslyOpenedFiles()
+    void findPreviouslyOpenedFiles(const qint64 afterId, const int limit, QObject* context, std::function<void(FilesPage)> done)
     {
-        QSqlQuery query;
-
-        if (!query.exec(SELECT_FILES_SQL))
+        DbWorker::singleton().read<FilesPage>([afterId, limit](Connection& connection)
         {
-            // qDebug() << "Error executing query:" << query.lastError().text();
-        }
+            FilesPage page{{}, afterId};
 
-        QList<FileObject*> files;
-        while (query.next())
-        {
-            if (const QString filePath = query.value(1).toString(); std::filesystem::exists(filePath.toStdString()))
+            QSqlQuery& query = connection.statement(SELECT_FILES_PAGE_SQL);
+            query.setForwardOnly(true);
+            query.addBindValue(afterId);
+            query.addBindValue(limit);
+            if (Connection::exec(query))
             {
-                const auto file = new FileObject;
-
-                file->setFilePath(filePath);
+                while (query.next())
+                {
+                    page.lastId = query.value(0).toLongLong();
 
-                QString title = query.value(2).toString(); // column title
-                file->setFileName(title);
-                files.append(file);
-            }
-            else
-            {
-                // delete row with this file
-                deleteRow(filePath);
+                    FileObject file;
+                    file.setFilePath(query.value(1).toString());
+                    file.setFileName(query.value(2).toString()); // column title
+                    page.files.append(file);
+                }
+                query.finish();
             }
-        }
-
-        return files;
+            return page;
+        }, context, std::move(done));
     }
 
-    QSqlError init_db()
+    void init_db()
     {
-        if (QSqlQuery query; !query.exec(FILES_SQL))
+        DbWorker::singleton().write([](Connection& connection)
         {
-            file_utils::file_log("Error executing query: " + query.lastError().text().toStdString());
-            return query.lastError();
-        }
+            connection.exec(FILES_SQL);
+        });
+    }
 
-        return {};
+    std::filesystem::path databasePath()
+    {
+        return std::filesystem::temp_directory_path() / "Buraq" / ".data" / "itools.db";
     }
 
     bool db_conn()
@@ -91,72 +81,27 @@ namespace database
 
         file_log("Initiating DB connection..");
 
-        std::filesystem::path dirName = std::filesystem::temp_directory_path() / "Buraq" / ".data";
-        if (!std::filesystem::create_directories(dirName))
-        {
-            file_log("Dir " + dirName.string() + " already exists.");
-        }
-
-        std::filesystem::path dbPathName = dirName / "itools.db";
-        std::string dbName = dbPathName.string();
-
+        const std::filesystem::path dbPathName = databasePath();
         file_log("current dir: " + std::filesystem::current_path().string());
-        file_log("DB name path: " + dbName);
+        file_log("DB name path: " + dbPathName.string());
 
-        try
+        DbWorker::singleton().start(dbPathName, [dbName = dbPathName.string()](const QSqlError& error)
         {
-            if (std::fstream db(dbName, std::ios::in); db.is_open())
-            {
-                // db file exists
-                db.close();
-            }
-            else
-            {
-                // create the db file
-                std::ofstream outputFile(dbName, std::ios::out);
-                outputFile.close();
-            }
-
-            QSqlDatabase dbEngine = QSqlDatabase::addDatabase("QSQLITE");
-            dbEngine.setDatabaseName(QString::fromStdString(dbName));
-
-            if (!dbEngine.open())
-            {
-                QSqlError error = dbEngine.lastError();
-
-                QMessageBox::critical(nullptr, QObject::tr("Cannot open database"),
-                                      "Unable to establish a database connection.\n"
-                                      "Click Cancel to exit.",
-                                      QMessageBox::Cancel);
-                file_log("Failed to open DB connection.");
-                file_log("DATABASE OPEN FAILED!");
-                file_log("  Database file checked: " + dbName);
-                file_log(&"  Error Type:"[error.type()]);
-                file_log("  Error (Driver Text):" + error.driverText().toStdString());
-                file_log(&"  Driver available:"[QSqlDatabase::isDriverAvailable("QSQLITE")]);
-                file_log("  Error (Database Text):" + error.databaseText().toStdString());
-                return false;
-            }
-            else
-            {
-                file_log("DB connection is good!"); // Initialize the database:
-                if (QSqlError err = init_db(); err.type() != QSqlError::NoError)
-                {
-                    file_log("Error executing initializing db: " + err.text().toStdString());
-                }
-            }
-        }
-        catch (const std::ios_base::failure& failure)
-        {
-            file_log("failed: ");
-            return false;
-        }
-        catch (...)
-        {
-            file_log("Exception catch all: db_conn failed!");
-            return false;
-        }
-
+            QMessageBox::critical(nullptr, QObject::tr("Cannot open database"),
+                                  "Unable to establish a database connection.\n"
+                                  "Click Cancel to exit.",
+                                  QMessageBox::Cancel);
+            file_log(LogLevel::Error, "Failed to open DB connection.");
+            file_log(LogLevel::Error, "DATABASE OPEN FAILED!");
+            file_log(LogLevel::Error, "  Database file checked: " + dbName);
+            file_log(LogLevel::Error, "  Error (Driver Text):" + error.driverText().toStdString());
+            file_log(LogLevel::Error,
+                     std::string("  Driver available:") + (QSqlDatabase::isDriverAvailable("QSQLITE") ? "yes" : "no"));
+            file_log(LogLevel::Error, "  Error (Database Text):" + error.databaseText().toStdString());
+        });
+
+        // Initialize the database:
+        init_db();
         return true;
     }
 }
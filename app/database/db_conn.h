@@ -27,8 +27,11 @@
 #ifndef IT_TOOLS_DB_CONN_H
 #define IT_TOOLS_DB_CONN_H
 
-#include <QSqlError>
-#include <QSqlQuery>
+#include <filesystem>
+#include <functional>
+
+#include <QList>
+#include <QObject>
 
 #include "../FileObject.h"
 
@@ -40,14 +43,32 @@ namespace database
 
     constexpr auto SELECT_FILES_SQL = "SELECT * FROM files;";
 
+    // Keyset paging: the next page starts after the last id of the previous one.
+    constexpr auto SELECT_FILES_PAGE_SQL = "SELECT id, file_path, file_name FROM files WHERE id > ? ORDER BY id LIMIT ?;";
+
     constexpr auto SELECT_FILE_BY_FILE_PATH_SQL = "SELECT * FROM files WHERE file_path = ?;";
 
     constexpr auto DELETE_BY_FILE_PATH_SQL ="DELETE FROM files WHERE file_path = ?;";
 
-    QVariant insertFile(const QString& filePath, const QString& title);
-    QVariant deleteRow(const QString& filePath);
-    QList<FileObject*> findPreviouslyOpenedFiles();
-    QSqlError init_db();
+    // The database file, in the user data directory.
+    std::filesystem::path databasePath();
+
+    // These queue work on the database thread (see DbWorker); results come back through done,
+    // on the GUI thread, unless context is gone by then.
+    void insertFile(const QString& filePath, const QString& title, QObject* context, std::function<void(bool inserted)> done);
+    void deleteRow(const QString& filePath);
+
+    struct FilesPage
+    {
+        QList<FileObject> files;
+        qint64 lastId; // pass as afterId for the next page
+    };
+
+    // Up to limit previously opened files, in the order they were added; fewer means the end.
+    // Whether they still exist is not checked: that is file system work, left to the caller.
+    void findPreviouslyOpenedFiles(qint64 afterId, int limit, QObject* context, std::function<void(FilesPage)> done);
+    void init_db();
+    // Starts the database thread; failing to open the file is reported to the user from there.
     bool db_conn();
 }
 
@@ -0,0 +1,190 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "db_worker.h"
+
+#include <optional>
+
+#include <QThread>
+
+#include "../../include/buraq.h"
+#include "Trace/Trace.h"
+
+namespace
+{
+    constexpr auto CONNECTION_NAME = "buraq";
+
+    void commit(QSqlDatabase& db)
+    {
+        if (!db.commit())
+        {
+            file_utils::file_log(LogLevel::Error, "Error committing: " + db.lastError().text().toStdString());
+            db.rollback();
+        }
+    }
+}
+
+namespace database
+{
+    QSqlQuery& Connection::statement(const char* sql)
+    {
+        if (const auto found = m_statements.find(sql); found != m_statements.end())
+        {
+            return found->second;
+        }
+
+        QSqlQuery query(m_db);
+        if (!query.prepare(sql))
+        {
+            file_utils::file_log(LogLevel::Error, "Error preparing query: " + query.lastError().text().toStdString());
+            // Not cached: it may work once the schema is there.
+            m_failed = std::move(query);
+            return m_failed;
+        }
+        return m_statements.emplace(sql, std::move(query)).first->second;
+    }
+
+    bool Connection::exec(const char* sql)
+    {
+        QSqlQuery query(m_db);
+        if (!query.exec(sql))
+        {
+            file_utils::file_log(LogLevel::Error, "Error executing query: " + query.lastError().text().toStdString());
+            return false;
+        }
+        return true;
+    }
+
+    bool Connection::exec(QSqlQuery& query)
+    {
+        if (!query.exec())
+        {
+            file_utils::file_log(LogLevel::Error, "Error executing query: " + query.lastError().text().toStdString());
+            return false;
+        }
+        return true;
+    }
+
+    DbWorker& DbWorker::singleton()
+    {
+        static DbWorker worker;
+        return worker;
+    }
+
+    DbWorker::~DbWorker()
+    {
+        stop();
+    }
+
+    void DbWorker::start(const std::filesystem::path& path, std::function<void(const QSqlError&)> onFailure)
+    {
+        if (m_thread != nullptr)
+        {
+            return;
+        }
+
+        m_thread = QThread::create([this, path, onFailure = std::move(onFailure)] { run(path, onFailure); });
+        m_thread->setObjectName("Database");
+        m_thread->start();
+    }
+
+    void DbWorker::stop()
+    {
+        if (m_thread == nullptr)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_one();
+
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+
+    void DbWorker::write(Job job)
+    {
+        enqueue(true, std::move(job));
+    }
+
+    void DbWorker::enqueue(const bool write, Job job)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_queue.push_back({write, std::move(job)});
+        }
+        m_wake.notify_one();
+    }
+
+    void DbWorker::run(const std::filesystem::path& path, const std::function<void(const QSqlError&)>& onFailure)
+    {
+        Trace::singleton().setThreadName("Database");
+        std::optional<TraceSpan> openSpan(std::in_place, "DbWorker::open");
+
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+
+        {
+            QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", CONNECTION_NAME);
+            db.setDatabaseName(QString::fromStdWString(path.wstring()));
+            if (!db.open())
+            {
+                QMetaObject::invokeMethod(QCoreApplication::instance(), [onFailure, lastError = db.lastError()]
+                {
+                    onFailure(lastError);
+                }, Qt::QueuedConnection);
+            }
+
+            Connection connection(db);
+            // WAL lets reads run while a write is in progress, and with synchronous=NORMAL a
+            // commit does not wait for the disk; a crash can lose the last commits, not corrupt.
+            connection.exec("PRAGMA journal_mode = WAL;");
+            connection.exec("PRAGMA synchronous = NORMAL;");
+            openSpan.reset();
+
+            std::deque<Queued> batch;
+            while (true)
+            {
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_wake.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+                    if (m_queue.empty())
+                    {
+                        break; // stopping, and nothing left to do
+                    }
+                    batch.swap(m_queue);
+                }
+
+                // Consecutive writes share a transaction; a read first sees them committed.
+                bool inTransaction = false;
+                for (Queued& queued : batch)
+                {
+                    if (queued.write && !inTransaction)
+                    {
+                        inTransaction = db.transaction();
+                    }
+                    else if (!queued.write && inTransaction)
+                    {
+                        commit(db);
+                        inTransaction = false;
+                    }
+                    queued.job(connection);
+                }
+                if (inTransaction)
+                {
+                    commit(db);
+                }
+                batch.clear();
+            }
+
+            connection.clear();
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(CONNECTION_NAME);
+    }
+}
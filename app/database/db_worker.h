@@ -0,0 +1,123 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef DB_WORKER_H
+#define DB_WORKER_H
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+#include <QCoreApplication>
+#include <QPointer>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+
+class QThread;
+
+namespace database
+{
+    // The connection as jobs see it.
+    class Connection
+    {
+    public:
+        explicit Connection(QSqlDatabase db) : m_db(std::move(db)) {}
+
+        // The statement for sql, prepared on first use and kept for the life of the connection.
+        // Bind its values and pass it to exec(). sql is the cache key, so it must be a literal.
+        QSqlQuery& statement(const char* sql);
+
+        // Runs a statement that takes no values, such as schema changes.
+        bool exec(const char* sql);
+        // Runs a bound statement; failures are logged.
+        static bool exec(QSqlQuery& query);
+
+        [[nodiscard]] QSqlDatabase& database() { return m_db; }
+
+        // Drops the cached statements; they must go before the connection is removed.
+        void clear()
+        {
+            m_statements.clear();
+            m_failed = QSqlQuery();
+        }
+
+    private:
+        QSqlDatabase m_db;
+        std::unordered_map<std::string_view, QSqlQuery> m_statements;
+        QSqlQuery m_failed; // handed out when a statement cannot be prepared
+    };
+
+    /**
+     * The application's SQLite connection, on a thread of its own.
+     *
+     * Nothing on the GUI thread touches the database: callers queue jobs, and reads hand
+     * their result back through a callback. Jobs run in the order queued. Writes queued close
+     * together run in one transaction, and the database is in WAL mode, so a burst of small
+     * writes costs one sync rather than one per statement.
+     */
+    class DbWorker
+    {
+    public:
+        static DbWorker& singleton();
+
+        using Job = std::function<void(Connection&)>;
+
+        // Opens path on the worker thread. onFailure is called on the GUI thread if it cannot be
+        // opened; jobs still run, and their statements fail.
+        void start(const std::filesystem::path& path, std::function<void(const QSqlError&)> onFailure);
+
+        // Runs every job queued so far, then closes the connection and ends the thread.
+        void stop();
+
+        void write(Job job);
+
+        // Runs job on the worker thread and calls done with its result on the GUI thread,
+        // unless context has been deleted by then.
+        template <typename Result>
+        void read(std::function<Result(Connection&)> job, QObject* context, std::function<void(Result)> done)
+        {
+            enqueue(false, [job = std::move(job), guard = QPointer<QObject>(context), done = std::move(done)](Connection& connection)
+            {
+                const Result result = job(connection);
+                QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, done, result]
+                {
+                    if (guard)
+                    {
+                        done(result);
+                    }
+                }, Qt::QueuedConnection);
+            });
+        }
+
+        DbWorker(const DbWorker&) = delete;
+        DbWorker& operator=(const DbWorker&) = delete;
+
+    private:
+        DbWorker() = default;
+        ~DbWorker();
+
+        struct Queued
+        {
+            bool write;
+            Job job;
+        };
+
+        void enqueue(bool write, Job job);
+        void run(const std::filesystem::path& path, const std::function<void(const QSqlError&)>& onFailure);
+
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::deque<Queued> m_queue;
+        bool m_stopping = false;
+
+        QThread* m_thread = nullptr;
+    };
+}
+
+#endif // DB_WORKER_H
@@ -0,0 +1,272 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "run_history.h"
+
+#include <QCryptographicHash>
+#include <QHash>
+
+#include "../../include/buraq.h"
+
+#include "./db_worker.h"
+
+namespace
+{
+    // Queued records are handed to the database thread after this long, or sooner once this many
+    // characters are waiting.
+    constexpr int FLUSH_INTERVAL_MS = 500;
+    constexpr qsizetype FLUSH_CHARS = 1024 * 1024;
+
+    constexpr int STREAM_OUTPUT = 0;
+    constexpr int STREAM_ERROR = 1;
+    constexpr int STREAM_SCRIPT = 2;
+}
+
+namespace database
+{
+    // What the database thread knows of the session's runs; only touched by its jobs.
+    struct RunHistory::WriterState
+    {
+        // Per run id of the session: the row and what has been written for it so far.
+        struct Active
+        {
+            qint64 id;
+            qint64 outputBytes = 0;
+            qint64 errorBytes = 0;
+            qint64 chunks = 0;
+        };
+
+        bool open = false;
+        bool hasFts = false;
+        QHash<quint64, Active> active;
+    };
+
+    namespace
+    {
+        void insertChunk(Connection& connection, const qint64 runId, const int stream, const qint64 seq, const QString& text)
+        {
+            QSqlQuery& insert = connection.statement(INSERT_RUN_OUTPUT_SQL);
+            insert.bindValue(0, text);
+            insert.bindValue(1, runId);
+            insert.bindValue(2, stream);
+            insert.bindValue(3, seq);
+            Connection::exec(insert);
+        }
+
+        void writeRecords(Connection& connection, RunHistory::WriterState& state, const QList<RunHistory::Record>& records)
+        {
+            for (const RunHistory::Record& record : records)
+            {
+                if (const auto* started = std::get_if<RunHistory::Started>(&record))
+                {
+                    QSqlQuery& insert = connection.statement(INSERT_RUN_SQL);
+                    insert.bindValue(0, started->scriptHash);
+                    insert.bindValue(1, started->script);
+                    insert.bindValue(2, started->startedAt.toMSecsSinceEpoch());
+                    if (Connection::exec(insert))
+                    {
+                        auto& active = state.active[started->runId];
+                        active.id = insert.lastInsertId().toLongLong();
+                        insertChunk(connection, active.id, STREAM_SCRIPT, active.chunks++, started->script);
+                    }
+                }
+                else if (const auto* output = std::get_if<RunHistory::Output>(&record))
+                {
+                    const auto active = state.active.find(output->runId);
+                    if (active == state.active.end())
+                    {
+                        continue; // its start could not be written
+                    }
+
+                    const qint64 bytes = output->text.toUtf8().size() + 1;
+                    (output->stream == STREAM_ERROR ? active->errorBytes : active->outputBytes) += bytes;
+                    insertChunk(connection, active->id, output->stream, active->chunks++, output->text);
+                }
+                else if (const auto* finished = std::get_if<RunHistory::Finished>(&record))
+                {
+                    const auto active = state.active.find(finished->runId);
+                    if (active == state.active.end())
+                    {
+                        continue;
+                    }
+
+                    QSqlQuery& finish = connection.statement(FINISH_RUN_SQL);
+                    finish.bindValue(0, finished->finishedAt.toMSecsSinceEpoch());
+                    finish.bindValue(1, finished->exitStatus);
+                    finish.bindValue(2, active->outputBytes);
+                    finish.bindValue(3, active->errorBytes);
+                    finish.bindValue(4, active->id);
+                    Connection::exec(finish);
+                    state.active.erase(active);
+                }
+            }
+        }
+
+        QList<RunSearchHit> searchOutput(Connection& connection, const bool hasFts, const QString& text, const int limit)
+        {
+            // Searches are rare next to writes; they are prepared when issued.
+            QSqlQuery query(connection.database());
+            query.setForwardOnly(true);
+            if (hasFts)
+            {
+                // One phrase: error text is full of characters FTS5 would read as syntax.
+                query.prepare(SEARCH_RUN_OUTPUT_FTS_SQL);
+                query.addBindValue(QLatin1Char('"') + QString(text).replace('"', "\"\"") + QLatin1Char('"'));
+            }
+            else
+            {
+                query.prepare(SEARCH_RUN_OUTPUT_PLAIN_SQL);
+                query.addBindValue(text);
+                query.addBindValue(text);
+            }
+            query.addBindValue(limit);
+
+            QList<RunSearchHit> hits;
+            if (!Connection::exec(query))
+            {
+                return hits;
+            }
+
+            while (query.next())
+            {
+                hits.append(RunSearchHit{
+                    query.value(0).toLongLong(),
+                    QDateTime::fromMSecsSinceEpoch(query.value(1).toLongLong()),
+                    query.value(2).isNull() ? -1 : query.value(2).toInt(),
+                    query.value(3).toInt(),
+                    query.value(4).toString(),
+                });
+            }
+            return hits;
+        }
+    }
+
+    RunHistory::RunHistory(QObject* parent)
+        : QObject(parent), m_state(std::make_shared<WriterState>())
+    {
+        DbWorker::singleton().write([state = m_state](Connection& connection)
+        {
+            state->hasFts = connection.exec(RUN_OUTPUT_FTS_SQL);
+            if (!state->hasFts)
+            {
+                file_utils::file_log("Run history: FTS5 not available, output search will scan.");
+                connection.exec(RUN_OUTPUT_PLAIN_SQL);
+            }
+            state->open = connection.exec(RUNS_SQL) && connection.exec(RUNS_BY_SCRIPT_SQL);
+        });
+
+        m_flushTimer.setSingleShot(true);
+        m_flushTimer.setInterval(FLUSH_INTERVAL_MS);
+        connect(&m_flushTimer, &QTimer::timeout, this, &RunHistory::flush);
+    }
+
+    RunHistory::~RunHistory()
+    {
+        flush();
+    }
+
+    void RunHistory::runStarted(const quint64 runId, const QString& script)
+    {
+        const QByteArray hash = QCryptographicHash::hash(script.toUtf8(), QCryptographicHash::Sha256);
+        queue(Started{runId, QString::fromLatin1(hash.toHex()), script, QDateTime::currentDateTime()}, script.size());
+    }
+
+    void RunHistory::appendOutput(const quint64 runId, const QString& text, const bool isError)
+    {
+        const int stream = isError ? STREAM_ERROR : STREAM_OUTPUT;
+
+        // Long text is split into chunks at line ends.
+        QStringView rest(text);
+        while (rest.size() > CHUNK_CHARS)
+        {
+            const qsizetype newline = rest.first(CHUNK_CHARS).lastIndexOf('\n');
+            const qsizetype cut = newline > 0 ? newline : CHUNK_CHARS;
+            appendChunk(runId, stream, rest.first(cut));
+            rest = rest.sliced(newline > 0 ? cut + 1 : cut);
+        }
+        appendChunk(runId, stream, rest);
+    }
+
+    void RunHistory::appendChunk(const quint64 runId, const int stream, const QStringView text)
+    {
+        // Consecutive lines of the same stream share a chunk until it is full.
+        if (!m_pending.isEmpty())
+        {
+            if (auto* last = std::get_if<Output>(&m_pending.last());
+                last != nullptr && last->runId == runId && last->stream == stream &&
+                last->text.size() + text.size() < CHUNK_CHARS)
+            {
+                last->text += '\n';
+                last->text += text;
+                m_pendingChars += text.size() + 1;
+                if (m_pendingChars >= FLUSH_CHARS)
+                {
+                    flush();
+                }
+                return;
+            }
+        }
+
+        queue(Output{runId, stream, text.toString()}, text.size());
+    }
+
+    void RunHistory::runFinished(const quint64 runId, const int exitStatus)
+    {
+        queue(Finished{runId, QDateTime::currentDateTime(), exitStatus}, 0);
+    }
+
+    quint64 RunHistory::search(const QString& text, const int limit)
+    {
+        // Anything still queued should be found too, and the worker's queue keeps the order.
+        flush();
+
+        const quint64 requestId = ++m_lastSearchId;
+        DbWorker::singleton().read<QList<RunSearchHit>>([state = m_state, text, limit](Connection& connection)
+        {
+            if (!state->open || text.trimmed().isEmpty())
+            {
+                return QList<RunSearchHit>();
+            }
+            return searchOutput(connection, state->hasFts, text, limit);
+        }, this, [this, requestId](const QList<RunSearchHit>& hits)
+        {
+            emit searchFinished(requestId, hits);
+        });
+        return requestId;
+    }
+
+    void RunHistory::queue(Record record, const qsizetype chars)
+    {
+        m_pending.append(std::move(record));
+        m_pendingChars += chars;
+
+        if (m_pendingChars >= FLUSH_CHARS)
+        {
+            flush();
+        }
+        else if (!m_flushTimer.isActive())
+        {
+            m_flushTimer.start();
+        }
+    }
+
+    void RunHistory::flush()
+    {
+        m_flushTimer.stop();
+        if (m_pending.isEmpty())
+        {
+            return;
+        }
+
+        DbWorker::singleton().write([state = m_state, records = std::move(m_pending)](Connection& connection)
+        {
+            if (state->open)
+            {
+                writeRecords(connection, *state, records);
+            }
+        });
+        m_pending = {};
+        m_pendingChars = 0;
+    }
+}
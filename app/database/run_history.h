@@ -0,0 +1,143 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef RUN_HISTORY_H
+#define RUN_HISTORY_H
+
+#include <memory>
+#include <variant>
+
+#include <QDateTime>
+#include <QList>
+#include <QObject>
+#include <QTimer>
+
+namespace database
+{
+    constexpr auto RUNS_SQL =
+        "CREATE TABLE IF NOT EXISTS runs(id INTEGER PRIMARY KEY, script_hash TEXT NOT NULL, script TEXT NOT NULL, "
+        "started_at INTEGER NOT NULL, finished_at INTEGER, exit_status INTEGER, "
+        "output_bytes INTEGER NOT NULL DEFAULT 0, error_bytes INTEGER NOT NULL DEFAULT 0);";
+
+    constexpr auto RUNS_BY_SCRIPT_SQL = "CREATE INDEX IF NOT EXISTS runs_by_script ON runs(script_hash, started_at);";
+
+    // Output (and the script itself) in chunks of up to RunHistory::CHUNK_CHARS characters.
+    // stream: 0 output, 1 errors, 2 script.
+    constexpr auto RUN_OUTPUT_FTS_SQL =
+        "CREATE VIRTUAL TABLE IF NOT EXISTS run_output USING fts5(chunk, run_id UNINDEXED, stream UNINDEXED, "
+        "seq UNINDEXED);";
+
+    // Same shape without the index, for SQLite builds that lack FTS5; searched with a scan.
+    constexpr auto RUN_OUTPUT_PLAIN_SQL =
+        "CREATE TABLE IF NOT EXISTS run_output(chunk TEXT, run_id INTEGER, stream INTEGER, seq INTEGER);";
+
+    constexpr auto INSERT_RUN_SQL = "INSERT INTO runs(script_hash, script, started_at) VALUES(?, ?, ?);";
+
+    constexpr auto FINISH_RUN_SQL =
+        "UPDATE runs SET finished_at = ?, exit_status = ?, output_bytes = ?, error_bytes = ? WHERE id = ?;";
+
+    constexpr auto INSERT_RUN_OUTPUT_SQL = "INSERT INTO run_output(chunk, run_id, stream, seq) VALUES(?, ?, ?, ?);";
+
+    // Newest first. Chunks are inserted in order, so rowid order is time order, and FTS5 walks
+    // its index backwards by rowid without sorting: LIMIT stops the search early.
+    constexpr auto SEARCH_RUN_OUTPUT_FTS_SQL =
+        "SELECT run_output.run_id, runs.started_at, runs.exit_status, run_output.stream, "
+        "snippet(run_output, 0, '', '', '…', 24) "
+        "FROM run_output JOIN runs ON runs.id = run_output.run_id "
+        "WHERE run_output MATCH ? ORDER BY run_output.rowid DESC LIMIT ?;";
+
+    constexpr auto SEARCH_RUN_OUTPUT_PLAIN_SQL =
+        "SELECT run_output.run_id, runs.started_at, runs.exit_status, run_output.stream, "
+        "substr(chunk, max(1, instr(lower(chunk), lower(?)) - 60), 160) "
+        "FROM run_output JOIN runs ON runs.id = run_output.run_id "
+        "WHERE instr(lower(chunk), lower(?)) > 0 ORDER BY run_output.rowid DESC LIMIT ?;";
+
+    struct RunSearchHit
+    {
+        qint64 runId; // runs.id, stable across sessions
+        QDateTime startedAt;
+        int exitStatus; // -1 while the run had not finished
+        int stream; // as in run_output
+        QString snippet;
+    };
+
+    /**
+     * Records every run (script, times, exit status, output) in the runs tables and searches
+     * them.
+     *
+     * Calls only queue work: records are batched on the GUI thread and handed to the database
+     * thread (DbWorker) a few times per second, where each batch is one transaction. Output is
+     * stored in chunks indexed by FTS5, so finding an error string in months of history is an
+     * index lookup rather than a scan.
+     */
+    class RunHistory final : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        // Characters of output per stored chunk; consecutive lines are packed up to this.
+        static constexpr qsizetype CHUNK_CHARS = 32 * 1024;
+
+        explicit RunHistory(QObject* parent = nullptr);
+        // Queues what is still pending; the database thread writes it before it stops.
+        ~RunHistory() override;
+
+        // runId is the session's run id, as passed to the execution backend.
+        void runStarted(quint64 runId, const QString& script);
+        // Complete lines, without the final newline.
+        void appendOutput(quint64 runId, const QString& text, bool isError);
+        void runFinished(quint64 runId, int exitStatus);
+
+        // Looks text up in the output and scripts of all recorded runs, newest first. The hits
+        // arrive through searchFinished with the id returned here.
+        quint64 search(const QString& text, int limit = 100);
+
+        struct Started
+        {
+            quint64 runId;
+            QString scriptHash;
+            QString script;
+            QDateTime startedAt;
+        };
+
+        struct Output
+        {
+            quint64 runId;
+            int stream;
+            QString text;
+        };
+
+        struct Finished
+        {
+            quint64 runId;
+            QDateTime finishedAt;
+            int exitStatus;
+        };
+
+        using Record = std::variant<Started, Output, Finished>;
+
+        struct WriterState;
+
+    signals:
+        void searchFinished(quint64 requestId, const QList<database::RunSearchHit>& hits);
+
+    private slots:
+        // Hands the queued records to the database thread.
+        void flush();
+
+    private:
+        void appendChunk(quint64 runId, int stream, QStringView text);
+        void queue(Record record, qsizetype chars);
+
+        // Shared with the queued jobs, which may outlive this object.
+        std::shared_ptr<WriterState> m_state;
+        QTimer m_flushTimer;
+
+        QList<Record> m_pending;
+        qsizetype m_pendingChars = 0;
+        quint64 m_lastSearchId = 0;
+    };
+}
+
+#endif // RUN_HISTORY_H
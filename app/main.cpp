@@ -12,19 +12,87 @@
 #include <QWidget>
 #include <QFrame>
 #include <QPushButton>
+#include <QLocalSocket>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+#include "Metrics/Metrics.h"
+#include "settings/SettingManager/SettingsManager.h"
+#include "Trace/Trace.h"
 
 int main(int argc, char* argv[])
 {
+    // --trace or BURAQ_TRACE: record startup spans, written on exit.
+    Trace::singleton().configure(argc, argv);
+
+    // --startup-benchmark: print the time to interactive and quit (tools/bench_startup.sh).
+    const bool startupBenchmark = std::any_of(argv + 1, argv + argc, [](const char* arg)
+    {
+        return std::strcmp(arg, "--startup-benchmark") == 0;
+    });
+
+    // --update-handshake=<server>: the updater that relaunched the app waits on this local
+    // socket to hear that the window is up.
+    QString updateHandshake;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (const std::string_view arg(argv[i]); arg.starts_with("--update-handshake="))
+        {
+            updateHandshake = QString::fromLocal8Bit(argv[i] + std::strlen("--update-handshake="));
+        }
+    }
+
+    std::optional<TraceSpan> span(std::in_place, "QApplication");
     QApplication app(argc, argv);
 
     // Set these before creating any QSettings objects
     QCoreApplication::setOrganizationName("BizAura.app Inc");
     QCoreApplication::setApplicationName("Buraq Editor");
+    SettingsManager::singleton(); // loads the settings, here on the GUI thread
 
+    span.emplace("AppUi");
     const AppUi appUi{};
+
+    if (startupBenchmark)
+    {
+        QObject::connect(&appUi, &AppUi::interactive, []
+        {
+            // From the top of main; the clock started in configure().
+            const double milliseconds = static_cast<double>(Trace::singleton().now()) / 1e6;
+            Metrics::singleton().record("startup.time_to_interactive_ms", milliseconds);
+            std::printf("time_to_interactive_ms %.1f\n", milliseconds);
+            std::fflush(stdout);
+            QCoreApplication::quit();
+        });
+    }
+
+    if (!updateHandshake.isEmpty())
+    {
+        QObject::connect(&appUi, &AppUi::interactive, &app, [&app, updateHandshake]
+        {
+            auto* socket = new QLocalSocket(&app);
+            QObject::connect(socket, &QLocalSocket::connected, socket, [socket]
+            {
+                socket->write("ready\n");
+                socket->disconnectFromServer(); // once written
+            });
+            QObject::connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+            QObject::connect(socket, &QLocalSocket::errorOccurred, socket, &QObject::deleteLater);
+            socket->connectToServer(updateHandshake);
+        });
+    }
+
+    span.emplace("AppUi::showUi");
     appUi.showUi();
+    span.reset();
 
-    return QApplication::exec();
+    const int exitCode = QApplication::exec();
+    Trace::singleton().write();
+    return exitCode;
 }
 
 
@@ -27,11 +27,15 @@
 #include <QGridLayout>
 #include <QLabel>
 #include <QFileDialog>
+#include <QListView>
+#include <QTimer>
 #include "CustomDrawer.h"
 
 #include <QPushButton>
 
+#include "FileListModel.h"
 #include "IconButton.h"
+#include "Trace/Trace.h"
 #include "../database/db_conn.h"
 
 CustomDrawer::CustomDrawer(Editor* editor) : QWidget(editor), editor(editor)
@@ -95,14 +99,23 @@ CustomDrawer::CustomDrawer(Editor* editor) : QWidget(editor), editor(editor)
     separator->setFrameShadow(QFrame::Sunken); // Gives a sunken 3D effect
     mainVLayout->addWidget(separator);
 
-    // 9. Add a stretch to the main layout to push content to the top.
-    // This ensures that if there's not enough content to fill the drawer,
-    // the existing widgets stay at the top.
-    mainVLayout->addStretch(1);
+    // 9. The previously opened files. The model reads them from the database
+    // a page at a time, as the list scrolls; nothing is read here.
+    m_fileModel = new FileListModel(this);
+    m_fileList = new QListView(this);
+    m_fileList->setObjectName("FileList");
+    m_fileList->setModel(m_fileModel);
+    m_fileList->setFrameShape(QFrame::NoFrame);
+    m_fileList->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_fileList->setUniformItemSizes(true);
+    mainVLayout->addWidget(m_fileList, 1);
 
-    // Read from the database and load all the files that were
-    // previously opened. This function should add widgets to `mainVLayout`.
-    showPreviouslyOpenedFiles();
+    connect(m_fileList, &QListView::clicked, this, &CustomDrawer::onFileClicked);
+    connect(m_fileModel, &FileListModel::pageChecked, this, &CustomDrawer::openFirstFile);
+
+    // The view asks for more rows only once it is shown; the first page is needed
+    // before that, to open the first file.
+    m_fileModel->fetchMore({});
 
     // drawer is collapsed by default.
     // show(); // Uncomment if you want it visible by default
@@ -135,109 +148,91 @@ void CustomDrawer::onAddButtonClicked()
             const std::string &fileName = file_utils::getFilename(filePath.toStdString());
 
             const QString qFileName = QString::fromStdString(fileName);
-            if (const QVariant result = database::insertFile(filePath, qFileName); result.isValid())
+            database::insertFile(filePath, qFileName, this, [this, filePath, qFileName](const bool inserted)
             {
-                createFileLabel(filePath, qFileName, true);
-            }
+                if (inserted)
+                {
+                    // updated the side panel to show this as the newly active file
+                    openFile(m_fileModel->addFile(filePath, qFileName));
+                }
+            });
         }
     }
 }
 
-void CustomDrawer::createFileLabel(
-    const QString& filePath, const QString& fileName, bool shouldAutoOpenFile) const
+void CustomDrawer::onFileClicked(const QModelIndex& index)
 {
-    const auto label = new FilePathLabel(filePath, nullptr);
+    if (index != m_activeFile)
+    {
+        openFile(index.row());
+    }
+}
 
-    connect(label, &FilePathLabel::clicked, this, &CustomDrawer::onFileLabelClick);
+void CustomDrawer::openFile(const int row)
+{
+    const QString filePath = m_fileModel->filePath(row);
+    if (filePath.isEmpty())
+    {
+        return;
+    }
 
-    const auto mainVLayout = qobject_cast<QVBoxLayout*>(layout());
-    mainVLayout->addWidget(label);
+    m_activeFile = m_fileModel->index(row);
+    m_fileList->setCurrentIndex(m_activeFile);
 
-    if (!filePath.isEmpty())
+    // Update the editor
+    if (editor)
     {
-        openFilePath(label, filePath, fileName);
-
-        if (shouldAutoOpenFile)
-        {
-            // updated the side panel to show this as the newly active file
-            emit label->clicked();
-        }
+        editor->openAndParseFile(filePath, QFile::OpenModeFlag::ReadWrite);
     }
 }
 
-void CustomDrawer::openFilePath(FilePathLabel* label, const QString& filePath, const QString& fileName)
+void CustomDrawer::windowShown()
 {
-    if (!filePath.isEmpty())
+    if (m_windowShown)
     {
-        label->setText(fileName);
-
-        QFile file(filePath);
-        file.close();
+        return;
     }
+
+    // One turn of the event loop, so the window paints before the file is read.
+    QTimer::singleShot(0, this, [this]
+    {
+        m_windowShown = true;
+        openFirstFile();
+    });
 }
 
-void CustomDrawer::onFileLabelClick()
+void CustomDrawer::openFirstFile()
 {
-    QObject* senderObj = sender();
-    const QObject* activeItem = state.activeFileLabel;
-    if (activeItem == senderObj)
+    // Once, when the window is up and the first page is checked; not if a file is open already.
+    if (m_openedFirstFile || !m_windowShown)
     {
-        // do nothing.
         return;
     }
-
-    if (activeItem != nullptr)
+    if (m_activeFile.isValid())
     {
-        if (const auto prevActiveLabel = dynamic_cast<FilePathLabel*>(state.activeFileLabel); prevActiveLabel !=
-            nullptr)
-        {
-            prevActiveLabel->reset();
-        }
+        m_openedFirstFile = true;
+        return;
     }
 
-    // update active label
-    if (
-        const auto label = dynamic_cast<FilePathLabel*>(senderObj);
-        label != nullptr
-    )
+    if (m_fileModel->rowCount() == 0)
     {
-        // sets active label css
-        label->activeLabel();
-
-        setActive(label);
-
-        // Update the editor
-        if (editor)
+        // Every file listed so far is gone; the next page may have one that is not. The view
+        // would only ask for it once the drawer is open.
+        if (m_fileModel->canFetchMore({}))
         {
-            editor->openAndParseFile(label->getFilePath(), QFile::OpenModeFlag::ReadWrite);
+            m_fileModel->fetchMore({});
         }
+        return;
     }
-}
-
-void CustomDrawer::setActive(QWidget* pLabel)
-{
-    state.activeFileLabel = pLabel;
-}
-
-void CustomDrawer::showPreviouslyOpenedFiles() const
-{
-    auto previousOpenedFiles = database::findPreviouslyOpenedFiles();
 
-    bool isFirstTime = true;
-    for (const auto file : previousOpenedFiles)
+    // Missing files are removed when the check on the thread pool comes back; the first row
+    // left after that is the first file that still exists.
+    if (!m_fileModel->isChecked(0))
     {
-        try
-        {
-            createFileLabel(file->getFilePath(), file->getFileName(), isFirstTime);
-
-            if (isFirstTime)
-            {
-                isFirstTime = false;
-            }
-        }
-        catch (...)
-        {
-            database::deleteRow(file->getFilePath());
-        }
+        return;
     }
+    m_openedFirstFile = true;
+
+    TraceSpan span("CustomDrawer::openFirstFile");
+    openFile(0);
 }
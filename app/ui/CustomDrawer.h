@@ -30,25 +30,23 @@
 
 #include <QWidget>
 #include <QGridLayout>
+#include <QPersistentModelIndex>
 #include "editor/Editor.h"
-#include "FilePathLabel.h"
 
 class QPushButton;
-
-struct drawerState {
-	QWidget *activeFileLabel;
-};
+class QListView;
+class FileListModel;
 
 class CustomDrawer : public QWidget {
 Q_OBJECT
 
-	void setActive(QWidget *pLabel);
-
 private slots:
 
 	void onAddButtonClicked();
 
-	void onFileLabelClick();
+	void onFileClicked(const QModelIndex &index);
+
+	void openFirstFile();
 
 public:
 	enum DrawerMeasurements {
@@ -62,18 +60,22 @@ public:
 	// smart pointer will be cleaned up.
 	~CustomDrawer() override = default;
 
-	void showPreviouslyOpenedFiles() const;
+	// Called by the window once it is shown; the first file is opened after that,
+	// so reading it does not hold up the first paint.
+	void windowShown();
 
 private:
 	Editor *editor;
 	std::unique_ptr<QPushButton> addFile;
 	std::unique_ptr<QVBoxLayout> pLayout;
 
-	struct drawerState state = {.activeFileLabel = nullptr};
-
-	static void openFilePath(FilePathLabel *label, const QString &filePath, const QString &fileName);
+	FileListModel *m_fileModel = nullptr;
+	QListView *m_fileList = nullptr;
+	QPersistentModelIndex m_activeFile;
+	bool m_windowShown = false;
+	bool m_openedFirstFile = false;
 
-	void createFileLabel(const QString &filePath, const QString &fileName, bool shouldAutoOpenFile) const;
+	void openFile(int row);
 };
 
 
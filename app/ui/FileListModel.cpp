@@ -0,0 +1,184 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "FileListModel.h"
+
+#include <filesystem>
+
+#include <QCoreApplication>
+#include <QPointer>
+#include <QThreadPool>
+
+#include "database/db_conn.h"
+
+FileListModel::FileListModel(QObject* parent) : QAbstractListModel(parent)
+{
+}
+
+int FileListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_entries.size());
+}
+
+QVariant FileListModel::data(const QModelIndex& index, const int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.size())
+    {
+        return {};
+    }
+
+    const Entry& entry = m_entries.at(index.row());
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        return entry.fileName;
+    case Qt::ToolTipRole:
+    case FilePathRole:
+        return entry.filePath;
+    default:
+        return {};
+    }
+}
+
+bool FileListModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && !m_atEnd && !m_loading;
+}
+
+void FileListModel::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent))
+    {
+        return;
+    }
+
+    m_loading = true;
+    database::findPreviouslyOpenedFiles(m_lastId, PAGE_ROWS, this, [this](database::FilesPage page)
+    {
+        m_loading = false;
+        m_lastId = page.lastId;
+        m_atEnd = page.files.size() < PAGE_ROWS;
+
+        QList<Entry> entries;
+        QStringList filePaths;
+        for (FileObject& file : page.files)
+        {
+            if (QString filePath = file.getFilePath(); !m_listed.contains(filePath))
+            {
+                m_listed.insert(filePath);
+                filePaths.append(filePath);
+                entries.append({std::move(filePath), file.getFileName()});
+            }
+        }
+
+        if (!entries.isEmpty())
+        {
+            const int first = static_cast<int>(m_entries.size());
+            beginInsertRows({}, first, first + static_cast<int>(entries.size()) - 1);
+            m_entries.append(std::move(entries));
+            endInsertRows();
+        }
+
+        checkExistence(std::move(filePaths));
+    });
+}
+
+int FileListModel::addFile(const QString& filePath, const QString& fileName)
+{
+    if (m_listed.contains(filePath))
+    {
+        for (int row = 0; row < m_entries.size(); ++row)
+        {
+            if (m_entries.at(row).filePath == filePath)
+            {
+                return row;
+            }
+        }
+    }
+
+    const int row = static_cast<int>(m_entries.size());
+    beginInsertRows({}, row, row);
+    m_entries.append({filePath, fileName, true});
+    m_listed.insert(filePath);
+    endInsertRows();
+    return row;
+}
+
+QString FileListModel::filePath(const int row) const
+{
+    return row >= 0 && row < m_entries.size() ? m_entries.at(row).filePath : QString();
+}
+
+bool FileListModel::isChecked(const int row) const
+{
+    return row >= 0 && row < m_entries.size() && m_entries.at(row).checked;
+}
+
+void FileListModel::checkExistence(QStringList filePaths)
+{
+    if (filePaths.isEmpty())
+    {
+        emit pageChecked();
+        return;
+    }
+
+    // A path on a slow or disconnected share can take seconds to answer; not on this thread.
+    QThreadPool::globalInstance()->start([model = QPointer<FileListModel>(this), filePaths = std::move(filePaths)]
+    {
+        QStringList missing;
+        for (const QString& filePath : filePaths)
+        {
+            // An error (no permission, share offline) is not an answer; the row stays.
+            if (std::error_code error; !std::filesystem::exists(filePath.toStdWString(), error) && !error)
+            {
+                missing.append(filePath);
+            }
+        }
+
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [model, filePaths, missing]
+        {
+            if (model)
+            {
+                model->onExistenceChecked(filePaths, missing);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void FileListModel::onExistenceChecked(const QStringList& filePaths, const QStringList& missing)
+{
+    removeMissing(missing);
+
+    // What is left of the page exists, or could not be checked and stays listed anyway.
+    const QSet<QString> checked(filePaths.begin(), filePaths.end());
+    for (Entry& entry : m_entries)
+    {
+        if (checked.contains(entry.filePath))
+        {
+            entry.checked = true;
+        }
+    }
+
+    emit pageChecked();
+}
+
+void FileListModel::removeMissing(const QStringList& filePaths)
+{
+    for (const QString& filePath : filePaths)
+    {
+        database::deleteRow(filePath);
+        m_listed.remove(filePath);
+
+        for (int row = 0; row < m_entries.size(); ++row)
+        {
+            if (m_entries.at(row).filePath == filePath)
+            {
+                beginRemoveRows({}, row, row);
+                m_entries.removeAt(row);
+                endRemoveRows();
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef FILE_LIST_MODEL_H
+#define FILE_LIST_MODEL_H
+
+#include <QAbstractListModel>
+#include <QSet>
+
+/**
+ * The drawer's previously opened files. Rows come from the database a page at a time through
+ * canFetchMore()/fetchMore(), so the drawer paints before the whole table is read, and the
+ * view asks for the next page only as it scrolls.
+ *
+ * Each page is shown as soon as it arrives; whether its files still exist is checked on the
+ * thread pool, and the rows of files that are gone are removed (and deleted from the table)
+ * when the answer comes back. The rows left are then marked as checked.
+ */
+class FileListModel final : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles
+    {
+        FilePathRole = Qt::UserRole + 1,
+    };
+
+    explicit FileListModel(QObject* parent = nullptr);
+
+    [[nodiscard]] int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    [[nodiscard]] QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    [[nodiscard]] bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    // Appends a file that was just added to the table; returns its row. A file already
+    // listed is not added twice.
+    int addFile(const QString& filePath, const QString& fileName);
+
+    [[nodiscard]] QString filePath(int row) const;
+
+    // Whether the file of row has passed the existence check; rows added with addFile() have.
+    [[nodiscard]] bool isChecked(int row) const;
+
+signals:
+    // After the existence check of a page is back and its missing rows are gone, so the first
+    // rows can be acted on without waiting for the rest.
+    void pageChecked();
+
+private:
+    static constexpr int PAGE_ROWS = 64;
+
+    struct Entry
+    {
+        QString filePath;
+        QString fileName;
+        bool checked = false;
+    };
+
+    void checkExistence(QStringList filePaths);
+    void onExistenceChecked(const QStringList& filePaths, const QStringList& missing);
+    void removeMissing(const QStringList& filePaths);
+
+    QList<Entry> m_entries;
+    // Rows added by addFile() come back in a later page too; they are skipped then.
+    QSet<QString> m_listed;
+
+    qint64 m_lastId = 0;
+    bool m_loading = false;
+    bool m_atEnd = false;
+};
+
+#endif // FILE_LIST_MODEL_H
@@ -1,21 +1,35 @@
 #include "ThemeManager.h"
 
+#include <QElapsedTimer>
+#include <QStyleHints>
+
+#include "ThemeStyle.h"
 #include "settings/SettingManager/SettingsManager.h"
+#include "Metrics/Metrics.h"
+#include "Trace/Trace.h"
 
 ThemeManager::ThemeManager(QObject* parent)
-    : QObject(parent)
+    : QObject(parent),
+      m_preference(SettingsManager::singleton().settings().theme), // retrieve theme from user preference
+      m_currentTheme(Dark),
+      m_style(new ThemeStyle())
 {
-    SettingsManager settingsManager{};
-    // retrieve theme from user preference
-    m_currentTheme = settingsManager.loadSettings().theme;
+    // The style draws the app's look from the palette, so a theme is a palette (applyTheme).
+    QApplication::setStyle(m_style);
+    QApplication::setFont(QFont({"Segoe UI", "Roboto", "Helvetica Neue", "Arial", "sans-serif"}, 10));
 
-    // Install THIS ThemeManager instance as an event filter on the QApplication object.
-    // This allows its eventFilter() method to intercept events sent to qApp.
-    qApp->installEventFilter(this); // CRUCIAL: Install self as filter on qApp
+    connect(&SettingsManager::singleton(), &SettingsManager::themeChanged, this, &ThemeManager::setAppTheme);
+    connect(QGuiApplication::styleHints(), &QStyleHints::colorSchemeChanged, this, [this]
+    {
+        if (m_preference == SystemDefault)
+        {
+            applyTheme(systemTheme());
+        }
+    });
 
-    qDebug() << "Theme: " << m_currentTheme;
+    qDebug() << "Theme: " << m_preference;
     // Set initial theme based on system or preference
-    setAppTheme(m_currentTheme); // default theme is Dark
+    setAppTheme(m_preference); // default theme is Dark
 }
 
 ThemeManager& ThemeManager::instance()
@@ -24,90 +38,36 @@ ThemeManager& ThemeManager::instance()
     return manager;
 }
 
-void ThemeManager::updateStyleSheet(const AppTheme theme, const QString& stylePath)
-{
-    if (QFile styleFile(stylePath); styleFile.open(QFile::ReadOnly | QFile::Text))
-    {
-        const QString style = styleFile.readAll();
-        qApp->setStyleSheet(style);
-        styleFile.close();
-        m_currentTheme = theme;
-        qDebug() << "Application theme set to:" << (theme == Dark ? "Dark" : "Light");
-        emit themeChanged(m_currentTheme);
-    }
-    else
-    {
-        qWarning() << "Failed to load stylesheet:" << stylePath;
-    }
-}
-
-void ThemeManager::setAppTheme(const AppTheme theme)
+void ThemeManager::applyTheme(const AppTheme theme)
 {
-    // Important: Only apply stylesheet if it's a different theme
-    if (m_currentTheme == theme && !qApp->styleSheet().isEmpty())
+    if (m_applied && m_currentTheme == theme)
     {
         return;
     }
 
-    QString stylePath;
-    switch (theme)
-    {
-    case Light:
-        stylePath = ":/styles/light_theme.qss";
-        m_currentTheme = Light;
-        break;
-    case Dark:
-        stylePath = ":/styles/dark_theme.qss";
-        m_currentTheme = Dark;
-        break;
-    case SystemDefault:
-        const AppTheme detectedTheme = getThemeFromPalette(qApp->palette());
-        stylePath = detectedTheme == Light ? ":/styles/light_theme.qss" : ":/styles/dark_theme.qss";
-        m_currentTheme = detectedTheme;
-        updateStyleSheet(detectedTheme, stylePath);
-        break;
-    }
+    TraceSpan span("ThemeManager::applyTheme");
+    QElapsedTimer timer;
+    timer.start();
 
-    if (theme != SystemDefault) updateStyleSheet(theme, stylePath);
+    // Widgets only see a PaletteChange and repaint; nothing is re-polished or laid out again.
+    m_style->setTheme(theme);
+    QApplication::setPalette(m_style->standardPalette());
+
+    m_currentTheme = theme;
+    m_applied = true;
+    Metrics::singleton().record("theme.switch_ms", static_cast<double>(timer.nsecsElapsed()) / 1e6);
+    qDebug() << "Application theme set to:" << (theme == Dark ? "Dark" : "Light");
+    emit themeChanged(m_currentTheme);
 }
 
-bool ThemeManager::eventFilter(QObject* watched, QEvent* event)
+void ThemeManager::setAppTheme(const AppTheme theme)
 {
-    // Check if the event is for the QApplication object itself
-    if (watched == qApp && event->type() == QEvent::ApplicationPaletteChange)
-    {
-        qDebug() << "Event filter caught QEvent::ApplicationPaletteChange!";
-
-        SettingsManager settings{};
-
-        if (const auto currentTheme = settings.loadSettings().theme; currentTheme != SystemDefault)
-        {
-            return false;
-        }
-
-        if (const AppTheme detectedTheme = getThemeFromPalette(qApp->palette()); detectedTheme != m_currentTheme)
-        {
-            qDebug() << "System palette changed. Detected new theme:" << (
-                detectedTheme == Dark ? "Dark" : "Light");
-            setAppTheme(detectedTheme); // Apply the detected theme
-        }
-        return true; // Event handled, stop propagation
-    }
-    // For other events or if not watching qApp, pass to base class eventFilter
-    return QObject::eventFilter(watched, event);
+    m_preference = theme;
+    applyTheme(theme == SystemDefault ? systemTheme() : theme);
 }
 
-// Helper function to determine theme from palette (remains the same)
-AppTheme ThemeManager::getThemeFromPalette(const QPalette& palette)
+AppTheme ThemeManager::systemTheme()
 {
-    const QColor windowColor = palette.color(QPalette::Window);
-    const double luminance = (0.2126 * windowColor.red() +
-        0.7152 * windowColor.green() +
-        0.0722 * windowColor.blue()) / 255.0;
-
-    if (constexpr double DARK_THEME_LUMINANCE_THRESHOLD = 0.3; luminance < DARK_THEME_LUMINANCE_THRESHOLD)
-    {
-        return Dark;
-    }
-    return Light;
+    // Not the palette: the app sets its own.
+    return QGuiApplication::styleHints()->colorScheme() == Qt::ColorScheme::Light ? Light : Dark;
 }
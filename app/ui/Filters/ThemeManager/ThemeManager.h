@@ -8,6 +8,8 @@
 #include <QPalette>
 #include <QEvent>
 
+class ThemeStyle;
+
 enum AppTheme {
     Light,
     Dark,
@@ -19,26 +21,30 @@ class ThemeManager final : public QObject
     Q_OBJECT
 public:
     static ThemeManager& instance();
-    void updateStyleSheet(AppTheme theme, const QString& stylePath);
 
+    // theme is the user's preference; SystemDefault follows the system palette from then on.
     void setAppTheme(AppTheme theme);
     AppTheme currentTheme() const { return m_currentTheme; }
-    static AppTheme getThemeFromPalette(const QPalette &palette);
 
     signals:
         void themeChanged(AppTheme theme);
 
-protected:
-    // This is the method that will be called when an event is filtered.
-    // It's part of the QEventFilter interface.
-    bool eventFilter(QObject *watched, QEvent *event) override;
-
 private:
     explicit ThemeManager(QObject *parent = nullptr);
     ThemeManager(const ThemeManager&) = delete;
     ThemeManager& operator=(const ThemeManager&) = delete;
 
+    // Light or Dark: applies its palette unless it is already the one in use.
+    void applyTheme(AppTheme theme);
+
+    // Light or Dark, as the system's color scheme is; Dark when it is not known.
+    static AppTheme systemTheme();
+
+    // What the user picked, as last set.
+    AppTheme m_preference;
     AppTheme m_currentTheme;
+    bool m_applied = false;
+    ThemeStyle* m_style; // owned by the application
 };
 
 #endif // THEME_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,551 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "ThemeStyle.h"
+
+#include <algorithm>
+
+#include <QAbstractItemView>
+#include <QFrame>
+#include <QLabel>
+#include <QMenu>
+#include <QPainter>
+#include <QPushButton>
+#include <QStatusBar>
+#include <QStyleFactory>
+#include <QStyleOption>
+
+// The colors of the Material Design sheets the themes used to be (dark_theme.qss,
+// light_theme.qss). Those with a palette role are drawn through it.
+struct ThemeColors
+{
+    QColor window;
+    QColor panel; // side panels and item views
+    QColor surface; // editors, menus, tool and status bars
+    QColor text;
+    QColor buttonText;
+    QColor mutedText; // placeholders, line numbers, disabled text
+    QColor border;
+    QColor separator;
+    QColor frameBorder; // around the main window; none when invalid
+    QColor primary;
+    QColor primaryHover;
+    QColor primaryPressed;
+    QColor selection;
+    QColor hover; // over transparent buttons
+    QColor pressed;
+    QColor danger; // the close button
+    QColor dangerPressed;
+    QColor handle; // scroll bar handle
+    QColor handleHover;
+};
+
+namespace
+{
+    const ThemeColors DARK_COLORS{
+        .window = QColor(0x232323),
+        .panel = QColor(0x333333),
+        .surface = QColor(0x333333),
+        .text = QColor(0xE0E0E0),
+        .buttonText = QColor(0xFFFFFF),
+        .mutedText = QColor(0xBBBBBB),
+        .border = QColor(0x4A4A4A),
+        .separator = QColor(0x555555),
+        .frameBorder = QColor(0x00BCD4),
+        .primary = QColor(0x2196F3),
+        .primaryHover = QColor(0x1976D2),
+        .primaryPressed = QColor(0x1565C0),
+        .selection = QColor(0x00568B),
+        .hover = QColor(255, 255, 255, 20),
+        .pressed = QColor(255, 255, 255, 38),
+        .danger = QColor(0xE5533D),
+        .dangerPressed = QColor(0xC2402B),
+        .handle = QColor(0x606060),
+        .handleHover = QColor(0x707070),
+    };
+
+    const ThemeColors LIGHT_COLORS{
+        .window = QColor(0xF5F5F5),
+        .panel = QColor(0xF5F5F5),
+        .surface = QColor(0xFFFFFF),
+        .text = QColor(0x212121),
+        .buttonText = QColor(0x212121),
+        .mutedText = QColor(0x9E9E9E),
+        .border = QColor(0xDCDCDC),
+        .separator = QColor(0xE0E0E0),
+        .frameBorder = QColor(),
+        .primary = QColor(0x2196F3),
+        .primaryHover = QColor(0x1E88E5),
+        .primaryPressed = QColor(0x1976D2),
+        .selection = QColor(0x2196F3),
+        .hover = QColor(0, 0, 0, 13),
+        .pressed = QColor(0, 0, 0, 26),
+        .danger = QColor(0xE5533D),
+        .dangerPressed = QColor(0xC2402B),
+        .handle = QColor(0xC0C0C0),
+        .handleHover = QColor(0xA0A0A0),
+    };
+
+    // Title bar and tool buttons: larger glyphs, 5px padding, square corners.
+    bool isIconButton(const QString& name)
+    {
+        return name == "folderButton" || name == "outputConsoleButton" || name == "settingGearButton" ||
+            name == "AddFile" || name == "minimizeButton" || name == "fileMenuButton" ||
+            name == "maximizeButton" || name == "closeButton";
+    }
+
+    QString objectName(const QWidget* widget)
+    {
+        return widget ? widget->objectName() : QString();
+    }
+
+    void fillRounded(QPainter* painter, const QRect& rect, const QColor& color, const qreal radius)
+    {
+        painter->save();
+        painter->setRenderHint(QPainter::Antialiasing);
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(color);
+        painter->drawRoundedRect(QRectF(rect), radius, radius);
+        painter->restore();
+    }
+}
+
+ThemeStyle::ThemeStyle()
+    : QProxyStyle(QStyleFactory::create("Fusion")),
+      m_colors(&DARK_COLORS)
+{
+}
+
+void ThemeStyle::setTheme(const AppTheme theme)
+{
+    m_colors = theme == Light ? &LIGHT_COLORS : &DARK_COLORS;
+}
+
+QPalette ThemeStyle::standardPalette() const
+{
+    const ThemeColors& colors = *m_colors;
+    QPalette palette;
+    palette.setColor(QPalette::Window, colors.window);
+    palette.setColor(QPalette::WindowText, colors.text);
+    palette.setColor(QPalette::Base, colors.surface);
+    palette.setColor(QPalette::AlternateBase, colors.panel);
+    palette.setColor(QPalette::Text, colors.text);
+    palette.setColor(QPalette::Button, colors.panel);
+    palette.setColor(QPalette::ButtonText, colors.buttonText);
+    palette.setColor(QPalette::BrightText, Qt::white);
+    palette.setColor(QPalette::Light, colors.mutedText);
+    palette.setColor(QPalette::Mid, colors.border);
+    palette.setColor(QPalette::Dark, colors.separator);
+    palette.setColor(QPalette::Highlight, colors.selection);
+    palette.setColor(QPalette::HighlightedText, Qt::white);
+    palette.setColor(QPalette::Link, colors.primary);
+    palette.setColor(QPalette::PlaceholderText, colors.mutedText);
+    palette.setColor(QPalette::ToolTipBase, colors.surface);
+    palette.setColor(QPalette::ToolTipText, colors.text);
+    palette.setColor(QPalette::Disabled, QPalette::WindowText, colors.mutedText);
+    palette.setColor(QPalette::Disabled, QPalette::Text, colors.mutedText);
+    palette.setColor(QPalette::Disabled, QPalette::ButtonText, colors.mutedText);
+    return palette;
+}
+
+void ThemeStyle::polish(QWidget* widget)
+{
+    QProxyStyle::polish(widget);
+
+    // Runs once per widget, not on theme switches, so only what both themes share is set here.
+    const QString name = widget->objectName();
+    if (name == "Frame" || name == "leftPanel" || name == "rightPanel" || name == "EditorMargin" ||
+        qobject_cast<QStatusBar*>(widget))
+    {
+        widget->setAttribute(Qt::WA_StyledBackground); // painted as PE_Widget
+    }
+
+    if (isIconButton(name) && qobject_cast<QPushButton*>(widget))
+    {
+        QFont font = widget->font();
+        font.setPointSize(name == "settingGearButton" ? 18 : 12);
+        if (name == "settingGearButton")
+        {
+            font.setWeight(QFont::Black);
+        }
+        widget->setFont(font);
+    }
+    else if (name == "HeaderLabel" && qobject_cast<QLabel*>(widget))
+    {
+        QFont font = widget->font();
+        font.setBold(true);
+        widget->setFont(font);
+        widget->setContentsMargins(2, 2, 2, 5);
+    }
+
+    if (auto* menu = qobject_cast<QMenu*>(widget))
+    {
+        menu->setMinimumWidth(300); // QMenu sizes its items to this, not to CT_Menu
+    }
+
+    if (auto* view = qobject_cast<QAbstractItemView*>(widget))
+    {
+        view->viewport()->setBackgroundRole(QPalette::AlternateBase);
+    }
+}
+
+int ThemeStyle::pixelMetric(const PixelMetric metric, const QStyleOption* option, const QWidget* widget) const
+{
+    switch (metric)
+    {
+    case PM_ScrollBarExtent:
+        return 12;
+    case PM_ScrollBarSliderMin:
+        return 20;
+    case PM_ToolBarItemSpacing:
+        return 5;
+    case PM_ToolBarFrameWidth:
+        return 2;
+    default:
+        return QProxyStyle::pixelMetric(metric, option, widget);
+    }
+}
+
+QSize ThemeStyle::sizeFromContents(const ContentsType type, const QStyleOption* option, const QSize& size,
+                                   const QWidget* widget) const
+{
+    if (type == CT_PushButton)
+    {
+        if (const auto* button = qstyleoption_cast<const QStyleOptionButton*>(option))
+        {
+            const QString name = objectName(widget);
+            QSize padding(24, 8);
+            if (isIconButton(name))
+            {
+                padding = QSize(5, 5);
+            }
+            else if ((button->features & QStyleOptionButton::Flat) || name == "TextButton" || name == "CodeRunner")
+            {
+                padding = QSize(0, 0);
+            }
+            return size + 2 * padding;
+        }
+    }
+
+    // Menus only: Fusion also draws combo box popups as menu items.
+    if (type == CT_MenuItem && qobject_cast<const QMenu*>(widget))
+    {
+        if (const auto* item = qstyleoption_cast<const QStyleOptionMenuItem*>(option))
+        {
+            if (item->menuItemType == QStyleOptionMenuItem::Separator)
+            {
+                return {size.width(), 9};
+            }
+            const QString text = QString(item->text).replace('\t', QStringLiteral("    "));
+            return {item->fontMetrics.horizontalAdvance(text) + 30, item->fontMetrics.height() + 16};
+        }
+    }
+
+    return QProxyStyle::sizeFromContents(type, option, size, widget);
+}
+
+QRect ThemeStyle::subControlRect(const ComplexControl control, const QStyleOptionComplex* option,
+                                 const SubControl subControl, const QWidget* widget) const
+{
+    // Scroll bars have no arrow buttons: the handle travels the whole groove.
+    if (control == CC_ScrollBar)
+    {
+        if (const auto* bar = qstyleoption_cast<const QStyleOptionSlider*>(option))
+        {
+            const QRect rect = bar->rect;
+            const bool horizontal = bar->orientation == Qt::Horizontal;
+            const int length = horizontal ? rect.width() : rect.height();
+            const int range = bar->maximum - bar->minimum;
+
+            int handle = length;
+            if (range > 0)
+            {
+                const int proportional = static_cast<int>(static_cast<qint64>(length) * bar->pageStep /
+                    (range + bar->pageStep));
+                handle = std::max(proxy()->pixelMetric(PM_ScrollBarSliderMin, bar, widget), proportional);
+            }
+            handle = std::min(handle, length);
+            const int position = sliderPositionFromValue(bar->minimum, bar->maximum, bar->sliderPosition,
+                                                         length - handle, bar->upsideDown);
+
+            const auto span = [&](const int start, const int extent)
+            {
+                return horizontal
+                           ? QRect(rect.x() + start, rect.y(), extent, rect.height())
+                           : QRect(rect.x(), rect.y() + start, rect.width(), extent);
+            };
+            switch (subControl)
+            {
+            case SC_ScrollBarGroove:
+                return rect;
+            case SC_ScrollBarSlider:
+                return span(position, handle);
+            case SC_ScrollBarSubPage:
+                return span(0, position);
+            case SC_ScrollBarAddPage:
+                return span(position + handle, length - position - handle);
+            default:
+                return {};
+            }
+        }
+    }
+
+    return QProxyStyle::subControlRect(control, option, subControl, widget);
+}
+
+void ThemeStyle::drawPrimitive(const PrimitiveElement element, const QStyleOption* option, QPainter* painter,
+                               const QWidget* widget) const
+{
+    const ThemeColors& colors = *m_colors;
+    const QPalette& palette = option->palette;
+    const QRect& rect = option->rect;
+
+    switch (element)
+    {
+    case PE_Widget:
+        {
+            const QString name = objectName(widget);
+            if (name == "Frame")
+            {
+                painter->fillRect(rect, palette.color(QPalette::Window));
+                if (colors.frameBorder.isValid())
+                {
+                    painter->save();
+                    painter->setPen(colors.frameBorder);
+                    painter->drawRect(rect.adjusted(0, 0, -1, -1));
+                    painter->restore();
+                }
+                return;
+            }
+            if (name == "leftPanel" || name == "rightPanel")
+            {
+                painter->fillRect(rect, palette.color(QPalette::AlternateBase));
+                return;
+            }
+            if (name == "EditorMargin")
+            {
+                painter->fillRect(rect, palette.color(QPalette::Base));
+                return;
+            }
+            if (qobject_cast<const QStatusBar*>(widget))
+            {
+                painter->fillRect(rect, palette.color(QPalette::Base));
+                painter->save();
+                painter->setPen(palette.color(QPalette::Mid));
+                painter->drawLine(rect.topLeft(), rect.topRight());
+                painter->restore();
+                return;
+            }
+            break;
+        }
+    case PE_Frame:
+    case PE_FrameLineEdit:
+        painter->save();
+        painter->setPen(option->state & State_HasFocus ? colors.primary : palette.color(QPalette::Mid));
+        painter->setBrush(Qt::NoBrush);
+        painter->drawRect(rect.adjusted(0, 0, -1, -1));
+        painter->restore();
+        return;
+    case PE_PanelLineEdit:
+        if (const auto* panel = qstyleoption_cast<const QStyleOptionFrame*>(option); panel && panel->lineWidth > 0)
+        {
+            painter->fillRect(rect, palette.color(QPalette::Base));
+            proxy()->drawPrimitive(PE_FrameLineEdit, option, painter, widget);
+            return;
+        }
+        break;
+    case PE_PanelMenu:
+        painter->fillRect(rect, palette.color(QPalette::Base));
+        return;
+    case PE_FrameMenu:
+        painter->save();
+        painter->setPen(palette.color(QPalette::Mid));
+        painter->drawRect(rect.adjusted(0, 0, -1, -1));
+        painter->restore();
+        return;
+    case PE_PanelToolBar:
+        painter->fillRect(rect, palette.color(QPalette::Base));
+        painter->save();
+        painter->setPen(palette.color(QPalette::Mid));
+        painter->drawLine(rect.bottomLeft(), rect.bottomRight());
+        painter->restore();
+        return;
+    case PE_IndicatorToolBarSeparator:
+        painter->save();
+        painter->setPen(palette.color(QPalette::Dark));
+        if (option->state & State_Horizontal)
+        {
+            painter->drawLine(rect.center().x(), rect.top() + 4, rect.center().x(), rect.bottom() - 4);
+        }
+        else
+        {
+            painter->drawLine(rect.left() + 4, rect.center().y(), rect.right() - 4, rect.center().y());
+        }
+        painter->restore();
+        return;
+    case PE_PanelButtonTool:
+        if (option->state & (State_Sunken | State_On))
+        {
+            fillRounded(painter, rect, colors.pressed, 4);
+        }
+        else if ((option->state & State_MouseOver) && (option->state & State_Enabled))
+        {
+            fillRounded(painter, rect, colors.hover, 4);
+        }
+        return;
+    case PE_FrameFocusRect:
+        if (qobject_cast<const QPushButton*>(widget))
+        {
+            return; // flat buttons show focus by nothing but the keyboard
+        }
+        break;
+    default:
+        break;
+    }
+
+    QProxyStyle::drawPrimitive(element, option, painter, widget);
+}
+
+void ThemeStyle::drawControl(const ControlElement element, const QStyleOption* option, QPainter* painter,
+                             const QWidget* widget) const
+{
+    const ThemeColors& colors = *m_colors;
+    const QString name = objectName(widget);
+
+    switch (element)
+    {
+    case CE_PushButtonBevel:
+        {
+            // Transparent with a tint on hover and press; primary and close buttons are colored.
+            const bool hovered = (option->state & State_MouseOver) && (option->state & State_Enabled);
+            const bool down = option->state & (State_Sunken | State_On);
+            QColor fill;
+            if (name == "PrimaryButton")
+            {
+                fill = down ? colors.primaryPressed : hovered ? colors.primaryHover : colors.primary;
+            }
+            else if (name == "closeButton")
+            {
+                fill = down ? colors.dangerPressed : hovered ? colors.danger : QColor();
+            }
+            else if (name != "CodeRunner")
+            {
+                fill = down ? colors.pressed : hovered ? colors.hover : QColor();
+            }
+
+            if (fill.isValid())
+            {
+                const bool square = isIconButton(name) || name == "TextButton";
+                fillRounded(painter, option->rect, fill, square ? 0 : 4);
+            }
+            return;
+        }
+    case CE_PushButtonLabel:
+        if (const auto* button = qstyleoption_cast<const QStyleOptionButton*>(option))
+        {
+            QStyleOptionButton label(*button);
+            label.state &= ~(State_Sunken | State_On); // the label does not shift when pressed
+            if (name == "PrimaryButton" || (name == "closeButton" && (option->state & (State_MouseOver | State_Sunken))))
+            {
+                label.palette.setColor(QPalette::ButtonText, Qt::white);
+            }
+            else if ((button->features & QStyleOptionButton::Flat) || name == "TextButton")
+            {
+                label.palette.setColor(QPalette::ButtonText, button->palette.color(QPalette::WindowText));
+            }
+            QProxyStyle::drawControl(element, &label, painter, widget);
+            return;
+        }
+        break;
+    case CE_ShapedFrame:
+        // Separator lines are a single border-colored pixel.
+        if (const auto* frame = qstyleoption_cast<const QStyleOptionFrame*>(option);
+            frame && (frame->frameShape == QFrame::HLine || frame->frameShape == QFrame::VLine))
+        {
+            const QRect& rect = frame->rect;
+            painter->save();
+            painter->setPen(frame->palette.color(QPalette::Mid));
+            if (frame->frameShape == QFrame::HLine)
+            {
+                painter->drawLine(rect.left(), rect.center().y(), rect.right(), rect.center().y());
+            }
+            else
+            {
+                painter->drawLine(rect.center().x(), rect.top(), rect.center().x(), rect.bottom());
+            }
+            painter->restore();
+            return;
+        }
+        break;
+    case CE_MenuItem:
+        // The app's menus hold plain actions: text and an optional shortcut.
+        if (const auto* item = qstyleoption_cast<const QStyleOptionMenuItem*>(option);
+            item && qobject_cast<const QMenu*>(widget))
+        {
+            const QRect& row = item->rect;
+            painter->save();
+            if (item->menuItemType == QStyleOptionMenuItem::Separator)
+            {
+                painter->setPen(item->palette.color(QPalette::Dark));
+                painter->drawLine(row.left(), row.center().y(), row.right(), row.center().y());
+            }
+            else
+            {
+                const bool enabled = item->state & State_Enabled;
+                const bool selected = enabled && (item->state & State_Selected);
+                if (selected)
+                {
+                    painter->fillRect(row, colors.primary);
+                }
+
+                const QPalette::ColorRole role = selected ? QPalette::HighlightedText : QPalette::Text;
+                const int flags = Qt::AlignVCenter | Qt::TextShowMnemonic | Qt::TextSingleLine;
+                const QRect textRect = row.adjusted(10, 0, -20, 0);
+                const qsizetype tab = item->text.indexOf('\t');
+                proxy()->drawItemText(painter, textRect, flags | Qt::AlignLeft, item->palette, enabled,
+                                      item->text.left(tab), role);
+                if (tab >= 0)
+                {
+                    proxy()->drawItemText(painter, textRect, flags | Qt::AlignRight, item->palette, enabled,
+                                          item->text.mid(tab + 1), role);
+                }
+            }
+            painter->restore();
+            return;
+        }
+        break;
+    case CE_SizeGrip:
+        return; // the frameless window resizes from its edges
+    default:
+        break;
+    }
+
+    QProxyStyle::drawControl(element, option, painter, widget);
+}
+
+void ThemeStyle::drawComplexControl(const ComplexControl control, const QStyleOptionComplex* option,
+                                    QPainter* painter, const QWidget* widget) const
+{
+    if (control == CC_ScrollBar)
+    {
+        if (const auto* bar = qstyleoption_cast<const QStyleOptionSlider*>(option))
+        {
+            painter->save();
+            painter->fillRect(bar->rect, bar->palette.color(QPalette::Window));
+            painter->setPen(bar->palette.color(QPalette::Mid));
+            painter->drawRect(bar->rect.adjusted(0, 0, -1, -1));
+            painter->restore();
+
+            if (bar->maximum > bar->minimum)
+            {
+                const QRect handle = proxy()->subControlRect(control, bar, SC_ScrollBarSlider, widget);
+                const bool hot = (bar->activeSubControls & SC_ScrollBarSlider) && (bar->state & State_MouseOver);
+                fillRounded(painter, handle.adjusted(1, 1, -1, -1), hot ? m_colors->handleHover : m_colors->handle, 5);
+            }
+            return;
+        }
+    }
+
+    QProxyStyle::drawComplexControl(control, option, painter, widget);
+}
@@ -0,0 +1,51 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef THEME_STYLE_H
+#define THEME_STYLE_H
+
+#include <QProxyStyle>
+
+#include "ThemeManager.h"
+
+struct ThemeColors;
+
+// The app's look (flat buttons, thin borders, slim scroll bars, the object-named title bar
+// and panel widgets) drawn over Fusion from the palette and the theme's colors. Nothing it
+// sets on a widget depends on the theme, so switching Light/Dark is a new palette and a
+// repaint; a stylesheet re-polishes every widget instead.
+class ThemeStyle final : public QProxyStyle
+{
+    Q_OBJECT
+
+public:
+    ThemeStyle();
+
+    // Light or Dark; takes effect with the next QApplication::setPalette(standardPalette()).
+    void setTheme(AppTheme theme);
+
+    [[nodiscard]] QPalette standardPalette() const override;
+
+    using QProxyStyle::polish;
+    void polish(QWidget* widget) override;
+
+    int pixelMetric(PixelMetric metric, const QStyleOption* option = nullptr,
+                    const QWidget* widget = nullptr) const override;
+    QSize sizeFromContents(ContentsType type, const QStyleOption* option, const QSize& size,
+                           const QWidget* widget) const override;
+    QRect subControlRect(ComplexControl control, const QStyleOptionComplex* option, SubControl subControl,
+                         const QWidget* widget) const override;
+
+    void drawPrimitive(PrimitiveElement element, const QStyleOption* option, QPainter* painter,
+                       const QWidget* widget = nullptr) const override;
+    void drawControl(ControlElement element, const QStyleOption* option, QPainter* painter,
+                     const QWidget* widget = nullptr) const override;
+    void drawComplexControl(ComplexControl control, const QStyleOptionComplex* option, QPainter* painter,
+                            const QWidget* widget = nullptr) const override;
+
+private:
+    const ThemeColors* m_colors;
+};
+
+#endif // THEME_STYLE_H
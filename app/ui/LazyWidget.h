@@ -0,0 +1,53 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef LAZY_WIDGET_H
+#define LAZY_WIDGET_H
+
+#include <functional>
+
+#include <QPointer>
+#include <QTimer>
+
+#include "Trace/Trace.h"
+
+/**
+ * A widget that is built the first time it is asked for, for surfaces that start hidden
+ * (dialogs, panels). The factory parents the widget, which Qt then owns. prewarm() builds it
+ * ahead of time, once the event loop has nothing else to do, so the first use is not slower.
+ */
+template <typename T>
+class LazyWidget
+{
+public:
+    // name is a literal; creation shows up as a trace span under it.
+    LazyWidget(const char* name, std::function<T*()> factory)
+        : m_name(name), m_factory(std::move(factory))
+    {
+    }
+
+    // Creates the widget if needed. Creation counts as const: it is not observable otherwise.
+    T* get() const
+    {
+        if (m_widget.isNull())
+        {
+            TraceSpan span(m_name);
+            m_widget = m_factory();
+        }
+        return m_widget.data();
+    }
+
+    // Creates it once pending events are handled; not at all if context is gone by then.
+    void prewarm(QObject* context) const
+    {
+        QTimer::singleShot(0, context, [this] { get(); });
+    }
+
+private:
+    const char* m_name;
+    std::function<T*()> m_factory;
+    mutable QPointer<T> m_widget;
+};
+
+#endif // LAZY_WIDGET_H
@@ -33,61 +33,82 @@
 #include "AppUi.h"
 #include "AppUi.h"
 
+#include <QProcess>
 #include <QTimer>
 #include <qcoreapplication.h>
 #include <QMouseEvent>
-#include <QSqlError>
 
 #include "buraq.h"
 #include "Config.h"
 #include "PluginManager.h"
 #include "Utils.h"
+#include "Trace/Trace.h"
 #include "clients/VersionClient/VersionRepository.h"
 #include "database/db_conn.h"
+#include "database/db_worker.h"
 #include "dialog/VersionUpdateDialog.h"
 #include "frameless_window/FramelessWindow.h"
-#include "ManagedProcess/ManagedProcess.h"
+#include "ManagedProcess/BridgeSupervisor.h"
+#include "settings/SettingManager/SettingsManager.h"
 
 AppUi::AppUi(QObject* parent) : QObject(parent)
 {
-    // Load configuration settings
-    Config::singleton();
+    // Every step but curl's global init builds widgets, icons or QObjects, which belong on the
+    // GUI thread, so they run in order; each is traced to see where startup time goes.
 
-    // Ensure the singleton (and curl_global_init) is created before threads,
-    // though Meyers singleton handles this.
-    Network::singleton(); // Initialize network singleton if not already.
+    // The bridge takes a while to boot; let it start while the rest of the UI is built.
+    {
+        TraceSpan span("AppUi::initPSLangSupport");
+        initPSLangSupport();
+    }
+
+    // Load configuration settings. Compiled in, so this is only the icons.
+    {
+        TraceSpan span("Config::singleton");
+        Config::singleton();
+    }
 
-    using file_utils::file_log;
-    if (!database::db_conn())
+    // curl_global_init, before any thread uses curl.
     {
-        file_log("db_conn() EXIT_FAILURE..");
-        // failed to connect to the database
-        // return EXIT_FAILURE;
+        TraceSpan span("Network::singleton");
+        Network::singleton();
     }
 
-    // Initialize the database:
-    if (const QSqlError err = database::init_db(); err.type() != QSqlError::NoError)
+    // Starts the database thread, which creates the tables itself.
     {
-        file_log("Error executing initializing db:" + err.text().toStdString());
-        // return EXIT_FAILURE;
+        TraceSpan span("database::db_conn");
+        if (!database::db_conn())
+        {
+            file_utils::file_log(LogLevel::Error, "db_conn() EXIT_FAILURE..");
+        }
     }
 
     // user's home dir should be the default location when the app starts.
     // In the later release, save user's last dir/path
     std::filesystem::current_path(ItoolsNS::get_user_home_directory());
 
-    // Init application views
-    initAppLayout();
-
     // init app's file system
-    initAppContext();
+    {
+        TraceSpan span("AppUi::initAppContext");
+        initAppContext();
+    }
+
+    // Init application views; they keep their data under the app context's paths.
+    {
+        TraceSpan span("AppUi::initAppLayout");
+        initAppLayout();
+    }
 }
 
+// When AppUi is destroyed, m_bridgeSupervisor's destructor
+// stops the bridge process. The window goes first, so what its widgets
+// queue on the way out (run history) is written before the database
+// thread stops.
 AppUi::~AppUi()
 {
-    // When the MyApp object is destroyed, m_bridgeProcess's destructor
-    // will be called automatically, terminating the child process.
-    delete m_bridgeProcess;
+    m_framelessWindow.reset();
+    SettingsManager::singleton().flush();
+    database::DbWorker::singleton().stop();
 }
 
 void AppUi::showUi() const
@@ -97,10 +118,11 @@ void AppUi::showUi() const
 
 void AppUi::initAppLayout()
 {
-    m_framelessWindow = std::make_unique<FramelessWindow>(nullptr);
+    m_framelessWindow = std::make_unique<FramelessWindow>(api_context->userDataPath);
 
     // Signals
     connect(this, &AppUi::updateStatusBar, m_framelessWindow.get(), &FramelessWindow::processStatusSlot);
+    connect(m_framelessWindow.get(), &FramelessWindow::firstPaint, this, &AppUi::onFirstPaint);
 }
 
 void AppUi::initAppContext()
@@ -119,9 +141,26 @@ void AppUi::initAppContext()
     api_context->userPath = userDataPath;
 
     pluginManager = std::make_unique<PluginManager>(api_context.get());
+}
+
+void AppUi::onFirstPaint()
+{
+    emit interactive();
 
-    // TBD
-    pluginManager->loadPluginsFromDirectory((searchPath / "plugins").string());
+    // What the window does not need to appear: one step per turn of the event loop,
+    // so input is handled in between.
+    QTimer::singleShot(0, this, [this]
+    {
+        TraceSpan span("PluginManager::loadPluginsFromDirectory");
+        // TBD
+        pluginManager->loadPluginsFromDirectory((api_context->searchPath / "plugins").string());
+    });
+    QTimer::singleShot(0, this, [this]
+    {
+        TraceSpan span("CodeRunner::warmUp");
+        m_framelessWindow->getEditor()->warmUpRunner();
+    });
+    QTimer::singleShot(0, this, [this] { m_framelessWindow->prewarm(); });
 
     // Schedule onWindowFullyLoaded to run after current event processing is done
     QTimer::singleShot(10000, this, &AppUi::onWindowFullyLoaded);
@@ -129,35 +168,43 @@ void AppUi::initAppContext()
 
 void AppUi::onWindowFullyLoaded()
 {
-    initPSLangSupport();
-
     verifyApplicationVersion();
 }
 
 void AppUi::initPSLangSupport()
 {
-    const std::filesystem::path psLangSupportPath = api_context->searchPath / "PS.Bridge/Buraq.Bridge.exe";
+    const std::filesystem::path searchPath(QCoreApplication::applicationDirPath().toStdString());
+#ifdef _WIN32
+    const std::filesystem::path psLangSupportPath = searchPath / "PS.Bridge/Buraq.Bridge.exe";
+#else
+    const std::filesystem::path psLangSupportPath = searchPath / "PS.Bridge/Buraq.Bridge";
+#endif
 
     qDebug() << "PSLang Support: " << psLangSupportPath.string();
 
-    emit updateStatusBar("PSLang Support..", 5000);
+    m_bridgeSupervisor = std::make_unique<BridgeSupervisor>(psLangSupportPath);
+    connect(m_bridgeSupervisor.get(), &BridgeSupervisor::statusMessage, this, &AppUi::updateStatusBar);
 
-    m_bridgeProcess = new ManagedProcess(psLangSupportPath);
+    m_bridgeSupervisor->start();
+}
 
-    if (!m_bridgeProcess->isRunning())
+void AppUi::verifyApplicationVersion()
+{
+    if (m_versionRepository == nullptr)
     {
-        std::cerr << "Bridge process failed to start." << std::endl;
-        emit updateStatusBar("PowerShell Support Failed.", 5000);
+        m_versionRepository = std::make_unique<VersionRepository>(api_context.get());
     }
 
-    emit updateStatusBar("PSLang Support Ready", 30000);
+    // The answer comes back on this thread; the window stays responsive meanwhile.
+    m_versionRepository->checkForUpdate(this, [this](const UpdateInfo& update_info)
+    {
+        onUpdateChecked(update_info);
+    });
 }
 
-void AppUi::verifyApplicationVersion()
+void AppUi::onUpdateChecked(const UpdateInfo& update_info)
 {
-    VersionRepository repo(api_context.get());
-
-    if (const UpdateInfo update_info = repo.main_version_logic(); update_info.isConnFailure == false)
+    if (update_info.isConnFailure == false)
     {
         if (update_info.latestVersion.empty())
         {
@@ -173,38 +220,19 @@ void AppUi::verifyApplicationVersion()
 
         if (versionUpdater.exec() == QDialog::Accepted)
         {
-            const std::filesystem::path installerExe = repo.downloadNewVersion();
-
-            qDebug() << "AppUi.cpp";
-            qDebug() << installerExe.string();
-            qDebug() << (api_context->searchPath / "updater.exe").string();
-            qDebug() << api_context->searchPath.parent_path().string();
-            qDebug() << "ENDs AppUi.cpp";
-            // Get the path to the AppData\Local folder
-            PWSTR pszPath = NULL;
-            if (const HRESULT hr = SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, NULL, &pszPath); SUCCEEDED(hr))
+            // The window stays usable while the installer downloads.
+            emit updateStatusBar("Downloading the update...", 0);
+            m_versionRepository->downloadNewVersion(this, [this](const TransferProgress& progress)
             {
-                // Convert the wide character string to a narrow character string (std::string)
-                std::wstring wsPath(pszPath);
-                std::string sPath(wsPath.begin(), wsPath.end());
-
-                sPath += "\\Programs\\Buraq";
-
-                // Print the resulting path
-                std::cout << "The path is: " << sPath << std::endl;
-
-                launchUpdaterAndExit(
-                    api_context->searchPath / "updater.exe", installerExe, sPath
-                );
-
-                // Free the memory allocated by SHGetKnownFolderPath
-                CoTaskMemFree(pszPath);
-            }
-            else
+                if (progress.total > 0)
+                {
+                    emit updateStatusBar(
+                        QString("Downloading the update... %1%").arg(progress.downloaded * 100 / progress.total), 0);
+                }
+            }, [this](const std::filesystem::path& package, const std::string& error)
             {
-                std::cerr << "Failed to get the path." << std::endl;
-            }
-            emit updateStatusBar("Ready.", 2000);
+                onUpdateDownloaded(package, error);
+            });
         }
         else
         {
@@ -219,47 +247,57 @@ void AppUi::verifyApplicationVersion()
     }
 }
 
+void AppUi::onUpdateDownloaded(const std::filesystem::path& package, const std::string& error)
+{
+    if (package.empty())
+    {
+        qDebug() << "Update download failed:" << error;
+        emit updateStatusBar("Failed to download the update!", 10000);
+        return;
+    }
+
+    // A staged update replaces this installation; the installer installs where it always does.
+    std::filesystem::path installation = api_context->searchPath;
+#ifdef _WIN32
+    const std::filesystem::path updater = api_context->searchPath / "updater.exe";
+    if (PWSTR pszPath = NULL; !std::filesystem::is_directory(package) &&
+        SUCCEEDED(SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, NULL, &pszPath)))
+    {
+        installation = std::filesystem::path(pszPath) / "Programs" / "Buraq";
+        CoTaskMemFree(pszPath);
+    }
+#else
+    const std::filesystem::path updater = api_context->searchPath / "updater";
+#endif
+
+    qDebug() << "Updating" << installation.string() << "from" << package.string();
+    launchUpdaterAndExit(updater, package, installation);
+    emit updateStatusBar("Ready.", 2000);
+}
+
 void AppUi::launchUpdaterAndExit(
     const std::filesystem::path& updaterPath,
     const std::filesystem::path& packagePath,
     const std::filesystem::path& installationPath
 )
 {
-    std::string commandLine = "\"" + updaterPath.string() + "\"";
-    commandLine += " \"" + packagePath.string() + "\"";
-    commandLine += " \"" + installationPath.string() + "\"";
-    commandLine += " " + std::to_string(GetCurrentProcessId()); // Pass current process ID
-
-    qDebug() << "commandLine: " << commandLine;
-
+    // The updater waits for this process to exit before it touches the installation.
     //updater.exe setup-x.x.x.dev.exe C:\Users\user\AppData\Local\Programs\Buraq\ 16572
-    STARTUPINFOA si;
-    PROCESS_INFORMATION pi;
-
-    ZeroMemory(&si, sizeof(si));
-    si.cb = sizeof(si);
-    ZeroMemory(&pi, sizeof(pi));
-
-    if (CreateProcessA(NULL, // No module name (use command line)
-                       (LPSTR)commandLine.c_str(), // Command line
-                       NULL, // Process handle not inheritable
-                       NULL, // Thread handle not inheritable
-                       FALSE, // Set handle inheritance to FALSE
-                       CREATE_NEW_CONSOLE,
-                       // Give the updater its own console. Prevents from closing after the main app is closed.
-                       NULL, // Use parent's environment block
-                       NULL, // Use parent's starting directory
-                       &si, // Pointer to STARTUPINFO structure
-                       &pi) // Pointer to PROCESS_INFORMATION structure
-    )
+    const QStringList arguments{
+        QString::fromStdString(packagePath.string()),
+        QString::fromStdString(installationPath.string()),
+        QString::number(QCoreApplication::applicationPid()),
+    };
+    qDebug() << "Launching" << updaterPath.string() << arguments;
+
+    if (QProcess::startDetached(QString::fromStdString(updaterPath.string()), arguments))
     {
-        CloseHandle(pi.hProcess);
-        CloseHandle(pi.hThread);
         std::cout << "Updater launched. Exiting main application." << std::endl;
-        exit(0);
+        // Through the event loop, so the settings and the database are saved on the way out.
+        QCoreApplication::quit();
     }
     else
     {
-        std::cerr << "Failed to launch updater. Error: " << GetLastError() << std::endl;
+        std::cerr << "Failed to launch updater " << updaterPath.string() << std::endl;
     }
 }
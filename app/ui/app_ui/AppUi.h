@@ -5,6 +5,7 @@
 #define APP_UI_H
 
 #include <filesystem>
+#include <string>
 #include <QObject>
 
 namespace buraq
@@ -17,20 +18,25 @@ class QMainWindow;
 class QMouseEvent;
 class QThread;
 class EditorMargin;
-class ManagedProcess;
+class BridgeSupervisor;
 class FramelessWindow;
 class PluginManager;
 class ToolBar;
+class VersionRepository;
+struct UpdateInfo;
 
 class AppUi final : public QObject
 {
     Q_OBJECT
 
 private slots:
+    void onFirstPaint();
     void onWindowFullyLoaded();
 
 signals:
     void updateStatusBar(const QString&, int timeOut);
+    // The window has painted and the event loop is running; deferred work starts after this.
+    void interactive();
 
 public:
     explicit AppUi(QObject* parent = nullptr);
@@ -49,13 +55,18 @@ private:
     std::unique_ptr<FramelessWindow> m_framelessWindow;
 
     // For running background services
-    ManagedProcess* m_bridgeProcess{};
+    std::unique_ptr<BridgeSupervisor> m_bridgeSupervisor;
+    std::unique_ptr<VersionRepository> m_versionRepository;
 
     QThread *m_workerThread{};
     Minion *m_minion{};
 
     void initPSLangSupport();
     void verifyApplicationVersion();
+    void onUpdateChecked(const UpdateInfo& update_info);
+    // package is the installer or a staged directory for the updater; empty if the download
+    // failed, for the reason in error.
+    void onUpdateDownloaded(const std::filesystem::path& package, const std::string& error);
     void initAppLayout();
     void initAppContext();
     static void launchUpdaterAndExit(
@@ -4,16 +4,18 @@
 
 #include <QIcon>
 #include "CodeRunner.h"
-#include <QThread>
 #include "CustomLabel.h"
 #include "Editor.h"
 #include "IconButton.h"
 #include "app_ui/AppUi.h"
+#include "clients/ExecutionBackend/ExecutionBackendFactory.h"
+#include "clients/ExecutionBackend/IExecutionBackend.h"
+#include "database/run_history.h"
 #include "frameless_window/FramelessWindow.h"
+#include "settings/SettingManager/SettingsManager.h"
 
 CodeRunner::CodeRunner(QWidget* parent)
-    : QPushButton("{ }", parent), m_window(parent), m_workerThread(nullptr),
-      m_minion(nullptr)
+    : QPushButton("{ }", parent), m_window(parent), m_history(new database::RunHistory(this))
 {
     setObjectName("CodeRunner");
 
@@ -26,38 +28,31 @@ CodeRunner::CodeRunner(QWidget* parent)
     CodeRunner::setupSignals();
 }
 
-// Call this once in your CodeRunner's constructor.
-void CodeRunner::setupWorker()
+// Called after startup (warmUp) or on the first run, whichever comes first.
+void CodeRunner::setupBackend()
 {
-    // --- 1. Create and Connect Objects ---
-    m_psClient = new PSClient(this);
-    m_workerThread = new QThread(this);
-    m_minion = new Minion();
-    m_minion->moveToThread(m_workerThread);
+    m_backend = execution::createBackend(SettingsManager::singleton().settings().executionBackend, this);
 
-    // --- 2. Connect Signals and Slots ---
-
-    // Minion (worker thread) asks psClient (main thread) to execute a script.
-    connect(m_minion, &Minion::runScriptRequested, m_psClient, &PSClient::runScript);
-
-    // psClient (main thread) sends result back to CodeRunner (main thread).
-    connect(m_psClient, &PSClient::scriptResultReceived, this, &CodeRunner::handleTaskResults);
-
-    // Clean up the thread and worker when the thread's event loop finishes.
-    connect(m_workerThread, &QThread::finished, m_minion, &QObject::deleteLater);
-    connect(m_workerThread, &QThread::finished, m_workerThread, &QObject::deleteLater);
-
-    m_workerThread->start();
+    connect(m_backend, &IExecutionBackend::recordsReady, this, &CodeRunner::handleRecordsReady);
+    connect(m_backend, &IExecutionBackend::outputReady, this, &CodeRunner::handleOutputReady);
+    connect(m_backend, &IExecutionBackend::runFinished, this, &CodeRunner::handleRunFinished);
 }
 
+void CodeRunner::warmUp()
+{
+    if (m_backend == nullptr)
+    {
+        setupBackend();
+    }
+    m_backend->warmUp();
+}
 
-// This function is now much simpler. It just gets the script and signals the worker.
+// Gets the script from the editor and hands it to the execution backend.
 void CodeRunner::runCode()
 {
-    if (!m_workerThread || !m_workerThread->isRunning())
+    if (m_backend == nullptr)
     {
-        // If the thread isn't running, set it up.
-        setupWorker();
+        setupBackend();
     }
 
     // --- Get the script text from the UI in the main thread ---
@@ -80,66 +75,58 @@ void CodeRunner::runCode()
 
     const auto cleanedScript = script.replace("\u2029", "\n");
 
-    emit statusUpdate("Running code..");
+    emit statusUpdate("Running code on " + m_backend->name() + "..");
 
-    // --- Safely trigger the task on the worker thread via a signal ---
-    // The Minion's process slot should be connected to this signal.
-    // We assume Minion has a signal like `startProcessing(QString)`.
-    QMetaObject::invokeMethod(m_minion, "processScript", Qt::QueuedConnection, Q_ARG(QString, cleanedScript));
+    // Backends are asynchronous; the result comes back through handleRunFinished().
+    const quint64 runId = ++m_lastRunId;
+    m_history->runStarted(runId, cleanedScript);
+    m_backend->execute(runId, cleanedScript);
 }
 
-void CodeRunner::handleTaskResults(const QVariant& result)
+void CodeRunner::handleRecordsReady(const quint64 runId, const RecordSetPtr& records)
 {
-    // if (result.isValid() && result.canConvert<QString>())
-    if (const auto flag = result.canConvert<QString>(); flag && result.isValid())
-    {
-        const auto resultString = result.value<QString>();
-        QString error = "";
-        int statusCode = 0;
-        if (!resultString.isEmpty() && resultString.contains("exception", Qt::CaseInsensitive))
-        {
-            error = resultString;
-            // resultString.clear();
-            statusCode = 1;
-        }
-        emit updateOutputResult(statusCode, resultString, error);
-    }
-    else
+    m_pendingRecords.insert(runId, records);
+}
+
+// Runs are answered in submission order, so a higher id means the next run has begun.
+void CodeRunner::markStarted(const quint64 runId)
+{
+    if (runId > m_lastStartedRunId)
     {
-        emit updateOutputResult(1, "", "Error failed to execute task.");
+        m_lastStartedRunId = runId;
+        emit runStarted(runId);
     }
 }
 
-void CodeRunner::handleProgress(int i)
+void CodeRunner::handleOutputReady(const quint64 runId, const QString& text, const bool isError)
 {
-    emit statusUpdate("Executing...");
+    markStarted(runId);
+    m_history->appendOutput(runId, text, isError);
+    emit updateOutputStream(text, isError);
 }
 
-void CodeRunner::handleWorkerFinished()
+void CodeRunner::handleRunFinished(const quint64 runId, const int exitCode, const QString& output, const QString& error)
 {
-    emit statusUpdate("Completed!");
+    markStarted(runId);
+    if (!output.isEmpty())
+    {
+        m_history->appendOutput(runId, output, false);
+    }
+    if (!error.isEmpty())
+    {
+        m_history->appendOutput(runId, error, true);
+    }
+    m_history->runFinished(runId, exitCode);
 
-    m_workerThread = nullptr;
-    m_minion = nullptr;
+    emit updateRecordResult(m_pendingRecords.take(runId));
+    emit updateOutputResult(exitCode, output, error);
 }
 
 CodeRunner::~CodeRunner()
 {
-    // smart pointers are deleted automatically
+    // m_backend is a child and is deleted by QObject;
     // editor pointer should be deleted elsewhere
     m_window = nullptr;
-
-    if (m_workerThread && m_workerThread->isRunning())
-    {
-        m_workerThread->requestInterruption();
-        m_workerThread->quit(); // Ask event loop to quit
-        if (!m_workerThread->wait(5000))
-        {
-            // Wait for max 5 seconds
-            m_workerThread->terminate(); // Force terminate (last resort)
-            m_workerThread->wait(); // Wait for termination
-        }
-    }
 }
 
 void CodeRunner::setupSignals()
@@ -152,5 +139,8 @@ void CodeRunner::setupSignals()
     connect(this, &CodeRunner::statusUpdate, window, &FramelessWindow::processStatusSlot);
 
     // Signal to update the out component in AppUI component for the completed process
+    connect(this, &CodeRunner::runStarted, window, &FramelessWindow::processRunStartedSlot);
+    connect(this, &CodeRunner::updateOutputStream, window, &FramelessWindow::processOutputSlot);
     connect(this, &CodeRunner::updateOutputResult, window, &FramelessWindow::processResultSlot);
+    connect(this, &CodeRunner::updateRecordResult, window, &FramelessWindow::processRecordsSlot);
 }
@@ -5,12 +5,17 @@
 #ifndef CODERUNNER_H
 #define CODERUNNER_H
 
+#include <QHash>
 #include <QPushButton>
 #include "IconButton.h"
-#include "Minion.h"
-#include "../clients/PSClient/PSClient.h"
+#include "clients/ExecutionBackend/RecordSet.h"
 
-class PSClient;
+class IExecutionBackend;
+
+namespace database
+{
+	class RunHistory;
+}
 
 class CodeRunner final : public QPushButton {
 
@@ -18,34 +23,47 @@ Q_OBJECT
 
 private slots:
 
-	void handleProgress(int);
+	void handleRecordsReady(quint64 runId, const RecordSetPtr &records);
 
-	void handleTaskResults(const QVariant &result); // Modified to take QVariant
+	void handleOutputReady(quint64 runId, const QString &text, bool isError);
 
-	void runCode();
+	void handleRunFinished(quint64 runId, int exitCode, const QString &output, const QString &error);
 
-	void handleWorkerFinished();
+	void runCode();
 
 signals:
 	void statusUpdate(QString status, int timeout = 10000);
+	// Emitted once per run, before its first output.
+	void runStarted(quint64 runId);
+	void updateOutputStream(const QString &text, bool isError);
 	void updateOutputResult(int exitCode, const QString &output, const QString &error);
+	// nullptr when the run returned no objects.
+	void updateRecordResult(const RecordSetPtr &records);
 
 public:
 	explicit CodeRunner(QWidget *parent = nullptr);
 	~CodeRunner() override;
 
+	// Creates the backend and lets it prepare, so the first run does not wait for it.
+	void warmUp();
+
 private:
 
 	// should be managed elsewhere
 	QWidget *m_window;
 
-	// cleanup will be handled by  &QObject::deleteLater
+	// Parented to this; created on the first run.
+	IExecutionBackend *m_backend{};
+	quint64 m_lastRunId = 0;
+	quint64 m_lastStartedRunId = 0;
+	// Records every run in the database; parented to this.
+	database::RunHistory *m_history;
+	// Records of runs whose runFinished() has not arrived yet.
+	QHash<quint64, RecordSetPtr> m_pendingRecords;
 
-	PSClient* m_psClient{};
-	QThread *m_workerThread;
-	Minion *m_minion;
+	void setupBackend();
 
-	void setupWorker();
+	void markStarted(quint64 runId);
 
 	void setupSignals();
 };
@@ -254,6 +254,11 @@ void Editor::openAndParseFile(const QString& filePath, QFile::OpenModeFlag modeF
     }
 }
 
+void Editor::warmUpRunner() const
+{
+    m_editorMargin->codeRunner->warmUp();
+}
+
 void Editor::setupSignals()
 {
     connect(m_plainTextEdit.get(), &QPlainTextEdit::cursorPositionChanged, this, &Editor::highlightCurrentLine);
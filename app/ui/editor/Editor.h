@@ -45,6 +45,8 @@ public:
     ~Editor() override = default;
 
     void openAndParseFile(const QString& filePath, QFile::OpenModeFlag modeFlag = QFile::OpenModeFlag::ReadOnly);
+    // Prepares the execution backend ahead of the first run.
+    void warmUpRunner() const;
     // Add forwarding methods if external code calls QPlainTextEdit methods on Editor
     [[nodiscard]] QString toPlainText() const { return m_plainTextEdit->toPlainText(); }
     [[nodiscard]] QString selectedText() const { return m_plainTextEdit->textCursor().selectedText(); }
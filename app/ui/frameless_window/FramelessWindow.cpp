@@ -5,6 +5,7 @@
 #include "FramelessWindow.h"
 
 #include <QStatusBar>
+#include <QTimer>
 #include <QVBoxLayout>
 #include <QSplitter>
 
@@ -21,13 +22,24 @@
 #include "settings/SettingManager/SettingsManager.h"
 
 #include <QIcon>
+#include <QWindow>
 
 #include "Frame/Frame.h"
+#include "Trace/Trace.h"
 
-FramelessWindow::FramelessWindow(QWidget* parent)
+FramelessWindow::FramelessWindow(std::filesystem::path userDataPath, QWidget* parent)
     : QMainWindow(parent),
       themeManager(ThemeManager::instance()),
-      m_outPutArea(std::make_unique<OutputDisplay>(this)),
+      m_userDataPath(std::move(userDataPath)),
+      m_outPutArea("FramelessWindow::createOutputDisplay", [this]
+      {
+          // Starts hidden; the splitter keeps it that way until it is shown.
+          const auto outputDisplay = new OutputDisplay(m_userDataPath / "runs", this);
+          rightSideSplitter->addWidget(outputDisplay);
+          rightSideSplitter->setSizes({500, 200}); // Initial heights for top and bottom sections
+          return outputDisplay;
+      }),
+      m_settingsDialog("FramelessWindow::createSettingsDialog", [this] { return new SettingsDialog(this); }),
       m_editor(std::make_unique<Editor>(this)),
       m_frameContainer(std::make_unique<QWidget>(this)),
       m_titleBar(std::make_unique<QWidget>(this)),
@@ -35,11 +47,10 @@ FramelessWindow::FramelessWindow(QWidget* parent)
       m_rightSidePanel(std::make_unique<QWidget>(this)),
       m_bottomPanel(std::make_unique<QWidget>(this)),
       m_centralWidget(std::make_unique<QWidget>(this)),
-      userPreferences(SettingsManager::loadSettings()),
       m_dragPosition(QPoint(0, 0))
 {
-    resize(userPreferences.windowSize);
-    //move(userPreferences.windowPosition);
+    resize(SettingsManager::singleton().settings().windowSize);
+    //move(SettingsManager::singleton().settings().windowPosition);
 
     // Initialize the ThemeManager instance
     installEventFilter(&themeManager);
@@ -213,18 +224,21 @@ FramelessWindow::FramelessWindow(QWidget* parent)
     connect(m_minimizeButton.get(), &QPushButton::clicked, this, &FramelessWindow::showMinimized);
     connect(this, &FramelessWindow::closeApp, this, &FramelessWindow::close);
 
-    // Create an instance of your settings dialog
-    const auto settingsDialog = new SettingsDialog(this);
-    connect(m_settingsButton.get(), &QPushButton::clicked, settingsDialog, &SettingsDialog::exec);
+    // The settings dialog is built on first use, or by prewarm()
+    connect(m_settingsButton.get(), &QPushButton::clicked, this, [this] { m_settingsDialog.get()->exec(); });
+}
+
+void FramelessWindow::prewarm()
+{
+    m_outPutArea.prewarm(this);
+    m_settingsDialog.prewarm(this);
 }
 
 // smart pointers will be cleaned up by std::unique_ptr
 FramelessWindow::~FramelessWindow()
 {
     // save the last window size & position
-    userPreferences.windowSize = this->size();
-    userPreferences.windowPosition = m_dragPosition;
-    SettingsManager::saveSettings(userPreferences);
+    SettingsManager::singleton().setWindowGeometry(this->size(), m_dragPosition);
 };
 
 void FramelessWindow::closeWindowSlot()
@@ -293,43 +307,74 @@ void FramelessWindow::initContentAreaLayout()
     topAreaSplitter->addWidget(m_editor.get());
     topAreaSplitter->setSizes({250, 750}); // Initial widths for drawer and editor
 
-    // 5. BOTTOM AREA (Output)
+    // 5. BOTTOM AREA (Output): added below the top area when first needed (see the constructor).
 
     // 6. ASSEMBLE THE VERTICAL SPLITTER:
-    // Add the horizontal splitter (as the top widget) and the output area (as the bottom widget).
     rightSideSplitter->addWidget(topAreaSplitter.get());
-    rightSideSplitter->addWidget(m_outPutArea.get());
-    rightSideSplitter->setSizes({500, 200}); // Initial heights for top and bottom sections
 
     // 7. ASSEMBLE THE MAIN LAYOUT
     mainLayout->addWidget(rightSideSplitter.get(), 1); // The '1' stretch factor allows it to expand
 }
 
-void FramelessWindow::processStatusSlot(const QString& message, const int timeout) const
+void FramelessWindow::processStatusSlot(const QString& message, const int timeout)
 {
-    if (m_statusBar)
+    m_pendingStatus = message;
+    m_pendingStatusTimeout = timeout;
+
+    if (m_statusTimer == nullptr)
     {
-        m_statusBar->showMessage(message, timeout);
+        m_statusTimer = new QTimer(this);
+        m_statusTimer->setSingleShot(true);
+        m_statusTimer->setInterval(16); // one display frame
+        connect(m_statusTimer, &QTimer::timeout, this, [this]
+        {
+            if (m_statusBar)
+            {
+                m_statusBar->showMessage(m_pendingStatus, m_pendingStatusTimeout);
+            }
+        });
+    }
+
+    if (!m_statusTimer->isActive())
+    {
+        m_statusTimer->start();
     }
 }
 
-void FramelessWindow::processResultSlot(const int exitCode, const QString& output, const QString& error) const
+void FramelessWindow::processRunStartedSlot(const quint64 runId) const
 {
-    if (m_outPutArea == nullptr) return;
+    OutputDisplay* outputDisplay = m_outPutArea.get();
+    outputDisplay->show();
+    outputDisplay->beginRun(runId);
+}
 
-    if (m_outPutArea->show(); exitCode == 0)
+void FramelessWindow::processOutputSlot(const QString& text, const bool isError) const
+{
+    m_outPutArea.get()->append(text, isError);
+}
+
+void FramelessWindow::processResultSlot(const int exitCode, const QString& output, const QString& error)
+{
+    OutputDisplay* outputDisplay = m_outPutArea.get();
+    if (outputDisplay->show(); exitCode == 0)
     {
-        m_outPutArea->log(output, error);
+        outputDisplay->log(output, error);
 
         processStatusSlot(error.isEmpty() ? "Completed!" : "Completed with errors.");
     }
     else
     {
         processStatusSlot("Process failed!");
-        m_outPutArea->log("", error);
+        // Output is kept: with separate streams, whatever ran before the error is still valid.
+        outputDisplay->log(output, error);
     }
 }
 
+void FramelessWindow::processRecordsSlot(const RecordSetPtr& records) const
+{
+    m_outPutArea.get()->showRecords(records);
+}
+
 void FramelessWindow::updateDrawer() const
 {
     qDebug() << "Open or close Drawer";
@@ -348,15 +393,13 @@ void FramelessWindow::updateDrawer() const
 void FramelessWindow::onShowOutputButtonClicked() const
 {
     qDebug() << "Open or close Output";
-    if (m_outPutArea == nullptr) return;
-
-    if (m_outPutArea->isHidden())
+    if (OutputDisplay* outputDisplay = m_outPutArea.get(); outputDisplay->isHidden())
     {
-        m_outPutArea->show();
+        outputDisplay->show();
     }
     else
     {
-        m_outPutArea->hide();
+        outputDisplay->hide();
     }
 }
 
@@ -399,6 +442,44 @@ void FramelessWindow::updateCursorShape(const QPoint& pos)
         setCursor(Qt::ArrowCursor);
 }
 
+void FramelessWindow::showEvent(QShowEvent* event)
+{
+    QMainWindow::showEvent(event);
+
+    // The first exposure is the first paint; see eventFilter().
+    if (!m_firstPaintSeen && windowHandle() != nullptr)
+    {
+        windowHandle()->installEventFilter(this);
+    }
+
+    // The drawer waits for this to open the first file.
+    if (m_drawer != nullptr)
+    {
+        m_drawer->windowShown();
+    }
+}
+
+bool FramelessWindow::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == windowHandle() && event->type() == QEvent::Expose && windowHandle()->isExposed())
+    {
+        m_firstPaintSeen = true;
+        windowHandle()->removeEventFilter(this);
+
+        // The exposure paints before control returns to the event loop.
+        QTimer::singleShot(0, this, [this]
+        {
+            if (Trace& trace = Trace::singleton(); trace.enabled())
+            {
+                trace.complete("startup (until first paint)", 0, trace.now());
+                trace.instant("first paint");
+            }
+            emit firstPaint();
+        });
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
 void FramelessWindow::mousePressEvent(QMouseEvent* event)
 {
     if (event->button() == Qt::LeftButton)
@@ -5,12 +5,16 @@
 #ifndef FRAMELESS_WINDOW_H
 #define FRAMELESS_WINDOW_H
 
+#include <filesystem>
+
 #include <QMainWindow>
 #include <QWidget>
 
 #include "Filters/Toolbar/ToolBarEvent.h"
+#include "LazyWidget.h"
 #include "settings/UserSettings.h"
 #include "settings/SettingManager/SettingsManager.h"
+#include "clients/ExecutionBackend/RecordSet.h"
 
 namespace buraq
 {
@@ -19,6 +23,7 @@ namespace buraq
 
 class QPushButton; // Forward declaration
 class QStatusBar;
+class QTimer;
 class QSplitter;
 class QGridLayout;
 class QPoint;
@@ -32,26 +37,39 @@ class EditorMargin;
 class ToolBar;
 class ThemeManager;
 class Frame;
+class SettingsDialog;
 
 class FramelessWindow final : public QMainWindow
 {
     Q_OBJECT
 
 public:
-    explicit FramelessWindow(QWidget* parent = nullptr);
+    // userDataPath: the app's data directory (buraq_api::userDataPath); the output panel keeps
+    // run output under it.
+    explicit FramelessWindow(std::filesystem::path userDataPath, QWidget* parent = nullptr);
     ~FramelessWindow() override;
 
     [[nodiscard]] Editor* getEditor() const;
     void onShowOutputButtonClicked() const;
     [[nodiscard]] PluginManager* getLangPluginManager() const;;
 
+    // Builds the output panel and the settings dialog while the app is idle, so neither
+    // costs anything on first use. Both are otherwise built when first needed.
+    void prewarm();
+
     void mousePressEvent(QMouseEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
     void mouseReleaseEvent(QMouseEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 public slots:
-    void processStatusSlot(const QString&, int timeout = 5000) const;
-    void processResultSlot(int exitCode, const QString& output, const QString& error) const;
+    // Status messages are applied once per display frame; the latest one wins.
+    void processStatusSlot(const QString&, int timeout = 5000);
+    void processRunStartedSlot(quint64 runId) const;
+    void processOutputSlot(const QString& text, bool isError) const;
+    void processResultSlot(int exitCode, const QString& output, const QString& error);
+    void processRecordsSlot(const RecordSetPtr& records) const;
     void updateDrawer() const;
     void closeWindowSlot();
     void showMaximizeOrRestoreSlot();
@@ -66,10 +84,12 @@ private:
     void initContentAreaLayout();
 
     ThemeManager& themeManager;
+    std::filesystem::path m_userDataPath;
 
     std::unique_ptr<PluginManager> pluginManager;
     std::unique_ptr<CustomDrawer> m_drawer;
-    std::unique_ptr<OutputDisplay> m_outPutArea;
+    LazyWidget<OutputDisplay> m_outPutArea;
+    LazyWidget<SettingsDialog> m_settingsDialog;
     std::unique_ptr<QGridLayout> m_placeHolderLayout;
     std::unique_ptr<Editor> m_editor;
     std::unique_ptr<ToolBar> m_toolBar;
@@ -98,15 +118,17 @@ private:
     std::unique_ptr<QVBoxLayout> m_leftSidePanelLayout;
     std::unique_ptr<QVBoxLayout> m_rightSidePanelLayout;
     std::unique_ptr<QHBoxLayout> m_bottomPanelLayout;
-    std::unique_ptr<SettingsManager> settingsManager;
 
     // splitters
      std::unique_ptr<QSplitter> rightSideSplitter;
      std::unique_ptr<QSplitter> topAreaSplitter;
 
     QStatusBar* m_statusBar{};
-    UserSettings userPreferences;
+    QTimer* m_statusTimer{};
+    QString m_pendingStatus;
+    int m_pendingStatusTimeout = 0;
 
+    bool m_firstPaintSeen = false;
     bool m_resizing = false;
     bool m_dragging = false;
     Qt::Edges m_resizeEdges;
@@ -116,6 +138,8 @@ private:
 signals:
     void closeApp();
     void windowResize(QSize size);
+    // Once, on the first turn of the event loop after the window's first paint.
+    void firstPaint();
 };
 
 #endif //FRAMELESS_WINDOW_H
@@ -0,0 +1,430 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "AnsiParser.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    // Byte classes; the parser only looks at a byte through its class.
+    enum Class : std::uint8_t
+    {
+        Text, // printable ASCII (in the ground state), TAB and everything >= 0x80
+        LineFeed,
+        CarriageReturn,
+        Esc,
+        Bell,
+        Control, // other C0 and DEL
+        Intermediate, // 0x20-0x2F
+        Digit,
+        Separator, // ':' and ';'
+        Private, // '<' '=' '>' '?'
+        OpenBracket, // '['
+        CloseBracket, // ']'
+        StringStart, // 'P' 'X' '^' '_': DCS, SOS, PM, APC
+        Final, // the rest of 0x40-0x7E
+        ClassCount,
+    };
+
+    enum Action : std::uint8_t
+    {
+        Ignore,
+        Print,
+        EndLine,
+        Return,
+        BeginCsi,
+        AddDigit,
+        NextParam,
+        MarkPrivate,
+        DispatchCsi,
+    };
+
+    struct Transition
+    {
+        Action action;
+        std::uint8_t next;
+    };
+
+    constexpr std::array<Class, 256> makeClasses()
+    {
+        std::array<Class, 256> classes{};
+        for (int b = 0; b < 256; ++b)
+        {
+            Class c = Text;
+            if (b == '\n') c = LineFeed;
+            else if (b == '\r') c = CarriageReturn;
+            else if (b == 0x1B) c = Esc;
+            else if (b == 0x07) c = Bell;
+            else if (b == '\t') c = Text;
+            else if (b < 0x20 || b == 0x7F) c = Control;
+            else if (b < 0x30) c = Intermediate;
+            else if (b <= '9') c = Digit;
+            else if (b == ':' || b == ';') c = Separator;
+            else if (b < 0x40) c = Private;
+            else if (b == '[') c = OpenBracket;
+            else if (b == ']') c = CloseBracket;
+            else if (b == 'P' || b == 'X' || b == '^' || b == '_') c = StringStart;
+            else if (b < 0x7F) c = Final;
+            classes[b] = c;
+        }
+        return classes;
+    }
+
+    constexpr auto CLASSES = makeClasses();
+
+    // Bytes that end a stretch of plain text in the ground state.
+    constexpr std::array<bool, 256> makeStops()
+    {
+        std::array<bool, 256> stops{};
+        for (int b = 0; b < 256; ++b)
+        {
+            const Class c = CLASSES[b];
+            stops[b] = c == LineFeed || c == CarriageReturn || c == Esc || c == Bell || c == Control;
+        }
+        return stops;
+    }
+
+    constexpr auto STOPS = makeStops();
+
+    // States, in AnsiParser::State order.
+    enum : std::uint8_t { G, E, EI, CP, CI, S, N };
+
+    using Row = std::array<Transition, ClassCount>;
+
+    // What a byte of each class does in each state. Line feeds and carriage returns abort a
+    // sequence rather than being swallowed by it, so broken output cannot hide later lines.
+    constexpr std::array<Row, N> TRANSITIONS = {{
+        // Ground
+        {{
+            {Print, G}, {EndLine, G}, {Return, G}, {Ignore, E}, {Ignore, G}, {Ignore, G}, {Print, G},
+            {Print, G}, {Print, G}, {Print, G}, {Print, G}, {Print, G}, {Print, G}, {Print, G},
+        }},
+        // Escape
+        {{
+            {Ignore, G}, {EndLine, G}, {Return, G}, {Ignore, E}, {Ignore, E}, {Ignore, E}, {Ignore, EI},
+            {Ignore, G}, {Ignore, G}, {Ignore, G}, {BeginCsi, CP}, {Ignore, S}, {Ignore, S}, {Ignore, G},
+        }},
+        // EscapeIntermediate
+        {{
+            {Ignore, G}, {EndLine, G}, {Return, G}, {Ignore, E}, {Ignore, EI}, {Ignore, EI}, {Ignore, EI},
+            {Ignore, G}, {Ignore, G}, {Ignore, G}, {Ignore, G}, {Ignore, G}, {Ignore, G}, {Ignore, G},
+        }},
+        // CsiParam
+        {{
+            {Ignore, G}, {EndLine, G}, {Return, G}, {Ignore, E}, {Ignore, CP}, {Ignore, CP}, {Ignore, CI},
+            {AddDigit, CP}, {NextParam, CP}, {MarkPrivate, CP}, {DispatchCsi, G}, {DispatchCsi, G},
+            {DispatchCsi, G}, {DispatchCsi, G},
+        }},
+        // CsiIgnore
+        {{
+            {Ignore, CI}, {EndLine, G}, {Return, G}, {Ignore, E}, {Ignore, CI}, {Ignore, CI}, {Ignore, CI},
+            {Ignore, CI}, {Ignore, CI}, {Ignore, CI}, {Ignore, G}, {Ignore, G}, {Ignore, G}, {Ignore, G},
+        }},
+        // String: ends with BEL or ESC '\' (ESC, then '\' as a final in the escape state)
+        {{
+            {Ignore, S}, {EndLine, G}, {Ignore, S}, {Ignore, E}, {Ignore, G}, {Ignore, S}, {Ignore, S},
+            {Ignore, S}, {Ignore, S}, {Ignore, S}, {Ignore, S}, {Ignore, S}, {Ignore, S}, {Ignore, S},
+        }},
+    }};
+
+    constexpr std::uint32_t indexed(const std::uint32_t index)
+    {
+        return TextStyle::INDEXED | (index & 0xFF);
+    }
+
+    constexpr std::uint32_t rgb(const std::uint32_t r, const std::uint32_t g, const std::uint32_t b)
+    {
+        return TextStyle::RGB | (r & 0xFF) << 16 | (g & 0xFF) << 8 | (b & 0xFF);
+    }
+}
+
+void AnsiParser::feed(const std::string_view bytes, const LineSink& sink)
+{
+    static_assert(TRANSITIONS.size() == StateCount);
+
+    const char* data = bytes.data();
+    const std::size_t size = bytes.size();
+    std::size_t i = 0;
+
+    while (i < size)
+    {
+        if (m_state == Ground)
+        {
+            // Copy plain text in one go up to the next control byte.
+            std::size_t end = i;
+            while (end < size && !STOPS[static_cast<unsigned char>(data[end])])
+            {
+                ++end;
+            }
+
+            if (end > i)
+            {
+                if (m_pendingCarriageReturn)
+                {
+                    m_pendingCarriageReturn = false;
+                    m_line.clear();
+                    m_runs.clear();
+                    if (!m_style.isDefault())
+                    {
+                        m_runs.push_back({0, m_style});
+                    }
+                }
+                m_line.append(data + i, end - i);
+                i = end;
+                if (i == size)
+                {
+                    break;
+                }
+            }
+        }
+
+        const char byte = data[i++];
+        const auto [action, next] = TRANSITIONS[m_state][CLASSES[static_cast<unsigned char>(byte)]];
+        m_state = static_cast<State>(next);
+
+        switch (action)
+        {
+        case Ignore:
+        case Print: // handled by the bulk copy above
+            break;
+        case EndLine:
+            emitLine(sink);
+            break;
+        case Return:
+            m_pendingCarriageReturn = true;
+            break;
+        case BeginCsi:
+            m_params[0] = 0;
+            m_colonAfter.fill(false);
+            m_paramCount = 0;
+            m_privateMarker = false;
+            break;
+        case AddDigit:
+            m_params[m_paramCount] = std::min<std::uint32_t>(m_params[m_paramCount] * 10 + (byte - '0'), 0xFFFF);
+            break;
+        case NextParam:
+            if (m_paramCount + 1 < MAX_PARAMS)
+            {
+                m_colonAfter[m_paramCount] = byte == ':';
+                m_params[++m_paramCount] = 0;
+            }
+            break;
+        case MarkPrivate:
+            m_privateMarker = true;
+            break;
+        case DispatchCsi:
+            dispatchCsi(byte);
+            break;
+        }
+    }
+}
+
+void AnsiParser::finish(const LineSink& sink)
+{
+    if (!m_line.empty())
+    {
+        emitLine(sink);
+    }
+    m_state = Ground;
+}
+
+void AnsiParser::reset()
+{
+    m_state = Ground;
+    m_pendingCarriageReturn = false;
+    m_style = {};
+    m_line.clear();
+    m_runs.clear();
+}
+
+void AnsiParser::emitLine(const LineSink& sink)
+{
+    m_pendingCarriageReturn = false;
+
+    // A style change right at the end of the line applies to no text.
+    while (!m_runs.empty() && m_runs.back().start >= m_line.size())
+    {
+        m_runs.pop_back();
+    }
+
+    sink(m_line, m_runs);
+
+    m_line.clear();
+    m_runs.clear();
+    if (!m_style.isDefault())
+    {
+        m_runs.push_back({0, m_style});
+    }
+}
+
+void AnsiParser::dispatchCsi(const char final)
+{
+    // Cursor movement, erasing and modes mean nothing in a log; only colors are kept.
+    if (final == 'm' && !m_privateMarker)
+    {
+        applySgr();
+    }
+}
+
+void AnsiParser::setStyle(const TextStyle& style)
+{
+    if (style == m_style)
+    {
+        return;
+    }
+    m_style = style;
+
+    const auto start = static_cast<std::uint32_t>(m_line.size());
+    if (!m_runs.empty() && m_runs.back().start == start)
+    {
+        m_runs.back().style = style;
+        // Back to what was in effect before: the run is not needed.
+        const bool sameAsBefore = m_runs.size() >= 2 ? m_runs[m_runs.size() - 2].style == style : style.isDefault();
+        if (sameAsBefore)
+        {
+            m_runs.pop_back();
+        }
+        return;
+    }
+    m_runs.push_back({start, style});
+}
+
+void AnsiParser::applySgr()
+{
+    TextStyle style = m_style;
+    const std::size_t count = m_paramCount + 1;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const std::uint32_t code = m_params[i];
+
+        // 38 and 48 take sub-parameters, either "38;5;n" / "38;2;r;g;b" or the colon forms
+        // "38:5:n" / "38:2:r:g:b" / "38:2:colorspace:r:g:b".
+        if (code == 38 || code == 48 || code == 58)
+        {
+            std::uint32_t color = 0;
+            bool valid = false;
+            if (m_colonAfter[i])
+            {
+                std::size_t end = i + 1;
+                while (end < count && m_colonAfter[end - 1])
+                {
+                    ++end;
+                }
+                const std::size_t groupSize = end - (i + 1);
+                const std::uint32_t* group = m_params.data() + i + 1;
+                if (groupSize >= 2 && group[0] == 5)
+                {
+                    color = indexed(group[1]);
+                    valid = true;
+                }
+                else if (groupSize >= 4 && group[0] == 2)
+                {
+                    color = rgb(group[groupSize - 3], group[groupSize - 2], group[groupSize - 1]);
+                    valid = true;
+                }
+                i = end - 1;
+            }
+            else if (i + 2 < count && m_params[i + 1] == 5)
+            {
+                color = indexed(m_params[i + 2]);
+                valid = true;
+                i += 2;
+            }
+            else if (i + 4 < count && m_params[i + 1] == 2)
+            {
+                color = rgb(m_params[i + 2], m_params[i + 3], m_params[i + 4]);
+                valid = true;
+                i += 4;
+            }
+            else
+            {
+                break; // malformed; the rest cannot be interpreted reliably
+            }
+
+            if (valid && code == 38) style.foreground = color;
+            if (valid && code == 48) style.background = color;
+            continue; // 58 (underline color) is parsed only to be skipped
+        }
+
+        // "4:3" (curly underline) and friends: the sub-parameter picks the underline style.
+        if (code == 4 && m_colonAfter[i] && i + 1 < count)
+        {
+            ++i;
+            if (m_params[i] == 0) style.flags &= ~TextStyle::Underline;
+            else style.flags |= TextStyle::Underline;
+            continue;
+        }
+
+        switch (code)
+        {
+        case 0: style = {}; break;
+        case 1: style.flags |= TextStyle::Bold; break;
+        case 2: style.flags |= TextStyle::Dim; break;
+        case 3: style.flags |= TextStyle::Italic; break;
+        case 4:
+        case 21: style.flags |= TextStyle::Underline; break;
+        case 7: style.flags |= TextStyle::Inverse; break;
+        case 8: style.flags |= TextStyle::Hidden; break;
+        case 9: style.flags |= TextStyle::Strike; break;
+        case 22: style.flags &= ~(TextStyle::Bold | TextStyle::Dim); break;
+        case 23: style.flags &= ~TextStyle::Italic; break;
+        case 24: style.flags &= ~TextStyle::Underline; break;
+        case 27: style.flags &= ~TextStyle::Inverse; break;
+        case 28: style.flags &= ~TextStyle::Hidden; break;
+        case 29: style.flags &= ~TextStyle::Strike; break;
+        case 39: style.foreground = 0; break;
+        case 49: style.background = 0; break;
+        default:
+            if (code >= 30 && code <= 37) style.foreground = indexed(code - 30);
+            else if (code >= 40 && code <= 47) style.background = indexed(code - 40);
+            else if (code >= 90 && code <= 97) style.foreground = indexed(code - 90 + 8);
+            else if (code >= 100 && code <= 107) style.background = indexed(code - 100 + 8);
+            break; // blink, fonts, ...: ignored
+        }
+    }
+
+    setStyle(style);
+}
+
+void AnsiParser::appendSgr(std::string& out, const TextStyle& style)
+{
+    out += "\x1b[0";
+
+    static constexpr std::pair<TextStyle::Flag, const char*> FLAGS[] = {
+        {TextStyle::Bold, ";1"}, {TextStyle::Dim, ";2"}, {TextStyle::Italic, ";3"}, {TextStyle::Underline, ";4"},
+        {TextStyle::Inverse, ";7"}, {TextStyle::Hidden, ";8"}, {TextStyle::Strike, ";9"},
+    };
+    for (const auto& [flag, code] : FLAGS)
+    {
+        if (style.flags & flag)
+        {
+            out += code;
+        }
+    }
+
+    const auto appendColor = [&out](const std::uint32_t color, const char* select)
+    {
+        switch (color >> 24)
+        {
+        case TextStyle::INDEXED >> 24:
+            out += select;
+            out += ";5;" + std::to_string(color & 0xFF);
+            break;
+        case TextStyle::RGB >> 24:
+            out += select;
+            out += ";2;" + std::to_string(color >> 16 & 0xFF) + ';' + std::to_string(color >> 8 & 0xFF) + ';' +
+                std::to_string(color & 0xFF);
+            break;
+        default:
+            break;
+        }
+    };
+    appendColor(style.foreground, ";38");
+    appendColor(style.background, ";48");
+
+    out += 'm';
+}
@@ -0,0 +1,81 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef ANSI_PARSER_H
+#define ANSI_PARSER_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "TextStyle.h"
+
+/**
+ * Streaming parser for terminal output: splits it into lines of plain text plus style runs.
+ *
+ * SGR sequences (ESC [ ... m) become style runs; every other escape sequence, OSC strings
+ * (e.g. hyperlinks and window titles) and C0 controls are dropped. A bare carriage return
+ * starts the line over, so progress bars keep only their last state. State is kept between
+ * feed() calls, so a sequence split across chunks parses the same as one that is not.
+ *
+ * Plain text is copied in bulk between control bytes, which keeps the parser at memory
+ * speed for output without escapes.
+ */
+class AnsiParser
+{
+public:
+    using LineSink = std::function<void(std::string_view text, std::span<const StyleRun> runs)>;
+
+    // Parses bytes, calling sink for every line completed by a '\n'.
+    void feed(std::string_view bytes, const LineSink& sink);
+
+    // Emits the unterminated last line, if any.
+    void finish(const LineSink& sink);
+
+    // Back to the default style and an empty line.
+    void reset();
+
+    [[nodiscard]] const TextStyle& style() const { return m_style; }
+
+    // Appends the SGR sequence that sets style from scratch, e.g. "\x1b[0;1;31m"; feeding the
+    // result back through a parser gives the same style.
+    static void appendSgr(std::string& out, const TextStyle& style);
+
+private:
+    enum State : std::uint8_t
+    {
+        Ground,
+        Escape,
+        EscapeIntermediate,
+        CsiParam,
+        CsiIgnore,
+        String, // OSC, DCS, SOS, PM and APC payloads; ESC '\' or BEL ends them
+        StateCount,
+    };
+
+    void dispatchCsi(char final);
+    void applySgr();
+    void setStyle(const TextStyle& style);
+    void emitLine(const LineSink& sink);
+
+    State m_state = Ground;
+    bool m_pendingCarriageReturn = false;
+
+    TextStyle m_style;
+    std::string m_line;
+    std::vector<StyleRun> m_runs;
+
+    // CSI parameters; colons (sub-parameters) are kept so "38:2::r:g:b" can be told apart.
+    static constexpr std::size_t MAX_PARAMS = 32;
+    std::array<std::uint32_t, MAX_PARAMS> m_params{};
+    std::array<bool, MAX_PARAMS> m_colonAfter{};
+    std::size_t m_paramCount = 0;
+    bool m_privateMarker = false;
+};
+
+#endif // ANSI_PARSER_H
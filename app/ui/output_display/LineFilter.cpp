@@ -0,0 +1,167 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "LineFilter.h"
+
+#include <algorithm>
+
+LineFilter::SubstringMatcher::SubstringMatcher(const std::string_view needle, const bool caseSensitive)
+{
+    for (std::size_t c = 0; c < m_fold.size(); ++c)
+    {
+        m_fold[c] = static_cast<unsigned char>(!caseSensitive && c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+    }
+
+    m_needle.reserve(needle.size());
+    for (const char c : needle)
+    {
+        const auto byte = static_cast<unsigned char>(c);
+        m_folds = m_folds || m_fold[byte] != byte || (!caseSensitive && byte >= 'a' && byte <= 'z');
+        m_needle.push_back(static_cast<char>(m_fold[byte]));
+    }
+
+    // Horspool shift: distance from the last occurrence of a byte to the end of the needle.
+    m_skip.fill(std::max<std::size_t>(m_needle.size(), 1));
+    for (std::size_t i = 0; i + 1 < m_needle.size(); ++i)
+    {
+        m_skip[static_cast<unsigned char>(m_needle[i])] = m_needle.size() - 1 - i;
+    }
+    if (!caseSensitive)
+    {
+        for (std::size_t c = 'A'; c <= 'Z'; ++c)
+        {
+            m_skip[c] = m_skip[m_fold[c]];
+        }
+    }
+}
+
+bool LineFilter::SubstringMatcher::operator()(const std::string_view haystack) const
+{
+    const std::size_t length = m_needle.size();
+    if (length == 0)
+    {
+        return true;
+    }
+    if (!m_folds)
+    {
+        return haystack.find(m_needle) != std::string_view::npos;
+    }
+
+    const auto* bytes = reinterpret_cast<const unsigned char*>(haystack.data());
+    for (std::size_t position = 0; position + length <= haystack.size();)
+    {
+        std::size_t i = length - 1;
+        while (m_fold[bytes[position + i]] == static_cast<unsigned char>(m_needle[i]))
+        {
+            if (i == 0)
+            {
+                return true;
+            }
+            --i;
+        }
+        position += m_skip[bytes[position + length - 1]];
+    }
+    return false;
+}
+
+void LineFilter::setQuery(Query query)
+{
+    m_query = std::move(query);
+    m_substring.reset();
+    if (!m_query.matcher && !m_query.text.empty())
+    {
+        m_substring.emplace(m_query.text, m_query.caseSensitive);
+    }
+
+    m_matches.clear();
+    m_nextSequence = 0;
+}
+
+bool LineFilter::update(const LineStore& store, const std::size_t maxLines)
+{
+    const std::uint64_t first = store.firstSequence();
+    const std::size_t count = store.lineCount();
+
+    // A clear() restarts the numbering; older matches and progress no longer apply.
+    if (m_nextSequence > first + count)
+    {
+        m_matches.clear();
+        m_nextSequence = 0;
+    }
+
+    std::size_t from = static_cast<std::size_t>(std::max(m_nextSequence, first) - first);
+    std::size_t to = count;
+
+    // A run is one contiguous range, so everything else can be skipped.
+    if (m_query.run.has_value())
+    {
+        const auto [runFirst, runEnd] = store.runLines(m_query.run.value());
+        from = std::max(from, runFirst);
+        to = std::min(to, runEnd);
+        if (from >= to)
+        {
+            // Nothing left of that run to look at; only lines appended later can still belong to it.
+            m_nextSequence = first + count;
+            return true;
+        }
+    }
+    to = std::min(to, from + maxLines);
+
+    const std::uint32_t kinds = m_query.kinds;
+    store.scan(from, to, [&](const std::size_t index, const std::string_view line, const LineStore::Kind kind)
+    {
+        if (!(kinds & kindBit(kind)))
+        {
+            return;
+        }
+        if (m_query.matcher ? m_query.matcher(line) : !m_substring || (*m_substring)(line))
+        {
+            m_matches.push_back(first + index);
+        }
+    });
+
+    m_nextSequence = first + to;
+
+    // Drop matches the store no longer holds once they make up most of the list.
+    const std::size_t dead = firstLiveMatch(store);
+    if (dead > 4096 && dead > m_matches.size() / 2)
+    {
+        m_matches.erase(m_matches.begin(), m_matches.begin() + static_cast<std::ptrdiff_t>(dead));
+    }
+
+    return caughtUp(store);
+}
+
+bool LineFilter::caughtUp(const LineStore& store) const
+{
+    const std::uint64_t end = store.firstSequence() + store.lineCount();
+    if (m_nextSequence >= end)
+    {
+        return true;
+    }
+
+    if (m_query.run.has_value())
+    {
+        // Lines past the run's end never match.
+        const auto [runFirst, runEnd] = store.runLines(m_query.run.value());
+        return runFirst >= runEnd || m_nextSequence >= store.firstSequence() + runEnd;
+    }
+    return false;
+}
+
+std::size_t LineFilter::firstLiveMatch(const LineStore& store) const
+{
+    return static_cast<std::size_t>(
+        std::lower_bound(m_matches.begin(), m_matches.end(), store.firstSequence()) - m_matches.begin());
+}
+
+std::size_t LineFilter::matchCount(const LineStore& store) const
+{
+    return m_matches.size() - firstLiveMatch(store);
+}
+
+std::size_t LineFilter::matchAt(const LineStore& store, const std::size_t n) const
+{
+    return static_cast<std::size_t>(m_matches[firstLiveMatch(store) + n] - store.firstSequence());
+}
@@ -0,0 +1,82 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef LINE_FILTER_H
+#define LINE_FILTER_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LineStore.h"
+
+/**
+ * Incrementally computed set of LineStore lines matching a query.
+ *
+ * update() scans the lines appended since the previous call, a bounded number at a time, so
+ * the caller can spread a large scan over several event loop iterations and keep up with new
+ * output cheaply. Matches are kept as sequence numbers and stay valid when the store drops
+ * its oldest lines.
+ */
+class LineFilter
+{
+public:
+    struct Query
+    {
+        // Substring to look for; empty matches every line.
+        std::string text;
+        bool caseSensitive = false;
+        // Replaces the substring test when set, e.g. for regular expressions.
+        std::function<bool(std::string_view)> matcher;
+        // Bit (1 << Kind) set for every kind to show.
+        std::uint32_t kinds = ~0u;
+        std::optional<std::uint32_t> run;
+    };
+
+    // Substring test. Case-insensitive search folds ASCII only and uses Horspool; everything
+    // else goes to the library's find, which is memchr-based and faster.
+    class SubstringMatcher
+    {
+    public:
+        SubstringMatcher(std::string_view needle, bool caseSensitive);
+        bool operator()(std::string_view haystack) const;
+
+    private:
+        std::array<unsigned char, 256> m_fold{};
+        std::array<std::size_t, 256> m_skip{};
+        std::string m_needle;
+        bool m_folds = false;
+    };
+
+    static constexpr std::uint32_t kindBit(LineStore::Kind kind) { return 1u << static_cast<unsigned>(kind); }
+
+    // Starts over with a new query.
+    void setQuery(Query query);
+    [[nodiscard]] const Query& query() const { return m_query; }
+
+    // Scans up to maxLines lines not looked at yet; returns true once caught up with the store.
+    bool update(const LineStore& store, std::size_t maxLines);
+
+    [[nodiscard]] bool caughtUp(const LineStore& store) const;
+
+    // Matches still held by the store.
+    [[nodiscard]] std::size_t matchCount(const LineStore& store) const;
+    // Store index of the n-th match.
+    [[nodiscard]] std::size_t matchAt(const LineStore& store, std::size_t n) const;
+
+private:
+    [[nodiscard]] std::size_t firstLiveMatch(const LineStore& store) const;
+
+    Query m_query;
+    std::optional<SubstringMatcher> m_substring;
+    std::vector<std::uint64_t> m_matches;
+    // Sequence number of the next line to look at.
+    std::uint64_t m_nextSequence = 0;
+};
+
+#endif // LINE_FILTER_H
@@ -0,0 +1,512 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "LineStore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+#include "RunOutputFile.h"
+
+namespace
+{
+    // Arena size the store starts with; it doubles up to Options::maxBytes as needed.
+    constexpr std::size_t INITIAL_ARENA_BYTES = 64 * 1024;
+
+    // e.g. "2026-10-19_14-03-22_run7.log"; sorts by time, and the run number matches the
+    // "(run N)" in the header line.
+    std::string runFileName(const std::uint32_t run)
+    {
+        const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        char stamp[32];
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%d_%H-%M-%S", std::localtime(&now));
+        return std::string(stamp) + "_run" + std::to_string(run) + ".log";
+    }
+}
+
+LineStore::LineStore() : LineStore(Options{})
+{
+}
+
+LineStore::LineStore(Options options) : m_options(std::move(options))
+{
+    m_options.maxBytes = std::max<std::size_t>(m_options.maxBytes, 1024);
+    m_options.maxLines = std::max<std::size_t>(m_options.maxLines, 1);
+}
+
+LineStore::~LineStore()
+{
+    clear();
+}
+
+void LineStore::appendText(std::string_view text, const Kind kind)
+{
+    while (true)
+    {
+        const std::size_t newline = text.find('\n');
+        std::string_view line = text.substr(0, newline);
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+
+        append(line, kind);
+
+        if (newline == std::string_view::npos)
+        {
+            return;
+        }
+        text.remove_prefix(newline + 1);
+    }
+}
+
+void LineStore::append(std::string_view line, const Kind kind, std::span<const StyleRun> runs)
+{
+    // Style runs are stored right behind the text; a line may not take more than the whole arena.
+    runs = runs.first(std::min<std::size_t>(runs.size(), UINT16_MAX));
+    if (line.size() + runs.size_bytes() > m_options.maxBytes)
+    {
+        runs = {};
+        line = line.substr(0, m_options.maxBytes);
+    }
+    while (!runs.empty() && runs.back().start >= line.size())
+    {
+        runs = runs.first(runs.size() - 1);
+    }
+    const auto length = static_cast<std::uint64_t>(line.size() + runs.size_bytes());
+
+    m_runBytes += line.size();
+    if (m_runFile == nullptr && !m_runFileFailed && !m_options.runDirectory.empty() &&
+        m_runBytes > m_options.persistBytes)
+    {
+        startRunFile();
+    }
+    if (m_runFile != nullptr)
+    {
+        writeToRunFile(line, kind, runs);
+    }
+
+    if (m_count == m_options.maxLines)
+    {
+        evictOldest();
+    }
+
+    // Find room in the arena: grow it while below the cap, evict old lines after that.
+    std::uint64_t position = 0;
+    while (true)
+    {
+        const std::uint64_t capacity = m_arena.size();
+        if (capacity > 0)
+        {
+            // Lines never wrap around the end of the arena; the tail is skipped instead.
+            const std::uint64_t offset = m_arenaTail % capacity;
+            const std::uint64_t padding = offset + length > capacity ? capacity - offset : 0;
+            if (m_arenaTail + padding + length - m_arenaHead <= capacity)
+            {
+                position = m_arenaTail + padding;
+                break;
+            }
+        }
+
+        if (capacity < m_options.maxBytes)
+        {
+            // Grow and compact: live lines are copied to the front of the new arena.
+            const std::uint64_t live = m_arenaTail - m_arenaHead;
+            std::size_t newCapacity = std::max<std::size_t>(capacity * 2, INITIAL_ARENA_BYTES);
+            while (newCapacity < live + length)
+            {
+                newCapacity *= 2;
+            }
+            newCapacity = std::min(newCapacity, m_options.maxBytes);
+
+            std::vector<char> arena(newCapacity);
+            std::uint64_t tail = 0;
+            for (std::size_t i = 0; i < m_count; ++i)
+            {
+                Entry& moved = m_entries[(m_first + i) % m_entries.size()];
+                std::memcpy(arena.data() + tail, text(moved).data(), footprint(moved));
+                moved.position = tail;
+                tail += footprint(moved);
+            }
+
+            m_arena = std::move(arena);
+            m_arenaHead = 0;
+            m_arenaTail = tail;
+            continue;
+        }
+
+        evictOldest();
+    }
+
+    char* destination = m_arena.data() + position % m_arena.size();
+    std::memcpy(destination, line.data(), line.size());
+    if (!runs.empty())
+    {
+        std::memcpy(destination + line.size(), runs.data(), runs.size_bytes());
+    }
+    m_arenaTail = position + length;
+
+    const Entry added{position, static_cast<std::uint32_t>(line.size()), kind, static_cast<std::uint16_t>(runs.size())};
+    if (m_count < m_entries.size())
+    {
+        m_entries[(m_first + m_count) % m_entries.size()] = added;
+    }
+    else
+    {
+        // Full but still below maxLines: unroll the ring and grow it.
+        std::rotate(m_entries.begin(), m_entries.begin() + static_cast<std::ptrdiff_t>(m_first), m_entries.end());
+        m_first = 0;
+        m_entries.push_back(added);
+    }
+    m_count++;
+
+    m_longestLine = std::max<std::size_t>(m_longestLine, line.size());
+    m_totalAppended++;
+}
+
+void LineStore::evictOldest()
+{
+    if (m_count == 0)
+    {
+        // Nothing left to free; start over at the front so a line that does not fit behind
+        // the old tail gets the whole arena.
+        m_arenaHead = m_arenaTail = 0;
+        return;
+    }
+
+    const Entry& oldest = m_entries[m_first];
+
+    // A line of a run with a file stays readable from there. Any other line is gone, and so is
+    // everything before it, which keeps the readable lines contiguous.
+    const std::uint64_t sequence = m_totalAppended - m_count;
+    if (runFileFor(sequence) != nullptr)
+    {
+        m_spilledCount++;
+    }
+    else
+    {
+        m_spilledCount = 0;
+        std::erase_if(m_runFiles, [sequence](const RunFile& runFile) { return runFile.sequence <= sequence; });
+    }
+
+    m_arenaHead = oldest.position + footprint(oldest);
+    m_first = (m_first + 1) % m_entries.size();
+    m_count--;
+
+    if (m_count == 0)
+    {
+        m_arenaHead = m_arenaTail = 0;
+    }
+}
+
+void LineStore::startRunFile()
+{
+    const std::uint32_t run = m_runs.empty() ? 0 : m_runs.back().run;
+    const std::uint64_t runStart = m_runs.empty() ? 0 : m_runs.back().sequence;
+    const std::uint64_t first = std::max(runStart, m_totalAppended - m_count);
+
+    std::error_code error;
+    std::filesystem::create_directories(m_options.runDirectory, error);
+    RunOutputFile::prune(m_options.runDirectory, m_options.runDirectoryBytes);
+
+    m_runFile = RunOutputFile::create(m_options.runDirectory / runFileName(run));
+    if (m_runFile == nullptr)
+    {
+        m_runFileFailed = true;
+        return;
+    }
+    m_runFiles.push_back({m_runFile, first});
+
+    // The run's lines still in memory go first, so the file holds all of it from `first` on.
+    std::vector<StyleRun> runs;
+    const std::size_t firstIndex = static_cast<std::size_t>(first - firstSequence());
+    for (std::size_t index = firstIndex; index < lineCount(); ++index)
+    {
+        const Entry& held = entry(index - m_spilledCount);
+        runs = styles(index);
+        writeToRunFile(text(held), held.kind, runs);
+    }
+}
+
+void LineStore::writeToRunFile(const std::string_view line, const Kind kind, const std::span<const StyleRun> runs)
+{
+    bool written;
+    if (runs.empty())
+    {
+        written = m_runFile->append(line, kind);
+    }
+    else
+    {
+        // Styles go to the file as the SGR sequences they came from.
+        m_encoded.clear();
+        std::size_t copied = 0;
+        for (const StyleRun& run : runs)
+        {
+            m_encoded.append(line.substr(copied, run.start - copied));
+            AnsiParser::appendSgr(m_encoded, run.style);
+            copied = run.start;
+        }
+        m_encoded.append(line.substr(copied));
+        written = m_runFile->append(m_encoded, kind);
+    }
+
+    if (!written)
+    {
+        // Disk full or similar: the file keeps the lines it has and the rest stay in memory only.
+        m_runFile.reset();
+        m_runFileFailed = true;
+    }
+}
+
+const LineStore::RunFile* LineStore::runFileFor(const std::uint64_t sequence) const
+{
+    const auto after = std::upper_bound(m_runFiles.begin(), m_runFiles.end(), sequence,
+                                        [](const std::uint64_t value, const RunFile& runFile)
+                                        {
+                                            return value < runFile.sequence;
+                                        });
+    if (after == m_runFiles.begin())
+    {
+        return nullptr;
+    }
+
+    const RunFile& found = *std::prev(after);
+    return sequence - found.sequence < found.file->lineCount() ? &found : nullptr;
+}
+
+void LineStore::decode(const std::string_view stored, std::string& text, std::vector<StyleRun>* runs) const
+{
+    if (stored.find('\x1b') == std::string_view::npos)
+    {
+        text.assign(stored);
+        return;
+    }
+
+    const AnsiParser::LineSink sink = [&text, runs](const std::string_view line, const std::span<const StyleRun> parsed)
+    {
+        text.assign(line);
+        if (runs != nullptr)
+        {
+            runs->assign(parsed.begin(), parsed.end());
+        }
+    };
+    text.clear();
+    m_decoder.reset();
+    m_decoder.feed(stored, sink);
+    m_decoder.finish(sink);
+}
+
+const LineStore::Entry& LineStore::entry(const std::size_t inMemoryIndex) const
+{
+    return m_entries[(m_first + inMemoryIndex) % m_entries.size()];
+}
+
+std::string_view LineStore::text(const Entry& entry) const
+{
+    return {m_arena.data() + entry.position % m_arena.size(), entry.length};
+}
+
+std::string LineStore::line(const std::size_t index) const
+{
+    if (index < m_spilledCount)
+    {
+        const std::uint64_t sequence = firstSequence() + index;
+        const RunFile* runFile = runFileFor(sequence);
+        std::string result;
+        decode(runFile->file->line(sequence - runFile->sequence), result, nullptr);
+        return result;
+    }
+
+    const std::size_t inMemory = index - m_spilledCount;
+    if (inMemory >= m_count)
+    {
+        return {};
+    }
+    return std::string(text(entry(inMemory)));
+}
+
+std::vector<StyleRun> LineStore::styles(const std::size_t index) const
+{
+    std::vector<StyleRun> runs;
+
+    if (index < m_spilledCount)
+    {
+        const std::uint64_t sequence = firstSequence() + index;
+        const RunFile* runFile = runFileFor(sequence);
+        std::string text;
+        decode(runFile->file->line(sequence - runFile->sequence), text, &runs);
+        return runs;
+    }
+
+    const std::size_t inMemory = index - m_spilledCount;
+    if (inMemory < m_count && entry(inMemory).styleRuns > 0)
+    {
+        const Entry& held = entry(inMemory);
+        runs.resize(held.styleRuns);
+        std::memcpy(runs.data(), text(held).data() + held.length, runs.size() * sizeof(StyleRun));
+    }
+    return runs;
+}
+
+LineStore::Kind LineStore::kind(const std::size_t index) const
+{
+    if (index < m_spilledCount)
+    {
+        const std::uint64_t sequence = firstSequence() + index;
+        const RunFile* runFile = runFileFor(sequence);
+        Kind result;
+        (void)runFile->file->line(sequence - runFile->sequence, &result);
+        return result;
+    }
+
+    const std::size_t inMemory = index - m_spilledCount;
+    return inMemory < m_count ? entry(inMemory).kind : Kind::Output;
+}
+
+void LineStore::scan(const std::size_t from, std::size_t to, const Visitor& visit) const
+{
+    to = std::min(to, lineCount());
+    std::size_t index = from;
+
+    // Spilled lines: each run file is read front to back, through its mapped window.
+    const std::uint64_t first = firstSequence();
+    std::string decoded;
+    while (index < std::min(to, m_spilledCount))
+    {
+        const RunFile* runFile = runFileFor(first + index);
+        const std::size_t fileFrom = static_cast<std::size_t>(first + index - runFile->sequence);
+        const std::size_t fileTo = std::min(runFile->file->lineCount(), fileFrom + (std::min(to, m_spilledCount) - index));
+        runFile->file->scan(fileFrom, fileTo, [&](const std::size_t n, const std::string_view stored, const Kind kind)
+        {
+            decode(stored, decoded, nullptr);
+            visit(static_cast<std::size_t>(runFile->sequence + n - first), decoded, kind);
+        });
+        index += fileTo - fileFrom;
+    }
+
+    if (index >= to)
+    {
+        return;
+    }
+
+    // Walk both rings sequentially instead of paying two divisions per line in entry()/text().
+    const std::uint64_t capacity = m_arena.size();
+    std::size_t slot = (m_first + (index - m_spilledCount)) % m_entries.size();
+    std::uint64_t position = m_entries[slot].position;
+    std::uint64_t physical = position % capacity;
+    for (; index < to; ++index)
+    {
+        const Entry& held = m_entries[slot];
+        physical += held.position - position;
+        position = held.position;
+        if (physical >= capacity)
+        {
+            physical -= capacity;
+        }
+
+        visit(index, std::string_view(m_arena.data() + physical, held.length), held.kind);
+
+        if (++slot == m_entries.size())
+        {
+            slot = 0;
+        }
+    }
+}
+
+void LineStore::setRun(const std::uint32_t run)
+{
+    // The previous run is complete; put its file on disk in case the app does not exit cleanly.
+    if (m_runFile != nullptr)
+    {
+        m_runFile->flush();
+        m_runFile.reset();
+    }
+    m_runFileFailed = false;
+    m_runBytes = 0;
+
+    if (!m_runs.empty() && m_runs.back().sequence == m_totalAppended)
+    {
+        m_runs.back().run = run; // the previous run got no lines
+        return;
+    }
+    m_runs.push_back({m_totalAppended, run});
+}
+
+std::uint32_t LineStore::run(const std::size_t index) const
+{
+    const std::uint64_t sequence = firstSequence() + index;
+    const auto after = std::upper_bound(m_runs.begin(), m_runs.end(), sequence,
+                                        [](const std::uint64_t value, const RunStart& start)
+                                        {
+                                            return value < start.sequence;
+                                        });
+    return after == m_runs.begin() ? 0 : std::prev(after)->run;
+}
+
+std::pair<std::size_t, std::size_t> LineStore::runLines(const std::uint32_t run) const
+{
+    // Runs are few and the one asked for is usually recent.
+    for (auto it = m_runs.rbegin(); it != m_runs.rend(); ++it)
+    {
+        if (it->run != run)
+        {
+            continue;
+        }
+
+        const std::uint64_t first = firstSequence();
+        const std::uint64_t end = it == m_runs.rbegin() ? m_totalAppended : std::prev(it)->sequence;
+        const std::uint64_t begin = std::max(it->sequence, first);
+        if (end <= begin)
+        {
+            return {0, 0};
+        }
+        return {static_cast<std::size_t>(begin - first), static_cast<std::size_t>(end - first)};
+    }
+    return {0, 0};
+}
+
+std::size_t LineStore::memoryBytes() const
+{
+    std::size_t bytes = m_arena.capacity() + m_entries.capacity() * sizeof(Entry);
+    for (const RunFile& runFile : m_runFiles)
+    {
+        bytes += runFile.file->memoryBytes();
+    }
+    return bytes;
+}
+
+bool LineStore::load(const std::filesystem::path& runFile)
+{
+    clear();
+
+    std::shared_ptr<RunOutputFile> file = RunOutputFile::open(runFile);
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    m_spilledCount = file->lineCount();
+    m_totalAppended = file->lineCount();
+    m_longestLine = file->longestLine();
+    m_runFiles.push_back({std::move(file), 0});
+    return true;
+}
+
+void LineStore::clear()
+{
+    m_arena = {};
+    m_arenaHead = m_arenaTail = 0;
+    m_entries = {};
+    m_first = m_count = 0;
+    m_spilledCount = 0;
+    m_runFiles = {};
+    m_runFile.reset();
+    m_runFileFailed = false;
+    m_runBytes = 0;
+    m_runs = {};
+    m_longestLine = 0;
+    m_totalAppended = 0;
+}
@@ -0,0 +1,178 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef LINE_STORE_H
+#define LINE_STORE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AnsiParser.h"
+#include "TextStyle.h"
+
+class RunOutputFile;
+
+/**
+ * Append-only store for the lines shown in the output panel, with a fixed memory cap.
+ *
+ * Line text lives as UTF-8 in one circular byte arena, each line followed by its style runs
+ * (if any); a second ring holds a small entry (position, length, kind) per line. When either
+ * is full the oldest lines are evicted.
+ *
+ * With Options::runDirectory set, a run whose output grows past Options::persistBytes is
+ * written through to a RunOutputFile there. Its evicted lines stay readable from that file, so
+ * scrolling back through a multi-GB run still works while the memory in use stays bounded, and
+ * the file outlives the session: load() shows it again later. Lines of smaller runs are
+ * dropped on eviction, together with anything older.
+ *
+ * Lines are addressed by index in [0, lineCount()), oldest first. Each line also has a
+ * sequence number that does not change when older lines are dropped (see firstSequence()),
+ * and belongs to the run set with setRun() when it was appended. Not thread-safe.
+ */
+class LineStore
+{
+public:
+    enum class Kind : std::uint8_t
+    {
+        Output,
+        Error,
+        Warning,
+        Header,
+    };
+
+    struct Options
+    {
+        // Bytes of line text kept in memory.
+        std::size_t maxBytes = 32 * 1024 * 1024;
+        // Lines kept in memory.
+        std::size_t maxLines = 1'000'000;
+        // Where runs with large output are written; nothing goes to disk when empty.
+        std::filesystem::path runDirectory;
+        // Bytes of text a run prints before it is written to the run directory.
+        std::uint64_t persistBytes = 8 * 1024 * 1024;
+        // Older run files are deleted once the directory holds more than this.
+        std::uint64_t runDirectoryBytes = 4ull * 1024 * 1024 * 1024;
+    };
+
+    LineStore();
+    explicit LineStore(Options options);
+    ~LineStore();
+
+    LineStore(const LineStore&) = delete;
+    LineStore& operator=(const LineStore&) = delete;
+
+    using Visitor = std::function<void(std::size_t index, std::string_view line, Kind kind)>;
+
+    // runs, if given, are sorted by start and refer to byte offsets in line.
+    void append(std::string_view line, Kind kind, std::span<const StyleRun> runs = {});
+
+    // Splits text on '\n' (dropping a trailing '\r') and appends every line.
+    void appendText(std::string_view text, Kind kind);
+
+    [[nodiscard]] std::size_t lineCount() const { return m_spilledCount + m_count; }
+    [[nodiscard]] std::string line(std::size_t index) const;
+    [[nodiscard]] Kind kind(std::size_t index) const;
+    // Empty for lines in the default style.
+    [[nodiscard]] std::vector<StyleRun> styles(std::size_t index) const;
+
+    // Calls visit for every line in [from, to); much faster than line() for long ranges.
+    void scan(std::size_t from, std::size_t to, const Visitor& visit) const;
+
+    // Lines appended from now on belong to run.
+    void setRun(std::uint32_t run);
+    [[nodiscard]] std::uint32_t run(std::size_t index) const;
+    // Index range [first, second) of the lines of run still held; empty if there are none.
+    [[nodiscard]] std::pair<std::size_t, std::size_t> runLines(std::uint32_t run) const;
+
+    // Sequence number of line 0; line i has sequence firstSequence() + i.
+    [[nodiscard]] std::uint64_t firstSequence() const { return m_totalAppended - lineCount(); }
+
+    // Length in bytes of the longest line appended so far; handy for horizontal scrolling.
+    [[nodiscard]] std::size_t longestLine() const { return m_longestLine; }
+
+    // Lines appended since construction or clear(), including dropped ones.
+    [[nodiscard]] std::uint64_t totalAppended() const { return m_totalAppended; }
+
+    // Heap memory held for line text, entries and run file indexes.
+    [[nodiscard]] std::size_t memoryBytes() const;
+
+    // Replaces the contents with a run file written earlier; its lines are read from disk as
+    // needed. False if the file cannot be opened, which leaves the store empty.
+    bool load(const std::filesystem::path& runFile);
+
+    // Drops every line; run files stay on disk.
+    void clear();
+
+private:
+    struct Entry
+    {
+        std::uint64_t position; // absolute arena position
+        std::uint32_t length; // of the text
+        Kind kind;
+        std::uint16_t styleRuns;
+    };
+
+    // A run file and the sequence number of its first line.
+    struct RunFile
+    {
+        std::shared_ptr<RunOutputFile> file;
+        std::uint64_t sequence;
+    };
+
+    struct RunStart
+    {
+        std::uint64_t sequence; // of the run's first line
+        std::uint32_t run;
+    };
+
+    // Bytes a line takes in the arena: its text plus its style runs.
+    static std::uint64_t footprint(const Entry& entry) { return entry.length + entry.styleRuns * sizeof(StyleRun); }
+
+    [[nodiscard]] const Entry& entry(std::size_t inMemoryIndex) const;
+    void evictOldest();
+    // Writes the current run's lines held so far to a new run file and keeps writing through.
+    void startRunFile();
+    void writeToRunFile(std::string_view line, Kind kind, std::span<const StyleRun> runs);
+    // The run file holding the line with this sequence number, or nullptr.
+    [[nodiscard]] const RunFile* runFileFor(std::uint64_t sequence) const;
+    // Splits the SGR sequences a line was written with back off into runs.
+    void decode(std::string_view stored, std::string& text, std::vector<StyleRun>* runs) const;
+    [[nodiscard]] std::string_view text(const Entry& entry) const;
+
+    Options m_options;
+
+    std::vector<char> m_arena;
+    std::uint64_t m_arenaHead = 0; // first byte still in use
+    std::uint64_t m_arenaTail = 0; // next byte to write
+
+    // Ring of entries for the lines held in memory.
+    std::vector<Entry> m_entries;
+    std::size_t m_first = 0;
+    std::size_t m_count = 0;
+
+    // Lines evicted from memory that are still readable from run files, and those files.
+    std::size_t m_spilledCount = 0;
+    std::vector<RunFile> m_runFiles;
+
+    // The current run: its size so far and the file it is written through to, if any.
+    std::uint64_t m_runBytes = 0;
+    std::shared_ptr<RunOutputFile> m_runFile;
+    bool m_runFileFailed = false;
+    std::string m_encoded;
+    mutable AnsiParser m_decoder;
+
+    // Sorted by sequence; a run's lines end where the next entry starts.
+    std::vector<RunStart> m_runs;
+
+    std::size_t m_longestLine = 0;
+    std::uint64_t m_totalAppended = 0;
+};
+
+#endif // LINE_STORE_H
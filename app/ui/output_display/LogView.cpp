@@ -0,0 +1,430 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "LogView.h"
+
+#include <algorithm>
+#include <climits>
+
+#include <QApplication>
+#include <QClipboard>
+#include <QFontDatabase>
+#include <QKeyEvent>
+#include <QPainter>
+#include <QScrollBar>
+
+namespace
+{
+    constexpr int LEFT_MARGIN = 6;
+
+    // Lines the filter looks at per event loop iteration; a few milliseconds' worth.
+    constexpr std::size_t FILTER_SLICE_LINES = 200'000;
+
+    // xterm's 256-color palette: 16 system colors, a 6x6x6 cube and 24 grays.
+    QColor paletteColor(const std::uint32_t index)
+    {
+        static constexpr QRgb SYSTEM[16] = {
+            0x0C0C0C, 0xC50F1F, 0x13A10E, 0xC19C00, 0x0037DA, 0x881798, 0x3A96DD, 0xCCCCCC,
+            0x767676, 0xE74856, 0x16C60C, 0xF9F1A5, 0x3B78FF, 0xB4009E, 0x61D6D6, 0xF2F2F2,
+        };
+        if (index < 16)
+        {
+            return QColor::fromRgb(SYSTEM[index]);
+        }
+        if (index < 232)
+        {
+            const auto level = [](const std::uint32_t value) { return value == 0 ? 0 : 55 + static_cast<int>(value) * 40; };
+            const std::uint32_t cube = index - 16;
+            return {level(cube / 36), level(cube / 6 % 6), level(cube % 6)};
+        }
+        const int gray = 8 + static_cast<int>(index - 232) * 10;
+        return {gray, gray, gray};
+    }
+
+    QColor styleColor(const std::uint32_t color, const QColor& fallback)
+    {
+        switch (color >> 24)
+        {
+        case TextStyle::INDEXED >> 24:
+            return paletteColor(color & 0xFF);
+        case TextStyle::RGB >> 24:
+            return QColor::fromRgb(color & 0xFFFFFF);
+        default:
+            return fallback;
+        }
+    }
+
+    QColor colorFor(const LineStore::Kind kind)
+    {
+        switch (kind)
+        {
+        case LineStore::Kind::Error:
+            return {0xFF, 0x63, 0x47};
+        case LineStore::Kind::Warning:
+            return {0xFF, 0xA5, 0x00};
+        case LineStore::Kind::Header:
+            return {0xFF, 0xFD, 0xD0};
+        case LineStore::Kind::Output:
+            break;
+        }
+        return Qt::white;
+    }
+}
+
+LogView::LogView(QWidget* parent, LineStore::Options options)
+    : QAbstractScrollArea(parent), m_store(std::make_unique<LineStore>(std::move(options)))
+{
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setFocusPolicy(Qt::StrongFocus);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    viewport()->setCursor(Qt::IBeamCursor);
+
+    m_filterTimer.setSingleShot(true);
+    m_filterTimer.setInterval(0);
+    connect(&m_filterTimer, &QTimer::timeout, this, &LogView::continueFilter);
+}
+
+LogView::~LogView() = default;
+
+void LogView::appendText(const QString& text, const LineStore::Kind kind)
+{
+    QScrollBar* bar = verticalScrollBar();
+    const bool following = bar->value() >= bar->maximum();
+
+    QString normalized = text;
+    normalized.replace(QChar::ParagraphSeparator, '\n');
+    const QByteArray bytes = normalized.toUtf8();
+
+    AnsiParser& parser = m_parsers[static_cast<std::size_t>(kind) % m_parsers.size()];
+    const AnsiParser::LineSink sink = [this, kind](const std::string_view line, const std::span<const StyleRun> runs)
+    {
+        m_store->append(line, kind, runs);
+    };
+    parser.feed(std::string_view(bytes.constData(), static_cast<std::size_t>(bytes.size())), sink);
+    parser.feed("\n", sink);
+
+    if (m_filtered && !m_filterTimer.isActive())
+    {
+        m_filterTimer.start();
+    }
+
+    updateScrollBars();
+    if (following)
+    {
+        bar->setValue(bar->maximum());
+    }
+    viewport()->update();
+}
+
+void LogView::beginRun(const std::uint32_t run)
+{
+    m_store->setRun(run);
+}
+
+void LogView::clear()
+{
+    m_store->clear();
+    for (AnsiParser& parser : m_parsers)
+    {
+        parser.reset();
+    }
+    m_filter.setQuery(m_filter.query());
+    m_anchor = m_cursor = -1;
+    updateScrollBars();
+    viewport()->update();
+}
+
+bool LogView::openRun(const std::filesystem::path& runFile)
+{
+    clear();
+    const bool loaded = m_store->load(runFile);
+
+    if (m_filtered)
+    {
+        m_filterTimer.start();
+    }
+    updateScrollBars();
+    verticalScrollBar()->setValue(0);
+    viewport()->update();
+    return loaded;
+}
+
+void LogView::setFilter(LineFilter::Query query)
+{
+    m_filter.setQuery(std::move(query));
+    m_filtered = true;
+    m_anchor = m_cursor = -1;
+
+    // The first slice runs right away so short transcripts filter without a visible step.
+    continueFilter();
+    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+}
+
+void LogView::clearFilter()
+{
+    if (!m_filtered)
+    {
+        return;
+    }
+
+    m_filterTimer.stop();
+    m_filtered = false;
+    m_filter.setQuery({});
+    m_anchor = m_cursor = -1;
+
+    updateScrollBars();
+    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+    viewport()->update();
+    emit filterProgress(static_cast<qsizetype>(m_store->lineCount()), true);
+}
+
+void LogView::continueFilter()
+{
+    QScrollBar* bar = verticalScrollBar();
+    const bool following = bar->value() >= bar->maximum();
+
+    const bool complete = m_filter.update(*m_store, FILTER_SLICE_LINES);
+    if (!complete)
+    {
+        m_filterTimer.start();
+    }
+
+    updateScrollBars();
+    if (following)
+    {
+        bar->setValue(bar->maximum());
+    }
+    viewport()->update();
+    emit filterProgress(static_cast<qsizetype>(m_filter.matchCount(*m_store)), complete);
+}
+
+std::size_t LogView::rowCount() const
+{
+    return m_filtered ? m_filter.matchCount(*m_store) : m_store->lineCount();
+}
+
+std::size_t LogView::storeIndex(const std::size_t row) const
+{
+    return m_filtered ? m_filter.matchAt(*m_store, row) : row;
+}
+
+int LogView::lineHeight() const
+{
+    return fontMetrics().height();
+}
+
+void LogView::updateScrollBars()
+{
+    const int visibleRows = std::max(1, viewport()->height() / lineHeight());
+    const auto lines = static_cast<int>(std::min<std::size_t>(rowCount(), INT_MAX));
+
+    QScrollBar* vertical = verticalScrollBar();
+    vertical->setRange(0, std::max(0, lines - visibleRows));
+    vertical->setPageStep(visibleRows);
+    vertical->setSingleStep(1);
+
+    // Widest line estimated from its byte length; exact for ASCII in a fixed font.
+    const int charWidth = fontMetrics().horizontalAdvance(QLatin1Char('M'));
+    const auto contentWidth = static_cast<int>(std::min<std::size_t>(m_store->longestLine(), INT_MAX / 16)) * charWidth;
+
+    QScrollBar* horizontal = horizontalScrollBar();
+    horizontal->setRange(0, std::max(0, contentWidth + 2 * LEFT_MARGIN - viewport()->width()));
+    horizontal->setPageStep(viewport()->width());
+    horizontal->setSingleStep(charWidth * 4);
+}
+
+void LogView::paintEvent(QPaintEvent*)
+{
+    QPainter painter(viewport());
+    painter.fillRect(viewport()->rect(), palette().color(QPalette::Base));
+    painter.setFont(font());
+
+    const int height = lineHeight();
+    const int ascent = fontMetrics().ascent();
+    const int x = LEFT_MARGIN - horizontalScrollBar()->value();
+    const auto first = static_cast<std::size_t>(verticalScrollBar()->value());
+    const std::size_t last = std::min(rowCount(), first + viewport()->height() / height + 2);
+
+    int y = 0;
+    for (std::size_t row = first; row < last; ++row, y += height)
+    {
+        if (isSelected(static_cast<qsizetype>(row)))
+        {
+            painter.fillRect(0, y, viewport()->width(), height, palette().color(QPalette::Highlight));
+        }
+
+        const std::size_t line = storeIndex(row);
+        const QColor color = colorFor(m_store->kind(line));
+        const std::vector<StyleRun> runs = m_store->styles(line);
+        if (runs.empty())
+        {
+            painter.setPen(color);
+            painter.drawText(x, y + ascent, QString::fromStdString(m_store->line(line)));
+        }
+        else
+        {
+            paintStyledLine(painter, x, y, m_store->line(line), runs, color);
+        }
+    }
+}
+
+void LogView::paintStyledLine(QPainter& painter, int x, const int y, const std::string& text,
+                              const std::vector<StyleRun>& runs, const QColor& defaultColor) const
+{
+    const int height = lineHeight();
+    const QColor base = palette().color(QPalette::Base);
+
+    // The text before the first run is in the default style.
+    std::size_t segmentStart = 0;
+    TextStyle style;
+    for (std::size_t i = 0; i <= runs.size(); ++i)
+    {
+        const std::size_t segmentEnd = i < runs.size() ? std::min<std::size_t>(runs[i].start, text.size()) : text.size();
+        if (segmentEnd > segmentStart)
+        {
+            const QString segment = QString::fromUtf8(text.data() + segmentStart,
+                                                      static_cast<qsizetype>(segmentEnd - segmentStart));
+
+            QFont font = painter.font();
+            font.setBold(style.flags & TextStyle::Bold);
+            font.setItalic(style.flags & TextStyle::Italic);
+            font.setUnderline(style.flags & TextStyle::Underline);
+            font.setStrikeOut(style.flags & TextStyle::Strike);
+            painter.setFont(font);
+
+            QColor foreground = styleColor(style.foreground, defaultColor);
+            QColor background = styleColor(style.background, base);
+            if (style.flags & TextStyle::Inverse)
+            {
+                std::swap(foreground, background);
+            }
+            if (style.flags & TextStyle::Dim)
+            {
+                foreground.setAlpha(160);
+            }
+
+            const int width = QFontMetrics(font).horizontalAdvance(segment);
+            if (background != base)
+            {
+                painter.fillRect(x, y, width, height, background);
+            }
+            if (!(style.flags & TextStyle::Hidden))
+            {
+                painter.setPen(foreground);
+                painter.drawText(x, y + fontMetrics().ascent(), segment);
+            }
+            x += width;
+        }
+
+        if (i < runs.size())
+        {
+            segmentStart = segmentEnd;
+            style = runs[i].style;
+        }
+    }
+
+    painter.setFont(font());
+}
+
+void LogView::resizeEvent(QResizeEvent* event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void LogView::changeEvent(QEvent* event)
+{
+    QAbstractScrollArea::changeEvent(event);
+    if (event->type() == QEvent::FontChange)
+    {
+        updateScrollBars();
+    }
+}
+
+qsizetype LogView::rowAt(const int y) const
+{
+    const qsizetype row = verticalScrollBar()->value() + std::max(0, y) / lineHeight();
+    return std::min<qsizetype>(row, static_cast<qsizetype>(rowCount()) - 1);
+}
+
+bool LogView::isSelected(const qsizetype row) const
+{
+    return m_anchor >= 0 && row >= std::min(m_anchor, m_cursor) && row <= std::max(m_anchor, m_cursor);
+}
+
+void LogView::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton || rowCount() == 0)
+    {
+        return;
+    }
+
+    m_cursor = rowAt(event->position().toPoint().y());
+    if (!(event->modifiers() & Qt::ShiftModifier) || m_anchor < 0)
+    {
+        m_anchor = m_cursor;
+    }
+    viewport()->update();
+}
+
+void LogView::mouseMoveEvent(QMouseEvent* event)
+{
+    if (!(event->buttons() & Qt::LeftButton) || m_anchor < 0)
+    {
+        return;
+    }
+
+    const int y = event->position().toPoint().y();
+    // Dragging past the edges scrolls.
+    if (y < 0)
+    {
+        verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepSub);
+    }
+    else if (y > viewport()->height())
+    {
+        verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepAdd);
+    }
+
+    m_cursor = rowAt(y);
+    viewport()->update();
+}
+
+void LogView::keyPressEvent(QKeyEvent* event)
+{
+    if (event->matches(QKeySequence::Copy))
+    {
+        copySelection();
+        return;
+    }
+
+    if (event->matches(QKeySequence::SelectAll) && rowCount() > 0)
+    {
+        m_anchor = 0;
+        m_cursor = static_cast<qsizetype>(rowCount()) - 1;
+        viewport()->update();
+        return;
+    }
+
+    QAbstractScrollArea::keyPressEvent(event);
+}
+
+void LogView::copySelection() const
+{
+    if (m_anchor < 0)
+    {
+        return;
+    }
+
+    std::string text;
+    const auto from = static_cast<std::size_t>(std::min(m_anchor, m_cursor));
+    const auto to = static_cast<std::size_t>(std::max(m_anchor, m_cursor));
+    for (std::size_t row = from; row <= to && row < rowCount(); ++row)
+    {
+        text += m_store->line(storeIndex(row));
+        text += '\n';
+    }
+
+    QApplication::clipboard()->setText(QString::fromStdString(text));
+}
@@ -0,0 +1,98 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef LOG_VIEW_H
+#define LOG_VIEW_H
+
+#include <array>
+#include <filesystem>
+#include <memory>
+
+#include <QAbstractScrollArea>
+#include <QTimer>
+
+#include "AnsiParser.h"
+#include "LineFilter.h"
+#include "LineStore.h"
+
+/**
+ * Read-only view over a LineStore. Only the rows that fit in the viewport are laid out and
+ * painted, so the cost of a repaint does not depend on how many lines are stored.
+ *
+ * Text goes through an AnsiParser per line kind, so colors and attributes set by escape
+ * sequences are shown and the sequences themselves are not. Lines are not wrapped and all
+ * rows have the same height. Selection works on whole lines
+ * (click and drag, Shift+click, Ctrl+A) and Ctrl+C copies it.
+ *
+ * With a filter set only matching lines are shown. The filter is evaluated a slice at a time
+ * from the event loop, and then only for lines appended since, so neither setting a filter
+ * nor new output blocks the UI however many lines are held.
+ */
+class LogView final : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit LogView(QWidget* parent = nullptr, LineStore::Options options = {});
+    ~LogView() override;
+
+    // Appends text, one line per '\n'; the last line is taken as complete. Keeps following the
+    // end if the view was at the bottom.
+    void appendText(const QString& text, LineStore::Kind kind);
+
+    // Lines appended from now on belong to run.
+    void beginRun(std::uint32_t run);
+
+    void clear();
+
+    // Replaces the contents with a run file written by the store earlier (see
+    // LineStore::Options::runDirectory); false if it cannot be read.
+    bool openRun(const std::filesystem::path& runFile);
+
+    void setFilter(LineFilter::Query query);
+    void clearFilter();
+    [[nodiscard]] bool isFiltered() const { return m_filtered; }
+
+    [[nodiscard]] const LineStore& store() const { return *m_store; }
+
+signals:
+    // Emitted as filtering progresses; complete once every line has been looked at.
+    void filterProgress(qsizetype matches, bool complete);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void keyPressEvent(QKeyEvent* event) override;
+    void changeEvent(QEvent* event) override;
+
+private:
+    void continueFilter();
+    // Paints one line whose text has style runs, starting at x.
+    void paintStyledLine(QPainter& painter, int x, int y, const std::string& text,
+                         const std::vector<StyleRun>& runs, const QColor& defaultColor) const;
+    // Rows shown: all lines, or the matching ones while filtered.
+    [[nodiscard]] std::size_t rowCount() const;
+    [[nodiscard]] std::size_t storeIndex(std::size_t row) const;
+    void updateScrollBars();
+    [[nodiscard]] int lineHeight() const;
+    [[nodiscard]] qsizetype rowAt(int y) const;
+    [[nodiscard]] bool isSelected(qsizetype row) const;
+    void copySelection() const;
+
+    std::unique_ptr<LineStore> m_store;
+    // Style state carries over between appends, separately for each kind.
+    std::array<AnsiParser, 4> m_parsers;
+
+    LineFilter m_filter;
+    bool m_filtered = false;
+    QTimer m_filterTimer;
+
+    // Selected rows, inclusive; -1 when nothing is selected.
+    qsizetype m_anchor = -1;
+    qsizetype m_cursor = -1;
+};
+
+#endif // LOG_VIEW_H
@@ -0,0 +1,126 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "OutputCoalescer.h"
+
+#include <algorithm>
+
+#include "LogView.h"
+
+namespace
+{
+    // One display frame at 60 Hz.
+    constexpr int FRAME_INTERVAL_MS = 16;
+    // Time a flush may take before the batch shrinks; leaves the rest of the frame for input and painting.
+    constexpr qint64 FLUSH_BUDGET_NS = 6'000'000;
+
+    constexpr qsizetype MIN_BATCH_LINES = 1'000;
+    constexpr qsizetype MAX_BATCH_LINES = 1'000'000;
+}
+
+OutputCoalescer::OutputCoalescer(LogView* view, QObject* parent)
+    : QObject(parent), m_view(view), m_batchLines(MIN_BATCH_LINES * 16)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setInterval(FRAME_INTERVAL_MS);
+    connect(&m_timer, &QTimer::timeout, this, &OutputCoalescer::flush);
+}
+
+void OutputCoalescer::beginRun(const std::uint32_t run)
+{
+    m_queuedRun = run;
+}
+
+void OutputCoalescer::append(const QString& text, const LineStore::Kind kind)
+{
+    const qsizetype lines = text.count('\n') + 1;
+
+    // Consecutive output of the same kind travels as one chunk.
+    if (!m_chunks.isEmpty() && m_chunks.last().kind == kind && m_chunks.last().run == m_queuedRun)
+    {
+        Chunk& last = m_chunks.last();
+        last.text += '\n';
+        last.text += text;
+        last.lines += lines;
+    }
+    else
+    {
+        m_chunks.append({text, kind, lines, m_queuedRun});
+    }
+    m_pendingLines += lines;
+
+    if (!m_timer.isActive())
+    {
+        m_timer.start();
+    }
+}
+
+qsizetype OutputCoalescer::drain(const qsizetype maxLines)
+{
+    qsizetype moved = 0;
+    while (!m_chunks.isEmpty() && moved < maxLines)
+    {
+        Chunk& chunk = m_chunks.first();
+        const qsizetype wanted = maxLines - moved;
+
+        if (chunk.run != m_viewRun)
+        {
+            m_viewRun = chunk.run;
+            m_view->beginRun(chunk.run);
+        }
+
+        if (chunk.lines <= wanted)
+        {
+            m_view->appendText(chunk.text, chunk.kind);
+            moved += chunk.lines;
+            m_chunks.removeFirst();
+            continue;
+        }
+
+        // Split the chunk after its wanted-th line.
+        qsizetype at = -1;
+        for (qsizetype i = 0; i < wanted; ++i)
+        {
+            at = chunk.text.indexOf('\n', at + 1);
+        }
+        m_view->appendText(chunk.text.first(at), chunk.kind);
+        chunk.text.remove(0, at + 1);
+        chunk.lines -= wanted;
+        moved += wanted;
+    }
+
+    m_pendingLines -= moved;
+    return moved;
+}
+
+void OutputCoalescer::flush()
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    drain(m_batchLines);
+    const qint64 took = elapsed.nsecsElapsed();
+
+    // Grow while flushes are cheap and output is still waiting; back off when one runs long.
+    if (took > FLUSH_BUDGET_NS)
+    {
+        m_batchLines = std::max(MIN_BATCH_LINES, m_batchLines / 2);
+    }
+    else if (m_pendingLines > 0 && took < FLUSH_BUDGET_NS / 2)
+    {
+        m_batchLines = std::min(MAX_BATCH_LINES, m_batchLines * 2);
+    }
+
+    if (m_pendingLines > 0)
+    {
+        m_timer.start();
+    }
+}
+
+void OutputCoalescer::flushAll()
+{
+    m_timer.stop();
+    drain(m_pendingLines);
+}
@@ -0,0 +1,67 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef OUTPUT_COALESCER_H
+#define OUTPUT_COALESCER_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QTimer>
+
+#include "LineStore.h"
+
+class LogView;
+
+/**
+ * Queues output for a LogView and hands it over at most once per display frame.
+ *
+ * However fast a script prints, the view sees one append and one repaint per frame. The
+ * number of lines moved per frame adapts to how long the previous flush took, so a large
+ * backlog drains quickly without a single flush stalling the event loop.
+ */
+class OutputCoalescer final : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OutputCoalescer(LogView* view, QObject* parent = nullptr);
+
+    // Lines queued from now on belong to run.
+    void beginRun(std::uint32_t run);
+
+    // Queues one or more lines.
+    void append(const QString& text, LineStore::Kind kind);
+
+    // Hands everything queued to the view right away.
+    void flushAll();
+
+    [[nodiscard]] qsizetype pendingLines() const { return m_pendingLines; }
+
+private slots:
+    void flush();
+
+private:
+    struct Chunk
+    {
+        QString text;
+        LineStore::Kind kind;
+        qsizetype lines;
+        std::uint32_t run;
+    };
+
+    // Moves up to maxLines lines to the view; returns how many were moved.
+    qsizetype drain(qsizetype maxLines);
+
+    LogView* m_view;
+    QTimer m_timer;
+    QList<Chunk> m_chunks;
+    qsizetype m_pendingLines = 0;
+    qsizetype m_batchLines;
+    // Run of the lines being queued, and of the last ones handed to the view.
+    std::uint32_t m_queuedRun = 0;
+    std::uint32_t m_viewRun = 0;
+};
+
+#endif // OUTPUT_COALESCER_H
@@ -23,64 +23,206 @@
 //
 // Created by talik on 5/1/2024.
 //
-#include <QScrollArea>
+#include <climits>
 #include <QDateTime>
+#include <QFileInfo>
 #include "OutputDisplay.h"
 #include "Utils.h"
 #include "app_ui/AppUi.h"
-#include <QScrollArea>
+#include <QComboBox>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QIntValidator>
 #include <QLabel>
-#include <QPlainTextEdit>
+#include <QHeaderView>
+#include <QLineEdit>
+#include <QRegularExpression>
+#include <QTableView>
+#include <QToolButton>
 #include <QVBoxLayout>
 
-void init_main_out_area(QPlainTextEdit*, QVBoxLayout*, int);
+#include "LogView.h"
+#include "OutputCoalescer.h"
+#include "RecordTableModel.h"
 
-OutputDisplay::OutputDisplay(QWidget* window) : QWidget(window), m_window(window)
+namespace
 {
-    // TODO This will eventually become a tool bar
-    const auto pMainLabel = new QLabel(this);
-    pMainLabel->setFixedHeight(25);
-    pMainLabel->setText("❯_");
+    // Prefix PowerShell puts in front of the warning stream's lines.
+    const QString WARNING_PREFIX = QStringLiteral("WARNING:");
+}
 
+OutputDisplay::OutputDisplay(std::filesystem::path runDirectory, QWidget* window)
+    : QWidget(window), m_window(window), m_runDirectory(std::move(runDirectory))
+{
     const auto layout = new QVBoxLayout(this);
     layout->setSpacing(0);
     layout->setContentsMargins(0, 0, 0, 0);
-    layout->addWidget(pMainLabel);
+    layout->addWidget(createFilterBar());
 
-    main = std::make_unique<QPlainTextEdit>();
-    init_main_out_area(main.get(), layout, 0);
+    // Output lines live in a capped ring; only the rows on screen are laid out. Runs that print
+    // more than the ring holds are also written to the run directory and paged back from there.
+    LineStore::Options options;
+    options.runDirectory = m_runDirectory;
+    m_logView = new LogView(this, options);
+    QPalette palette = m_logView->palette();
+    palette.setColor(QPalette::Highlight, QColor(0, 120, 215)); // A common blue selection background
+    m_logView->setPalette(palette);
+    m_logView->setMinimumHeight(50);
+    layout->addWidget(m_logView);
+    m_coalescer = new OutputCoalescer(m_logView, this);
+
+    connect(m_logView, &LogView::filterProgress, this, [this](const qsizetype matches, const bool complete)
+    {
+        if (!m_logView->isFiltered())
+        {
+            m_matchLabel->clear();
+            return;
+        }
+        m_matchLabel->setText(QString::number(matches) + (complete ? " matches" : " matches…"));
+    });
+
+    // Objects returned by a run. Fixed row heights and interactive column widths keep the
+    // view from measuring every row, which matters with hundreds of thousands of them.
+    m_recordsModel = new RecordTableModel(this);
+    m_recordsView = new QTableView(this);
+    m_recordsView->setModel(m_recordsModel);
+    m_recordsView->setSortingEnabled(true);
+    m_recordsView->setWordWrap(false);
+    m_recordsView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_recordsView->setHorizontalScrollMode(QAbstractItemView::ScrollPerPixel);
+    m_recordsView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_recordsView->verticalHeader()->setDefaultSectionSize(m_recordsView->fontMetrics().height() + 6);
+    m_recordsView->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    m_recordsView->horizontalHeader()->setStretchLastSection(true);
+    m_recordsView->setMinimumHeight(50);
+    m_recordsView->hide();
+    layout->addWidget(m_recordsView, 2);
 
     hide();
 }
 
-void init_main_out_area(QPlainTextEdit* main, QVBoxLayout* layout, int editorWidth = 0)
+QWidget* OutputDisplay::createFilterBar()
 {
-    // For displaying the output_display
-    layout->addWidget(main);
+    const auto bar = new QWidget(this);
+    bar->setFixedHeight(25);
 
-    // Get the current palette
-    QPalette palette = main->palette();
+    const auto barLayout = new QHBoxLayout(bar);
+    barLayout->setContentsMargins(0, 0, 4, 0);
+    barLayout->setSpacing(4);
 
-    // Set the color for the background of the selection
-    palette.setColor(QPalette::Highlight, QColor(0, 120, 215)); // A common blue selection background
-    palette.setColor(QPalette::Text, QColor(Qt::white)); // A common blue selection background
-    main->setPalette(palette);
+    const auto pMainLabel = new QLabel("❯_", bar);
+    barLayout->addWidget(pMainLabel);
+    barLayout->addStretch(1);
+
+    m_filterEdit = new QLineEdit(bar);
+    m_filterEdit->setPlaceholderText("Filter output");
+    m_filterEdit->setClearButtonEnabled(true);
+    m_filterEdit->setMaximumWidth(260);
+
+    m_caseButton = new QToolButton(bar);
+    m_caseButton->setText("Aa");
+    m_caseButton->setToolTip("Match case");
+    m_caseButton->setCheckable(true);
+
+    m_regexButton = new QToolButton(bar);
+    m_regexButton->setText(".*");
+    m_regexButton->setToolTip("Regular expression");
+    m_regexButton->setCheckable(true);
+
+    m_streamCombo = new QComboBox(bar);
+    m_streamCombo->addItem("All streams", ~0u);
+    m_streamCombo->addItem("Output", LineFilter::kindBit(LineStore::Kind::Output));
+    m_streamCombo->addItem("Errors", LineFilter::kindBit(LineStore::Kind::Error));
+    m_streamCombo->addItem("Warnings", LineFilter::kindBit(LineStore::Kind::Warning));
+
+    m_runEdit = new QLineEdit(bar);
+    m_runEdit->setPlaceholderText("Run");
+    m_runEdit->setToolTip("Only show the output of this run");
+    m_runEdit->setValidator(new QIntValidator(1, INT_MAX, m_runEdit));
+    m_runEdit->setFixedWidth(50);
+
+    m_matchLabel = new QLabel(bar);
+
+    m_openRunButton = new QToolButton(bar);
+    m_openRunButton->setText("Open…");
+    m_openRunButton->setToolTip("Open the saved output of an earlier run");
+
+    barLayout->addWidget(m_matchLabel);
+    barLayout->addWidget(m_filterEdit);
+    barLayout->addWidget(m_caseButton);
+    barLayout->addWidget(m_regexButton);
+    barLayout->addWidget(m_streamCombo);
+    barLayout->addWidget(m_runEdit);
+    barLayout->addWidget(m_openRunButton);
+
+    connect(m_filterEdit, &QLineEdit::textChanged, this, &OutputDisplay::applyFilter);
+    connect(m_caseButton, &QToolButton::toggled, this, &OutputDisplay::applyFilter);
+    connect(m_regexButton, &QToolButton::toggled, this, &OutputDisplay::applyFilter);
+    connect(m_streamCombo, &QComboBox::currentIndexChanged, this, &OutputDisplay::applyFilter);
+    connect(m_runEdit, &QLineEdit::textChanged, this, &OutputDisplay::applyFilter);
+    connect(m_openRunButton, &QToolButton::clicked, this, &OutputDisplay::openRunOutput);
+
+    return bar;
+}
+
+void OutputDisplay::applyFilter() const
+{
+    LineFilter::Query query;
+    query.caseSensitive = m_caseButton->isChecked();
+    query.kinds = m_streamCombo->currentData().toUInt();
+    if (!m_runEdit->text().isEmpty())
+    {
+        query.run = m_runEdit->text().toUInt();
+    }
+
+    const QString text = m_filterEdit->text();
+    if (m_regexButton->isChecked() && !text.isEmpty())
+    {
+        QRegularExpression pattern(text, query.caseSensitive
+                                             ? QRegularExpression::NoPatternOption
+                                             : QRegularExpression::CaseInsensitiveOption);
+        if (!pattern.isValid())
+        {
+            m_matchLabel->setText(pattern.errorString());
+            return;
+        }
+        pattern.optimize();
+        query.matcher = [pattern](const std::string_view line)
+        {
+            return pattern.match(QString::fromUtf8(line.data(), static_cast<qsizetype>(line.size()))).hasMatch();
+        };
+    }
+    else
+    {
+        query.text = text.toStdString();
+    }
 
-    main->setReadOnly(true);
-    main->setLineWrapMode(QPlainTextEdit::LineWrapMode::WidgetWidth);
+    if (query.text.empty() && !query.matcher && query.kinds == ~0u && !query.run.has_value())
+    {
+        m_logView->clearFilter();
+        return;
+    }
 
-    main->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    // Lines still queued would otherwise only be found on the next frame.
+    m_coalescer->flushAll();
+    m_logView->setFilter(std::move(query));
+}
 
-    if (editorWidth > 0)
+void OutputDisplay::openRunOutput()
+{
+    const QString path = QFileDialog::getOpenFileName(this, "Open run output", QString::fromStdWString(m_runDirectory.wstring()),
+                                                      "Run output (*.log)");
+    if (path.isEmpty())
     {
-        main->setMinimumWidth(editorWidth);
+        return;
     }
 
-    // --- QSS for Custom Scrollbar ---
-    // Apply the stylesheet directly to the textEdit widget
-    // This ensures only this textEdit's scrollbars are affected (and its children if any)
-    main->setVerticalScrollBarPolicy(Qt::ScrollBarPolicy::ScrollBarAsNeeded);
-    main->setMinimumHeight(50);
+    // Whatever is still queued belongs to the log being replaced.
+    m_coalescer->flushAll();
+    if (!m_logView->openRun(std::filesystem::path(path.toStdWString())))
+    {
+        m_matchLabel->setText("Could not open " + QFileInfo(path).fileName());
+    }
 }
 
 void OutputDisplay::toggle()
@@ -95,66 +237,57 @@ void OutputDisplay::toggle()
     }
 }
 
-void OutputDisplay::log(const QString& output, const QString& errorOutput) const
+void OutputDisplay::beginRun(const quint64 runId) const
 {
-    QStringList list = output.split("\\u2029");
-    QStringList errorsList = errorOutput.split("\\u2029");
-
-    QLabel* error = createLabel(errorOutput, "error");
+    m_coalescer->beginRun(static_cast<std::uint32_t>(runId));
 
     // Adds timestamp
-    QDateTime currentDateTime = QDateTime::currentDateTime();
-    QString formattedDateTime = currentDateTime.toString("yyyy-MM-dd hh:mm:ss"); // Custom format
-    main->appendHtml("<h4 style=\"color: #FFFDD0;\">Executed: " +
-        formattedDateTime + "</h4>");
-    // End Adds timestamp
-
-    main->appendHtml("<div>");
-    for (const QString& qString : list)
+    const QString formattedDateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
+    m_coalescer->append("Executed: " + formattedDateTime + " (run " + QString::number(runId) + ")",
+                        LineStore::Kind::Header);
+}
+
+void OutputDisplay::append(const QString& text, const bool isError) const
+{
+    const auto kind = isError ? LineStore::Kind::Error : LineStore::Kind::Output;
+    if (!text.contains(WARNING_PREFIX))
     {
-        main->appendHtml("<p  style=\"color: #FFFFFF;\">" + qString + "</p>");
+        m_coalescer->append(text, kind);
+        return;
     }
-    for (const QString& qString : errorsList)
+
+    // Warnings get their own kind so they can be told apart and filtered on.
+    for (const QString& line : text.split('\n'))
     {
-        // error logs
-        main->appendHtml("<p style=\"color: #FF6347;\">" + qString + "</p>");
+        m_coalescer->append(line, line.startsWith(WARNING_PREFIX) ? LineStore::Kind::Warning : kind);
     }
-    main->appendHtml("</div>");
+}
 
-    if (error != nullptr)
+void OutputDisplay::log(const QString& output, const QString& errorOutput) const
+{
+    if (!output.isEmpty())
     {
-        const auto layout = new QVBoxLayout;
-        layout->addWidget(error);
+        append(output, false);
+    }
+    if (!errorOutput.isEmpty())
+    {
+        append(errorOutput, true);
     }
 }
 
-QLabel* OutputDisplay::createLabel(const QString& text, QString state)
+void OutputDisplay::showRecords(const RecordSetPtr& records) const
 {
-    if (text.isEmpty())
-        return nullptr;
-
-    auto label = new QLabel;
-    label->setText(text);
-    label->setFont(QFont("Arial", 32));
+    // Sorting is reset with the data; the header indicator would be stale otherwise.
+    m_recordsView->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+    m_recordsModel->setRecords(records);
 
-	//@formatter:off
-	// label->setStyleSheet(
-	// 	std::equal(state.begin(), state.end(), "error") ? "color: #FF6347;" : "color: #F9F6EE;");
-    //@formatter:on
-
-    label->setAlignment(Qt::AlignLeft);
-
-    // Call adjustSize() after setting the text
-    label->adjustSize();
-
-    // Get the recommended size from sizeHint()
-    QSize recommendedSize = label->sizeHint();
-    recommendedSize.setWidth(recommendedSize.width() * 2); // Add some extra width
-    // auto n = std::max(100, recommendedSize.height());
-    recommendedSize.setHeight(recommendedSize.height() + 100); // Add some extra width
-
-    // Set the label's size manually
-    label->setFixedSize(recommendedSize);
+    if (records == nullptr)
+    {
+        m_recordsView->hide();
+        return;
+    }
 
-    return label;
+    // Size columns from the header and the first rows only.
+    m_recordsView->resizeColumnsToContents();
+    m_recordsView->show();
 }
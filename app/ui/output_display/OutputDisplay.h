@@ -27,10 +27,20 @@
 #ifndef OUTPUT_DISPLAY_H
 #define OUTPUT_DISPLAY_H
 
+#include <filesystem>
+
 #include <QWidget>
 
+#include "clients/ExecutionBackend/RecordSet.h"
+
+class LogView;
+class OutputCoalescer;
+class QComboBox;
 class QLabel;
-class QPlainTextEdit;
+class QLineEdit;
+class QTableView;
+class QToolButton;
+class RecordTableModel;
 
 class OutputDisplay final : public QWidget {
 Q_OBJECT
@@ -38,17 +48,50 @@ Q_OBJECT
 public:
 	~OutputDisplay() override = default;
 
-	explicit OutputDisplay(QWidget *window = nullptr);
+	// runDirectory: where the output of large runs is written.
+	explicit OutputDisplay(std::filesystem::path runDirectory, QWidget *window = nullptr);
 
 	void toggle();
 
+	// Starts the output of a new run with a timestamp line.
+	void beginRun(quint64 runId) const;
+
+	// Queues complete lines; they reach the view on the next display frame.
+	void append(const QString &text, bool isError) const;
+
+	// Queues whatever of a run's output was not streamed through append().
 	void log(const QString &output, const QString &error) const;
 
+	// Shows the objects returned by the last run in the table; nullptr hides it.
+	void showRecords(const RecordSetPtr &records) const;
+
+private slots:
+	// Rebuilds the log filter from the filter bar.
+	void applyFilter() const;
+
+	// Lets the user pick a saved run output and shows it in place of the current log.
+	void openRunOutput();
+
 private:
-	// m_state is "error" or "default"
-	static QLabel *createLabel(const QString &text, QString state = "default");
-	std::unique_ptr<QPlainTextEdit> main;
+	QWidget *createFilterBar();
+
+	LogView *m_logView;
+	OutputCoalescer *m_coalescer;
+	QTableView *m_recordsView;
+	RecordTableModel *m_recordsModel;
+
+	// Filter bar
+	QLineEdit *m_filterEdit;
+	QToolButton *m_caseButton;
+	QToolButton *m_regexButton;
+	QComboBox *m_streamCombo;
+	QLineEdit *m_runEdit;
+	QLabel *m_matchLabel;
+	QToolButton *m_openRunButton;
 	QWidget *m_window;
+
+	// Where the output of large runs is kept between sessions.
+	std::filesystem::path m_runDirectory;
 };
 
 #endif //OUTPUT_DISPLAY_H
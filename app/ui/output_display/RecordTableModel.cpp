@@ -0,0 +1,183 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "RecordTableModel.h"
+
+#include <algorithm>
+#include <numeric>
+
+RecordTableModel::RecordTableModel(QObject* parent) : QAbstractTableModel(parent)
+{
+}
+
+void RecordTableModel::setRecords(RecordSetPtr records)
+{
+    beginResetModel();
+
+    m_records = std::move(records);
+    const auto rows = m_records ? static_cast<int>(m_records->rowCount()) : 0;
+
+    m_order.resize(rows);
+    std::iota(m_order.begin(), m_order.end(), 0);
+    m_fetched = std::min(rows, FETCH_BATCH);
+
+    endResetModel();
+}
+
+int RecordTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_fetched;
+}
+
+int RecordTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() || !m_records ? 0 : static_cast<int>(m_records->columnCount());
+}
+
+QVariant RecordTableModel::data(const QModelIndex& index, const int role) const
+{
+    if (!index.isValid() || !m_records || index.row() >= m_fetched)
+    {
+        return {};
+    }
+
+    const QJsonValue value = m_records->value(m_order[index.row()], index.column());
+
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        if (value.isDouble())
+        {
+            // Whole numbers (ids, sizes) without a trailing ".0".
+            const double number = value.toDouble();
+            return number == static_cast<double>(static_cast<qint64>(number))
+                       ? QString::number(static_cast<qint64>(number))
+                       : QString::number(number, 'f', 2);
+        }
+        if (value.isBool())
+        {
+            return value.toBool() ? "True" : "False";
+        }
+        return value.toString();
+    case Qt::ToolTipRole:
+        return value.isString() ? value.toString() : QVariant();
+    case Qt::TextAlignmentRole:
+        return value.isDouble()
+                   ? QVariant(Qt::AlignRight | Qt::AlignVCenter)
+                   : QVariant(Qt::AlignLeft | Qt::AlignVCenter);
+    default:
+        return {};
+    }
+}
+
+QVariant RecordTableModel::headerData(const int section, const Qt::Orientation orientation, const int role) const
+{
+    if (role != Qt::DisplayRole || !m_records)
+    {
+        return {};
+    }
+
+    if (orientation == Qt::Horizontal)
+    {
+        return m_records->columns.value(section);
+    }
+    return section + 1;
+}
+
+bool RecordTableModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && m_fetched < static_cast<int>(m_order.size());
+}
+
+void RecordTableModel::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent))
+    {
+        return;
+    }
+
+    const int more = std::min(FETCH_BATCH, static_cast<int>(m_order.size()) - m_fetched);
+    beginInsertRows(QModelIndex(), m_fetched, m_fetched + more - 1);
+    m_fetched += more;
+    endInsertRows();
+}
+
+void RecordTableModel::sort(const int column, const Qt::SortOrder order)
+{
+    if (!m_records || column < 0 || column >= m_records->columnCount())
+    {
+        return;
+    }
+
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+    const QModelIndexList persistent = persistentIndexList();
+    const std::vector<int> previousOrder = persistent.isEmpty() ? std::vector<int>() : m_order;
+
+    // Pull the keys out once; comparing QJsonValues directly would decode them on every
+    // comparison. Numbers sort numerically, everything else as case-insensitive text,
+    // and empty cells go last either way.
+    const QJsonArray& values = m_records->values[column];
+    const auto rows = static_cast<qsizetype>(m_order.size());
+
+    bool numeric = true;
+    for (qsizetype row = 0; row < rows && numeric; ++row)
+    {
+        numeric = values[row].isDouble() || values[row].isNull();
+    }
+
+    const bool ascending = order == Qt::AscendingOrder;
+    if (numeric)
+    {
+        std::vector<double> keys(rows);
+        std::vector<char> missing(rows);
+        for (qsizetype row = 0; row < rows; ++row)
+        {
+            missing[row] = values[row].isNull();
+            keys[row] = values[row].toDouble();
+        }
+
+        std::ranges::stable_sort(m_order, [&](const int a, const int b)
+        {
+            if (missing[a] != missing[b]) return missing[b] != 0;
+            return ascending ? keys[a] < keys[b] : keys[b] < keys[a];
+        });
+    }
+    else
+    {
+        std::vector<QString> keys(rows);
+        for (qsizetype row = 0; row < rows; ++row)
+        {
+            const QJsonValue value = values[row];
+            keys[row] = value.isBool() ? (value.toBool() ? "True" : "False") : value.toVariant().toString();
+        }
+
+        std::ranges::stable_sort(m_order, [&](const int a, const int b)
+        {
+            if (keys[a].isEmpty() != keys[b].isEmpty()) return keys[b].isEmpty();
+            const int result = QString::compare(keys[a], keys[b], Qt::CaseInsensitive);
+            return ascending ? result < 0 : result > 0;
+        });
+    }
+
+    // Keep selections and the current index on the same records.
+    if (!persistent.isEmpty())
+    {
+        std::vector<int> viewRowOf(m_order.size());
+        for (int row = 0; row < static_cast<int>(m_order.size()); ++row)
+        {
+            viewRowOf[m_order[row]] = row;
+        }
+
+        QModelIndexList moved;
+        moved.reserve(persistent.size());
+        for (const QModelIndex& index : persistent)
+        {
+            const int row = viewRowOf[previousOrder[index.row()]];
+            moved.append(row < m_fetched ? this->index(row, index.column()) : QModelIndex());
+        }
+        changePersistentIndexList(persistent, moved);
+    }
+
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
@@ -0,0 +1,51 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef RECORD_TABLE_MODEL_H
+#define RECORD_TABLE_MODEL_H
+
+#include <vector>
+
+#include <QAbstractTableModel>
+
+#include "clients/ExecutionBackend/RecordSet.h"
+
+/**
+ * Table over the RecordSet of a run. Rows are handed to the view in batches through
+ * canFetchMore()/fetchMore() as it scrolls, and cells are converted only when painted,
+ * so a run returning hundreds of thousands of objects costs one index per row up front.
+ *
+ * Sorting reorders an index permutation; the records themselves are never copied.
+ */
+class RecordTableModel final : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit RecordTableModel(QObject* parent = nullptr);
+
+    void setRecords(RecordSetPtr records);
+    [[nodiscard]] const RecordSetPtr& records() const { return m_records; }
+
+    [[nodiscard]] int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    [[nodiscard]] int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    [[nodiscard]] QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    [[nodiscard]] bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+private:
+    static constexpr int FETCH_BATCH = 2000;
+
+    RecordSetPtr m_records;
+    // View row -> record row.
+    std::vector<int> m_order;
+    // Rows handed to the view so far.
+    int m_fetched = 0;
+};
+
+#endif // RECORD_TABLE_MODEL_H
@@ -0,0 +1,471 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "RunOutputFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Bytes mapped at a time. Windows wants views to start on a 64 KiB boundary, which is
+    // also a multiple of every page size in use.
+    constexpr std::uint64_t WINDOW_BYTES = 64 * 1024 * 1024;
+    constexpr std::uint64_t WINDOW_ALIGNMENT = 64 * 1024;
+
+    struct IndexHeader
+    {
+        char magic[8];
+        std::uint32_t stride;
+        std::uint32_t reserved;
+        std::uint64_t longestLine;
+    };
+
+    constexpr char INDEX_MAGIC[8] = {'B', 'U', 'R', 'A', 'Q', 'I', 'D', 'X'};
+
+    std::filesystem::path indexPath(const std::filesystem::path& path)
+    {
+        std::filesystem::path result = path;
+        result += ".idx";
+        return result;
+    }
+
+    // fopen() takes the path in the ANSI code page on Windows, which cannot hold every user name.
+    std::FILE* openFile(const std::filesystem::path& path, const bool write)
+    {
+#ifdef _WIN32
+        return _wfopen(path.c_str(), write ? L"wb" : L"rb");
+#else
+        return std::fopen(path.c_str(), write ? "wb" : "rb");
+#endif
+    }
+
+    bool seekTo(std::FILE* file, const std::uint64_t offset, const int origin)
+    {
+#ifdef _WIN32
+        return _fseeki64(file, static_cast<long long>(offset), origin) == 0;
+#else
+        return fseeko(file, static_cast<off_t>(offset), origin) == 0;
+#endif
+    }
+
+    bool isTag(const char byte)
+    {
+        return byte >= 0x01 && byte <= 0x01 + static_cast<char>(LineStore::Kind::Header);
+    }
+
+    std::string_view untag(std::string_view line, LineStore::Kind* kind)
+    {
+        LineStore::Kind found = LineStore::Kind::Output;
+        if (!line.empty() && isTag(line.front()))
+        {
+            found = static_cast<LineStore::Kind>(line.front() - 0x01);
+            line.remove_prefix(1);
+        }
+        if (kind != nullptr)
+        {
+            *kind = found;
+        }
+        return line;
+    }
+}
+
+RunOutputFile::RunOutputFile(std::filesystem::path path) : m_path(std::move(path))
+{
+}
+
+RunOutputFile::~RunOutputFile()
+{
+    unmap();
+#ifdef _WIN32
+    if (m_readHandle != nullptr)
+    {
+        CloseHandle(m_readHandle);
+    }
+#else
+    if (m_readFd >= 0)
+    {
+        ::close(m_readFd);
+    }
+#endif
+
+    if (m_writer != nullptr)
+    {
+        std::fclose(m_writer);
+    }
+    if (m_indexWriter != nullptr)
+    {
+        writeIndexHeader();
+        std::fclose(m_indexWriter);
+    }
+}
+
+std::unique_ptr<RunOutputFile> RunOutputFile::create(const std::filesystem::path& path)
+{
+    std::unique_ptr<RunOutputFile> file(new RunOutputFile(path));
+    file->m_writer = openFile(path, true);
+    file->m_indexWriter = openFile(indexPath(path), true);
+    if (file->m_writer == nullptr || file->m_indexWriter == nullptr)
+    {
+        return nullptr;
+    }
+    file->writeIndexHeader();
+    return file;
+}
+
+std::unique_ptr<RunOutputFile> RunOutputFile::open(const std::filesystem::path& path)
+{
+    std::unique_ptr<RunOutputFile> file(new RunOutputFile(path));
+    if (!file->load())
+    {
+        return nullptr;
+    }
+    return file;
+}
+
+void RunOutputFile::prune(const std::filesystem::path& directory, const std::uint64_t maxBytes)
+{
+    struct Found
+    {
+        std::filesystem::path path;
+        std::filesystem::file_time_type written;
+        std::uint64_t bytes;
+    };
+
+    std::error_code error;
+    std::vector<Found> files;
+    std::uint64_t total = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        if (entry.path().extension() != ".log" || !entry.is_regular_file(error))
+        {
+            continue;
+        }
+
+        const std::uint64_t bytes = entry.file_size(error) + std::filesystem::file_size(indexPath(entry.path()), error);
+        files.push_back({entry.path(), entry.last_write_time(error), bytes});
+        total += bytes;
+    }
+
+    std::sort(files.begin(), files.end(), [](const Found& a, const Found& b) { return a.written < b.written; });
+    for (const Found& found : files)
+    {
+        if (total <= maxBytes)
+        {
+            break;
+        }
+        // A file still open for reading cannot be deleted on Windows; it goes on a later pass.
+        if (std::filesystem::remove(found.path, error))
+        {
+            std::filesystem::remove(indexPath(found.path), error);
+            total -= found.bytes;
+        }
+    }
+}
+
+bool RunOutputFile::append(const std::string_view line, const LineStore::Kind kind)
+{
+    if (m_writer == nullptr || m_failed)
+    {
+        return false;
+    }
+
+    if (m_lineCount % INDEX_STRIDE == 0)
+    {
+        m_failed = std::fwrite(&m_size, sizeof(m_size), 1, m_indexWriter) != 1;
+        if (m_failed)
+        {
+            return false;
+        }
+        m_index.push_back(m_size);
+    }
+
+    // Output needs no tag, unless its text starts with a byte that would read as one.
+    const bool tagged = kind != LineStore::Kind::Output || (!line.empty() && isTag(line.front()));
+    const char tag = static_cast<char>(0x01 + static_cast<int>(kind));
+    if ((tagged && std::fputc(tag, m_writer) == EOF) ||
+        std::fwrite(line.data(), 1, line.size(), m_writer) != line.size() || std::fputc('\n', m_writer) == EOF)
+    {
+        // The partial line has no '\n', so open() will not count it either.
+        m_failed = true;
+        m_index.resize((m_lineCount + INDEX_STRIDE - 1) / INDEX_STRIDE);
+        return false;
+    }
+
+    const std::size_t length = line.size() + (tagged ? 1 : 0);
+    m_size += length + 1;
+    m_longestLine = std::max(m_longestLine, length);
+    m_lineCount++;
+    return true;
+}
+
+void RunOutputFile::flush()
+{
+    if (m_writer != nullptr && m_flushed != m_size)
+    {
+        std::fflush(m_writer);
+        std::fflush(m_indexWriter);
+        m_flushed = m_size;
+    }
+}
+
+void RunOutputFile::writeIndexHeader()
+{
+    IndexHeader header{};
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.stride = INDEX_STRIDE;
+    header.longestLine = m_longestLine;
+
+    if (seekTo(m_indexWriter, 0, SEEK_SET))
+    {
+        std::fwrite(&header, sizeof(header), 1, m_indexWriter);
+        seekTo(m_indexWriter, 0, SEEK_END);
+    }
+}
+
+bool RunOutputFile::load()
+{
+    std::error_code error;
+    m_flushed = std::filesystem::file_size(m_path, error);
+    if (error)
+    {
+        return false;
+    }
+
+    // Entries are taken as long as they look sane; a missing or torn index only means more of
+    // the file has to be scanned below.
+    if (std::FILE* index = openFile(indexPath(m_path), false))
+    {
+        IndexHeader header{};
+        if (std::fread(&header, sizeof(header), 1, index) == 1 &&
+            std::memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) == 0 && header.stride == INDEX_STRIDE)
+        {
+            m_longestLine = static_cast<std::size_t>(header.longestLine);
+
+            std::vector<std::uint64_t> block(64 * 1024);
+            std::size_t read;
+            bool sane = true;
+            while (sane && (read = std::fread(block.data(), sizeof(std::uint64_t), block.size(), index)) > 0)
+            {
+                for (std::size_t i = 0; i < read && sane; ++i)
+                {
+                    sane = block[i] < m_flushed && (m_index.empty() ? block[i] == 0 : block[i] > m_index.back());
+                    if (sane)
+                    {
+                        m_index.push_back(block[i]);
+                    }
+                }
+            }
+        }
+        std::fclose(index);
+    }
+
+    if (m_index.empty())
+    {
+        if (m_flushed == 0)
+        {
+            return true;
+        }
+        m_index.push_back(0);
+    }
+
+    // Count the lines after the last index entry, which the index does not cover.
+    m_lineCount = (m_index.size() - 1) * INDEX_STRIDE;
+    m_size = m_flushed;
+    std::uint64_t offset = m_index.back();
+    while (offset < m_flushed)
+    {
+        const std::uint64_t end = findNewline(offset);
+        if (end == m_flushed)
+        {
+            break; // a last line cut short by a crash
+        }
+
+        m_longestLine = std::max<std::size_t>(m_longestLine, end - offset);
+        m_lineCount++;
+        offset = end + 1;
+        if (m_lineCount % INDEX_STRIDE == 0 && offset < m_flushed)
+        {
+            m_index.push_back(offset);
+        }
+    }
+    m_size = m_flushed = offset;
+    return true;
+}
+
+bool RunOutputFile::map(const std::uint64_t offset, const std::uint64_t length)
+{
+    if (m_window != nullptr && offset >= m_windowOffset && offset + length <= m_windowOffset + m_windowLength)
+    {
+        return true;
+    }
+
+    if (offset + length > m_flushed)
+    {
+        flush();
+    }
+    unmap();
+
+    const std::uint64_t start = offset - offset % WINDOW_ALIGNMENT;
+    const std::uint64_t end = std::min(std::max(start + WINDOW_BYTES, offset + length), m_flushed);
+    if (end <= start)
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    if (m_readHandle == nullptr)
+    {
+        const HANDLE handle = CreateFileW(m_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                          nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        m_readHandle = handle;
+    }
+
+    // A mapping object cannot grow with the file, so each window gets one sized to reach it.
+    m_mappingHandle = CreateFileMappingW(m_readHandle, nullptr, PAGE_READONLY, static_cast<DWORD>(end >> 32),
+                                         static_cast<DWORD>(end), nullptr);
+    if (m_mappingHandle == nullptr)
+    {
+        return false;
+    }
+    void* view = MapViewOfFile(m_mappingHandle, FILE_MAP_READ, static_cast<DWORD>(start >> 32),
+                               static_cast<DWORD>(start), static_cast<SIZE_T>(end - start));
+    if (view == nullptr)
+    {
+        CloseHandle(m_mappingHandle);
+        m_mappingHandle = nullptr;
+        return false;
+    }
+#else
+    if (m_readFd < 0)
+    {
+        m_readFd = ::open(m_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (m_readFd < 0)
+        {
+            return false;
+        }
+    }
+
+    void* view = ::mmap(nullptr, end - start, PROT_READ, MAP_SHARED, m_readFd, static_cast<off_t>(start));
+    if (view == MAP_FAILED)
+    {
+        return false;
+    }
+    ::madvise(view, end - start, MADV_SEQUENTIAL);
+#endif
+
+    m_window = static_cast<const char*>(view);
+    m_windowOffset = start;
+    m_windowLength = end - start;
+    return true;
+}
+
+void RunOutputFile::unmap()
+{
+    if (m_window == nullptr)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_window);
+    CloseHandle(m_mappingHandle);
+    m_mappingHandle = nullptr;
+#else
+    ::munmap(const_cast<char*>(m_window), m_windowLength);
+#endif
+    m_window = nullptr;
+    m_windowOffset = m_windowLength = 0;
+}
+
+std::uint64_t RunOutputFile::findNewline(std::uint64_t from)
+{
+    while (from < m_size && map(from, 1))
+    {
+        const char* begin = m_window + (from - m_windowOffset);
+        const std::uint64_t available = std::min(m_windowOffset + m_windowLength, m_size) - from;
+        if (const void* found = std::memchr(begin, '\n', available))
+        {
+            return from + static_cast<std::uint64_t>(static_cast<const char*>(found) - begin);
+        }
+        from += available;
+    }
+    return m_size;
+}
+
+std::uint64_t RunOutputFile::lineStart(const std::size_t n)
+{
+    // Walk forward from the closer of the index entry and where the last read ended.
+    std::size_t line = n - n % INDEX_STRIDE;
+    std::uint64_t offset = m_index[line / INDEX_STRIDE];
+    if (m_cursorLine > line && m_cursorLine <= n)
+    {
+        line = m_cursorLine;
+        offset = m_cursorOffset;
+    }
+
+    for (; line < n; ++line)
+    {
+        offset = findNewline(offset) + 1;
+    }
+    return offset;
+}
+
+std::string_view RunOutputFile::line(const std::size_t n, LineStore::Kind* kind)
+{
+    if (n >= m_lineCount)
+    {
+        return {};
+    }
+
+    const std::uint64_t begin = lineStart(n);
+    const std::uint64_t end = findNewline(begin);
+    if (!map(begin, end - begin))
+    {
+        return {};
+    }
+
+    m_cursorLine = n + 1;
+    m_cursorOffset = end + 1;
+    return untag({m_window + (begin - m_windowOffset), static_cast<std::size_t>(end - begin)}, kind);
+}
+
+void RunOutputFile::scan(const std::size_t from, std::size_t to, const Visitor& visit)
+{
+    to = std::min(to, m_lineCount);
+    if (from >= to)
+    {
+        return;
+    }
+
+    std::uint64_t offset = lineStart(from);
+    for (std::size_t n = from; n < to; ++n)
+    {
+        const std::uint64_t end = findNewline(offset);
+        if (!map(offset, end - offset))
+        {
+            return;
+        }
+
+        LineStore::Kind kind;
+        const std::string_view text = untag({m_window + (offset - m_windowOffset), static_cast<std::size_t>(end - offset)}, &kind);
+        visit(n, text, kind);
+        offset = end + 1;
+
+        m_cursorLine = n + 1;
+        m_cursorOffset = offset;
+    }
+}
@@ -0,0 +1,113 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef RUN_OUTPUT_FILE_H
+#define RUN_OUTPUT_FILE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "LineStore.h"
+
+/**
+ * The output of one run on disk, one line per '\n', plus a sparse index holding the offset of
+ * every INDEX_STRIDE-th line.
+ *
+ * Lines that are not plain output start with a tag byte (0x01 + kind); the rest is the text as
+ * given, so a file written with SGR sequences in it still reads fine in a terminal. Reads go
+ * through a memory-mapped window that moves along the file: only the pages being looked at are
+ * brought in, whatever the file size. The index is written next to the file (path + ".idx"),
+ * so opening the output of an earlier session reads the index instead of scanning the file.
+ *
+ * A file is appended to by the object that created it and may be read while it grows.
+ * Not thread-safe.
+ */
+class RunOutputFile
+{
+public:
+    static constexpr std::size_t INDEX_STRIDE = 64;
+
+    // Creates path for appending, replacing any file there; nullptr if it cannot be written.
+    static std::unique_ptr<RunOutputFile> create(const std::filesystem::path& path);
+    // Opens a file written earlier, read-only; nullptr if it cannot be read.
+    static std::unique_ptr<RunOutputFile> open(const std::filesystem::path& path);
+
+    // Deletes the least recently written run files in directory until the rest fit in maxBytes.
+    static void prune(const std::filesystem::path& directory, std::uint64_t maxBytes);
+
+    ~RunOutputFile();
+
+    RunOutputFile(const RunOutputFile&) = delete;
+    RunOutputFile& operator=(const RunOutputFile&) = delete;
+
+    // line must not contain '\n'. False if the file is read-only or the write failed; no more
+    // lines are taken after a failure, so the ones written stay numbered correctly.
+    bool append(std::string_view line, LineStore::Kind kind);
+
+    // Pushes buffered lines and index entries to the OS.
+    void flush();
+
+    // The views handed out point into the mapped window and are valid until the next call.
+    using Visitor = std::function<void(std::size_t n, std::string_view line, LineStore::Kind kind)>;
+
+    // Line n without its tag; empty if n is out of range.
+    [[nodiscard]] std::string_view line(std::size_t n, LineStore::Kind* kind = nullptr);
+
+    // Calls visit for every line in [from, to), reading the file front to back.
+    void scan(std::size_t from, std::size_t to, const Visitor& visit);
+
+    [[nodiscard]] std::size_t lineCount() const { return m_lineCount; }
+    // Length in bytes of the longest line, tag included.
+    [[nodiscard]] std::size_t longestLine() const { return m_longestLine; }
+    [[nodiscard]] const std::filesystem::path& path() const { return m_path; }
+    // Heap memory held, which is mostly the index.
+    [[nodiscard]] std::size_t memoryBytes() const { return m_index.capacity() * sizeof(std::uint64_t); }
+
+private:
+    explicit RunOutputFile(std::filesystem::path path);
+
+    // Offset of the first '\n' at or after from; m_size if there is none.
+    [[nodiscard]] std::uint64_t findNewline(std::uint64_t from);
+    // Offset where line n starts; n <= m_lineCount.
+    [[nodiscard]] std::uint64_t lineStart(std::size_t n);
+    // Maps a window over at least [offset, offset + length); false if the file cannot be mapped.
+    bool map(std::uint64_t offset, std::uint64_t length);
+    void unmap();
+    // Reads the index and counts the lines written after its last entry.
+    bool load();
+    void writeIndexHeader();
+
+    std::filesystem::path m_path;
+    std::FILE* m_writer = nullptr;
+    std::FILE* m_indexWriter = nullptr;
+    bool m_failed = false;
+
+    std::uint64_t m_size = 0; // bytes of complete lines
+    std::uint64_t m_flushed = 0; // bytes the OS has; only these can be mapped
+    std::size_t m_lineCount = 0;
+    std::size_t m_longestLine = 0;
+    std::vector<std::uint64_t> m_index; // offset of line k * INDEX_STRIDE
+
+    // Where the last read ended, so reading consecutive lines does not go back to the index.
+    std::size_t m_cursorLine = 0;
+    std::uint64_t m_cursorOffset = 0;
+
+    // Read side: the file and the window of it mapped right now.
+#ifdef _WIN32
+    void* m_readHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#else
+    int m_readFd = -1;
+#endif
+    const char* m_window = nullptr;
+    std::uint64_t m_windowOffset = 0;
+    std::uint64_t m_windowLength = 0;
+};
+
+#endif // RUN_OUTPUT_FILE_H
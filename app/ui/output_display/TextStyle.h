@@ -0,0 +1,44 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef TEXT_STYLE_H
+#define TEXT_STYLE_H
+
+#include <cstdint>
+
+// Character attributes set by ANSI SGR sequences.
+struct TextStyle
+{
+    enum Flag : std::uint8_t
+    {
+        Bold = 1 << 0,
+        Dim = 1 << 1,
+        Italic = 1 << 2,
+        Underline = 1 << 3,
+        Inverse = 1 << 4,
+        Strike = 1 << 5,
+        Hidden = 1 << 6,
+    };
+
+    // Colors: 0 is the default, otherwise the top byte tells how to read the rest.
+    static constexpr std::uint32_t INDEXED = 1u << 24; // low byte: xterm 256-color index
+    static constexpr std::uint32_t RGB = 2u << 24; // low 24 bits: 0xRRGGBB
+
+    std::uint32_t foreground = 0;
+    std::uint32_t background = 0;
+    std::uint8_t flags = 0;
+
+    [[nodiscard]] bool isDefault() const { return foreground == 0 && background == 0 && flags == 0; }
+
+    friend bool operator==(const TextStyle&, const TextStyle&) = default;
+};
+
+// Style that applies from byte `start` of a line up to the next run or the end of the line.
+struct StyleRun
+{
+    std::uint32_t start;
+    TextStyle style;
+};
+
+#endif // TEXT_STYLE_H
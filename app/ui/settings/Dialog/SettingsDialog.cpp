@@ -27,7 +27,6 @@ SettingsDialog::SettingsDialog(QWidget* parent)
     : QDialog(parent),
       m_titleBar(std::make_unique<QWidget>(this)),
       m_Frame(std::make_unique<Frame>(this)),
-      settingsManager(new SettingsManager()),
       themeManager(ThemeManager::instance())
 {
     setWindowTitle("Settings");
@@ -37,7 +36,7 @@ SettingsDialog::SettingsDialog(QWidget* parent)
     this->setAttribute(Qt::WA_TranslucentBackground);
 
     // Load user preferences
-    userPreference = settingsManager->loadSettings();
+    userPreference = SettingsManager::singleton().settings();
 
     // Create a central widget to hold the main layout.
     // QMainWindow requires a central widget to manage content.
@@ -76,10 +75,8 @@ SettingsDialog::~SettingsDialog() = default;
 
 void SettingsDialog::applyChanges() const
 {
-    settingsManager->saveSettings(userPreference);
-
-    // update the UI
-    themeManager.setAppTheme(userPreference.theme);
+    // ThemeManager follows the theme through SettingsManager::themeChanged
+    SettingsManager::singleton().update(userPreference);
 }
 
 void SettingsDialog::setTheme(const int index)
@@ -14,7 +14,6 @@ class QTabWidget;
 class QDialogButtonBox;
 class QListWidget;
 class QStackedWidget;
-class SettingsManager;
 class Frame;
 
 class SettingsDialog final : public QDialog
@@ -37,7 +36,6 @@ private:
     std::unique_ptr<QWidget> m_titleBar;
     std::unique_ptr<Frame> m_Frame;
 
-    SettingsManager* settingsManager;
     UserSettings userPreference;
     ThemeManager &themeManager;
     // Helper functions to create each page of the settings dialog
@@ -7,6 +7,116 @@
 #include <QSettings>
 #include <QVariant>
 
+SettingsManager& SettingsManager::singleton()
+{
+    static SettingsManager instance; // Created once, thread-safe since C++11
+    return instance;
+}
+
+SettingsManager::SettingsManager()
+    : m_settings(loadSettings())
+{
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(SAVE_DELAY_MS);
+    connect(&m_saveTimer, &QTimer::timeout, this, &SettingsManager::save);
+
+    m_writer.setMaxThreadCount(1);
+}
+
+SettingsManager::~SettingsManager()
+{
+    flush();
+}
+
+void SettingsManager::setTheme(const AppTheme theme)
+{
+    if (m_settings.theme == theme)
+    {
+        return;
+    }
+    m_settings.theme = theme;
+    scheduleSave();
+    emit themeChanged(theme);
+}
+
+void SettingsManager::setWindowGeometry(const QSize size, const QPoint position)
+{
+    if (m_settings.windowSize == size && m_settings.windowPosition == position)
+    {
+        return;
+    }
+    m_settings.windowSize = size;
+    m_settings.windowPosition = position;
+    scheduleSave();
+    emit windowGeometryChanged(size, position);
+}
+
+void SettingsManager::setWordWrapEnabled(const bool enabled)
+{
+    if (m_settings.wordWrapEnabled == enabled)
+    {
+        return;
+    }
+    m_settings.wordWrapEnabled = enabled;
+    scheduleSave();
+    emit wordWrapChanged(enabled);
+}
+
+void SettingsManager::setEditorFontSize(const int size)
+{
+    if (m_settings.editorFontSize == size)
+    {
+        return;
+    }
+    m_settings.editorFontSize = size;
+    scheduleSave();
+    emit editorFontSizeChanged(size);
+}
+
+void SettingsManager::setExecutionBackend(const QString& backend)
+{
+    if (m_settings.executionBackend == backend)
+    {
+        return;
+    }
+    m_settings.executionBackend = backend;
+    scheduleSave();
+    emit executionBackendChanged(backend);
+}
+
+void SettingsManager::update(const UserSettings& settings)
+{
+    setTheme(settings.theme);
+    setWindowGeometry(settings.windowSize, settings.windowPosition);
+    setWordWrapEnabled(settings.wordWrapEnabled);
+    setEditorFontSize(settings.editorFontSize);
+    setExecutionBackend(settings.executionBackend);
+}
+
+void SettingsManager::scheduleSave()
+{
+    // Not restarted by later changes, so a steady stream of them is still written.
+    if (!m_saveTimer.isActive())
+    {
+        m_saveTimer.start();
+    }
+}
+
+void SettingsManager::save()
+{
+    m_writer.start([settings = m_settings] { saveSettings(settings); });
+}
+
+void SettingsManager::flush()
+{
+    if (m_saveTimer.isActive())
+    {
+        m_saveTimer.stop();
+        save();
+    }
+    m_writer.waitForDone();
+}
+
 void SettingsManager::saveSettings(const UserSettings& settings)
 {
     // QSettings will automatically use the organization and application name set in main.cpp
@@ -21,6 +131,7 @@ void SettingsManager::saveSettings(const UserSettings& settings)
     qsettings.setValue("windowPosition", settings.windowPosition);
     qsettings.setValue("wordWrap", settings.wordWrapEnabled);
     qsettings.setValue("editorFontSize", settings.editorFontSize);
+    qsettings.setValue("executionBackend", settings.executionBackend);
 
     qsettings.endGroup();
 }
@@ -65,6 +176,7 @@ UserSettings SettingsManager::loadSettings()
         settings.windowPosition = qsettings.value("windowPosition", QVariant::fromValue(settings.windowPosition)).toPoint();
         settings.wordWrapEnabled = qsettings.value("wordWrap", QVariant::fromValue(settings.wordWrapEnabled)).toBool();
         settings.editorFontSize = qsettings.value("editorFontSize", QVariant::fromValue(settings.editorFontSize)).toInt();
+        settings.executionBackend = qsettings.value("executionBackend", settings.executionBackend).toString();
     }
     catch (...)
     {
@@ -7,19 +7,69 @@
 
 #include <optional> // Required for std::optional
 
+#include <QObject>
+#include <QThreadPool>
+#include <QTimer>
+
 #include "../UserSettings.h" // Settings struct
 
-class SettingsManager
+/**
+ * The user's settings, loaded from QSettings once and served from memory. Setters emit a
+ * signal only when the value changes and persist on a background thread; changes made within
+ * SAVE_DELAY_MS of each other are written together.
+ *
+ * GUI thread only. Create it before any other use (main does), after the organization and
+ * application names are set.
+ */
+class SettingsManager final : public QObject
 {
+    Q_OBJECT
+
 public:
-    // Saves the given settings object to persistent storage
-    static void saveSettings(const UserSettings& settings);
+    static SettingsManager& singleton();
 
-    // Loads the settings object from persistent storage
-    static UserSettings loadSettings();
+    // Reading a value is a field load; storage is not touched.
+    const UserSettings& settings() const { return m_settings; }
+
+    void setTheme(AppTheme theme);
+    void setWindowGeometry(QSize size, QPoint position);
+    void setWordWrapEnabled(bool enabled);
+    void setEditorFontSize(int size);
+    void setExecutionBackend(const QString& backend);
+
+    // All of the above at once, e.g. from the settings dialog.
+    void update(const UserSettings& settings);
+
+    // Writes pending changes now and waits until they are stored; called on exit.
+    void flush();
+
+signals:
+    void themeChanged(AppTheme theme);
+    void windowGeometryChanged(QSize size, QPoint position);
+    void wordWrapChanged(bool enabled);
+    void editorFontSizeChanged(int size);
+    void executionBackendChanged(const QString& backend);
 
 private:
+    static constexpr int SAVE_DELAY_MS = 500;
+
+    SettingsManager();
+    ~SettingsManager() override;
+    SettingsManager(const SettingsManager&) = delete;
+    SettingsManager& operator=(const SettingsManager&) = delete;
+
+    // Reads and writes persistent storage.
+    static UserSettings loadSettings();
+    static void saveSettings(const UserSettings& settings);
+
     static std::optional<AppTheme> intToTheme(int value);
+
+    void scheduleSave();
+    void save();
+
+    UserSettings m_settings;
+    QTimer m_saveTimer;
+    QThreadPool m_writer; // one thread, so writes land in order
 };
 
 #endif // SETTINGSMANAGER_H
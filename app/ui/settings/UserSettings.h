@@ -24,6 +24,8 @@ struct UserSettings
     QPoint windowPosition = QPoint(100, 100);
     bool wordWrapEnabled = true;
     int editorFontSize = 11;
+    // One of the execution::BACKEND_* names; empty selects the platform default.
+    QString executionBackend;
     SettingsDialogPreference settingsDialog;
 };
 
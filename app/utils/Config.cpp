@@ -24,128 +24,141 @@
 // Created by talik on 5/12/2025.
 //
 
+#include <filesystem>
+
+#include <QDomDocument>
 #include <QFile>
-#include <QDir>
 
 #include <Config.h>
-#include <error_codes.h>
+#include <GeneratedConfig.h>
+
+#include "buraq.h"
+
+namespace
+{
+    // Same shape as main_config.xml; what it has replaces the built-in values.
+    std::filesystem::path overridePath()
+    {
+        return std::filesystem::temp_directory_path() / "Buraq" / ".data" / "main_config.xml";
+    }
+
+    void assignStyle(StyleSheetStruct& style, const generated_config::Style& generated)
+    {
+        style.color = QString::fromUtf8(generated.color);
+        style.backgroundColor = QString::fromUtf8(generated.backgroundColor);
+        style.padding = QString::fromUtf8(generated.padding);
+        style.border = QString::fromUtf8(generated.border);
+        style.height = QString::fromUtf8(generated.height);
+        style.borderColor = QString::fromUtf8(generated.borderColor);
+        style.borderBottom = QString::fromUtf8(generated.borderBottom);
+        style.styleSheet = QString::fromUtf8(generated.styleSheet);
+    }
+}
 
 Config::Config() : mainStyles(new MainStyles),
                    windowConfig(new WindowConfig),
                    appIcons(new AppIcons)
 {
+    loadDefaults();
+
+    // One stat in the common case; the XML is only parsed when there is an override.
+    if (std::error_code error; std::filesystem::exists(overridePath(), error))
+    {
+        loadOverride(QString::fromStdWString(overridePath().wstring()));
+    }
 }
 
 Config& Config::singleton()
 {
     static Config instance; // Created once, thread-safe since C++11
-    if (!instance.isSetup)
-    {
-        Config::loadConfig(&instance);
-        instance.isSetup = true;
-    }
     return instance;
 }
 
-void Config::loadConfig(Config* _this)
+void Config::loadDefaults()
 {
-    QFile config(":/config/main_config");
+    // Compiled from main_config.xml by cmake/GenerateConfig.cmake.
+    namespace generated = generated_config;
+
+    title = QString::fromUtf8(generated::title);
+    version = QString::fromUtf8(generated::version);
+    appLogo = QIcon::fromTheme(QString::fromUtf8(generated::appLogo));
+
+    windowConfig->minWidth = generated::window.minWidth;
+    windowConfig->minHeight = generated::window.minHeight;
+    windowConfig->normalSize = generated::window.normalSize;
+    windowConfig->minimizeIcon = QIcon::fromTheme(QString::fromUtf8(generated::window.minimizeIcon));
+    windowConfig->maximizeIcon = QIcon::fromTheme(QString::fromUtf8(generated::window.maximizeIcon));
+    windowConfig->restoreIcon = QIcon::fromTheme(QString::fromUtf8(generated::window.restoreIcon));
+    windowConfig->closeIcon = QIcon::fromTheme(QString::fromUtf8(generated::window.closeIcon));
+
+    appIcons->settingsIcon = QIcon::fromTheme(QString::fromUtf8(generated::icons.settings));
+    appIcons->folderIcon = QIcon::fromTheme(QString::fromUtf8(generated::icons.folder));
+    appIcons->terminalIcon = QIcon::fromTheme(QString::fromUtf8(generated::icons.terminal));
+    appIcons->playCode = QIcon::fromTheme(QString::fromUtf8(generated::icons.playCode));
+    appIcons->executeIcon = QIcon::fromTheme(QString::fromUtf8(generated::icons.execute));
+    appIcons->executeSelectedIcon = QIcon::fromTheme(QString::fromUtf8(generated::icons.executeSelected));
+    appIcons->addFileIcon = QIcon::fromTheme(QString::fromUtf8(generated::icons.addFile));
+
+    assignStyle(mainStyles->commonStyle, generated::commonStyle);
+    assignStyle(mainStyles->controlToolBar, generated::controlToolBar);
+    assignStyle(mainStyles->toolBar, generated::toolBar);
+    assignStyle(mainStyles->statusToolBar, generated::statusToolBar);
+    assignStyle(mainStyles->toolBarHover, generated::toolBarHover);
+}
+
+bool Config::loadOverride(const QString& path)
+{
+    QFile config(path);
     if (!config.open(QIODevice::ReadOnly))
     {
-        // Add this line to see all available resources at the root.
-        exit(ErrorCode::ERROR_FILE_NOT_FOUND);
+        file_utils::file_log(LogLevel::Warning, "Config: cannot open " + path.toStdString());
+        return false;
     }
 
     QDomDocument configDoc;
     if (!configDoc.setContent(&config))
     {
-        config.close();
-        qDebug() << "Error parsing XML config.";
-        exit(ErrorCode::ERROR_INVALID_FORMAT);
+        file_utils::file_log(LogLevel::Warning,
+                             "Config: cannot parse " + path.toStdString() + "; using the built-in configuration.");
+        return false;
     }
 
     // Get the root element (configuration)
-    QDomElement root = configDoc.documentElement();
+    const QDomElement root = configDoc.documentElement();
     if (root.tagName() != "configuration")
     {
-        exit(ErrorCode::ERROR_INVALID_FORMAT);
+        file_utils::file_log(LogLevel::Warning, "Config: " + path.toStdString() + " is not a configuration.");
+        return false;
     }
 
-    QDomNodeList appTitleList = root.elementsByTagName("Title");
-    if (appTitleList.count() > 0)
+    if (const QDomElement element = root.firstChildElement("Title"); !element.isNull())
     {
-        // Extracts the first element from the appTitleList QDomNodeList and converts it to a QDomElement.
-        // This element typically represents the application's title node in the XML configuration.
-        QDomElement appTitleElement = appTitleList.at(0).toElement();
-        _this->title = QString(appTitleElement.text());
+        title = element.text();
     }
-    else
+    if (const QDomElement element = root.firstChildElement("Version"); !element.isNull())
     {
-        qDebug() << "Error: Configuration is missing a 'Title'.";
-        exit(ErrorCode::ERROR_INVALID_FORMAT);
+        version = element.text();
     }
-
-    QDomNodeList appVersionList = root.elementsByTagName("Version");
-    if (appVersionList.count() > 0)
+    if (const QDomElement element = root.firstChildElement("AppLogo"); !element.isNull())
     {
-        QDomElement appVersionElement = appVersionList.at(0).toElement();
-        _this->version = QString(appVersionElement.text());
+        appLogo = QIcon::fromTheme(element.text());
     }
-    else
+    if (const QDomElement element = root.firstChildElement("window"); !element.isNull())
     {
-        // Error: Configuration is missing a 'Version'.;
-        exit(ErrorCode::ERROR_INVALID_FORMAT);
+        processWindowAttr(element);
     }
-
-    QDomNodeList appLogoList = root.elementsByTagName("AppLogo");
-    if (appLogoList.count() > 0)
+    if (const QDomElement element = root.firstChildElement("AppIcons"); !element.isNull())
     {
-        QDomElement appLogoElement = appLogoList.at(0).toElement();
-        _this->appLogo = QIcon::fromTheme(appLogoElement.text());
+        processAppIconsAttr(element);
     }
-    else
+    if (const QDomElement element = root.firstChildElement("Styles"); !element.isNull())
     {
-        qDebug() << "Error: Configuration is missing a 'AppLogo'.";
-        exit(ErrorCode::ERROR_INVALID_FORMAT);
+        processStyles(element);
     }
 
-    QDomNodeList windowList = root.elementsByTagName("window");
-    if (windowList.count() > 0)
-    {
-        QDomElement windowElement = windowList.at(0).toElement();
-        _this->processWindowAttr(windowElement);
-    }
-    else
-    {
-        // "Error: Configuration is missing a 'window'.";
-        exit(ErrorCode::ERROR_INVALID_FORMAT);
-    }
-
-    if (const QDomNodeList appIconsList = root.elementsByTagName("AppIcons"); appIconsList.count() > 0)
-    {
-        const QDomElement appIconsElement = appIconsList.at(0).toElement();
-        _this->processAppIconsAttr(appIconsElement);
-    }
-    else
-    {
-        qDebug() << "Error: Configuration is missing a 'AppIcons'.";
-        exit(ErrorCode::ERROR_INVALID_FORMAT);
-    }
-
-    if (const QDomNodeList mainStylesList = root.elementsByTagName("Styles"); mainStylesList.count() > 0)
-    {
-        const QDomElement mainStylesElement = mainStylesList.at(0).toElement();
-        _this->processStyles(mainStylesElement);
-    }
-    else
-    {
-        // "Error: Configuration is missing a 'Styles'.";
-        exit(ErrorCode::ERROR_INVALID_FORMAT);
-    }
-
-    config.close();
+    file_utils::file_log("Config: loaded " + path.toStdString());
+    return true;
 }
-
 void Config::processWindowAttr(const QDomElement& element) const
 {
     const auto attrs = element.attributes();
@@ -227,49 +240,42 @@ void Config::processAppIconsAttr(const QDomElement& element) const
 
 void Config::processStyles(const QDomElement& element) const
 {
-    auto styleNodes = element.childNodes();
-    QDomElement qDomCommonNode;
-    for (int i = 0; i < styleNodes.size(); ++i)
+    // commonStyle first: the others inherit from it.
+    if (const QDomElement common = element.firstChildElement("commonStyle"); !common.isNull())
     {
-        auto temp = styleNodes.item(i).toElement();
-        if (temp.tagName() == "commonStyle")
-        {
-            processStyleBlock(temp, mainStyles->commonStyle);
-            break;
-        }
+        processStyleBlock(common, mainStyles->commonStyle);
     }
 
-    for (int i = 0; i < styleNodes.size(); ++i)
+    for (QDomElement temp = element.firstChildElement(); !temp.isNull(); temp = temp.nextSiblingElement())
     {
-        auto temp = styleNodes.item(i).toElement();
-        if (temp.tagName() != "commonStyle")
+        if (temp.tagName() == "controlToolBar")
+        {
+            processStyleBlock(temp, mainStyles->controlToolBar);
+        }
+        else if (temp.tagName() == "toolBar")
+        {
+            processStyleBlock(temp, mainStyles->toolBar);
+        }
+        else if (temp.tagName() == "statusToolBar")
+        {
+            processStyleBlock(temp, mainStyles->statusToolBar);
+        }
+        else if (temp.tagName() == "toolBarHover")
         {
-            if (temp.tagName() == "controlToolBar")
-            {
-                processStyleBlock(temp, mainStyles->controlToolBar);
-            }
-            if (temp.tagName() == "toolBar")
-            {
-                processStyleBlock(temp, mainStyles->toolBar);
-            }
-            if (temp.tagName() == "statusToolBar")
-            {
-                processStyleBlock(temp, mainStyles->statusToolBar);
-            }
-            if (temp.tagName() == "toolBarHover")
-            {
-                processStyleBlock(temp, mainStyles->toolBarHover);
-            }
+            processStyleBlock(temp, mainStyles->toolBarHover);
         }
     }
 }
 
 void Config::processStyleBlock(const QDomElement& element, StyleSheetStruct& aStruct) const
 {
+    // A block replaces the built-in one; cmake/GenerateConfig.cmake builds those the same way.
+    aStruct = StyleSheetStruct();
+
     // includes styles
-    if (element.hasAttribute("inherits") && element.attributes().item(0).nodeValue() == "commonStyle")
+    if (element.attribute("inherits") == "commonStyle")
     {
-        const StyleSheetStruct commonStyle =  mainStyles->commonStyle;
+        const StyleSheetStruct& commonStyle = mainStyles->commonStyle;
         aStruct.color = commonStyle.color;
         aStruct.backgroundColor = commonStyle.backgroundColor;
         aStruct.padding = commonStyle.padding;
@@ -277,39 +283,43 @@ void Config::processStyleBlock(const QDomElement& element, StyleSheetStruct& aSt
         aStruct.height = commonStyle.height;
     }
 
-    const auto styleNodes = element.childNodes();
-    for (int i = 0; i < styleNodes.size(); ++i)
+    bool hasChildren = false;
+    for (QDomElement temp = element.firstChildElement(); !temp.isNull(); temp = temp.nextSiblingElement())
     {
-        auto temp = styleNodes.item(i).toElement();
+        hasChildren = true;
         if (temp.tagName() == "backgroundColor")
         {
             aStruct.backgroundColor = QString("background-color:" + temp.text() + ";");
         }
-        if (temp.tagName() == "border")
+        else if (temp.tagName() == "border")
         {
             aStruct.border = QString("border: " + temp.text() + ";");
         }
-        if (temp.tagName() == "borderBottom")
+        else if (temp.tagName() == "borderBottom")
         {
             aStruct.borderBottom = QString("border-bottom:" + temp.text() + ";");
         }
-        if (temp.tagName() == "borderTop")
+        else if (temp.tagName() == "borderTop")
         {
             aStruct.borderBottom = QString("border-top:" + temp.text() + ";");
         }
-        if (temp.tagName() == "borderColor")
+        else if (temp.tagName() == "borderColor")
         {
             aStruct.borderColor = QString("border-color:" + temp.text() + ";");
         }
-        if (temp.tagName() == "padding")
+        else if (temp.tagName() == "padding")
         {
             aStruct.padding = QString("padding:" + temp.text() + ";");
         }
-        if (temp.tagName() == "height")
+        else if (temp.tagName() == "height")
         {
             aStruct.height = QString("height:" + temp.text() + ";");
         }
+    }
 
+    // Joined once, not per child.
+    if (hasChildren)
+    {
         aStruct.styleSheet = aStruct.backgroundColor + aStruct.padding + aStruct.color + aStruct.border + aStruct.height
             + aStruct.borderColor + aStruct.borderBottom;
     }
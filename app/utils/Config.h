@@ -130,7 +130,6 @@ private:
 	Config(const Config &) = delete;			// No copy constructor
 	Config &operator=(const Config &) = delete; // No copy assignment
 
-	bool isSetup = false;
 	QString title;
 	QString version;
 	QString powershellPath;
@@ -139,6 +138,12 @@ private:
 	std::unique_ptr<AppIcons> appIcons;
 	std::unique_ptr<MainStyles> mainStyles;
 
+	// The values compiled in from main_config.xml.
+	void loadDefaults();
+
+	// Replaces the values that the file at path has; false if it cannot be read.
+	bool loadOverride(const QString &path);
+
 	void processWindowAttr(const QDomElement &) const;
 
 	void processAppIconsAttr(const QDomElement &element) const;
@@ -146,8 +151,6 @@ private:
 	void processStyles(const QDomElement &element) const;
 
 	void processStyleBlock(const QDomElement &element, StyleSheetStruct &aStruct) const;
-
-	static void loadConfig(Config *_thi);
 };
 
 #endif // ITOOLS_CONFIG_H
@@ -99,7 +99,6 @@ private:
     std::unique_ptr<QHBoxLayout> m_extraButtonsLayout;
     std::unique_ptr<QHBoxLayout> m_bottomPanelLayout;
     std::unique_ptr<QPushButton> m_closeButton;
-    std::unique_ptr<SettingsManager> settingsManager;
     std::unique_ptr<Frame> m_Frame;
 
     QWidget* parent{};
@@ -0,0 +1,54 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "Metrics.h"
+
+#include <algorithm>
+
+#include "buraq.h"
+
+Metrics& Metrics::singleton()
+{
+    static Metrics instance; // Created once, thread-safe since C++11
+    return instance;
+}
+
+void Metrics::record(const std::string& name, const double value)
+{
+    {
+        std::lock_guard lock(m_mutex);
+
+        MetricSummary& metric = m_metrics[name];
+        metric.min = metric.count == 0 ? value : std::min(metric.min, value);
+        metric.max = metric.count == 0 ? value : std::max(metric.max, value);
+        metric.last = value;
+        metric.sum += value;
+        metric.count++;
+    }
+
+    file_utils::file_log("[metric] " + name + "=" + std::to_string(value));
+}
+
+void Metrics::increment(const std::string& name)
+{
+    std::lock_guard lock(m_mutex);
+    m_counters[name]++;
+}
+
+std::optional<MetricSummary> Metrics::summary(const std::string& name) const
+{
+    std::lock_guard lock(m_mutex);
+    if (const auto it = m_metrics.find(name); it != m_metrics.end())
+    {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+long long Metrics::counter(const std::string& name) const
+{
+    std::lock_guard lock(m_mutex);
+    const auto it = m_counters.find(name);
+    return it != m_counters.end() ? it->second : 0;
+}
@@ -0,0 +1,54 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef BURAQ_METRICS_H
+#define BURAQ_METRICS_H
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+// Summary of all values recorded under one metric name.
+struct MetricSummary
+{
+    double last = 0;
+    double min = 0;
+    double max = 0;
+    double sum = 0;
+    long long count = 0;
+};
+
+/**
+ * Process-wide registry of named measurements (timings, counters).
+ * Every recorded sample is also written to the application log so it can be
+ * inspected after the fact; counters are only kept in memory.
+ */
+class Metrics
+{
+public:
+    static Metrics& singleton();
+
+    // Records a single sample, e.g. record("bridge.time_to_ready_ms", 812).
+    void record(const std::string& name, double value);
+
+    // Adds one to a counter, e.g. increment("bridge.restarts"). Counters are not samples:
+    // they have no summary, only counter().
+    void increment(const std::string& name);
+
+    [[nodiscard]] std::optional<MetricSummary> summary(const std::string& name) const;
+    [[nodiscard]] long long counter(const std::string& name) const;
+
+private:
+    Metrics() = default;
+    ~Metrics() = default;
+    Metrics(const Metrics&) = delete; // No copy constructor
+    Metrics& operator=(const Metrics&) = delete; // No copy assignment
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, MetricSummary> m_metrics;
+    std::map<std::string, long long> m_counters;
+};
+
+#endif // BURAQ_METRICS_H
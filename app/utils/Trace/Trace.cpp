@@ -0,0 +1,204 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "Trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include "buraq.h"
+
+namespace
+{
+    std::int64_t steadyNanoseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    std::filesystem::path defaultTracePath()
+    {
+        return std::filesystem::temp_directory_path() / "Buraq" / "buraq-trace.json";
+    }
+
+    void appendJsonString(std::string& out, const std::string_view text)
+    {
+        out += '"';
+        for (const char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out += '\\';
+                out += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            }
+            else
+            {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+
+    // Trace-event timestamps are microseconds; the fraction keeps the nanoseconds.
+    void appendMicroseconds(std::string& out, const std::int64_t nanoseconds)
+    {
+        char number[32];
+        std::snprintf(number, sizeof(number), "%lld.%03lld", static_cast<long long>(nanoseconds / 1000),
+                      static_cast<long long>(nanoseconds % 1000));
+        out += number;
+    }
+}
+
+Trace& Trace::singleton()
+{
+    static Trace instance; // Created once, thread-safe since C++11
+    return instance;
+}
+
+Trace::Trace() : m_origin(steadyNanoseconds())
+{
+}
+
+void Trace::configure(const int argc, char* argv[])
+{
+    std::filesystem::path path;
+    bool requested = false;
+
+    if (const char* env = std::getenv("BURAQ_TRACE"); env != nullptr && *env != '\0')
+    {
+        requested = true;
+        if (std::strcmp(env, "1") != 0)
+        {
+            path = env;
+        }
+    }
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg(argv[i]);
+        if (arg == "--trace")
+        {
+            requested = true;
+        }
+        else if (arg.starts_with("--trace="))
+        {
+            requested = true;
+            path = arg.substr(std::strlen("--trace="));
+        }
+    }
+
+    if (!requested)
+    {
+        return;
+    }
+
+    m_path = path.empty() ? defaultTracePath() : path;
+    m_origin = steadyNanoseconds();
+    setThreadName("main");
+    m_enabled.store(true, std::memory_order_relaxed);
+}
+
+std::int64_t Trace::now() const
+{
+    return steadyNanoseconds() - m_origin;
+}
+
+std::uint32_t Trace::threadId()
+{
+    // Small, stable ids read better in the viewer than the platform's.
+    static std::atomic<std::uint32_t> next = 1;
+    thread_local const std::uint32_t id = next.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+void Trace::complete(const char* name, const std::int64_t start, const std::int64_t end)
+{
+    const std::uint32_t thread = threadId();
+    std::lock_guard lock(m_mutex);
+    m_events.push_back({name, 'X', thread, start, end - start});
+}
+
+void Trace::instant(const char* name)
+{
+    if (!enabled())
+    {
+        return;
+    }
+
+    const std::int64_t at = now();
+    const std::uint32_t thread = threadId();
+    std::lock_guard lock(m_mutex);
+    m_events.push_back({name, 'i', thread, at, 0});
+}
+
+void Trace::setThreadName(const std::string& name)
+{
+    const std::uint32_t thread = threadId();
+    std::lock_guard lock(m_mutex);
+    m_threadNames[thread] = name;
+}
+
+bool Trace::write()
+{
+    if (!enabled())
+    {
+        return false;
+    }
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    {
+        std::lock_guard lock(m_mutex);
+        json.reserve(json.size() + m_events.size() * 96);
+
+        json += R"({"ph":"M","pid":1,"tid":0,"name":"process_name","args":{"name":"Buraq"}})";
+        for (const auto& [thread, name] : m_threadNames)
+        {
+            json += ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(thread) +
+                ",\"name\":\"thread_name\",\"args\":{\"name\":";
+            appendJsonString(json, name);
+            json += "}}";
+        }
+
+        for (const Event& event : m_events)
+        {
+            json += ",\n{\"ph\":\"";
+            json += event.phase;
+            json += "\",\"pid\":1,\"tid\":" + std::to_string(event.thread) + ",\"name\":";
+            appendJsonString(json, event.name);
+            json += ",\"ts\":";
+            appendMicroseconds(json, event.start);
+            if (event.phase == 'X')
+            {
+                json += ",\"dur\":";
+                appendMicroseconds(json, event.duration);
+            }
+            else
+            {
+                json += R"(,"s":"p")"; // instant across the whole process
+            }
+            json += '}';
+        }
+    }
+    json += "\n]}\n";
+
+    std::error_code error;
+    std::filesystem::create_directories(m_path.parent_path(), error);
+    std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+    if (!file.write(json.data(), static_cast<std::streamsize>(json.size())))
+    {
+        file_utils::file_log(LogLevel::Warning, "Trace: cannot write " + m_path.string());
+        return false;
+    }
+
+    file_utils::file_log("Trace: wrote " + m_path.string());
+    return true;
+}
@@ -0,0 +1,102 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef BURAQ_TRACE_H
+#define BURAQ_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Timeline of named spans, written as Chrome trace-event JSON (chrome://tracing, Perfetto).
+ *
+ * Off unless BURAQ_TRACE is set or --trace is passed; while off a span costs one atomic
+ * load. Timestamps are nanoseconds on the steady clock since configure(), and every event
+ * carries the id of the thread that recorded it.
+ */
+class Trace
+{
+public:
+    static Trace& singleton();
+
+    // Turns recording on for --trace[=file] or BURAQ_TRACE=file ("1" for the default file).
+    // Call first thing in main, so the clock starts with the process.
+    void configure(int argc, char* argv[]);
+
+    [[nodiscard]] bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Nanoseconds since configure().
+    [[nodiscard]] std::int64_t now() const;
+
+    // name must outlive the trace: use string literals.
+    void complete(const char* name, std::int64_t start, std::int64_t end);
+    void instant(const char* name);
+
+    // Names the calling thread in the viewer.
+    void setThreadName(const std::string& name);
+
+    // Writes what was recorded to the file given to configure(); false if it cannot.
+    bool write();
+
+private:
+    Trace();
+    ~Trace() = default;
+    Trace(const Trace&) = delete; // No copy constructor
+    Trace& operator=(const Trace&) = delete; // No copy assignment
+
+    struct Event
+    {
+        const char* name;
+        char phase; // 'X' complete, 'i' instant
+        std::uint32_t thread;
+        std::int64_t start;
+        std::int64_t duration;
+    };
+
+    static std::uint32_t threadId();
+
+    std::atomic<bool> m_enabled = false;
+    std::int64_t m_origin;
+    std::filesystem::path m_path;
+
+    std::mutex m_mutex;
+    std::vector<Event> m_events;
+    std::map<std::uint32_t, std::string> m_threadNames;
+};
+
+/**
+ * Records the time between its construction and destruction as one span, e.g.
+ *     TraceSpan span("AppUi::initAppLayout");
+ */
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char* name)
+        : m_name(name), m_start(Trace::singleton().enabled() ? Trace::singleton().now() : -1)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (m_start >= 0)
+        {
+            Trace& trace = Trace::singleton();
+            trace.complete(m_name, m_start, trace.now());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* m_name;
+    std::int64_t m_start;
+};
+
+#endif // BURAQ_TRACE_H
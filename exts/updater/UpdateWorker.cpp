@@ -4,20 +4,73 @@
 
 #include "UpdateWorker.h"
 
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QProcess>
 #include <QThread>
 
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
 // Include Windows header for process waiting
 #ifdef _WIN32
 
 #include <windows.h>
 
+#else
+
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#endif
+
+namespace
+{
+    // How long the relaunched app gets to report that its window is up.
+    constexpr int APP_READY_TIMEOUT_MS = 30000;
+
+    /**
+     * Swaps two directories in one step, so there is no moment without an installation:
+     * renameat2(RENAME_EXCHANGE) on Linux, renamex_np(RENAME_SWAP) on macOS. False where the
+     * platform or the file system cannot; Windows has no such call.
+     */
+    bool exchangeDirectories(const std::filesystem::path& first, const std::filesystem::path& second,
+                             std::error_code& ec)
+    {
+#if defined(__linux__) && defined(RENAME_EXCHANGE)
+        if (renameat2(AT_FDCWD, first.c_str(), AT_FDCWD, second.c_str(), RENAME_EXCHANGE) == 0)
+        {
+            return true;
+        }
+        ec = std::error_code(errno, std::generic_category());
+#elif defined(__APPLE__)
+        if (renamex_np(first.c_str(), second.c_str(), RENAME_SWAP) == 0)
+        {
+            return true;
+        }
+        ec = std::error_code(errno, std::generic_category());
+#else
+        (void)first;
+        (void)second;
+        ec = std::make_error_code(std::errc::function_not_supported);
 #endif
+        return false;
+    }
+}
 
 UpdateWorker::UpdateWorker(QObject* parent) : QObject(parent)
 {
 }
 
-void UpdateWorker::doUpdate(const std::filesystem::path& installerPath,
+void UpdateWorker::doUpdate(const std::filesystem::path& packagePath,
                             const std::filesystem::path& installationPath,
                             const unsigned long parentPID)
 {
@@ -26,71 +79,58 @@ void UpdateWorker::doUpdate(const std::filesystem::path& installerPath,
     // --- 1. Wait for Main App to Close ---
     waitForMainAppToClose(parentPID);
 
+    // From here until the relaunched app is up, there is no app to use.
+    QElapsedTimer downtime;
+    downtime.start();
     emit progressChanged(10); // Update progress after waiting
 
     // --- 2. Perform Installation ---
     emit statusTextChanged("Applying update...");
-    emit logMessage(QString("Update package: %1").arg(installerPath.c_str()));
-    emit logMessage(QString("Installation path: %1").arg(installationPath.c_str()));
+    emit logMessage(QString("Update package: %1").arg(QString::fromStdString(packagePath.string())));
+    emit logMessage(QString("Installation path: %1").arg(QString::fromStdString(installationPath.string())));
 
     emit progressChanged(20);
 
-    // extracting files
-    if (!installNewVersion(installerPath, installationPath))
+    // "C:/Programs/Buraq/" names the same directory as "C:/Programs/Buraq", whose siblings the
+    // staging and backup directories are.
+    std::filesystem::path installation = installationPath.lexically_normal();
+    if (!installation.has_filename())
     {
-        return;
+        installation = installation.parent_path();
     }
 
-    emit finished(true, "Update completed successfully!"); // Signal success
-    QThread::msleep(2); // Wait a moment for the OS to release file handles
-
-    // restart app
-    emit logMessage("Restarting application...");
-    QThread::msleep(1); // User friendliness
-
-    const auto mainAppExePath = std::filesystem::path(installationPath.string()) / "buraq.exe";
-
-#ifdef _WIN32
-    if (HANDLE hLaunchedProcess = nullptr; launchApp(mainAppExePath, &hLaunchedProcess, "--show-gui", true))
+    // A directory holds the new version's files, staged by the app; anything else is the installer.
+    if (std::filesystem::is_directory(packagePath)
+            ? !switchToStagedVersion(packagePath, installation)
+            : !installNewVersion(packagePath, installation))
     {
-        emit logMessage(
-            QString("Relaunching %1. Waiting for it to become responsive...").arg(
-                QString::fromStdString(mainAppExePath.filename().string())));
-
-
-        const bool appStarted = waitForAppWindow(hLaunchedProcess, 90000); // 30-second timeout
-        CloseHandle(hLaunchedProcess); // Close handle once we're done with it
-
-        if (appStarted)
-        {
-            emit logMessage("Main application appears to have started successfully.");
-            emit progressChanged(100);
-            emit finished(true, "Update completed successfully!"); // Signal success
-        }
-        else
-        {
-            emit logMessage(
-                "Warning: Main application launched but its window did not appear within timeout. Update finished.");
-            emit finished(false, "Update completed, but app window not found!"); // Signal partial success/warning
-        }
+        return;
     }
+    const qint64 switchedMs = downtime.elapsed();
 
-#else
-    // Add alternative implementation for Linux or macOS
-#endif
+    // --- 3. Relaunch ---
+    emit progressChanged(90);
+    emit statusTextChanged("Restarting application...");
+    if (!relaunchApp(installation))
+    {
+        emit finished(false, "Update completed, but the application did not start!");
+        return;
+    }
 
+    const qint64 downtimeMs = downtime.elapsed();
+    emit logMessage(QString("Downtime: %1 ms (switch %2 ms, restart %3 ms)")
+                    .arg(downtimeMs).arg(switchedMs).arg(downtimeMs - switchedMs));
     emit progressChanged(100);
-    QThread::msleep(2);
-
+    emit finished(true, "Update completed successfully!");
     emit restart();
 }
 
 void UpdateWorker::waitForMainAppToClose(const unsigned long parentPID)
 {
-#ifdef _WIN32
     emit statusTextChanged("Waiting for main application to close...");
     emit logMessage(QString("Watching Parent Process ID: %1").arg(parentPID));
 
+#ifdef _WIN32
     if (HANDLE hParentProcess = OpenProcess(SYNCHRONIZE, FALSE, parentPID); hParentProcess == NULL)
     {
         // Could be that the parent already closed, which is fine.
@@ -98,185 +138,99 @@ void UpdateWorker::waitForMainAppToClose(const unsigned long parentPID)
     }
     else
     {
-        // Wait for the process to terminate
+        // Signalled once the process is gone, its files closed with it.
         WaitForSingleObject(hParentProcess, INFINITE);
         CloseHandle(hParentProcess);
         emit logMessage("Main application has exited. Proceeding with update.");
     }
-    // Give a moment for the OS to release file handles
-    QThread::msleep(1000);
 #else
-	// Implement waiting for other OSes if needed
-	emit logMessage("Process waiting not implemented for this OS, proceeding immediately.");
-	QThread::msleep(1000);
-#endif
-}
-
-#ifdef _WIN32
-// In UpdateWorker.h (if you want to keep waitForMainAppToStart, but its logic needs overhaul)
-// For simplicity, let's remove the faulty waitForMainAppToStart for now.
-// If you want to WAIT for the child, then the WaitForSingleObject should be on pi.hProcess.
-// For *this* problem (app closing with dialog), the primary fix is correct handle closing.
-bool UpdateWorker::launchApp(const std::filesystem::path& appPath, HANDLE* outProcessHandle, const QString& args,
-                             const bool createNewConsole)
-{
-    if (appPath.empty() || !std::filesystem::exists(appPath))
+    const auto pid = static_cast<pid_t>(parentPID);
+#ifdef SYS_pidfd_open
+    // Readable once the process has exited; unlike kill(pid, 0) it cannot be fooled by a new
+    // process reusing the PID, nor by a zombie its parent has not reaped yet.
+    if (const int pidfd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0)); pidfd >= 0)
     {
-        emit logMessage(
-            QString("Error: Application path is invalid or does not exist for relaunch: %1").arg(
-                QString::fromStdString(appPath.string())));
-        if (outProcessHandle) *outProcessHandle = NULL;
-        return false;
-    }
-
-    emit logMessage(
-        QString("Attempting to launch: %1 with args: %2").arg(QString::fromStdString(appPath.string()), args));
-
-    // CreateProcessA requires a non-const char* buffer for lpCommandLine
-    // and it must contain the full command line, including the executable path,
-    // when lpApplicationName is NULL (which is generally safer).
-    std::string cmd_str = "\"" + appPath.string() + "\""; // Always quote the path to handle spaces
-    if (!args.isEmpty())
-    {
-        cmd_str += " " + args.toStdString();
+        pollfd descriptor{.fd = pidfd, .events = POLLIN, .revents = 0};
+        while (poll(&descriptor, 1, -1) < 0 && errno == EINTR)
+        {
+        }
+        close(pidfd);
+        emit logMessage("Main application has exited. Proceeding with update.");
+        return;
     }
-
-    // Allocate a mutable buffer for CreateProcessA
-    // CreateProcessA might modify this buffer.
-    std::vector<char> cmd_buffer(cmd_str.begin(), cmd_str.end());
-    cmd_buffer.push_back('\0'); // Null-terminate the buffer
-
-    STARTUPINFOA si;
-    PROCESS_INFORMATION pi;
-    ZeroMemory(&si, sizeof(si));
-    si.cb = sizeof(si);
-    ZeroMemory(&pi, sizeof(pi));
-
-    DWORD creationFlags = 0; // Default flags
-
-    // --- CRITICAL CHANGE HERE ---
-    // If buraq.exe is a CONSOLE application:
-    if (createNewConsole)
+    if (errno == ESRCH)
     {
-        creationFlags |= CREATE_NEW_CONSOLE; // Give it its own console window
+        emit logMessage("Main application has already exited. Proceeding with update.");
+        return;
     }
-    else
+#endif
+    // Kernels before 5.3, and other systems.
+    while (kill(pid, 0) == 0 || errno == EPERM)
     {
-        creationFlags |= DETACHED_PROCESS; // Run without any console window (fully in background)
+        QThread::msleep(10);
     }
+    emit logMessage("Main application has exited. Proceeding with update.");
+#endif
+}
 
-    // Try launching the process
-    BOOL success = CreateProcessA(
-        NULL, // lpApplicationName (use lpCommandLine for full path)
-        cmd_buffer.data(), // lpCommandLine (modifiable buffer)
-        NULL, // lpProcessAttributes
-        NULL, // lpThreadAttributes
-        FALSE, // bInheritHandles (don't inherit handles from parent)
-        creationFlags, // dwCreationFlags (0 for default, or CREATE_NO_WINDOW, etc.)
-        NULL, // lpEnvironment
-        appPath.parent_path().string().c_str(), // lpCurrentDirectory (set working directory of new process)
-        &si,
-        &pi
-    );
+/**
+ * Starts the app from the installation and waits for it to report that its window is up: it
+ * gets the name of a local socket (--update-handshake) and writes "ready" to it once painted.
+ * @param installationPath The installation to start the app from.
+ * @return Returns true if the app reported ready in time.
+ */
+bool UpdateWorker::relaunchApp(const std::filesystem::path& installationPath)
+{
+#ifdef _WIN32
+    const std::filesystem::path appPath = installationPath / "buraq.exe";
+#else
+    const std::filesystem::path appPath = installationPath / "buraq";
+#endif
 
-    if (success)
+    QLocalServer server;
+    const QString serverName = QString("buraq-update-%1").arg(QCoreApplication::applicationPid());
+    QLocalServer::removeServer(serverName); // left by a crashed updater
+    if (!server.listen(serverName))
     {
-        emit logMessage(
-            QString("Successfully launched process. PID: %1, Thread ID: %2").arg(pi.dwProcessId).arg(pi.dwThreadId));
-        // Return the process handle if requested
-        if (outProcessHandle)
-        {
-            *outProcessHandle = pi.hProcess; // Pass back the process handle
-        }
-        else
-        {
-            // If caller doesn't want the handle, close it immediately
-            CloseHandle(pi.hProcess);
-        }
-        CloseHandle(pi.hThread); // Always close the thread handle, as we don't need it.
-        return true;
+        emit logMessage(QString("Error: cannot listen for the application: %1").arg(server.errorString()));
+        return false;
     }
-    else
-    {
-        const DWORD error = GetLastError();
-        emit logMessage(
-            QString("CreateProcessA failed. Error Code: %1. Path: %2").arg(error).arg(
-                QString::fromStdString(appPath.string())));
 
-        // Provide more specific error messages for common issues
-        if (error == ERROR_FILE_NOT_FOUND)
-        {
-            emit logMessage("Common cause: The executable file was not found at the specified path.");
-        }
-        else if (error == ERROR_ACCESS_DENIED)
-        {
-            emit logMessage("Common cause: Access denied (permissions issue or another process is locking the file).");
-        }
-        else if (error == ERROR_BAD_EXE_FORMAT)
-        {
-            emit logMessage("Common cause: Corrupted executable or architecture mismatch (e.g., 32-bit vs 64-bit).");
-        }
-        else if (error == ERROR_INVALID_PARAMETER)
-        {
-            emit logMessage("Common cause: Invalid command line arguments or application name.");
-        }
-        if (outProcessHandle) *outProcessHandle = NULL;
+    emit logMessage(QString("Relaunching %1...").arg(QString::fromStdString(appPath.string())));
+    if (!QProcess::startDetached(QString::fromStdString(appPath.string()),
+                                 {"--show-gui", "--update-handshake=" + server.fullServerName()},
+                                 QString::fromStdString(installationPath.string())))
+    {
+        emit logMessage(QString("Error: cannot start %1").arg(QString::fromStdString(appPath.string())));
         return false;
     }
-}
-
 
-// NEW HELPER FUNCTION: Wait for a process window to appear
-// This is more robust for "app started" than just process creation
-bool UpdateWorker::waitForAppWindow(HANDLE hProcess, DWORD timeout_ms)
-{
-    DWORD startTime = GetTickCount();
-    while (GetTickCount() - startTime < timeout_ms)
+    QElapsedTimer timer;
+    timer.start();
+    while (server.waitForNewConnection(static_cast<int>(std::max<qint64>(0, APP_READY_TIMEOUT_MS - timer.elapsed()))))
     {
-        DWORD exitCode;
-        if (GetExitCodeProcess(hProcess, &exitCode) && exitCode != STILL_ACTIVE)
+        QLocalSocket* socket = server.nextPendingConnection();
+        while (!socket->canReadLine() && socket->waitForReadyRead(
+            static_cast<int>(std::max<qint64>(0, APP_READY_TIMEOUT_MS - timer.elapsed()))))
         {
-            // Process terminated prematurely
-            emit logMessage("Launched application terminated prematurely while waiting for window.");
-            return false;
         }
-
-        // Enumerate windows and check if one belongs to this process
-        // This is a simplified check. A more robust way might involve
-        // finding the main window by title or class after the process starts.
-        // For a simple 'any window' check for the launched process:
-        HWND hWnd = NULL;
-        do
+        const bool ready = socket->readLine().trimmed() == "ready";
+        delete socket;
+        if (ready)
         {
-            hWnd = FindWindowEx(NULL, hWnd, NULL, NULL); // Enumerate all top-level windows
-            if (hWnd != NULL)
-            {
-                DWORD pid;
-                GetWindowThreadProcessId(hWnd, &pid);
-                if (pid == GetProcessId(hProcess))
-                {
-                    // Found a window belonging to our process!
-                    // Optionally, check if it's actually visible: IsWindowVisible(hWnd)
-                    emit logMessage(QString("Found window for launched application (HWND: %1)").arg((quintptr)hWnd));
-                    return true;
-                }
-            }
+            emit logMessage(QString("The application is up after %1 ms.").arg(timer.elapsed()));
+            return true;
         }
-        while (hWnd != NULL);
-
-        QThread::msleep(100); // Small delay to avoid busy-waiting
     }
-    emit logMessage(QString("Timed out waiting for application window."));
-    return false; // Timeout
+    emit logMessage("Warning: the application did not report that it started.");
+    return false;
 }
-#else
-// Add implementation for linux or macOS
-#endif
 
 /**
- * Runs the installer app after removing the old installation.
+ * Runs the installer over the existing installation, which is left in place, so a failed
+ * install keeps the old version working. Windows only.
  * @param installerPath Runs the installer app, waits for the app to complete
- * @param installationPath The location where the new installation will be created.
+ * @param installationPath The installation the installer updates in place.
  * @return Returns true if the installer app completes successfully.
  */
 bool UpdateWorker::installNewVersion(const std::filesystem::path& installerPath,
@@ -293,18 +247,10 @@ bool UpdateWorker::installNewVersion(const std::filesystem::path& installerPath,
 
     emit progressChanged(60);
 
+#ifdef _WIN32
+    // Installed over the current version: if the installer fails, that version still runs.
     std::error_code ec;
-    if (std::filesystem::is_directory(installationPath, ec))
-    {
-        if (const uintmax_t removed_count = std::filesystem::remove_all(installationPath, ec);
-            removed_count == 0 || ec
-        )
-        {
-            emit logMessage("Failed to remove any files");
-        }
-    }
-
-    emit progressChanged(70); // Installer finished
+    emit progressChanged(70);
 
     emit statusTextChanged("Running installer...");
     emit logMessage(
@@ -380,4 +326,152 @@ bool UpdateWorker::installNewVersion(const std::filesystem::path& installerPath,
         emit finished(false, "Update Failed: Could not launch installer!");
         return false;
     }
+#else
+    (void)installationPath;
+    emit logMessage("Error: installers only run on Windows; elsewhere updates are staged.");
+    emit finished(false, "Update Failed: Installer is not supported on this system!");
+    return false;
+#endif
+}
+
+/**
+ * Replaces the installation with the complete copy staged next to it. Where the platform can,
+ * the two directories trade places in one rename (exchangeDirectories), so the installation is
+ * never missing or half updated. Otherwise, as on Windows, it goes file by file: each installed
+ * file is moved aside to <installation>.old, then each staged one moved in. Files can be renamed
+ * while they are open, as updater.exe and its DLLs are, where the directory could not be. If a
+ * move fails, the ones done are undone in reverse, leaving the installation as it was.
+ * @param stagingPath The new version's files, on the installation's volume.
+ * @param installationPath The installation to replace.
+ * @return Returns true if the installation now holds the new version.
+ */
+bool UpdateWorker::switchToStagedVersion(const std::filesystem::path& stagingPath,
+                                         const std::filesystem::path& installationPath)
+{
+    std::error_code ec;
+    std::filesystem::path backupPath = installationPath.has_filename() ? installationPath : installationPath.parent_path();
+    backupPath += ".old";
+    std::filesystem::remove_all(backupPath, ec); // left by an earlier update
+
+    // Relative paths of the files to move; patches the app left unapplied are not part of it.
+    const auto filesUnder = [](const std::filesystem::path& root, std::vector<std::filesystem::path>& files)
+    {
+        std::error_code error;
+        for (auto it = std::filesystem::recursive_directory_iterator(root, error);
+             !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+        {
+            if (it->path().filename() == ".patches")
+            {
+                it.disable_recursion_pending();
+            }
+            else if (it->is_regular_file())
+            {
+                files.push_back(it->path().lexically_relative(root));
+            }
+        }
+        return !error;
+    };
+    std::vector<std::filesystem::path> installed, staged;
+    if (!filesUnder(installationPath, installed) || !filesUnder(stagingPath, staged) || staged.empty())
+    {
+        emit logMessage(QString("Error: cannot list the files of %1 or %2").arg(
+            QString::fromStdString(installationPath.string()), QString::fromStdString(stagingPath.string())));
+        emit finished(false, "Update Failed: the staged update is incomplete!");
+        return false;
+    }
+
+    emit statusTextChanged("Switching to the new version...");
+    emit progressChanged(40);
+
+    if (exchangeDirectories(stagingPath, installationPath, ec))
+    {
+        // The staging directory now holds the previous version.
+        std::filesystem::remove_all(installationPath / ".patches", ec);
+        std::filesystem::remove_all(stagingPath, ec);
+        emit progressChanged(80);
+        emit logMessage(QString("Swapped in %1 files in one step.").arg(staged.size()));
+        return true;
+    }
+    emit logMessage(QString("Moving the files one by one (%1).").arg(QString::fromStdString(ec.message())));
+
+    std::vector<std::pair<std::filesystem::path, std::filesystem::path>> journal;
+    const auto move = [&journal, &ec](const std::filesystem::path& from, const std::filesystem::path& to)
+    {
+        std::filesystem::create_directories(to.parent_path(), ec);
+        std::filesystem::rename(from, to, ec);
+        if (!ec)
+        {
+            journal.emplace_back(from, to);
+        }
+        return !ec;
+    };
+
+    bool switched = true;
+    for (const std::filesystem::path& file : installed)
+    {
+        if (!move(installationPath / file, backupPath / file))
+        {
+            switched = false;
+            emit logMessage(QString("Cannot move %1 aside: %2").arg(QString::fromStdString(file.string()),
+                                                                     QString::fromStdString(ec.message())));
+            break;
+        }
+    }
+    for (std::size_t i = 0; switched && i < staged.size(); ++i)
+    {
+        if (!move(stagingPath / staged[i], installationPath / staged[i]))
+        {
+            switched = false;
+            emit logMessage(QString("Cannot move %1 in: %2").arg(QString::fromStdString(staged[i].string()),
+                                                                  QString::fromStdString(ec.message())));
+        }
+    }
+
+    if (!switched)
+    {
+        bool restored = true;
+        for (auto it = journal.rbegin(); it != journal.rend(); ++it)
+        {
+            std::error_code undo;
+            std::filesystem::rename(it->second, it->first, undo);
+            if (undo)
+            {
+                restored = false;
+                emit logMessage(QString("Cannot move %1 back: %2").arg(QString::fromStdString(it->first.string()),
+                                                                       QString::fromStdString(undo.message())));
+            }
+        }
+        if (restored)
+        {
+            std::filesystem::remove_all(backupPath, ec);
+        }
+        emit finished(false, "Update Failed: the previous version was kept.");
+        return false;
+    }
+
+    emit progressChanged(80);
+    emit statusTextChanged("Cleaning up...");
+
+    // Best effort: what is still open, like this updater, goes with the next update. Directories
+    // the move aside emptied go too, the deepest first.
+    std::vector<std::filesystem::path> directories;
+    for (auto it = std::filesystem::recursive_directory_iterator(installationPath, ec);
+         !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+    {
+        if (it->is_directory(ec))
+        {
+            directories.push_back(it->path());
+        }
+    }
+    for (auto it = directories.rbegin(); it != directories.rend(); ++it)
+    {
+        if (std::filesystem::is_empty(*it, ec))
+        {
+            std::filesystem::remove(*it, ec);
+        }
+    }
+    std::filesystem::remove_all(stagingPath, ec);
+    std::filesystem::remove_all(backupPath, ec);
+    emit logMessage(QString("Switched %1 files to the new version.").arg(staged.size()));
+    return true;
 }
@@ -9,11 +9,8 @@
 #include <QObject>
 #include <QString>
 
-#ifdef _WIN32
-
-#include <windows.h>
-
-#endif
+#include <filesystem>
+#include <string>
 
 void log(const std::string& _log);
 
@@ -25,8 +22,9 @@ public:
     explicit UpdateWorker(QObject* parent = nullptr);
 
 public slots:
-    // The main function to run in the background thread
-    void doUpdate(const std::filesystem::path& installerPath, const std::filesystem::path& installationPath,
+    // The main function to run in the background thread. packagePath is the installer, or a
+    // directory with the complete new version staged next to the installation.
+    void doUpdate(const std::filesystem::path& packagePath, const std::filesystem::path& installationPath,
                   unsigned long parentPID);
 
 signals:
@@ -39,13 +37,9 @@ signals:
 
 private:
     void waitForMainAppToClose(unsigned long parentPID);
-#ifdef _WIN32
-
-    bool launchApp(const std::filesystem::path& appPath, HANDLE* outProcessHandle, const QString& args, bool createNewConsole = false);
-    bool waitForAppWindow(HANDLE hProcess, DWORD timeout_ms);
-
-#endif
+    bool relaunchApp(const std::filesystem::path& installationPath);
     bool installNewVersion(const std::filesystem::path& installerPath, const std::filesystem::path& installationPath);
+    bool switchToStagedVersion(const std::filesystem::path& stagingPath, const std::filesystem::path& installationPath);
 };
 
 #endif //UPDATE_WORKER_H
@@ -1,5 +1,7 @@
 // Updater.exe - main.cpp
-#include <windows.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
 #include <string>
 #include <iostream>
 #include <QApplication>
@@ -17,42 +19,42 @@ void log(const std::string& _log)
 
 int main(int argc, char* argv[])
 {
-    QApplication app(argc, argv);
+    // --headless: no window; the log goes to stderr and the exit code says whether the update
+    // went through (tools/test_update_swap.sh).
+    const bool headless = std::any_of(argv + 1, argv + argc, [](const char* arg)
+    {
+        return std::strcmp(arg, "--headless") == 0;
+    });
+    const std::unique_ptr<QCoreApplication> app = headless
+                                                      ? std::make_unique<QCoreApplication>(argc, argv)
+                                                      : std::make_unique<QApplication>(argc, argv);
 
     // --- Get arguments from command line ---
-    if (QApplication::arguments().size() < 4)
+    QStringList arguments = QCoreApplication::arguments();
+    arguments.removeAll("--headless");
+    if (arguments.size() < 4)
     {
-        qCritical() << "Usage: Updater.exe <packagePath> <installPath> <parentPID>";
+        qCritical() << "Usage: Updater.exe [--headless] <packagePath> <installPath> <parentPID>";
         return 1;
     }
 
     //updater.exe setup-x.x.x.dev.exe C:\Users\user\AppData\Local\Programs\Buraq\ 16572
+    //updater C:\Users\user\AppData\Local\Programs\Buraq.staging-v1.2.0 C:\Users\user\AppData\Local\Programs\Buraq 16572
 
-    const std::filesystem::path installer(QApplication::arguments().at(1).toStdString());
-    const std::filesystem::path installation_path(QApplication::arguments().at(2).toStdString());
-    const unsigned long parentPID = QApplication::arguments().at(3).toULong();
+    const std::filesystem::path installer(arguments.at(1).toStdString());
+    const std::filesystem::path installation_path(arguments.at(2).toStdString());
+    const unsigned long parentPID = arguments.at(3).toULong();
 
     log("Updater started.");
     log("Installer: " + installer.string());
     log("Install Dir: " + installation_path.string());
     log("Parent PID: " + std::to_string(parentPID));
 
-    // --- Setup Dialog and Worker Thread ---
-    UpdateProgressDialog dialog;
-
     auto* workerThread = new QThread();
     auto* worker = new UpdateWorker();
 
     worker->moveToThread(workerThread);
 
-    // --- Connect Signals and Slots ---
-    // Connect worker signals to dialog slots
-    QObject::connect(worker, &UpdateWorker::statusTextChanged, &dialog, &UpdateProgressDialog::setStatusText);
-    QObject::connect(worker, &UpdateWorker::logMessage, &dialog, &UpdateProgressDialog::addLogMessage);
-    QObject::connect(worker, &UpdateWorker::progressChanged, &dialog, &UpdateProgressDialog::setProgress);
-    QObject::connect(worker, &UpdateWorker::finished, &dialog, &UpdateProgressDialog::onUpdateFinished);
-    QObject::connect(worker, &UpdateWorker::restart, &dialog, &UpdateProgressDialog::accept);
-
     // When the worker is finished, quit the thread
     QObject::connect(worker, &UpdateWorker::finished, workerThread, &QThread::quit);
     // When the thread quits, clean up the worker and thread objects
@@ -65,6 +67,36 @@ int main(int argc, char* argv[])
         worker->doUpdate(installer, installation_path, parentPID);
     });
 
+    if (headless)
+    {
+        bool success = false;
+        QObject::connect(worker, &UpdateWorker::logMessage, app.get(), [](const QString& message)
+        {
+            std::cerr << message.toStdString() << std::endl;
+        });
+        QObject::connect(worker, &UpdateWorker::finished, app.get(), [&success](const bool ok, const QString& message)
+        {
+            std::cerr << message.toStdString() << std::endl;
+            success = ok;
+        });
+        QObject::connect(workerThread, &QThread::finished, app.get(), &QCoreApplication::quit);
+
+        workerThread->start();
+        QCoreApplication::exec();
+        return success ? 0 : 1;
+    }
+
+    // --- Setup Dialog and Worker Thread ---
+    UpdateProgressDialog dialog;
+
+    // --- Connect Signals and Slots ---
+    // Connect worker signals to dialog slots
+    QObject::connect(worker, &UpdateWorker::statusTextChanged, &dialog, &UpdateProgressDialog::setStatusText);
+    QObject::connect(worker, &UpdateWorker::logMessage, &dialog, &UpdateProgressDialog::addLogMessage);
+    QObject::connect(worker, &UpdateWorker::progressChanged, &dialog, &UpdateProgressDialog::setProgress);
+    QObject::connect(worker, &UpdateWorker::finished, &dialog, &UpdateProgressDialog::onUpdateFinished);
+    QObject::connect(worker, &UpdateWorker::restart, &dialog, &UpdateProgressDialog::accept);
+
     // --- Start the Process ---
     workerThread->start(); // Start the background thread
 
@@ -32,6 +32,8 @@
 #include <set>
 #include <map>
 
+#include "logger.h"
+
 namespace buraq
 {
     struct buraq_api
@@ -72,7 +74,9 @@ namespace buraq
 namespace file_utils
 {
     std::string getFilename(const std::string& filePath);
+    // Logs through Logger::singleton(), so the call only queues the line.
     void file_log(const std::string& message);
+    void file_log(LogLevel level, const std::string& message);
 }
 
 #endif // BURAQ_API_H
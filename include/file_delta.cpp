@@ -0,0 +1,139 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "file_delta.h"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include <zstd.h>
+
+#include "sha256.h"
+
+namespace {
+	struct CCtxDeleter {
+		void operator()(ZSTD_CCtx *context) const { ZSTD_freeCCtx(context); }
+	};
+
+	struct DCtxDeleter {
+		void operator()(ZSTD_DCtx *context) const { ZSTD_freeDCtx(context); }
+	};
+
+	bool read_file(const std::filesystem::path &path, std::vector<char> &data, std::string &error) {
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file) {
+			error = "Cannot open " + path.string();
+			return false;
+		}
+		data.resize(static_cast<std::size_t>(file.tellg()));
+		if (!file.seekg(0) || !file.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+			error = "Cannot read " + path.string();
+			return false;
+		}
+		return true;
+	}
+
+	// The match window has to reach back over the whole old file.
+	int window_log(const std::size_t size) {
+		const ZSTD_bounds bounds = ZSTD_cParam_getBounds(ZSTD_c_windowLog);
+		int log = bounds.lowerBound;
+		while (log < bounds.upperBound && (std::size_t{1} << log) < size) {
+			log++;
+		}
+		return log;
+	}
+
+	bool failed(const std::size_t code, const std::string &what, std::string &error) {
+		if (ZSTD_isError(code)) {
+			error = what + ": " + ZSTD_getErrorName(code);
+			return true;
+		}
+		return false;
+	}
+}
+
+bool file_delta::create_patch(const std::filesystem::path &oldFile, const std::filesystem::path &newFile,
+                              const std::filesystem::path &patch, std::string &error, const int level) {
+	std::vector<char> oldData, newData;
+	if (!read_file(oldFile, oldData, error) || !read_file(newFile, newData, error)) {
+		return false;
+	}
+
+	const std::unique_ptr<ZSTD_CCtx, CCtxDeleter> context(ZSTD_createCCtx());
+	const int windowLog = window_log(std::max(oldData.size(), newData.size()));
+	if (failed(ZSTD_CCtx_setParameter(context.get(), ZSTD_c_compressionLevel, level), "level", error) ||
+		failed(ZSTD_CCtx_setParameter(context.get(), ZSTD_c_windowLog, windowLog), "window", error) ||
+		failed(ZSTD_CCtx_setParameter(context.get(), ZSTD_c_enableLongDistanceMatching, 1), "long mode", error) ||
+		failed(ZSTD_CCtx_refPrefix(context.get(), oldData.data(), oldData.size()), "prefix", error)) {
+		return false;
+	}
+
+	std::vector<char> compressed(ZSTD_compressBound(newData.size()));
+	const std::size_t size = ZSTD_compress2(context.get(), compressed.data(), compressed.size(), newData.data(),
+	                                        newData.size());
+	if (failed(size, "Cannot compress " + newFile.string(), error)) {
+		return false;
+	}
+
+	std::ofstream output(patch, std::ios::binary | std::ios::trunc);
+	if (!output.write(compressed.data(), static_cast<std::streamsize>(size)) || !output.flush()) {
+		error = "Cannot write " + patch.string();
+		return false;
+	}
+	return true;
+}
+
+bool file_delta::apply_patch(const std::filesystem::path &oldFile, const std::filesystem::path &patch,
+                             const std::filesystem::path &output, std::string &sha256, std::string &error) {
+	std::vector<char> oldData;
+	if (!read_file(oldFile, oldData, error)) {
+		return false;
+	}
+	std::ifstream input(patch, std::ios::binary);
+	std::ofstream out(output, std::ios::binary | std::ios::trunc);
+	if (!input || !out) {
+		error = "Cannot open " + (input ? output : patch).string();
+		return false;
+	}
+
+	const std::unique_ptr<ZSTD_DCtx, DCtxDeleter> context(ZSTD_createDCtx());
+	if (failed(ZSTD_DCtx_setParameter(context.get(), ZSTD_d_windowLogMax,
+	                                  ZSTD_dParam_getBounds(ZSTD_d_windowLogMax).upperBound), "window", error) ||
+		failed(ZSTD_DCtx_refPrefix(context.get(), oldData.data(), oldData.size()), "prefix", error)) {
+		return false;
+	}
+
+	// Streamed: the new file never has to be in memory whole.
+	std::vector<char> inBuffer(ZSTD_DStreamInSize());
+	std::vector<char> outBuffer(ZSTD_DStreamOutSize());
+	Sha256 hasher;
+	std::size_t pending = 0; // non-zero while a frame is unfinished
+	while (input.read(inBuffer.data(), static_cast<std::streamsize>(inBuffer.size())) || input.gcount() > 0) {
+		ZSTD_inBuffer in{inBuffer.data(), static_cast<std::size_t>(input.gcount()), 0};
+		while (in.pos < in.size) {
+			ZSTD_outBuffer out_buffer{outBuffer.data(), outBuffer.size(), 0};
+			pending = ZSTD_decompressStream(context.get(), &out_buffer, &in);
+			if (failed(pending, "Cannot apply " + patch.string(), error)) {
+				return false;
+			}
+			hasher.update(outBuffer.data(), out_buffer.pos);
+			if (!out.write(outBuffer.data(), static_cast<std::streamsize>(out_buffer.pos))) {
+				error = "Cannot write " + output.string();
+				return false;
+			}
+		}
+	}
+	if (pending != 0) {
+		error = patch.string() + " is truncated";
+		return false;
+	}
+	if (!out.flush()) {
+		error = "Cannot write " + output.string();
+		return false;
+	}
+	sha256 = hasher.hexDigest();
+	return true;
+}
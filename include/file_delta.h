@@ -0,0 +1,28 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef FILE_DELTA_H
+#define FILE_DELTA_H
+
+#include <filesystem>
+#include <string>
+
+/**
+ * Binary patches between two versions of a file: the new file compressed with zstd, using the
+ * old one as its dictionary (what `zstd --patch-from` does), so the patch holds only what
+ * changed. Either side of a patch is read into memory whole.
+ *
+ * A patch is a plain zstd frame; `zstd -d --patch-from=<old> <patch>` applies it too.
+ */
+namespace file_delta {
+	// level as for zstd (1-22); higher makes smaller patches, slower.
+	bool create_patch(const std::filesystem::path &oldFile, const std::filesystem::path &newFile,
+	                  const std::filesystem::path &patch, std::string &error, int level = 19);
+
+	// Writes the new file to output, and its SHA-256 (hex) to sha256, hashed as it is written.
+	bool apply_patch(const std::filesystem::path &oldFile, const std::filesystem::path &patch,
+	                 const std::filesystem::path &output, std::string &sha256, std::string &error);
+}
+
+#endif //FILE_DELTA_H
@@ -0,0 +1,341 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "logger.h"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <system_error>
+
+namespace {
+	// Wall clock in system_clock ticks, for the call site. Linux's coarse clock ticks every few
+	// milliseconds, which is plenty for a log, and costs a fraction of the precise one.
+	std::int64_t logTime() {
+#ifdef CLOCK_REALTIME_COARSE
+		timespec now{};
+		clock_gettime(CLOCK_REALTIME_COARSE, &now);
+		return std::chrono::duration_cast<std::chrono::system_clock::duration>(
+			std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec)).count();
+#else
+		return std::chrono::system_clock::now().time_since_epoch().count();
+#endif
+	}
+
+	std::tm localTime(const std::time_t time) {
+		std::tm local{};
+#ifdef _WIN32
+		localtime_s(&local, &time);
+#else
+		localtime_r(&time, &local);
+#endif
+		return local;
+	}
+
+	bool parseLevel(std::string name, LogLevel &level) {
+		std::ranges::transform(name, name.begin(), [](const unsigned char c) { return std::tolower(c); });
+		for (const LogLevel candidate : {LogLevel::Debug, LogLevel::Info, LogLevel::Warning, LogLevel::Error}) {
+			if (name == Logger::levelName(candidate)) {
+				level = candidate;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// <stem>.<index><ext> next to path, or path itself for 0.
+	std::filesystem::path rotatedPath(const std::filesystem::path &path, const int index) {
+		if (index == 0) {
+			return path;
+		}
+		std::filesystem::path rotated = path;
+		rotated.replace_filename(path.stem().string() + "." + std::to_string(index) + path.extension().string());
+		return rotated;
+	}
+}
+
+Logger::Logger(LoggerOptions options) : m_options(std::move(options)), m_level(m_options.level) {
+	const std::size_t slots = std::bit_ceil(std::max<std::size_t>(m_options.slots, 2));
+	m_slots = std::make_unique<Slot[]>(slots);
+	for (std::size_t i = 0; i < slots; ++i) {
+		m_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	m_mask = slots - 1;
+
+	m_thread = std::thread(&Logger::run, this);
+}
+
+Logger::~Logger() {
+	{
+		std::lock_guard lock(m_mutex);
+		m_stopping = true;
+	}
+	m_wake.notify_one();
+	m_thread.join();
+}
+
+Logger &Logger::singleton() {
+	static Logger *const logger = [] {
+		LoggerOptions options;
+		std::error_code error;
+		options.path = std::filesystem::temp_directory_path(error) / "Buraq" / ".data" / "log.txt";
+		if (const char *level = std::getenv("BURAQ_LOG_LEVEL"); level != nullptr && !parseLevel(level, options.level)) {
+			std::cerr << "BURAQ_LOG_LEVEL should be debug, info, warning or error, not " << level << std::endl;
+		}
+
+		auto *created = new Logger(std::move(options));
+		std::atexit([] { singleton().flush(); });
+		return created;
+	}();
+	return *logger;
+}
+
+void Logger::setLevel(const LogLevel level) {
+	m_level.store(level, std::memory_order_relaxed);
+}
+
+const char *Logger::levelName(const LogLevel level) {
+	switch (level) {
+		case LogLevel::Debug:
+			return "debug";
+		case LogLevel::Info:
+			return "info";
+		case LogLevel::Warning:
+			return "warning";
+		case LogLevel::Error:
+			return "error";
+	}
+	return "?";
+}
+
+void Logger::log(const LogLevel level, std::string_view message) {
+	if (!enabled(level)) {
+		return;
+	}
+	const std::int64_t time = logTime();
+
+	// Half the ring at most, so one message can never wait for itself.
+	const std::uint64_t capacity = m_mask + 1;
+	const std::uint64_t maxSlots = std::min<std::uint64_t>(capacity / 2, UINT16_MAX);
+	const std::size_t maxLength = FIRST_TEXT_BYTES + (maxSlots - 1) * sizeof(Slot::bytes);
+	message = message.substr(0, maxLength);
+	const std::size_t rest = message.size() > FIRST_TEXT_BYTES ? message.size() - FIRST_TEXT_BYTES : 0;
+	const std::uint64_t count = 1 + (rest + sizeof(Slot::bytes) - 1) / sizeof(Slot::bytes);
+
+	// Claims count consecutive slots. The writer frees slots in order, so if the last one is free
+	// for this lap, so are the ones before it.
+	std::uint64_t position = m_head.load(std::memory_order_relaxed);
+	for (;;) {
+		const std::uint64_t last = position + count - 1;
+		const std::uint64_t sequence = m_slots[last & m_mask].sequence.load(std::memory_order_acquire);
+		const auto lag = static_cast<std::int64_t>(sequence - last);
+		if (lag == 0) {
+			if (m_head.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (lag < 0) {
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		} else {
+			position = m_head.load(std::memory_order_relaxed);
+		}
+	}
+
+	const Header header{
+		time,
+		static_cast<std::uint32_t>(message.size()),
+		static_cast<std::uint16_t>(count),
+		level,
+	};
+	Slot &first = m_slots[position & m_mask];
+	std::memcpy(first.bytes, &header, sizeof(header));
+	std::size_t copied = std::min(message.size(), FIRST_TEXT_BYTES);
+	std::memcpy(first.bytes + sizeof(header), message.data(), copied);
+	for (std::uint64_t i = 1; i < count; ++i) {
+		const std::size_t bytes = std::min(message.size() - copied, sizeof(Slot::bytes));
+		std::memcpy(m_slots[(position + i) & m_mask].bytes, message.data() + copied, bytes);
+		copied += bytes;
+	}
+	for (std::uint64_t i = 0; i < count; ++i) {
+		m_slots[(position + i) & m_mask].sequence.store(position + i + 1, std::memory_order_release);
+	}
+
+	// Past half full the writer should not wait for its interval. One caller wakes it.
+	if (position + count - m_tail.load(std::memory_order_relaxed) > capacity / 2 &&
+		!m_wakeRequested.load(std::memory_order_relaxed) &&
+		!m_wakeRequested.exchange(true, std::memory_order_relaxed)) {
+		m_wake.notify_one();
+	}
+}
+
+void Logger::flush() {
+	std::unique_lock lock(m_mutex);
+	const std::uint64_t target = m_head.load(std::memory_order_acquire);
+	if (m_writtenTo >= target) {
+		return;
+	}
+	m_flushTarget = std::max(m_flushTarget, target);
+	m_wake.notify_one();
+	m_written.wait_for(lock, std::chrono::seconds(1), [&] { return m_writtenTo >= target; });
+}
+
+void Logger::run() {
+	std::unique_lock lock(m_mutex);
+	for (;;) {
+		m_wake.wait_for(lock, m_options.flushInterval, [this] {
+			return m_stopping || m_flushTarget > m_writtenTo || m_wakeRequested.load(std::memory_order_relaxed);
+		});
+		const bool stopping = m_stopping;
+		lock.unlock();
+
+		m_wakeRequested.store(false, std::memory_order_relaxed);
+		drain();
+		const std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+
+		lock.lock();
+		m_writtenTo = tail;
+		m_written.notify_all();
+		if (stopping && tail == m_head.load(std::memory_order_acquire)) {
+			return;
+		}
+		if (stopping || m_flushTarget > tail) {
+			// A caller is still copying its message into slots that were waited for.
+			lock.unlock();
+			std::this_thread::yield();
+			lock.lock();
+		}
+	}
+}
+
+void Logger::drain() {
+	const std::uint64_t capacity = m_mask + 1;
+	std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+	bool wrote = false;
+
+	if (!m_file.is_open()) {
+		openFile();
+	}
+
+	for (;;) {
+		Slot &first = m_slots[tail & m_mask];
+		if (first.sequence.load(std::memory_order_acquire) != tail + 1) {
+			break;
+		}
+		Header header{};
+		std::memcpy(&header, first.bytes, sizeof(header));
+
+		bool complete = true;
+		for (std::uint64_t i = 1; i < header.slots && complete; ++i) {
+			complete = m_slots[(tail + i) & m_mask].sequence.load(std::memory_order_acquire) == tail + i + 1;
+		}
+		if (!complete) {
+			break;
+		}
+
+		m_text.assign(first.bytes + sizeof(header), std::min<std::size_t>(header.length, FIRST_TEXT_BYTES));
+		for (std::uint64_t i = 1; i < header.slots; ++i) {
+			const std::size_t bytes = std::min(header.length - m_text.size(), sizeof(Slot::bytes));
+			m_text.append(m_slots[(tail + i) & m_mask].bytes, bytes);
+		}
+		for (std::uint64_t i = 0; i < header.slots; ++i) {
+			m_slots[(tail + i) & m_mask].sequence.store(tail + i + capacity, std::memory_order_release);
+		}
+		tail += header.slots;
+
+		writeLine(header, m_text);
+		wrote = true;
+	}
+
+	// Once per drain: callers read it, and a store per message would keep taking the line away.
+	m_tail.store(tail, std::memory_order_relaxed);
+
+	if (const std::uint64_t dropped = m_dropped.load(std::memory_order_relaxed); dropped != m_reportedDropped) {
+		const Header header{logTime(), 0, 1, LogLevel::Warning};
+		writeLine(header, std::to_string(dropped - m_reportedDropped) + " messages dropped, the log ring was full.");
+		m_reportedDropped = dropped;
+		wrote = true;
+	}
+
+	if (wrote && m_file.is_open()) {
+		m_file.flush();
+		if (!m_file) {
+			// Disk full or the like: reopen on the next drain rather than stop logging.
+			m_file.close();
+			m_file.clear();
+		}
+	}
+}
+
+void Logger::writeLine(const Header &header, const std::string_view text) {
+	if (!m_file.is_open()) {
+		return;
+	}
+
+	// "YYYY-MM-DD HH:MM:SS.mmm [level] text"; the part up to the second changes once a second.
+	const auto ticks = std::chrono::system_clock::duration(header.time);
+	const std::int64_t milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(ticks).count();
+	const std::int64_t second = milliseconds >= 0 ? milliseconds / 1000 : (milliseconds - 999) / 1000;
+	if (second != m_cachedSecond) {
+		const std::tm local = localTime(static_cast<std::time_t>(second));
+		std::strftime(m_cachedTime, sizeof(m_cachedTime), "%Y-%m-%d %H:%M:%S", &local);
+		m_cachedSecond = second;
+	}
+	const auto millisecond = static_cast<int>(milliseconds - second * 1000);
+
+	m_line.assign(m_cachedTime);
+	m_line += '.';
+	m_line += static_cast<char>('0' + millisecond / 100);
+	m_line += static_cast<char>('0' + millisecond / 10 % 10);
+	m_line += static_cast<char>('0' + millisecond % 10);
+	m_line += " [";
+	m_line += levelName(header.level);
+	m_line += "] ";
+	m_line += text;
+	m_line += '\n';
+
+	if (m_options.maxBytes != 0 && m_fileBytes != 0 && m_fileBytes + m_line.size() > m_options.maxBytes) {
+		rotate();
+		if (!m_file.is_open()) {
+			return;
+		}
+	}
+	m_file.write(m_line.data(), static_cast<std::streamsize>(m_line.size()));
+	m_fileBytes += m_line.size();
+}
+
+bool Logger::openFile() {
+	std::error_code error;
+	std::filesystem::create_directories(m_options.path.parent_path(), error);
+	m_file.open(m_options.path, std::ios::binary | std::ios::app);
+	if (!m_file.is_open()) {
+		// Once; the next drain tries again.
+		if (!m_reportedOpenError) {
+			std::cerr << "Error: Could not open file " << m_options.path.string() << " for appending." << std::endl;
+			m_reportedOpenError = true;
+		}
+		m_file.clear();
+		return false;
+	}
+
+	const std::uintmax_t size = std::filesystem::file_size(m_options.path, error);
+	m_fileBytes = error ? 0 : size;
+	return true;
+}
+
+void Logger::rotate() {
+	m_file.close();
+
+	// log.2.txt -> log.3.txt, log.1.txt -> log.2.txt, log.txt -> log.1.txt; the oldest goes.
+	std::error_code error;
+	std::filesystem::remove(rotatedPath(m_options.path, std::max(m_options.keepFiles, 0)), error);
+	for (int index = m_options.keepFiles - 1; index >= 0; --index) {
+		std::filesystem::rename(rotatedPath(m_options.path, index), rotatedPath(m_options.path, index + 1), error);
+	}
+
+	openFile();
+}
@@ -0,0 +1,137 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+enum class LogLevel : std::uint8_t {
+	Debug,
+	Info,
+	Warning,
+	Error,
+};
+
+struct LoggerOptions {
+	std::filesystem::path path;
+	// Messages below it are skipped at the call site.
+	LogLevel level = LogLevel::Info;
+	// A write that takes the file past this renames it to <stem>.1<ext> first; 0 never rotates.
+	std::uint64_t maxBytes = 4 * 1024 * 1024;
+	// Rotated files kept, <stem>.1<ext> being the newest.
+	int keepFiles = 3;
+	// Ring size in 128-byte slots, rounded up to a power of two. A message takes a slot for every
+	// 120 bytes or so; when the ring is full, messages are dropped and counted instead of waiting.
+	std::size_t slots = 8192;
+	// How long written lines may sit in the ring when nothing else wakes the writer.
+	std::chrono::milliseconds flushInterval{50};
+};
+
+/**
+ * Log file written by its own thread. log() copies the message with its time into a lock-free
+ * ring that any number of threads push to, and returns; the writer thread formats and writes
+ * everything in the ring a few times a second, or as soon as it is half full, rotating the file
+ * when it grows past maxBytes. Lines keep the order in which log() claimed their slots.
+ */
+class Logger {
+public:
+	explicit Logger(LoggerOptions options);
+
+	// Writes what is still in the ring.
+	~Logger();
+
+	Logger(const Logger &) = delete;
+	Logger &operator=(const Logger &) = delete;
+
+	// The app's log, <temp>/Buraq/.data/log.txt. BURAQ_LOG_LEVEL (debug, info, warning, error)
+	// sets its level. Never destroyed, so it can log from static destructors; flushed at exit.
+	static Logger &singleton();
+
+	[[nodiscard]] bool enabled(LogLevel level) const {
+		return level >= m_level.load(std::memory_order_relaxed);
+	}
+	void setLevel(LogLevel level);
+
+	// Never blocks. Messages longer than half the ring are cut short.
+	void log(LogLevel level, std::string_view message);
+	// Blocks until everything logged before the call is in the file, for at most a second.
+	void flush();
+
+	// Messages lost to a full ring so far.
+	[[nodiscard]] std::uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+	static const char *levelName(LogLevel level);
+
+private:
+	static constexpr std::size_t SLOT_BYTES = 128;
+
+	struct alignas(SLOT_BYTES) Slot {
+		// Position this slot is free for; that + 1 once the producer has filled it.
+		std::atomic<std::uint64_t> sequence;
+		char bytes[SLOT_BYTES - sizeof(std::atomic<std::uint64_t>)];
+	};
+
+	// At the start of a message's first slot; its text follows, then fills the next slots.
+	struct Header {
+		std::int64_t time; // system_clock ticks
+		std::uint32_t length;
+		std::uint16_t slots;
+		LogLevel level;
+	};
+
+	static constexpr std::size_t FIRST_TEXT_BYTES = sizeof(Slot::bytes) - sizeof(Header);
+
+	void run();
+	// Writes the messages published so far, in order. Writer thread only.
+	void drain();
+	void writeLine(const Header &header, std::string_view text);
+	bool openFile();
+	void rotate();
+
+	LoggerOptions m_options;
+	std::atomic<LogLevel> m_level;
+	std::unique_ptr<Slot[]> m_slots;
+	std::uint64_t m_mask = 0;
+
+	// Producers' claims; apart from the writer's position so they do not share a cache line.
+	alignas(64) std::atomic<std::uint64_t> m_head = 0;
+	std::atomic<std::uint64_t> m_dropped = 0;
+	// Set by the producer that finds the ring half full, until the writer wakes.
+	std::atomic<bool> m_wakeRequested = false;
+	alignas(64) std::atomic<std::uint64_t> m_tail = 0;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_written;
+	// Under m_mutex: positions flush() waits for, and up to which lines are in the file.
+	std::uint64_t m_flushTarget = 0;
+	std::uint64_t m_writtenTo = 0;
+	bool m_stopping = false;
+	std::thread m_thread;
+
+	// Writer thread only.
+	std::ofstream m_file;
+	std::uint64_t m_fileBytes = 0;
+	std::string m_line;
+	std::string m_text;
+	bool m_reportedOpenError = false;
+	std::uint64_t m_reportedDropped = 0;
+	// Formatted "YYYY-MM-DD HH:MM:SS" of m_cachedSecond, so localtime runs once a second.
+	std::int64_t m_cachedSecond = -1;
+	char m_cachedTime[20] = {};
+};
+
+#endif // LOGGER_H
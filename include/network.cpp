@@ -3,104 +3,120 @@
 //
 
 #include <curl/curl.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <iostream>
+#include <string_view>
 #include "network.h"
 #include <fstream> // For std::ofstream
 
-Network::Network() {
-	// Initialize libcurl globally. Do this once at the start of your program.
-	if (const CURLcode global_init_res = curl_global_init(CURL_GLOBAL_DEFAULT); global_init_res != CURLE_OK) {
-		// This is a serious issue, often best to terminate or throw.
-		// Note: curl_global_init is not perfectly thread-safe if called concurrently
-		// by different parts of a very complex application before the singleton is first accessed.
-		// However, for typical singleton usage where it's initialized early, it's usually fine.
-		throw std::runtime_error(std::string("curl_global_init() failed: ") + curl_easy_strerror(global_init_res));
-	}
+namespace {
+	// Connections kept open per host, and in all, for later transfers to reuse.
+	constexpr long MAX_HOST_CONNECTIONS = 6;
+	constexpr long MAX_CONNECTIONS = 16;
+	// Easy handles kept for reuse; they hold the TLS session and DNS caches.
+	constexpr std::size_t MAX_IDLE_HANDLES = 8;
+}
 
-	curl = curl_easy_init(); // <--- Initialize the easy handle
-	if (!curl) {
-		// Handle error: libcurl easy handle could not be created
-		throw std::runtime_error("curl_easy_init() failed. CURL easy handle could not be created.");
-	}
+struct Network::Transfer {
+	TransferId id = 0;
+	HttpRequest request;
+	std::function<void(HttpResponse)> done;
+	HttpResponse response;
+	curl_slist *headers = nullptr;
+	char errorBuffer[CURL_ERROR_SIZE] = {};
+	// Why a callback of ours stopped the transfer, in place of curl's error.
+	const char *abortReason = nullptr;
 
-	// Set a user agent (good practice)
-	curl_easy_setopt(curl, CURLOPT_USERAGENT, "libcurl-c++-buraq/1.0");
+	~Transfer() { curl_slist_free_all(headers); }
+};
 
-	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-}
+static size_t write_callback(char *data, size_t size, size_t nmemb, void *userdata) {
+	auto *transfer = static_cast<Network::Transfer *>(userdata);
+	const size_t bytes = size * nmemb;
 
-Network::~Network() {
-	// Always cleanup the easy handle
-	curl_easy_cleanup(curl);
-	curl = nullptr;
+	// A server that ignores the range sends the whole file, which must not land at the offset.
+	if (!transfer->request.range.empty() && transfer->response.status != 206 &&
+		!transfer->request.url.starts_with("file:")) {
+		transfer->abortReason = "server did not answer the range request with 206";
+		return 0;
+	}
+	if (transfer->request.onData) {
+		// Anything but bytes makes curl abort with CURLE_WRITE_ERROR.
+		return transfer->request.onData(data, bytes) ? bytes : 0;
+	}
+	transfer->response.body.append(data, bytes);
+	return bytes;
 }
 
+// Keeps the status and validators of the final response; a redirect's headers are dropped.
+static size_t header_callback(char *buffer, size_t size, size_t nitems, void *userdata) {
+	auto *response = &static_cast<Network::Transfer *>(userdata)->response;
+	const std::string_view line(buffer, size * nitems);
+
+	if (line.starts_with("HTTP/")) {
+		response->etag.clear();
+		response->lastModified.clear();
+		// "HTTP/1.1 206 Partial Content"; curl's own value replaces this once the transfer ends.
+		if (const size_t space = line.find(' '); space != std::string_view::npos) {
+			response->status = std::strtol(std::string(line.substr(space + 1, 3)).c_str(), nullptr, 10);
+		}
+	}
+	else if (const size_t colon = line.find(':'); colon != std::string_view::npos) {
+		std::string name(line.substr(0, colon));
+		std::ranges::transform(name, name.begin(), [](const unsigned char c) { return std::tolower(c); });
 
-// Callback for std::ofstream
-size_t write_data_to_ofstream(void *ptr, size_t size, size_t nmemb, void *userdata) {
-	auto *out_stream = static_cast<std::ofstream *>(userdata);
-	const std::ios_base::iostate original_exceptions = out_stream->exceptions();
-	out_stream->exceptions(std::ios::failbit | std::ios::badbit); // Enable for this scope
+		std::string_view value = line.substr(colon + 1);
+		while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front()))) value.remove_prefix(1);
+		while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back()))) value.remove_suffix(1);
 
-	try {
-		out_stream->write(static_cast<const char*>(ptr), size * nmemb);
-		out_stream->exceptions(original_exceptions); // Restore original exception mask
-		return size * nmemb; // Success
-	} catch (const std::ios_base::failure& e) {
-		std::cerr << "Write Callback Exception: " << e.what() << std::endl;
-		// Some implementations might provide an error code
-		if (e.code()) { // C++11
-			std::cerr << "  Error Code: " << e.code().value() << " (" << e.code().message() << ")" << std::endl;
+		if (name == "etag") {
+			response->etag = value;
+		}
+		else if (name == "last-modified") {
+			response->lastModified = value;
 		}
-		// e.what() *might* contain text from strerror(errno) depending on the STL implementation.
-		out_stream->clear(); // Clear error flags on the stream
-		out_stream->exceptions(original_exceptions); // Restore original exception mask
-		return 0; // Signal error to libcurl
 	}
+	return size * nitems;
 }
 
-// libcurl write callback function
-size_t Network::write_callback(void *contents, size_t size, size_t nmemb, std::string *userp) {
-	userp->append((char *) contents, size * nmemb);
-	return size * nmemb;
+static int progress_callback(void *userdata, const curl_off_t dltotal, const curl_off_t dlnow, curl_off_t, curl_off_t) {
+	const auto *transfer = static_cast<Network::Transfer *>(userdata);
+	transfer->request.onProgress({.downloaded = dlnow, .total = dltotal});
+	return 0;
 }
 
-std::string Network::http_get(const std::string &url) const
-{
-	if (!curl) {
-		// This shouldn't happen if constructor succeeded, and it's not cleaned up elsewhere
-		return "Error: CURL handle not initialized.";
+Network::Network() {
+	// Initialize libcurl globally. Do this once at the start of your program.
+	if (const CURLcode global_init_res = curl_global_init(CURL_GLOBAL_DEFAULT); global_init_res != CURLE_OK) {
+		// This is a serious issue, often best to terminate or throw.
+		throw std::runtime_error(std::string("curl_global_init() failed: ") + curl_easy_strerror(global_init_res));
 	}
 
-	std::string readBuffer;
-
-	// Set URL
-	curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-	// Set the write callback function
-	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-	// Pass the readBuffer string to the callback
-	curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
+	m_multi = curl_multi_init();
+	if (!m_multi) {
+		throw std::runtime_error("curl_multi_init() failed.");
+	}
+	curl_multi_setopt(m_multi, CURLMOPT_MAX_HOST_CONNECTIONS, MAX_HOST_CONNECTIONS);
+	curl_multi_setopt(m_multi, CURLMOPT_MAXCONNECTS, MAX_CONNECTIONS);
 
-	// You might want to reset other options if the handle is reused extensively
-	curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L); // Ensure it's a GET
+	m_thread = std::thread(&Network::run, this);
+}
 
-	if (const CURLcode res = curl_easy_perform(curl); res != CURLE_OK) {
-		std::cerr << "curl_easy_perform() failed for URL " << url << ": "
-				  << curl_easy_strerror(res) << std::endl;
-		throw std::runtime_error("Status not OK!");
+Network::~Network() {
+	{
+		std::lock_guard lock(m_mutex);
+		m_stopping = true;
 	}
+	curl_multi_wakeup(m_multi);
+	m_thread.join();
 
-	long http_code = 0;
-	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-	if (http_code != 200) {
-		std::cerr << "HTTP GET request to " << url << " returned HTTP code " << http_code << std::endl;
-		std::cerr << "Response body: " << readBuffer << std::endl; // Log server error message
-		// Handle non-200 responses appropriately
+	for (CURL *easy : m_idleHandles) {
+		curl_easy_cleanup(easy);
 	}
-	// For a reusable handle, consider what to do if a request fails.
-	// Sometimes, specific errors might require re-initializing the handle.
-
-	return readBuffer;
+	curl_multi_cleanup(m_multi);
+	curl_global_cleanup();
 }
 
 // network.cpp
@@ -109,67 +125,245 @@ Network &Network::singleton() {
 	return instance;
 }
 
-int Network::downloadFile(const std::string &url, const char *filename) const
-{
-	if (!curl) {
-		// ... cleanup curl ...
-		curl_global_cleanup();
-		return 1;
+Network::TransferId Network::start(HttpRequest request, std::function<void(HttpResponse)> done) {
+	auto transfer = std::make_unique<Transfer>();
+	transfer->id = m_nextId.fetch_add(1, std::memory_order_relaxed);
+	transfer->request = std::move(request);
+	transfer->done = std::move(done);
+
+	const TransferId id = transfer->id;
+	{
+		std::lock_guard lock(m_mutex);
+		m_starting.push_back(std::move(transfer));
+	}
+	curl_multi_wakeup(m_multi);
+	return id;
+}
+
+std::future<HttpResponse> Network::fetch(HttpRequest request) {
+	auto promise = std::make_shared<std::promise<HttpResponse>>();
+	std::future<HttpResponse> future = promise->get_future();
+	start(std::move(request), [promise](HttpResponse response) { promise->set_value(std::move(response)); });
+	return future;
+}
+
+void Network::cancel(const TransferId id) {
+	{
+		std::lock_guard lock(m_mutex);
+		m_cancelling.push_back(id);
 	}
+	curl_multi_wakeup(m_multi);
+}
+
+HttpResponse Network::get(const std::string &url, const std::vector<std::string> &headers) {
+	HttpResponse response = fetch({.url = url, .headers = headers}).get();
+	if (!response.ok()) {
+		throw std::runtime_error("GET " + url + " failed: " + response.error);
+	}
+	return response;
+}
 
+int Network::downloadFile(const std::string &url, const char *filename) {
 	std::ofstream output_file_stream(filename, std::ios::binary);
 	if (!output_file_stream.is_open()) {
 		std::cerr << "Error: Cannot open file for writing: " << filename << std::endl;
-		// ... cleanup curl ...
-		curl_global_cleanup();
 		return 1;
 	}
 
-	// --- 4. Set libcurl options ---
-	// Set the URL
-	curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+	HttpRequest request{.url = url};
+	request.onData = [&output_file_stream](const char *data, const std::size_t size) {
+		return static_cast<bool>(output_file_stream.write(data, static_cast<std::streamsize>(size)));
+	};
+	const HttpResponse response = fetch(std::move(request)).get();
+	output_file_stream.close();
 
-	// Set the callback function for writing data
-	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data_to_ofstream);
+	if (!response.ok()) {
+		std::cerr << "Download of " << url << " failed: " << response.error << std::endl;
+		return 1;
+	}
+	if (response.status >= 400) {
+		std::cerr << "Download of " << url << " returned HTTP code " << response.status << std::endl;
+		return 1;
+	}
+	std::cout << "Download successful!" << std::endl;
+	return 0;
+}
+
+void Network::run() {
+	while (true) {
+		std::vector<std::unique_ptr<Transfer>> starting;
+		std::vector<TransferId> cancelling;
+		bool stopping;
+		{
+			std::lock_guard lock(m_mutex);
+			starting.swap(m_starting);
+			cancelling.swap(m_cancelling);
+			stopping = m_stopping;
+		}
+
+		// Started first, so a transfer cancelled right after start() is found below.
+		for (auto &transfer : starting) {
+			if (stopping) {
+				finish(std::move(transfer), "cancelled");
+			} else {
+				attach(std::move(transfer));
+			}
+		}
+		for (const TransferId id : cancelling) {
+			const auto it = std::ranges::find_if(m_active, [id](const auto &entry) { return entry.second->id == id; });
+			if (it != m_active.end()) {
+				CURL *easy = it->first;
+				std::unique_ptr<Transfer> transfer = std::move(it->second);
+				m_active.erase(it);
+				release(easy);
+				finish(std::move(transfer), "cancelled");
+			}
+		}
 
-	// Set the userdata pointer for the callback (our output file)
-	curl_easy_setopt(curl, CURLOPT_WRITEDATA, &output_file_stream);
+		if (stopping) {
+			for (auto &[easy, transfer] : m_active) {
+				curl_multi_remove_handle(m_multi, easy);
+				curl_easy_cleanup(easy);
+				finish(std::move(transfer), "cancelled");
+			}
+			m_active.clear();
+			return;
+		}
 
-	// Follow HTTP redirects (e.g., 301, 302)
-	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+		int running = 0;
+		curl_multi_perform(m_multi, &running);
 
-	// Fail verbosely if the HTTP code is >= 400
-	curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+		int queued = 0;
+		while (const CURLMsg *message = curl_multi_info_read(m_multi, &queued)) {
+			if (message->msg == CURLMSG_DONE) {
+				finish(message->easy_handle, message->data.result);
+			}
+		}
 
-	// --- 5. Perform the file transfer ---
-	const CURLcode res = curl_easy_perform(curl);
+		// Until a socket is ready, a timeout of curl's is due, or curl_multi_wakeup().
+		int timeout = 1000;
+		if (long curlTimeout = -1; curl_multi_timeout(m_multi, &curlTimeout) == CURLM_OK && curlTimeout >= 0) {
+			timeout = static_cast<int>(std::min<long>(curlTimeout, timeout));
+		}
+		curl_multi_poll(m_multi, nullptr, 0, timeout, nullptr);
+	}
+}
 
-	// --- 6. Check for errors ---
-	if (res != CURLE_OK) {
-		std::cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << std::endl;
-		// If FAILONERROR is set, this will also trigger for HTTP 4xx/5xx errors.
+void Network::attach(std::unique_ptr<Transfer> transfer) {
+	CURL *easy;
+	if (!m_idleHandles.empty()) {
+		easy = m_idleHandles.back();
+		m_idleHandles.pop_back();
 	} else {
-		long http_code = 0;
-		curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-		if (http_code == 200) {
-			std::cout << "Download successful!" << std::endl;
-		} else {
-			// This case might not be hit if FAILONERROR is effective,
-			// but good for completeness or if FAILONERROR is off.
-			std::cout << "Download completed with HTTP status code: " << http_code << std::endl;
+		easy = curl_easy_init();
+		if (!easy) {
+			finish(std::move(transfer), "curl_easy_init() failed.");
+			return;
 		}
 	}
 
-	// --- 7. Cleanup ---
-	// Close the output file
-	 output_file_stream.close(); // Close after download or on error
+	for (const std::string &header : transfer->request.headers) {
+		transfer->headers = curl_slist_append(transfer->headers, header.c_str());
+	}
+
+	Transfer *t = transfer.get();
+	curl_easy_setopt(easy, CURLOPT_URL, t->request.url.c_str());
+	curl_easy_setopt(easy, CURLOPT_HTTPGET, 1L);
+	curl_easy_setopt(easy, CURLOPT_HTTPHEADER, t->headers);
+	if (!t->request.range.empty()) {
+		curl_easy_setopt(easy, CURLOPT_RANGE, t->request.range.c_str());
+	}
+	// Set a user agent (good practice)
+	curl_easy_setopt(easy, CURLOPT_USERAGENT, "libcurl-c++-buraq/1.0");
+	curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+	curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+	curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+	curl_easy_setopt(easy, CURLOPT_CONNECTTIMEOUT_MS, t->request.connectTimeoutMs);
+	if (t->request.stallTimeoutSeconds > 0) {
+		curl_easy_setopt(easy, CURLOPT_LOW_SPEED_LIMIT, 1L);
+		curl_easy_setopt(easy, CURLOPT_LOW_SPEED_TIME, t->request.stallTimeoutSeconds);
+	}
+	curl_easy_setopt(easy, CURLOPT_ERRORBUFFER, t->errorBuffer);
+	curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, write_callback);
+	curl_easy_setopt(easy, CURLOPT_WRITEDATA, t);
+	curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, header_callback);
+	curl_easy_setopt(easy, CURLOPT_HEADERDATA, t);
+	if (t->request.onProgress) {
+		curl_easy_setopt(easy, CURLOPT_XFERINFOFUNCTION, progress_callback);
+		curl_easy_setopt(easy, CURLOPT_XFERINFODATA, t);
+		curl_easy_setopt(easy, CURLOPT_NOPROGRESS, 0L);
+	}
+
+	if (curl_multi_add_handle(m_multi, easy) != CURLM_OK) {
+		curl_easy_cleanup(easy);
+		finish(std::move(transfer), "curl_multi_add_handle() failed.");
+		return;
+	}
+	m_active.emplace(easy, std::move(transfer));
+}
+
+void Network::finish(CURL *easy, const CURLcode result) {
+	const auto node = m_active.extract(easy);
+	if (node.empty()) {
+		return;
+	}
+	std::unique_ptr<Transfer> transfer = std::move(node.mapped());
+	HttpResponse &response = transfer->response;
+
+	curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &response.status);
+	if (result == CURLE_OK && response.status == 0 && transfer->request.url.starts_with("file:")) {
+		response.status = transfer->request.range.empty() ? 200 : 206;
+	}
 
-	// Clean up the curl easy handle
-	curl_easy_cleanup(curl);
+	curl_off_t total = 0, connect = 0, firstByte = 0, bytes = 0, speed = 0;
+	long connects = 0;
+	curl_easy_getinfo(easy, CURLINFO_TOTAL_TIME_T, &total);
+	curl_easy_getinfo(easy, CURLINFO_CONNECT_TIME_T, &connect);
+	curl_easy_getinfo(easy, CURLINFO_STARTTRANSFER_TIME_T, &firstByte);
+	curl_easy_getinfo(easy, CURLINFO_SIZE_DOWNLOAD_T, &bytes);
+	curl_easy_getinfo(easy, CURLINFO_SPEED_DOWNLOAD_T, &speed);
+	curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &connects);
+	response.stats = {
+		.totalSeconds = static_cast<double>(total) / 1e6,
+		.connectSeconds = connects == 0 ? 0 : static_cast<double>(connect) / 1e6,
+		.firstByteSeconds = static_cast<double>(firstByte) / 1e6,
+		.bytes = bytes,
+		.bytesPerSecond = static_cast<double>(speed),
+		.reusedConnection = connects == 0 && result == CURLE_OK,
+	};
 
-	// Clean up the global libcurl environment
-	// This should be called once when the program is done with libcurl.
-	curl_global_cleanup();
+	release(easy);
+
+	const char *error = nullptr;
+	if (result != CURLE_OK && transfer->abortReason != nullptr) {
+		error = transfer->abortReason;
+	} else if (result != CURLE_OK) {
+		error = transfer->errorBuffer[0] != '\0' ? transfer->errorBuffer : curl_easy_strerror(result);
+	}
+	finish(std::move(transfer), error);
+}
+
+void Network::release(CURL *easy) {
+	curl_multi_remove_handle(m_multi, easy);
+	if (m_idleHandles.size() < MAX_IDLE_HANDLES) {
+		curl_easy_reset(easy);
+		m_idleHandles.push_back(easy);
+	} else {
+		curl_easy_cleanup(easy);
+	}
+}
+
+void Network::finish(std::unique_ptr<Transfer> transfer, const char *error) {
+	if (error != nullptr) {
+		transfer->response.error = error;
+	}
 
-	return (res == CURLE_OK) ? 0 : 1;
+	// A throwing callback must not take the network thread down with it.
+	try {
+		transfer->done(std::move(transfer->response));
+	} catch (const std::exception &e) {
+		std::cerr << "Network: callback for " << transfer->request.url << " threw: " << e.what() << std::endl;
+	} catch (...) {
+		std::cerr << "Network: callback for " << transfer->request.url << " threw." << std::endl;
+	}
 }
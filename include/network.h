@@ -6,22 +6,87 @@
 #define NETWORK_H
 
 #include <curl/curl.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
-class Network {
-public:
-	static Network &singleton(); // Return a reference
-	std::string http_get(const std::string &url) const;
+struct TransferProgress {
+	std::int64_t downloaded = 0;
+	// 0 until the size is known.
+	std::int64_t total = 0;
+};
+
+struct TransferStats {
+	double totalSeconds = 0;
+	// Until connected; 0 if an open connection was reused.
+	double connectSeconds = 0;
+	double firstByteSeconds = 0;
+	std::int64_t bytes = 0;
+	double bytesPerSecond = 0;
+	bool reusedConnection = false;
+};
+
+struct HttpRequest {
+	std::string url;
+	// "Name: value"
+	std::vector<std::string> headers;
+	// Bytes to ask for, "first-last" or "first-"; anything but a 206 answer fails the transfer.
+	std::string range;
+	// Takes the body as it arrives instead of HttpResponse::body; returning false aborts.
+	std::function<bool(const char *data, std::size_t size)> onData;
+	std::function<void(const TransferProgress &)> onProgress;
+	long connectTimeoutMs = 10000;
+	// Aborts when nothing arrives for this long; 0 waits forever.
+	long stallTimeoutSeconds = 30;
+};
 
-	static size_t write_callback(void *contents, size_t size, size_t nmemb, std::string *userp);
+struct HttpResponse {
+	// HTTP status; file:// URLs that could be read report 200, or 206 for a range.
+	long status = 0;
+	std::string body;
+	// Validators for a conditional request next time; empty if the server sent none.
+	std::string etag;
+	std::string lastModified;
+	// What went wrong with the transfer; empty on success. HTTP errors are only the status.
+	std::string error;
+	TransferStats stats;
 
-	int downloadFile(const std::string &url, const char *filename) const;
+	[[nodiscard]] bool ok() const { return error.empty(); }
+};
+
+/**
+ * HTTP client with every transfer on one curl multi handle, driven by its own thread.
+ * Transfers run concurrently, and connections are kept open for later transfers to the
+ * same host.
+ *
+ * onData, onProgress and done run on the network thread: keep them short, and never wait
+ * there for another transfer.
+ */
+class Network {
+public:
+	using TransferId = std::uint64_t;
+	// State of one transfer, for curl's callbacks; see network.cpp.
+	struct Transfer;
 
-	[[maybe_unused]] [[maybe_unused]] void http_post(const std::string &url);
+	static Network &singleton(); // Return a reference
 
-	[[maybe_unused]] [[maybe_unused]] void http_put(const std::string &url);
+	// done is called exactly once, also when the transfer fails or is cancelled.
+	TransferId start(HttpRequest request, std::function<void(HttpResponse)> done);
+	std::future<HttpResponse> fetch(HttpRequest request);
+	// Ends the transfer with error "cancelled", unless it has ended already.
+	void cancel(TransferId id);
 
-	[[maybe_unused]] [[maybe_unused]] void http_delete(const std::string &url);
+	// Blocking, for worker threads. get() throws on transport errors; HTTP errors come back
+	// as the status.
+	HttpResponse get(const std::string &url, const std::vector<std::string> &headers = {});
+	int downloadFile(const std::string &url, const char *filename);
 
 private:
 	Network();
@@ -31,7 +96,26 @@ private:
 	Network(const Network &) = delete; // No copy constructor
 	Network &operator=(const Network &) = delete; // No copy assignment
 
-	CURL *curl;
+	void run();
+	void attach(std::unique_ptr<Transfer> transfer);
+	// Takes easy off the multi handle and keeps it for the next transfer.
+	void release(CURL *easy);
+	void finish(CURL *easy, CURLcode result);
+	void finish(std::unique_ptr<Transfer> transfer, const char *error);
+
+	CURLM *m_multi = nullptr;
+	std::thread m_thread;
+	std::atomic<TransferId> m_nextId = 1;
+
+	// Handed from callers to the network thread.
+	std::mutex m_mutex;
+	std::vector<std::unique_ptr<Transfer>> m_starting;
+	std::vector<TransferId> m_cancelling;
+	bool m_stopping = false;
+
+	// Network thread only.
+	std::unordered_map<CURL *, std::unique_ptr<Transfer>> m_active;
+	std::vector<CURL *> m_idleHandles;
 };
 
 #endif //NETWORK_H
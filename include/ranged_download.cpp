@@ -0,0 +1,377 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "ranged_download.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace {
+	constexpr std::int64_t CHUNK_BYTES = 1 << 20;
+	// Read back from the file (the page cache, as it was just written) this much at a time.
+	constexpr std::int64_t HASH_BLOCK_BYTES = 1 << 20;
+	// Failures of one chunk in a row, with no byte arriving in between, before giving up.
+	constexpr int MAX_CHUNK_FAILURES = 5;
+	constexpr std::chrono::milliseconds RETRY_DELAY{250};
+	constexpr std::chrono::milliseconds PROGRESS_INTERVAL{200};
+	constexpr std::chrono::seconds PART_MAP_INTERVAL{1};
+	constexpr const char *PART_MAP_HEADER = "buraq-download 1";
+
+	std::string normalizedDigest(std::string sha) {
+		if (sha.starts_with("sha256:")) {
+			sha.erase(0, 7);
+		}
+		std::ranges::transform(sha, sha.begin(), [](const unsigned char c) { return std::tolower(c); });
+		return sha;
+	}
+
+	double secondsSince(const std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+RangedDownload::RangedDownload(DownloadRequest request) : m_request(std::move(request)) {
+	m_request.sha256 = normalizedDigest(m_request.sha256);
+	m_request.connections = std::max(1, m_request.connections);
+	m_partMapPath = m_request.path;
+	m_partMapPath += ".parts";
+}
+
+DownloadResult RangedDownload::run(const std::stop_token stop) {
+	using std::chrono::steady_clock;
+	const steady_clock::time_point started = steady_clock::now();
+
+	DownloadResult result;
+	if (!prepare(result)) {
+		return result;
+	}
+
+	steady_clock::time_point lastProgress;
+	steady_clock::time_point lastSave = started;
+	steady_clock::time_point allArrived;
+	std::vector<char> block(HASH_BLOCK_BYTES);
+
+	std::unique_lock lock(m_mutex);
+	while (true) {
+		const steady_clock::time_point now = steady_clock::now();
+
+		for (Chunk &chunk : m_chunks) {
+			if (!chunk.ended) {
+				continue;
+			}
+			chunk.ended = false;
+
+			const HttpResponse &response = chunk.response;
+			if (response.ok() && chunk.end < 0 && response.status == 200) {
+				chunk.end = chunk.begin + chunk.written; // size was unknown until now
+			}
+			if (chunk.complete()) {
+				continue;
+			}
+
+			std::string error = response.ok() ? "HTTP " + std::to_string(response.status) : response.error;
+			if (!response.ok() && response.status == 200 && m_chunks.size() > 1) {
+				// Sent the whole file for a range: start over as one stream.
+				abort(lock);
+				m_chunks = {{.begin = 0, .end = m_request.size}};
+				m_hasher = Sha256();
+				m_hashed = 0;
+				break;
+			}
+			if (response.ok() && response.status >= 400 && response.status < 500) {
+				result.error = m_request.url + ": " + error; // retrying will not change the answer
+			} else if (chunk.end < 0) {
+				result.error = m_request.url + ": " + error; // without a size there is no range to resume
+			} else if (++chunk.failures > MAX_CHUNK_FAILURES) {
+				result.error = m_request.url + ": " + error + " (gave up after " +
+					std::to_string(MAX_CHUNK_FAILURES) + " retries)";
+			} else {
+				chunk.retryAt = now + RETRY_DELAY * chunk.failures;
+				result.retries++;
+			}
+		}
+		if (result.error.empty() && stop.stop_requested()) {
+			result.error = "cancelled";
+		}
+		if (!result.error.empty()) {
+			abort(lock);
+			m_output.close();
+			m_input.close();
+			for (const Chunk &chunk : m_chunks) {
+				result.downloadedBytes += chunk.written;
+			}
+			result.downloadedBytes -= result.resumedBytes;
+			lock.unlock();
+			savePartMap();
+			result.seconds = secondsSince(started);
+			return result;
+		}
+
+		// In order, so the hashed prefix follows the download closely.
+		steady_clock::time_point nextRetry = steady_clock::time_point::max();
+		for (std::size_t i = 0; i < m_chunks.size() && m_running < m_request.connections; ++i) {
+			const Chunk &chunk = m_chunks[i];
+			if (chunk.running || chunk.complete()) {
+				continue;
+			}
+			if (chunk.retryAt > now) {
+				nextRetry = std::min(nextRetry, chunk.retryAt);
+				continue;
+			}
+			startChunk(i);
+		}
+
+		const bool arrived = std::ranges::all_of(m_chunks, [](const Chunk &chunk) { return chunk.complete(); });
+		if (arrived && allArrived == steady_clock::time_point{}) {
+			allArrived = now;
+		}
+		const std::int64_t end = frontier();
+		// The last bytes can come before the transfer's done callback, which holds this object.
+		if (arrived && m_hashed == end && m_running == 0) {
+			break;
+		}
+
+		if (m_hashed == end) {
+			const auto deadline = std::min(nextRetry, now + PART_MAP_INTERVAL);
+			m_changed.wait_until(lock, stop, deadline, [this] {
+				return frontier() > m_hashed ||
+					std::ranges::any_of(m_chunks, [](const Chunk &chunk) { return chunk.ended; });
+			});
+		}
+
+		std::int64_t downloaded = 0;
+		for (const Chunk &chunk : m_chunks) {
+			downloaded += chunk.written;
+		}
+		const std::int64_t hashTo = frontier();
+		lock.unlock();
+
+		while (m_hashed < hashTo) {
+			const std::int64_t size = std::min(hashTo - m_hashed, HASH_BLOCK_BYTES);
+			if (!m_input.seekg(m_hashed) || !m_input.read(block.data(), size)) {
+				lock.lock();
+				result.error = "Cannot read back " + m_request.path.string();
+				break;
+			}
+			m_hasher.update(block.data(), static_cast<std::size_t>(size));
+			m_hashed += size;
+		}
+		if (!result.error.empty()) {
+			continue;
+		}
+
+		const steady_clock::time_point after = steady_clock::now();
+		if (m_request.onProgress && after - lastProgress >= PROGRESS_INTERVAL) {
+			m_request.onProgress({.downloaded = downloaded, .total = m_request.size});
+			lastProgress = after;
+		}
+		if (after - lastSave >= PART_MAP_INTERVAL) {
+			savePartMap();
+			lastSave = after;
+		}
+		lock.lock();
+	}
+	lock.unlock();
+
+	m_output.close();
+	m_input.close();
+	const std::string digest = m_hasher.hexDigest();
+	result.verifySeconds = secondsSince(allArrived);
+	result.seconds = secondsSince(started);
+	result.downloadedBytes = m_hashed - result.resumedBytes;
+	if (m_request.onProgress) {
+		m_request.onProgress({.downloaded = m_hashed, .total = m_hashed});
+	}
+
+	std::error_code error;
+	std::filesystem::remove(m_partMapPath, error);
+	if (!m_request.sha256.empty() && digest != m_request.sha256) {
+		std::filesystem::remove(m_request.path, error);
+		result.error = "Checksum mismatch for " + m_request.url + ": expected " + m_request.sha256 + ", got " + digest;
+	}
+	return result;
+}
+
+bool RangedDownload::prepare(DownloadResult &result) {
+	std::error_code error;
+	std::filesystem::create_directories(m_request.path.parent_path(), error);
+
+	// Unbuffered, so a byte counted as written is in the file, and a read sees it.
+	m_output.rdbuf()->pubsetbuf(nullptr, 0);
+	m_input.rdbuf()->pubsetbuf(nullptr, 0);
+
+	if (m_request.size > 0 && loadPartMap() && std::filesystem::file_size(m_request.path, error) ==
+		static_cast<std::uintmax_t>(m_request.size)) {
+		for (const Chunk &chunk : m_chunks) {
+			result.resumedBytes += chunk.written;
+		}
+	} else {
+		m_chunks.clear();
+		if (m_request.size > 0) {
+			for (std::int64_t begin = 0; begin < m_request.size; begin += CHUNK_BYTES) {
+				m_chunks.push_back({.begin = begin, .end = std::min(begin + CHUNK_BYTES, m_request.size)});
+			}
+		} else {
+			m_chunks.push_back({.begin = 0, .end = -1});
+		}
+		m_hasher = Sha256();
+		m_hashed = 0;
+
+		std::filesystem::remove(m_partMapPath, error);
+		std::ofstream(m_request.path, std::ios::binary | std::ios::trunc);
+		if (m_request.size > 0) {
+			std::filesystem::resize_file(m_request.path, m_request.size, error);
+			if (error) {
+				result.error = "Cannot allocate " + m_request.path.string() + ": " + error.message();
+				return false;
+			}
+		}
+	}
+
+	m_output.open(m_request.path, std::ios::binary | std::ios::in | std::ios::out);
+	m_input.open(m_request.path, std::ios::binary);
+	if (!m_output.is_open() || !m_input.is_open()) {
+		result.error = "Cannot open " + m_request.path.string();
+		return false;
+	}
+	return true;
+}
+
+// Line based:
+//   buraq-download 1
+//   url <url>
+//   size <bytes> sha256 <hex or ->
+//   hashed <bytes> <Sha256 state>
+//   chunk <begin> <end> <written>    (one per chunk, in order)
+bool RangedDownload::loadPartMap() {
+	std::ifstream file(m_partMapPath);
+	std::string line, word, url, sha, state;
+	std::int64_t size = 0, hashed = 0;
+
+	if (!std::getline(file, line) || line != PART_MAP_HEADER) {
+		return false;
+	}
+	if (!(file >> word >> url) || word != "url" || url != m_request.url) {
+		return false;
+	}
+	if (!(file >> word >> size >> word >> sha) || size != m_request.size ||
+		sha != (m_request.sha256.empty() ? "-" : m_request.sha256)) {
+		return false;
+	}
+	if (!(file >> word >> hashed >> state) || word != "hashed" || !m_hasher.restoreState(state) ||
+		m_hasher.bytesHashed() != static_cast<std::uint64_t>(hashed)) {
+		return false;
+	}
+
+	std::vector<Chunk> chunks;
+	Chunk chunk;
+	while (file >> word >> chunk.begin >> chunk.end >> chunk.written) {
+		const std::int64_t expectedBegin = chunks.empty() ? 0 : chunks.back().end;
+		if (word != "chunk" || chunk.begin != expectedBegin || chunk.end <= chunk.begin || chunk.written < 0 ||
+			chunk.begin + chunk.written > chunk.end) {
+			return false;
+		}
+		chunks.push_back(chunk);
+	}
+	if (chunks.empty() || chunks.back().end != m_request.size) {
+		return false;
+	}
+
+	m_chunks = std::move(chunks);
+	m_hashed = hashed;
+	return m_hashed <= frontier();
+}
+
+void RangedDownload::savePartMap() {
+	if (m_request.size <= 0) {
+		return; // cannot resume without knowing the size
+	}
+
+	std::ostringstream map;
+	map << PART_MAP_HEADER << '\n'
+		<< "url " << m_request.url << '\n'
+		<< "size " << m_request.size << " sha256 " << (m_request.sha256.empty() ? "-" : m_request.sha256) << '\n'
+		<< "hashed " << m_hashed << ' ' << m_hasher.saveState() << '\n';
+	{
+		std::lock_guard lock(m_mutex);
+		for (const Chunk &chunk : m_chunks) {
+			map << "chunk " << chunk.begin << ' ' << chunk.end << ' ' << chunk.written << '\n';
+		}
+	}
+
+	// Replaced in one step, so a crash leaves the previous map rather than half of this one.
+	std::filesystem::path temporary = m_partMapPath;
+	temporary += ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::trunc);
+		file << map.str();
+		if (!file.flush()) {
+			return;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(temporary, m_partMapPath, error);
+}
+
+void RangedDownload::startChunk(const std::size_t index) {
+	Chunk &chunk = m_chunks[index];
+	chunk.running = true;
+	m_running++;
+
+	HttpRequest request{.url = m_request.url};
+	if (chunk.end >= 0 && (chunk.begin + chunk.written > 0 || chunk.end < m_request.size)) {
+		request.range = std::to_string(chunk.begin + chunk.written) + "-" + std::to_string(chunk.end - 1);
+	}
+	request.onData = [this, index](const char *data, const std::size_t size) {
+		Chunk &c = m_chunks[index];
+		// Only this thread changes written, so reading it unlocked is safe.
+		const std::int64_t offset = c.begin + c.written;
+		if (c.end >= 0 && offset + static_cast<std::int64_t>(size) > c.end) {
+			return false; // more than was asked for
+		}
+		if (!m_output.seekp(offset) || !m_output.write(data, static_cast<std::streamsize>(size))) {
+			return false;
+		}
+
+		std::lock_guard lock(m_mutex);
+		c.written += static_cast<std::int64_t>(size);
+		if (c.failures > 0) {
+			c.failures = 0; // it is getting somewhere
+		}
+		m_changed.notify_one();
+		return true;
+	};
+
+	chunk.transfer = Network::singleton().start(std::move(request), [this, index](HttpResponse response) {
+		std::lock_guard lock(m_mutex);
+		Chunk &c = m_chunks[index];
+		c.running = false;
+		c.ended = true;
+		c.response = std::move(response);
+		m_running--;
+		m_changed.notify_one();
+	});
+}
+
+std::int64_t RangedDownload::frontier() const {
+	std::int64_t end = 0;
+	for (const Chunk &chunk : m_chunks) {
+		end = chunk.begin + chunk.written;
+		if (!chunk.complete()) {
+			break;
+		}
+	}
+	return end;
+}
+
+void RangedDownload::abort(std::unique_lock<std::mutex> &lock) {
+	for (const Chunk &chunk : m_chunks) {
+		if (chunk.running) {
+			Network::singleton().cancel(chunk.transfer);
+		}
+	}
+	// The callbacks hold this object; wait them out.
+	m_changed.wait(lock, [this] { return m_running == 0; });
+}
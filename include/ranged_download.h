@@ -0,0 +1,110 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef RANGED_DOWNLOAD_H
+#define RANGED_DOWNLOAD_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+#include "network.h"
+#include "sha256.h"
+
+struct DownloadRequest {
+	std::string url;
+	std::filesystem::path path;
+	// Expected size in bytes. Without it the file comes in one stream and cannot resume.
+	std::int64_t size = 0;
+	// Expected SHA-256 in hex, "sha256:" prefix allowed as in the manifest; empty skips the check.
+	std::string sha256;
+	// Range requests in flight at once.
+	int connections = 4;
+	// Called on the thread in run(), a few times a second.
+	std::function<void(const TransferProgress &)> onProgress;
+};
+
+struct DownloadResult {
+	// Empty on success.
+	std::string error;
+	// Already on disk from an interrupted run, and downloaded by this one.
+	std::int64_t resumedBytes = 0;
+	std::int64_t downloadedBytes = 0;
+	double seconds = 0;
+	// Hashing left to do after the last byte arrived.
+	double verifySeconds = 0;
+	int retries = 0;
+
+	[[nodiscard]] bool ok() const { return error.empty(); }
+};
+
+/**
+ * Downloads one file through Network as consecutive 1 MiB range requests, several in flight,
+ * written in place into a file of the final size.
+ *
+ * Which ranges are on disk is saved next to the file (<path>.parts) with the SHA-256 state, so
+ * a later run with the same request picks up where this one stopped. Chunks are handed out in
+ * order and the file is hashed as soon as a prefix of it is complete, so when the last byte
+ * arrives only the chunks still in flight are left to verify. A dropped connection retries its
+ * chunk from the byte it reached. A server that ignores ranges gets one plain request instead.
+ */
+class RangedDownload {
+public:
+	explicit RangedDownload(DownloadRequest request);
+
+	// Blocks until the file is complete and verified, has failed, or stop is requested. A failed
+	// checksum removes the file; any other failure keeps what arrived for the next run.
+	DownloadResult run(std::stop_token stop = {});
+
+private:
+	struct Chunk {
+		std::int64_t begin = 0;
+		// Exclusive; -1 while the size is unknown.
+		std::int64_t end = 0;
+		// Network thread writes it, once the bytes are in the file.
+		std::int64_t written = 0;
+		bool running = false;
+		// Ended, with response, and not looked at by run() yet.
+		bool ended = false;
+		HttpResponse response;
+		Network::TransferId transfer = 0;
+		int failures = 0;
+		std::chrono::steady_clock::time_point retryAt;
+
+		[[nodiscard]] bool complete() const { return end >= 0 && begin + written == end; }
+	};
+
+	bool prepare(DownloadResult &result);
+	bool loadPartMap();
+	void savePartMap();
+	void startChunk(std::size_t index);
+	// End of the part of the file that is complete from the start.
+	[[nodiscard]] std::int64_t frontier() const;
+	// Cancels what is running and waits for it, keeping the progress for the next run.
+	void abort(std::unique_lock<std::mutex> &lock);
+
+	DownloadRequest m_request;
+	std::filesystem::path m_partMapPath;
+	// Written by the network thread only.
+	std::fstream m_output;
+	std::ifstream m_input;
+
+	std::mutex m_mutex;
+	std::condition_variable_any m_changed;
+	std::vector<Chunk> m_chunks;
+	int m_running = 0;
+
+	// run() only.
+	Sha256 m_hasher;
+	std::int64_t m_hashed = 0;
+};
+
+#endif //RANGED_DOWNLOAD_H
@@ -0,0 +1,172 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "sha256.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace {
+	constexpr std::array<std::uint32_t, 64> K = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+	};
+
+	constexpr char HEX[] = "0123456789abcdef";
+
+	constexpr std::uint32_t rotr(const std::uint32_t x, const int n) {
+		return (x >> n) | (x << (32 - n));
+	}
+
+	void appendHex(std::string &out, const std::uint8_t byte) {
+		out += HEX[byte >> 4];
+		out += HEX[byte & 0xf];
+	}
+
+	bool parseHex(const std::string_view hex, std::uint8_t *out) {
+		for (std::size_t i = 0; i < hex.size() / 2; ++i) {
+			if (std::from_chars(hex.data() + 2 * i, hex.data() + 2 * i + 2, out[i], 16).ptr != hex.data() + 2 * i + 2) {
+				return false;
+			}
+		}
+		return hex.size() % 2 == 0;
+	}
+}
+
+Sha256::Sha256() {
+	reset();
+}
+
+void Sha256::reset() {
+	m_state = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+	m_length = 0;
+}
+
+void Sha256::compress(const std::uint8_t *block) {
+	std::uint32_t w[64];
+	for (int i = 0; i < 16; ++i) {
+		w[i] = static_cast<std::uint32_t>(block[4 * i]) << 24 | static_cast<std::uint32_t>(block[4 * i + 1]) << 16 |
+			static_cast<std::uint32_t>(block[4 * i + 2]) << 8 | block[4 * i + 3];
+	}
+	for (int i = 16; i < 64; ++i) {
+		const std::uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+		const std::uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+		w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+	}
+
+	auto [a, b, c, d, e, f, g, h] = m_state;
+	for (int i = 0; i < 64; ++i) {
+		const std::uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+		const std::uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+		h = g;
+		g = f;
+		f = e;
+		e = d + t1;
+		d = c;
+		c = b;
+		b = a;
+		a = t1 + t2;
+	}
+	m_state[0] += a;
+	m_state[1] += b;
+	m_state[2] += c;
+	m_state[3] += d;
+	m_state[4] += e;
+	m_state[5] += f;
+	m_state[6] += g;
+	m_state[7] += h;
+}
+
+void Sha256::update(const void *data, std::size_t size) {
+	auto bytes = static_cast<const std::uint8_t *>(data);
+	std::size_t buffered = m_length % 64;
+	m_length += size;
+
+	if (buffered > 0) {
+		const std::size_t take = std::min(size, 64 - buffered);
+		std::memcpy(m_buffer.data() + buffered, bytes, take);
+		bytes += take;
+		size -= take;
+		if (buffered + take < 64) {
+			return;
+		}
+		compress(m_buffer.data());
+	}
+	for (; size >= 64; bytes += 64, size -= 64) {
+		compress(bytes);
+	}
+	std::memcpy(m_buffer.data(), bytes, size);
+}
+
+std::string Sha256::hexDigest() {
+	const std::uint64_t bits = m_length * 8;
+	std::uint8_t padding[72] = {0x80};
+	const std::size_t padLength = (m_length % 64 < 56 ? 56 : 120) - m_length % 64;
+	for (int i = 0; i < 8; ++i) {
+		padding[padLength + i] = static_cast<std::uint8_t>(bits >> (56 - 8 * i));
+	}
+	update(padding, padLength + 8);
+
+	std::string digest;
+	for (const std::uint32_t word : m_state) {
+		for (int shift = 24; shift >= 0; shift -= 8) {
+			appendHex(digest, static_cast<std::uint8_t>(word >> shift));
+		}
+	}
+	reset();
+	return digest;
+}
+
+// "<state words>:<length>:<buffered bytes>", all hex but the length.
+std::string Sha256::saveState() const {
+	std::string state;
+	for (const std::uint32_t word : m_state) {
+		for (int shift = 24; shift >= 0; shift -= 8) {
+			appendHex(state, static_cast<std::uint8_t>(word >> shift));
+		}
+	}
+	state += ':' + std::to_string(m_length) + ':';
+	for (std::size_t i = 0; i < m_length % 64; ++i) {
+		appendHex(state, m_buffer[i]);
+	}
+	return state;
+}
+
+bool Sha256::restoreState(const std::string_view state) {
+	const std::size_t first = state.find(':');
+	const std::size_t second = state.find(':', first + 1);
+	if (first != 64 || second == std::string_view::npos) {
+		return false;
+	}
+
+	std::uint64_t length = 0;
+	const std::string_view lengthText = state.substr(first + 1, second - first - 1);
+	if (std::from_chars(lengthText.data(), lengthText.data() + lengthText.size(), length).ptr !=
+		lengthText.data() + lengthText.size()) {
+		return false;
+	}
+
+	std::uint8_t words[32];
+	std::array<std::uint8_t, 64> buffer{};
+	const std::string_view bufferText = state.substr(second + 1);
+	if (!parseHex(state.substr(0, 64), words) || bufferText.size() != 2 * (length % 64) ||
+		!parseHex(bufferText, buffer.data())) {
+		return false;
+	}
+
+	for (int i = 0; i < 8; ++i) {
+		m_state[i] = static_cast<std::uint32_t>(words[4 * i]) << 24 | static_cast<std::uint32_t>(words[4 * i + 1]) << 16 |
+			static_cast<std::uint32_t>(words[4 * i + 2]) << 8 | words[4 * i + 3];
+	}
+	m_buffer = buffer;
+	m_length = length;
+	return true;
+}
@@ -0,0 +1,42 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * Incremental SHA-256 (FIPS 180-4), for checking downloads as they arrive.
+ *
+ * The state can be saved and restored, so an interrupted download resumes hashing where
+ * it stopped instead of reading the file again.
+ */
+class Sha256 {
+public:
+	Sha256();
+
+	void update(const void *data, std::size_t size);
+	// Lower-case hex digest. The object starts over afterwards.
+	std::string hexDigest();
+
+	[[nodiscard]] std::uint64_t bytesHashed() const { return m_length; }
+	[[nodiscard]] std::string saveState() const;
+	// Returns false, and leaves the object as it was, if state is not from saveState().
+	bool restoreState(std::string_view state);
+
+private:
+	void reset();
+	void compress(const std::uint8_t *block);
+
+	std::array<std::uint32_t, 8> m_state{};
+	std::array<std::uint8_t, 64> m_buffer{};
+	std::uint64_t m_length = 0;
+};
+
+#endif //SHA256_H
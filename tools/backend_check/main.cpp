@@ -0,0 +1,185 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+// Runs scripts through the app's PersistentProcessBackend and checks the lines the output
+// panel would show for each run: none lost or split, and no blank line after output that ends
+// in a newline. Covers bash and python, and pwsh when it is installed; a missing interpreter
+// is skipped. Exits with 1 if any run shows something else.
+//
+//   backend_check [--dialect bash|python|powershell]
+
+#include <iostream>
+#include <map>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QStandardPaths>
+#include <QTimer>
+
+#include "clients/ExecutionBackend/PersistentProcessBackend.h"
+
+namespace
+{
+    using Dialect = PersistentProcessBackend::Dialect;
+
+    struct Case
+    {
+        QString script;
+        QStringList expected; // stdout, as lines of the output panel
+    };
+
+    QStringList numbers(const int count)
+    {
+        QStringList lines;
+        for (int i = 1; i <= count; ++i)
+        {
+            lines.append(QString::number(i));
+        }
+        return lines;
+    }
+
+    // Large outputs arrive in several reads, so the sentinel's newline lands in any of them.
+    QList<Case> casesFor(const Dialect dialect)
+    {
+        switch (dialect)
+        {
+        case Dialect::Bash:
+            return {
+                {"echo hello", {"hello"}},
+                {"printf 'no newline'", {"no newline"}},
+                {"echo a; echo; echo b", {"a", "", "b"}},
+                {"printf 'a\\n\\n'", {"a", ""}},
+                {"seq 1 20000", numbers(20000)},
+            };
+        case Dialect::Python:
+            return {
+                {"print('hello')", {"hello"}},
+                {"import sys; sys.stdout.write('no newline')", {"no newline"}},
+                {"print('a'); print(); print('b')", {"a", "", "b"}},
+                {"print('a\\n')", {"a", ""}},
+                {"for i in range(1, 20001): print(i)", numbers(20000)},
+            };
+        case Dialect::PowerShell:
+            return {
+                {"'hello'", {"hello"}},
+                {"'a', 'b'", {"a", "b"}},
+                {"1..20000", numbers(20000)},
+            };
+        }
+        return {};
+    }
+
+    // As LineStore::appendText splits what the output panel is given.
+    void appendLines(QStringList& lines, const QString& text)
+    {
+        for (QString line : text.split('\n'))
+        {
+            if (line.endsWith('\r'))
+            {
+                line.chop(1);
+            }
+            lines.append(line);
+        }
+    }
+
+    bool check(const Dialect dialect)
+    {
+        const QString program = PersistentProcessBackend::defaultProgram(dialect);
+        if (QStandardPaths::findExecutable(program).isEmpty())
+        {
+            std::cout << program.toStdString() << ": not found, skipped" << std::endl;
+            return true;
+        }
+
+        const QList<Case> cases = casesFor(dialect);
+        PersistentProcessBackend backend(dialect, program);
+        std::map<quint64, QStringList> shown;
+        qsizetype finished = 0;
+        QEventLoop loop;
+
+        // What CodeRunner hands the output panel: streamed lines, then whatever came with the end.
+        QObject::connect(&backend, &IExecutionBackend::outputReady,
+                         [&shown](const quint64 runId, const QString& text, const bool isError)
+                         {
+                             if (!isError)
+                             {
+                                 appendLines(shown[runId], text);
+                             }
+                         });
+        QObject::connect(&backend, &IExecutionBackend::runFinished,
+                         [&](const quint64 runId, int, const QString& output, const QString&)
+                         {
+                             if (!output.isEmpty())
+                             {
+                                 appendLines(shown[runId], output);
+                             }
+                             if (++finished == cases.size())
+                             {
+                                 loop.quit();
+                             }
+                         });
+        QTimer::singleShot(60000, &loop, &QEventLoop::quit);
+
+        for (qsizetype i = 0; i < cases.size(); ++i)
+        {
+            backend.execute(static_cast<quint64>(i + 1), cases[i].script);
+        }
+        loop.exec();
+
+        bool ok = finished == cases.size();
+        for (qsizetype i = 0; i < cases.size(); ++i)
+        {
+            const QStringList& lines = shown[static_cast<quint64>(i + 1)];
+            const bool passed = lines == cases[i].expected;
+            ok = ok && passed;
+
+            std::cout << program.toStdString() << ": " << (passed ? "ok      " : "FAILED  ")
+                << cases[i].script.left(40).toStdString();
+            if (!passed)
+            {
+                std::cout << " (" << lines.size() << " lines, expected " << cases[i].expected.size();
+                if (!lines.isEmpty())
+                {
+                    std::cout << "; last \"" << lines.last().toStdString() << "\"";
+                }
+                std::cout << ")";
+            }
+            std::cout << std::endl;
+        }
+        if (finished != cases.size())
+        {
+            std::cout << program.toStdString() << ": timed out after " << finished << " runs" << std::endl;
+        }
+        return ok;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("backend_check");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Checks the output lines of runs through the persistent interpreter backend.");
+    parser.addHelpOption();
+    parser.addOption({"dialect", "Only this interpreter: bash, python or powershell.", "dialect"});
+    parser.process(app);
+
+    const std::map<QString, Dialect> dialects{
+        {"bash", Dialect::Bash},
+        {"python", Dialect::Python},
+        {"powershell", Dialect::PowerShell},
+    };
+
+    bool ok = true;
+    for (const auto& [name, dialect] : dialects)
+    {
+        if (!parser.isSet("dialect") || parser.value("dialect") == name)
+        {
+            ok = check(dialect) && ok;
+        }
+    }
+    return ok ? 0 : 1;
+}
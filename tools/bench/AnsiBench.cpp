@@ -0,0 +1,97 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+// Throughput of AnsiParser on plain and colored output, fed in pipe-sized chunks, with and
+// without storing the resulting lines.
+
+#include <cstdio>
+#include <string>
+
+#include "BenchUtils.h"
+#include "output_display/AnsiParser.h"
+#include "output_display/LineStore.h"
+
+namespace
+{
+    // What pwsh 7 prints for a table: colored header and separator, then plain rows with the
+    // occasional colored cell.
+    std::string makeTranscript(const std::size_t bytes, const bool colored)
+    {
+        std::string transcript;
+        transcript.reserve(bytes + 256);
+        for (std::size_t row = 0; transcript.size() < bytes; ++row)
+        {
+            if (row % 40 == 0)
+            {
+                transcript += colored ? "\x1b[32;1mHandles  NPM(K)    PM(K)      WS(K)     CPU(s)     Id  SI ProcessName\x1b[0m\n"
+                                      : "Handles  NPM(K)    PM(K)      WS(K)     CPU(s)     Id  SI ProcessName\n";
+                transcript += colored ? "\x1b[32;1m-------  ------    -----      -----     ------     --  -- -----------\x1b[0m\n"
+                                      : "-------  ------    -----      -----     ------     --  -- -----------\n";
+            }
+
+            char line[160];
+            const int length = std::snprintf(line, sizeof(line), "%7zu %7zu %8zu %10zu %10.2f %6zu %3zu %s%s%s\n",
+                                             row % 3000, row % 97, row * 13 % 900000, row * 29 % 900000,
+                                             static_cast<double>(row % 10000) / 3.0, row % 65536, row % 4,
+                                             colored && row % 5 == 0 ? "\x1b[38;2;255;165;0m" : "",
+                                             "svchost", colored && row % 5 == 0 ? "\x1b[39m" : "");
+            transcript.append(line, static_cast<std::size_t>(length));
+        }
+        return transcript;
+    }
+
+    void run(const char* label, const std::string& transcript, LineStore* store)
+    {
+        constexpr std::size_t CHUNK = 64 * 1024;
+
+        AnsiParser parser;
+        std::size_t lines = 0;
+        std::size_t runs = 0;
+        const AnsiParser::LineSink sink = [&](const std::string_view text, const std::span<const StyleRun> styles)
+        {
+            ++lines;
+            runs += styles.size();
+            if (store != nullptr)
+            {
+                store->append(text, LineStore::Kind::Output, styles);
+            }
+        };
+
+        const bench::Stopwatch stopwatch;
+        for (std::size_t offset = 0; offset < transcript.size(); offset += CHUNK)
+        {
+            parser.feed(std::string_view(transcript).substr(offset, CHUNK), sink);
+        }
+        parser.finish(sink);
+        const double seconds = stopwatch.seconds();
+
+        const double mib = static_cast<double>(transcript.size()) / (1024 * 1024);
+        std::printf("%-24s %7.1f MiB/s  %5.1f ns/line  (%zu lines, %zu style runs)\n", label, mib / seconds,
+                    seconds * 1e9 / static_cast<double>(lines), lines, runs);
+    }
+}
+
+int ansiBench(const int argc, char** argv)
+{
+    const std::size_t mib = std::stoull(bench::option(argc, argv, "--mib", "64"));
+
+    const std::string plain = makeTranscript(mib * 1024 * 1024, false);
+    const std::string colored = makeTranscript(mib * 1024 * 1024, true);
+
+    run("plain, parse only", plain, nullptr);
+    run("colored, parse only", colored, nullptr);
+
+    LineStore::Options options;
+    options.maxBytes = 256 * 1024 * 1024;
+    options.maxLines = 10'000'000;
+    {
+        LineStore store(options);
+        run("plain, parse + store", plain, &store);
+    }
+    {
+        LineStore store(options);
+        run("colored, parse + store", colored, &store);
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+namespace bench
+{
+    class Stopwatch
+    {
+    public:
+        Stopwatch() : m_start(std::chrono::steady_clock::now()) {}
+
+        [[nodiscard]] double seconds() const
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+        }
+
+    private:
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    // Current ("VmRSS") or peak ("VmHWM") resident set size in KiB; 0 where unknown.
+    inline std::int64_t rssKb(const bool peak = false)
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return 0;
+        }
+        return static_cast<std::int64_t>((peak ? counters.PeakWorkingSetSize : counters.WorkingSetSize) / 1024);
+#else
+        std::FILE* status = std::fopen("/proc/self/status", "r");
+        if (status == nullptr)
+        {
+            return 0;
+        }
+
+        const char* key = peak ? "VmHWM:" : "VmRSS:";
+        char line[256];
+        std::int64_t kb = 0;
+        while (std::fgets(line, sizeof(line), status) != nullptr)
+        {
+            if (std::strncmp(line, key, std::strlen(key)) == 0)
+            {
+                kb = std::strtoll(line + std::strlen(key), nullptr, 10);
+                break;
+            }
+        }
+        std::fclose(status);
+        return kb;
+#endif
+    }
+
+    // Value of "--name value" in argv, or fallback.
+    inline std::string option(const int argc, char** argv, const char* name, std::string fallback = {})
+    {
+        for (int i = 0; i + 1 < argc; ++i)
+        {
+            if (std::strcmp(argv[i], name) == 0)
+            {
+                return argv[i + 1];
+            }
+        }
+        return fallback;
+    }
+}
+
+#endif // BENCH_UTILS_H
@@ -0,0 +1,69 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+// Downloads a file with RangedDownload, as the updater does, and reports throughput, how much
+// was resumed, and how long the checksum took after the last byte. Run it again after an
+// interruption to resume. tools/test_update_download.sh drives it against a flaky http_stub.
+
+#include <cstdio>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+#include "BenchUtils.h"
+#include "ranged_download.h"
+
+int downloadBench(const int argc, char** argv)
+{
+    const std::string url = bench::option(argc, argv, "--url");
+    const std::string out = bench::option(argc, argv, "--out");
+    if (url.empty() || out.empty())
+    {
+        std::fprintf(stderr, "download needs --url and --out\n");
+        return 1;
+    }
+
+    RangedDownload download({
+        .url = url,
+        .path = out,
+        .size = std::stoll(bench::option(argc, argv, "--size", "0")),
+        .sha256 = bench::option(argc, argv, "--sha256"),
+        .connections = std::stoi(bench::option(argc, argv, "--connections", "4")),
+        .onProgress = [](const TransferProgress& progress)
+        {
+            std::fprintf(stderr, "\r%.1f / %.1f MiB", static_cast<double>(progress.downloaded) / (1024.0 * 1024.0),
+                         static_cast<double>(progress.total) / (1024.0 * 1024.0));
+        },
+    });
+
+    // Stops the download part way, as closing the app would.
+    std::stop_source stop;
+    std::jthread stopper;
+    if (const int stopAfterMs = std::stoi(bench::option(argc, argv, "--stop-after-ms", "0")); stopAfterMs > 0)
+    {
+        stopper = std::jthread([&stop, stopAfterMs](const std::stop_token& cancelled)
+        {
+            const auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(stopAfterMs);
+            while (!cancelled.stop_requested() && std::chrono::steady_clock::now() < until)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            stop.request_stop();
+        });
+    }
+
+    const DownloadResult result = download.run(stop.get_token());
+    constexpr double MIB = 1024.0 * 1024.0;
+    std::fprintf(stderr, "\n");
+    std::printf("downloaded %.1f MiB (resumed %.1f MiB) in %.2f s: %.1f MiB/s, %d retries\n",
+                static_cast<double>(result.downloadedBytes) / MIB, static_cast<double>(result.resumedBytes) / MIB,
+                result.seconds, static_cast<double>(result.downloadedBytes) / MIB / result.seconds, result.retries);
+    if (!result.ok())
+    {
+        std::printf("failed: %s\n", result.error.c_str());
+        return 1;
+    }
+    std::printf("verify_after_last_byte_ms %.2f\n", result.verifySeconds * 1e3);
+    return 0;
+}
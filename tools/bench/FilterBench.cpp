@@ -0,0 +1,75 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+// Fills a LineStore with N lines spread over several runs and times full LineFilter passes
+// for the kinds of queries the output panel's filter bar issues.
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "BenchUtils.h"
+#include "output_display/LineFilter.h"
+#include "output_display/LineStore.h"
+
+namespace
+{
+    void timeQuery(const char* label, const LineStore& store, LineFilter::Query query)
+    {
+        LineFilter filter;
+        filter.setQuery(std::move(query));
+
+        const bench::Stopwatch stopwatch;
+        while (!filter.update(store, store.lineCount()))
+        {
+        }
+        const double seconds = stopwatch.seconds();
+
+        std::printf("%-28s %8.2f ms  %9zu matches\n", label, seconds * 1e3, filter.matchCount(store));
+    }
+}
+
+int filterBench(const int argc, char** argv)
+{
+    const std::size_t lines = std::stoull(bench::option(argc, argv, "--lines", "1000000"));
+    const std::size_t runs = std::stoull(bench::option(argc, argv, "--runs", "20"));
+    const std::size_t maxMiB = std::stoull(bench::option(argc, argv, "--max-mib", "256"));
+    const std::string runDirectory = bench::option(argc, argv, "--run-dir");
+
+    LineStore::Options options;
+    options.maxBytes = maxMiB * 1024 * 1024;
+    options.maxLines = lines;
+    options.runDirectory = runDirectory;
+    options.persistBytes = 0;
+    LineStore store(options);
+
+    std::vector<std::string> samples;
+    for (std::size_t i = 0; i < 4096; ++i)
+    {
+        char buffer[160];
+        const int length = std::snprintf(buffer, sizeof(buffer),
+                                          "%8zu  process-%-6zu %10.2f %12zu  Running   C:\\Windows\\System32\\svc%zu.exe",
+                                          i * 7919, i % 997, static_cast<double>(i % 10000) / 7.0, i * 4096, i % 31);
+        samples.emplace_back(buffer, static_cast<std::size_t>(length));
+    }
+
+    for (std::size_t i = 0; i < lines; ++i)
+    {
+        if (i % (lines / runs) == 0)
+        {
+            store.setRun(static_cast<std::uint32_t>(i / (lines / runs) + 1));
+        }
+        store.append(samples[i % samples.size()], i % 50 == 0 ? LineStore::Kind::Error : LineStore::Kind::Output);
+    }
+    std::printf("%zu lines in %zu runs%s\n\n", store.lineCount(), runs, runDirectory.empty() ? "" : " (run files)");
+
+    timeQuery("everything", store, {});
+    timeQuery("substring \"svc7.exe\"", store, {.text = "svc7.exe"});
+    timeQuery("substring \"SVC7.EXE\" (Aa)", store, {.text = "SVC7.EXE", .caseSensitive = true});
+    timeQuery("substring \"process-42 \"", store, {.text = "process-42 "});
+    timeQuery("errors only", store, {.kinds = LineFilter::kindBit(LineStore::Kind::Error)});
+    timeQuery("run 7", store, {.run = 7});
+    timeQuery("run 7 + \"running\"", store, {.text = "running", .run = 7});
+    return 0;
+}
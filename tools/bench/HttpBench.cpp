@@ -0,0 +1,77 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+// Fetches a URL many times through Network with a bounded number of transfers in flight and
+// reports latency percentiles, throughput and how often a pooled connection was reused.
+// Meant for a local server, e.g. tools/http_stub.
+
+#include <algorithm>
+#include <cstdint>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "BenchUtils.h"
+#include "network.h"
+
+int httpBench(const int argc, char** argv)
+{
+    const std::string url = bench::option(argc, argv, "--url", "http://127.0.0.1:8080/manifest.json");
+    const int requests = std::stoi(bench::option(argc, argv, "--requests", "1000"));
+    const int concurrency = std::max(1, std::stoi(bench::option(argc, argv, "--concurrency", "8")));
+
+    Network& network = Network::singleton();
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::vector<double> latencies;
+    int inFlight = 0;
+    int failures = 0;
+    int reused = 0;
+    std::int64_t bytes = 0;
+
+    const bench::Stopwatch stopwatch;
+    for (int i = 0; i < requests; ++i)
+    {
+        {
+            std::unique_lock lock(mutex);
+            finished.wait(lock, [&] { return inFlight < concurrency; });
+            inFlight++;
+        }
+
+        network.start({.url = url}, [&](const HttpResponse& response)
+        {
+            std::lock_guard lock(mutex);
+            inFlight--;
+            if (!response.ok() || response.status >= 400)
+            {
+                failures++;
+            }
+            reused += response.stats.reusedConnection ? 1 : 0;
+            bytes += response.stats.bytes;
+            latencies.push_back(response.stats.totalSeconds * 1e3);
+            finished.notify_one();
+        });
+    }
+    {
+        std::unique_lock lock(mutex);
+        finished.wait(lock, [&] { return inFlight == 0; });
+    }
+    const double seconds = stopwatch.seconds();
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](const double p)
+    {
+        return latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(p * latencies.size()))];
+    };
+
+    std::printf("%d requests, %d in flight: %.0f req/s, %.2f MiB/s\n", requests, concurrency, requests / seconds,
+                static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds);
+    std::printf("latency ms  p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n", percentile(0.5), percentile(0.9),
+                percentile(0.99), latencies.back());
+    std::printf("connections reused %d of %d, failures %d\n", reused, requests, failures);
+    return failures == 0 ? 0 : 1;
+}
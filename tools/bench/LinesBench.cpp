@@ -0,0 +1,141 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+// Appends N lines shaped like script output to a LineStore, then reads random lines back,
+// reporting time per line and memory. With --run-dir the lines also go to a run file, which
+// is then reopened the way the output panel does after a restart.
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BenchUtils.h"
+#include "output_display/LineStore.h"
+
+namespace
+{
+    // Lines longer than half the arena, in a store that keeps 1 KiB: each one evicts every
+    // other line and no longer fits behind the previous one. Used to hang append().
+    bool longLinesFit()
+    {
+        LineStore::Options options;
+        options.maxBytes = 1024;
+        LineStore store(options);
+
+        for (const std::size_t length : {600, 700, 1024, 2000, 600, 1})
+        {
+            const std::string line(length, 'x');
+            store.append(line, LineStore::Kind::Output);
+            if (store.line(store.lineCount() - 1).size() != std::min<std::size_t>(length, options.maxBytes))
+            {
+                return false;
+            }
+        }
+        return store.lineCount() == 2;
+    }
+}
+
+int linesBench(const int argc, char** argv)
+{
+    const std::size_t lines = std::stoull(bench::option(argc, argv, "--lines", "1000000"));
+    const std::size_t maxMiB = std::stoull(bench::option(argc, argv, "--max-mib", "32"));
+    const std::string runDirectory = bench::option(argc, argv, "--run-dir");
+
+    LineStore::Options options;
+    options.maxBytes = maxMiB * 1024 * 1024;
+    options.maxLines = lines;
+    options.runDirectory = runDirectory;
+    options.persistBytes = 0;
+    LineStore store(options);
+    store.setRun(1);
+
+    // Typical Format-Table output: fixed columns, varying values. Formatted up front so the
+    // timing is of the store, not of snprintf.
+    std::vector<std::string> samples;
+    for (std::size_t i = 0; i < 4096; ++i)
+    {
+        char buffer[160];
+        const int length = std::snprintf(buffer, sizeof(buffer),
+                                          "%8zu  process-%-6zu %10.2f %12zu  Running   C:\\Windows\\System32\\svc%zu.exe",
+                                          i * 7919, i % 997, static_cast<double>(i % 10000) / 7.0, i * 4096, i % 31);
+        samples.emplace_back(buffer, static_cast<std::size_t>(length));
+    }
+
+    const std::int64_t rssBefore = bench::rssKb();
+    std::size_t bytes = 0;
+
+    const bench::Stopwatch append;
+    for (std::size_t i = 0; i < lines; ++i)
+    {
+        const std::string& sample = samples[i % samples.size()];
+        store.append(sample, i % 50 == 0 ? LineStore::Kind::Error : LineStore::Kind::Output);
+        bytes += sample.size();
+    }
+    const double appendSeconds = append.seconds();
+
+    // Random access, as a view scrolled to arbitrary positions would do.
+    std::mt19937_64 random(42);
+    constexpr int READS = 100000;
+    std::size_t checksum = 0;
+
+    const bench::Stopwatch read;
+    for (int i = 0; i < READS; ++i)
+    {
+        checksum += store.line(random() % store.lineCount()).size();
+    }
+    const double readSeconds = read.seconds();
+    const std::size_t readable = store.lineCount();
+    const std::size_t memory = store.memoryBytes();
+
+    std::printf("lines appended   %zu (%.1f MiB of text)\n", lines, static_cast<double>(bytes) / (1024 * 1024));
+    std::printf("lines readable   %zu\n", readable);
+    std::printf("append           %.3f s, %.1f ns/line, %.1f MiB/s\n", appendSeconds,
+                appendSeconds * 1e9 / static_cast<double>(lines),
+                static_cast<double>(bytes) / (1024 * 1024) / appendSeconds);
+    std::printf("random read      %.1f ns/line (checksum %zu)\n", readSeconds * 1e9 / READS, checksum);
+    std::printf("store memory     %.1f MiB (cap %zu MiB text)\n", static_cast<double>(memory) / (1024 * 1024), maxMiB);
+    std::printf("rss growth       %.1f MiB, peak rss %.1f MiB\n",
+                static_cast<double>(bench::rssKb() - rssBefore) / 1024,
+                static_cast<double>(bench::rssKb(true)) / 1024);
+
+    const bool longLines = longLinesFit();
+    std::printf("long lines       %s\n", longLines ? "ok" : "FAILED");
+
+    if (!runDirectory.empty())
+    {
+        // What the panel does when a saved run is opened: index only, pages mapped on demand.
+        std::filesystem::path runFile;
+        for (const auto& entry : std::filesystem::directory_iterator(runDirectory))
+        {
+            if (entry.path().extension() == ".log" && (runFile.empty() || entry.last_write_time() >
+                std::filesystem::last_write_time(runFile)))
+            {
+                runFile = entry.path();
+            }
+        }
+        store.setRun(2); // flushes the run file
+
+        LineStore reopened;
+        const bench::Stopwatch open;
+        const bool loaded = reopened.load(runFile);
+        const double openSeconds = open.seconds();
+
+        checksum = 0;
+        const bench::Stopwatch reread;
+        for (int i = 0; loaded && i < READS; ++i)
+        {
+            checksum += reopened.line(random() % reopened.lineCount()).size();
+        }
+        const double rereadSeconds = reread.seconds();
+
+        std::printf("reopen           %.2f ms, %zu lines, %.1f MiB index (%s)\n", openSeconds * 1e3,
+                    reopened.lineCount(), static_cast<double>(reopened.memoryBytes()) / (1024 * 1024),
+                    runFile.filename().string().c_str());
+        std::printf("reopened read    %.1f ns/line (checksum %zu)\n", rereadSeconds * 1e9 / READS, checksum);
+    }
+    return longLines ? 0 : 1;
+}
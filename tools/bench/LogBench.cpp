@@ -0,0 +1,137 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+// Cost of a log call at the call site. T threads log N messages in bursts that fit the ring,
+// with a flush between bursts outside the timing, so the figure is what a caller pays and not
+// how fast the disk is. Also times a call below the level, and the previous file_log (open,
+// format, write, close on every call) for comparison.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchUtils.h"
+#include "logger.h"
+
+namespace
+{
+    // file_utils::file_log before Logger, minus the comments.
+    void legacyLog(const std::filesystem::path& path, const std::string& message)
+    {
+        std::ofstream outputFile(path, std::ios::out | std::ios::app);
+        const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        const std::tm* local = std::localtime(&now);
+        std::ostringstream oss;
+        oss << std::put_time(local, "%Y-%m-%d %H:%M:%S");
+        outputFile << oss.str() << ": " << message << std::endl;
+        outputFile.close();
+    }
+}
+
+int logBench(const int argc, char** argv)
+{
+    const std::size_t messages = std::stoull(bench::option(argc, argv, "--messages", "1000000"));
+    const int threads = std::max(1, std::stoi(bench::option(argc, argv, "--threads", "1")));
+    const std::size_t burst = std::stoull(bench::option(argc, argv, "--burst", "1000"));
+    const std::size_t legacy = std::stoull(bench::option(argc, argv, "--legacy", "10000"));
+    const std::filesystem::path directory = bench::option(argc, argv, "--dir",
+                                                          std::filesystem::temp_directory_path().string());
+
+    const std::filesystem::path path = directory / "buraq_bench_log.txt";
+    std::error_code error;
+    for (const char* name : {"buraq_bench_log.txt", "buraq_bench_log.1.txt", "buraq_bench_log_legacy.txt"})
+    {
+        std::filesystem::remove(directory / name, error);
+    }
+
+    // Shaped like the app's messages: a fixed text and a path or a number.
+    std::vector<std::string> samples;
+    for (int i = 0; i < 64; ++i)
+    {
+        samples.push_back("Update: patch for bin/plugin" + std::to_string(i) +
+                          ".dll failed (checksum mismatch), downloading it whole.");
+    }
+
+    LoggerOptions options;
+    options.path = path;
+    options.maxBytes = 64 * 1024 * 1024;
+    options.keepFiles = 1;
+    Logger logger(options);
+
+    // Bursts of every thread together, each small enough for its share of the ring.
+    const std::size_t perThread = messages / static_cast<std::size_t>(threads);
+    const std::size_t perBurst = std::min(burst, std::size_t{4096} / static_cast<std::size_t>(threads));
+    std::vector<double> threadSeconds(threads);
+    const bench::Stopwatch total;
+    for (std::size_t done = 0; done < perThread; done += perBurst)
+    {
+        const std::size_t count = std::min(perBurst, perThread - done);
+        std::vector<std::jthread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t]
+            {
+                const bench::Stopwatch calls;
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    logger.log(LogLevel::Info, samples[(done + i) % samples.size()]);
+                }
+                threadSeconds[t] += calls.seconds();
+            });
+        }
+        workers.clear();
+        logger.flush();
+    }
+    const double totalSeconds = total.seconds();
+
+    double callSeconds = 0;
+    for (const double seconds : threadSeconds)
+    {
+        callSeconds += seconds;
+    }
+    const double logged = static_cast<double>(perThread * threads);
+
+    // Below the level: what a debug line costs in a release setup.
+    constexpr int SKIPPED = 10000000;
+    const bench::Stopwatch skipped;
+    for (int i = 0; i < SKIPPED; ++i)
+    {
+        logger.log(LogLevel::Debug, samples[i % samples.size()]);
+    }
+    const double skippedSeconds = skipped.seconds();
+
+    const std::filesystem::path legacyPath = directory / "buraq_bench_log_legacy.txt";
+    const bench::Stopwatch legacyCalls;
+    for (std::size_t i = 0; i < legacy; ++i)
+    {
+        legacyLog(legacyPath, samples[i % samples.size()]);
+    }
+    const double legacySeconds = legacyCalls.seconds();
+
+    std::printf("messages         %.0f from %d thread(s), bursts of %zu\n", logged, threads, perBurst);
+    std::printf("log()            %.1f ns/call\n", callSeconds * 1e9 / logged);
+    std::printf("written          %.2f s in all, %.1f MiB, %.0f lines/s\n", totalSeconds,
+                static_cast<double>(std::filesystem::file_size(path, error)) / (1024 * 1024), logged / totalSeconds);
+    std::printf("dropped          %llu\n", static_cast<unsigned long long>(logger.dropped()));
+    std::printf("below level      %.1f ns/call\n", skippedSeconds * 1e9 / SKIPPED);
+    if (legacy > 0)
+    {
+        std::printf("previous log     %.1f ns/call (%zu calls)\n", legacySeconds * 1e9 / static_cast<double>(legacy),
+                    legacy);
+    }
+
+    for (const char* name : {"buraq_bench_log.txt", "buraq_bench_log.1.txt", "buraq_bench_log_legacy.txt"})
+    {
+        std::filesystem::remove(directory / name, error);
+    }
+    return 0;
+}
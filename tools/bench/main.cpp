@@ -0,0 +1,55 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+// buraq_bench <benchmark> [options]; run without arguments for the list.
+
+#include <cstdio>
+#include <cstring>
+
+int ansiBench(int argc, char** argv);
+int downloadBench(int argc, char** argv);
+int filterBench(int argc, char** argv);
+int httpBench(int argc, char** argv);
+int linesBench(int argc, char** argv);
+int logBench(int argc, char** argv);
+
+namespace
+{
+    struct Benchmark
+    {
+        const char* name;
+        const char* description;
+        int (*run)(int argc, char** argv);
+    };
+
+    constexpr Benchmark BENCHMARKS[] = {
+        {"ansi", "Parse ANSI-colored output into lines and style runs [--mib M]", ansiBench},
+        {"download", "Download a file in ranges, resumably [--url U] [--out F] [--size B] [--sha256 H]", downloadBench},
+        {"filter", "Filter a 1M-line LineStore [--lines N] [--runs R] [--run-dir DIR]", filterBench},
+        {"http", "Fetch a URL through Network [--url U] [--requests N] [--concurrency C]", httpBench},
+        {"lines", "Append lines to the output LineStore [--lines N] [--max-mib M] [--run-dir DIR]", linesBench},
+        {"log", "Log from threads through Logger [--messages N] [--threads T] [--legacy N] [--dir DIR]", logBench},
+    };
+}
+
+int main(const int argc, char** argv)
+{
+    if (argc >= 2)
+    {
+        for (const Benchmark& benchmark : BENCHMARKS)
+        {
+            if (std::strcmp(argv[1], benchmark.name) == 0)
+            {
+                return benchmark.run(argc - 1, argv + 1);
+            }
+        }
+    }
+
+    std::printf("usage: buraq_bench <benchmark> [options]\n\n");
+    for (const Benchmark& benchmark : BENCHMARKS)
+    {
+        std::printf("  %-10s %s\n", benchmark.name, benchmark.description);
+    }
+    return argc >= 2 ? 1 : 0;
+}
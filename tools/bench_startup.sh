@@ -0,0 +1,60 @@
+#!/bin/bash
+
+# Time to interactive of the app: from main() to the first turn of the event loop after the
+# window's first paint, as printed by `buraq --startup-benchmark`, plus the wall time of the
+# whole process (load, startup, quit).
+# Usage: tools/bench_startup.sh [path to buraq]
+#
+# Cold runs drop the page cache first, which needs root on Linux; elsewhere (or without
+# root) they are skipped. Environment: RUNS (per mode), QT_QPA_PLATFORM (e.g. offscreen).
+
+set -euo pipefail
+
+APP="${1:-_gate_build/build/buraq}"
+RUNS="${RUNS:-10}"
+
+drop_caches() {
+  if [ -w /proc/sys/vm/drop_caches ]; then
+    sync
+    echo 3 > /proc/sys/vm/drop_caches
+    return 0
+  fi
+  return 1
+}
+
+run_once() {
+  local start end tti
+  start=$(date +%s%N)
+  tti=$("$APP" --startup-benchmark 2>/dev/null | awk '/^time_to_interactive_ms/ { print $2 }')
+  end=$(date +%s%N)
+  printf '%s %s\n' "${tti:-nan}" "$(( (end - start) / 1000000 ))"
+}
+
+# Prints "median min max" of the first column, then of the second.
+summarize() {
+  sort -n -k1,1 "$1" | awk '{ a[NR] = $1 } END { printf "tti_ms median %s min %s max %s  ", a[int((NR + 1) / 2)], a[1], a[NR] }'
+  sort -n -k2,2 "$1" | awk '{ a[NR] = $2 } END { printf "wall_ms median %s min %s max %s\n", a[int((NR + 1) / 2)], a[1], a[NR] }'
+}
+
+samples=$(mktemp)
+trap 'rm -f "$samples"' EXIT
+
+if drop_caches; then
+  : > "$samples"
+  for _ in $(seq "$RUNS"); do
+    drop_caches
+    run_once >> "$samples"
+  done
+  printf '%-5s ' cold
+  summarize "$samples"
+else
+  echo "cold  skipped (dropping the page cache needs root on Linux)"
+fi
+
+run_once > /dev/null # loads everything into the cache
+: > "$samples"
+for _ in $(seq "$RUNS"); do
+  run_once >> "$samples"
+done
+printf '%-5s ' warm
+summarize "$samples"
@@ -0,0 +1,52 @@
+#!/bin/bash
+
+# Compares the bridge transports (tcp, local socket, local socket + shared memory) for
+# large results. Usage: tools/bench_transports.sh <dir with bridge_mock and bridge_loadgen>
+#
+# Environment: SIZES (bytes, space separated), REQUESTS, CLIENTS. BRIDGE=<path to Buraq.Bridge>
+# measures the real bridge instead of bridge_mock, with results made by "'x' * <size>".
+
+set -euo pipefail
+
+BIN_DIR="${1:-_gate_build/build}"
+SIZES="${SIZES:-1048576 4194304 16777216}"
+REQUESTS="${REQUESTS:-200}"
+CLIENTS="${CLIENTS:-1}"
+PORT=$((20000 + $$ % 20000))
+
+# An absolute socket path off Windows, as the app passes it: .NET puts a bare name under
+# /tmp/CoreFxPipe_, where QLocalSocket does not look.
+case "$(uname -s)" in
+  MINGW*|MSYS*|CYGWIN*) PIPE="buraq-bench-$$" ;;
+  *) PIPE="${TMPDIR:-/tmp}/buraq-bench-$$" ;;
+esac
+
+# The bridge exits when its stdin closes; this keeps it open until the script ends.
+control="$(mktemp -u)"
+mkfifo "$control"
+exec 3<>"$control"
+rm -f "$control"
+
+for size in $SIZES; do
+  if [ -n "${BRIDGE:-}" ]; then
+    "$BRIDGE" --port "$PORT" --pipe "$PIPE" <&3 >/dev/null 2>&1 &
+    script="'x' * $size"
+    startup=3 # .NET and the PowerShell runspace
+  else
+    "$BIN_DIR/bridge_mock" --port "$PORT" --pipe "$PIPE" --output-bytes "$size" 2>/dev/null &
+    script="Get-Date"
+    startup=0.5
+  fi
+  mock=$!
+  trap 'kill $mock 2>/dev/null || true' EXIT
+  sleep "$startup"
+
+  for transport in tcp local shm; do
+    printf '%-9s %-6s ' "$size" "$transport"
+    "$BIN_DIR/bridge_loadgen" --transport "$transport" --port "$PORT" --pipe "$PIPE" --script "$script" \
+      --requests "$REQUESTS" --clients "$CLIENTS" --warmup 5 --json || echo "failed (exit $?)"
+  done
+
+  kill "$mock" 2>/dev/null || true
+  wait "$mock" 2>/dev/null || true
+done
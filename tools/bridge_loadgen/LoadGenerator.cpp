@@ -0,0 +1,195 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "LoadGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QFile>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+namespace
+{
+    // Results of this size and up go through shared memory in "shm" mode.
+    constexpr qint64 SHM_THRESHOLD = 64 * 1024;
+}
+
+double LoadReport::percentileMs(const double p) const
+{
+    if (latenciesUs.empty())
+    {
+        return 0;
+    }
+
+    // Nearest-rank percentile.
+    const auto rank = static_cast<size_t>(std::ceil(p / 100.0 * static_cast<double>(latenciesUs.size())));
+    const size_t index = std::clamp<size_t>(rank, 1, latenciesUs.size()) - 1;
+    return static_cast<double>(latenciesUs[index]) / 1000.0;
+}
+
+LoadGenerator::LoadGenerator(LoadOptions options, QObject* parent)
+    : QObject(parent), m_options(std::move(options))
+{
+    m_timeout.setSingleShot(true);
+    connect(&m_timeout, &QTimer::timeout, this, [this] { finish(true); });
+}
+
+void LoadGenerator::start()
+{
+    m_report.latenciesUs.reserve(m_options.requests);
+    m_clock.start();
+    m_timeout.start(m_options.timeoutMs);
+
+    for (int i = 0; i < m_options.clients; ++i)
+    {
+        auto* client = new PSClient(this);
+        if (m_options.transport == "tcp")
+        {
+            client->setEndpoints({BridgeEndpoint::tcp(m_options.host, m_options.port)});
+            client->setSharedMemoryThreshold(0);
+        }
+        else
+        {
+            client->setEndpoints({BridgeEndpoint::local(m_options.pipeName)});
+            client->setSharedMemoryThreshold(m_options.transport == "shm" ? SHM_THRESHOLD : 0);
+        }
+        connect(client, &PSClient::scriptResultReceived, this,
+                [this, client](const quint64 requestId, const BridgeResult& result)
+                {
+                    onResult(client, requestId, result);
+                });
+        m_clients.push_back(client);
+    }
+
+    for (PSClient* client : m_clients)
+    {
+        for (int i = 0; i < m_options.pipeline; ++i)
+        {
+            send(client);
+        }
+    }
+}
+
+void LoadGenerator::send(PSClient* client)
+{
+    const bool measured = m_sentPerClient.value(client) >= m_options.warmup;
+    if (measured && m_sent >= m_options.requests)
+    {
+        return;
+    }
+
+    m_sentPerClient[client]++;
+    const qint64 now = m_clock.nsecsElapsed();
+    if (measured)
+    {
+        m_sent++;
+        if (m_measureStartNs < 0)
+        {
+            m_measureStartNs = now;
+        }
+    }
+
+    const quint64 requestId = client->runScript(m_options.script);
+    m_inFlight[client].insert(requestId, {client, now, measured});
+}
+
+void LoadGenerator::onResult(PSClient* client, const quint64 requestId, const BridgeResult& result)
+{
+    if (m_done)
+    {
+        return;
+    }
+
+    const InFlight run = m_inFlight[client].take(requestId);
+    if (run.client == nullptr)
+    {
+        return;
+    }
+
+    if (m_report.endpoint.isEmpty())
+    {
+        m_report.endpoint = client->connectedEndpoint();
+    }
+
+    if (run.measured)
+    {
+        if (result.delivered)
+        {
+            m_report.completed++;
+            m_report.latenciesUs.push_back((m_clock.nsecsElapsed() - run.sentAtNs) / 1000);
+            // Characters, which is bytes for the ASCII output of the mock.
+            m_report.bytesReceived += result.output.size();
+            m_report.recordsReceived += result.records ? result.records->rowCount() : 0;
+        }
+        else
+        {
+            m_report.failed++;
+        }
+
+        if (m_report.completed + m_report.failed >= m_options.requests)
+        {
+            finish(false);
+            return;
+        }
+    }
+
+    send(client);
+}
+
+void LoadGenerator::finish(const bool timedOut)
+{
+    if (m_done)
+    {
+        return;
+    }
+
+    m_done = true;
+    m_timeout.stop();
+
+    m_report.timedOut = timedOut;
+    m_report.elapsedSeconds =
+        static_cast<double>(m_clock.nsecsElapsed() - std::max<qint64>(m_measureStartNs, 0)) / 1e9;
+    std::ranges::sort(m_report.latenciesUs);
+    m_report.peakRssKb = peakRssKb();
+    for (const PSClient* client : m_clients)
+    {
+        m_report.sharedMemoryResults += client->sharedMemoryResults();
+    }
+
+    emit finished(m_report);
+}
+
+qint64 peakRssKb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return static_cast<qint64>(counters.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    // Linux: "VmHWM:     12345 kB"
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return 0;
+    }
+
+    while (!status.atEnd())
+    {
+        const QByteArray line = status.readLine();
+        if (line.startsWith("VmHWM:"))
+        {
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+        }
+    }
+    return 0;
+#endif
+}
@@ -0,0 +1,101 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+
+#include "clients/PSClient/PSClient.h"
+
+struct LoadOptions
+{
+    // "tcp", "local" (local socket) or "shm" (local socket + shared memory results).
+    QString transport = "tcp";
+    QString host = "127.0.0.1";
+    quint16 port = 12345;
+    // Local socket name for the "local" and "shm" transports.
+    QString pipeName = "buraq-mock";
+    // Total runs to complete (successful or not).
+    int requests = 1000;
+    // Number of PSClient instances, i.e. connections.
+    int clients = 1;
+    // Runs per client allowed in flight at once (pipelining over one connection).
+    int pipeline = 1;
+    // Runs per client sent before measuring starts; not part of `requests`.
+    int warmup = 10;
+    int timeoutMs = 60000;
+    QString script = "Get-Date";
+};
+
+struct LoadReport
+{
+    int completed = 0;
+    int failed = 0;
+    bool timedOut = false;
+    double elapsedSeconds = 0;
+    qint64 bytesReceived = 0;
+    qint64 recordsReceived = 0;
+    // Results that came through shared memory, over all clients.
+    quint64 sharedMemoryResults = 0;
+    // Round-trip latencies in microseconds, sorted.
+    std::vector<qint64> latenciesUs;
+    qint64 peakRssKb = 0;
+    // Endpoint the first client ended up on, e.g. "local:buraq-mock".
+    QString endpoint;
+
+    [[nodiscard]] double percentileMs(double p) const;
+};
+
+/**
+ * Closed-loop load against the bridge protocol using the app's PSClient: every client keeps
+ * `pipeline` runs outstanding and sends the next one as soon as a result comes back.
+ */
+class LoadGenerator final : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LoadGenerator(LoadOptions options, QObject* parent = nullptr);
+
+    void start();
+
+    signals:
+        void finished(const LoadReport& report);
+
+private:
+    struct InFlight
+    {
+        PSClient* client = nullptr;
+        qint64 sentAtNs = 0;
+        bool measured = false;
+    };
+
+    void send(PSClient* client);
+    void onResult(PSClient* client, quint64 requestId, const BridgeResult& result);
+    void finish(bool timedOut);
+
+    LoadOptions m_options;
+    std::vector<PSClient*> m_clients;
+    // Keyed by client then request id; request ids are only unique per client.
+    QHash<PSClient*, QHash<quint64, InFlight>> m_inFlight;
+    QHash<PSClient*, int> m_sentPerClient;
+    // Measured runs sent so far.
+    int m_sent = 0;
+    QElapsedTimer m_clock;
+    qint64 m_measureStartNs = -1;
+    QTimer m_timeout;
+    LoadReport m_report;
+    bool m_done = false;
+};
+
+// Peak resident set size of this process in KiB, or 0 where unknown.
+qint64 peakRssKb();
+
+#endif // LOAD_GENERATOR_H
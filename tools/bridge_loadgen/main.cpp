@@ -0,0 +1,142 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+// Load generator for the bridge protocol. Start a bridge (or tools/bridge_mock) first, e.g.
+//
+//   bridge_mock --port 12345 --latency 1 --output-bytes 4096 &
+//   bridge_loadgen --requests 20000 --clients 4 --pipeline 8
+//
+// --transport picks tcp, local (named pipe / Unix socket) or shm (local + shared memory);
+// tools/bench_transports.sh compares the three for multi-megabyte results.
+//
+// Prints round-trip latency percentiles, throughput and peak memory of the client side.
+
+#include <algorithm>
+#include <iostream>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "LoadGenerator.h"
+
+namespace
+{
+    void printText(const LoadOptions& options, const LoadReport& report)
+    {
+        const double seconds = std::max(report.elapsedSeconds, 1e-9);
+
+        std::cout << "transport     " << options.transport.toStdString() << " (" << report.endpoint.toStdString() << ")\n"
+            << "requests      " << options.requests << " (" << options.clients << " clients x "
+            << options.pipeline << " in flight)\n"
+            << "completed     " << report.completed << "\n"
+            << "failed        " << report.failed << "\n"
+            << "records       " << report.recordsReceived << "\n"
+            << "via shm       " << report.sharedMemoryResults << "\n"
+            << "elapsed       " << report.elapsedSeconds << " s" << (report.timedOut ? " (timed out)" : "") << "\n"
+            << "throughput    " << report.completed / seconds << " runs/s, "
+            << static_cast<double>(report.bytesReceived) / seconds / (1024 * 1024) << " MiB/s\n"
+            << "latency p50   " << report.percentileMs(50) << " ms\n"
+            << "latency p90   " << report.percentileMs(90) << " ms\n"
+            << "latency p99   " << report.percentileMs(99) << " ms\n"
+            << "latency max   " << report.percentileMs(100) << " ms\n"
+            << "peak rss      " << report.peakRssKb << " KiB" << std::endl;
+    }
+
+    // One object per run, convenient for comparing runs in scripts.
+    void printJson(const LoadOptions& options, const LoadReport& report)
+    {
+        const double seconds = std::max(report.elapsedSeconds, 1e-9);
+
+        const QJsonObject json{
+            {"transport", options.transport},
+            {"endpoint", report.endpoint},
+            {"requests", options.requests},
+            {"clients", options.clients},
+            {"pipeline", options.pipeline},
+            {"completed", report.completed},
+            {"failed", report.failed},
+            {"records", report.recordsReceived},
+            {"shm_results", static_cast<qint64>(report.sharedMemoryResults)},
+            {"timed_out", report.timedOut},
+            {"elapsed_s", report.elapsedSeconds},
+            {"runs_per_s", report.completed / seconds},
+            {"bytes_per_s", static_cast<double>(report.bytesReceived) / seconds},
+            {"p50_ms", report.percentileMs(50)},
+            {"p90_ms", report.percentileMs(90)},
+            {"p99_ms", report.percentileMs(99)},
+            {"max_ms", report.percentileMs(100)},
+            {"peak_rss_kb", report.peakRssKb},
+        };
+        std::cout << QJsonDocument(json).toJson(QJsonDocument::Compact).toStdString() << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("bridge_loadgen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures PSClient against a bridge or bridge_mock.");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"transport", "tcp, local or shm.", "kind", "tcp"},
+        {"pipe", "Local socket name for local/shm; an absolute path for Buraq.Bridge off Windows.", "name", "buraq-mock"},
+        {"host", "Bridge host.", "host", "127.0.0.1"},
+        {"port", "Bridge port.", "port", "12345"},
+        {"requests", "Measured runs.", "count", "1000"},
+        {"clients", "Concurrent connections.", "count", "1"},
+        {"pipeline", "Runs in flight per connection.", "count", "1"},
+        {"warmup", "Unmeasured runs per connection.", "count", "10"},
+        {"timeout", "Give up after this many milliseconds.", "ms", "60000"},
+        {"script", "Script sent on every run.", "script", "Get-Date"},
+        {"json", "Print the report as one line of JSON."},
+    });
+    parser.process(app);
+
+    LoadOptions options;
+    options.transport = parser.value("transport");
+    options.pipeName = parser.value("pipe");
+    options.host = parser.value("host");
+    options.port = static_cast<quint16>(parser.value("port").toUInt());
+    options.requests = std::max(1, parser.value("requests").toInt());
+    options.clients = std::max(1, parser.value("clients").toInt());
+    options.pipeline = std::max(1, parser.value("pipeline").toInt());
+    options.warmup = std::max(0, parser.value("warmup").toInt());
+    options.timeoutMs = parser.value("timeout").toInt();
+    options.script = parser.value("script");
+
+    if (options.transport != "tcp" && options.transport != "local" && options.transport != "shm")
+    {
+        std::cerr << "Unknown transport: " << options.transport.toStdString() << std::endl;
+        return 1;
+    }
+
+    const bool json = parser.isSet("json");
+    int exitCode = 0;
+
+    LoadGenerator generator(options);
+    QObject::connect(&generator, &LoadGenerator::finished, &app, [&](const LoadReport& report)
+    {
+        json ? printJson(options, report) : printText(options, report);
+        exitCode = report.timedOut ? 2 : (report.failed > 0 ? 1 : 0);
+
+        // Without this "shm" would quietly measure the local socket: the ring could not be
+        // created or attached (e.g. on macOS), or no result was large enough for it.
+        if (options.transport == "shm" && report.completed > 0 && report.sharedMemoryResults == 0)
+        {
+            std::cerr << "No result came through shared memory: the ring could not be set up (see above), "
+                "or no result reached the threshold." << std::endl;
+            exitCode = 3;
+        }
+        QCoreApplication::quit();
+    });
+
+    generator.start();
+    QCoreApplication::exec();
+
+    return exitCode;
+}
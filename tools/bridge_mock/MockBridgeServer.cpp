@@ -0,0 +1,267 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "MockBridgeServer.h"
+
+#include <cstdlib>
+
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocalSocket>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <QTimer>
+
+#include "clients/PSClient/BridgeProtocol.h"
+
+MockBridgeServer::MockBridgeServer(const MockOptions& options, QObject* parent)
+    : QObject(parent), m_options(options), m_random(options.seed)
+{
+    if (m_options.records > 0)
+    {
+        m_records = makeRecords(m_options.records);
+    }
+
+    connect(&m_server, &QTcpServer::newConnection, this, [this]
+    {
+        while (QTcpSocket* socket = m_server.nextPendingConnection())
+        {
+            socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            accept(socket);
+        }
+    });
+
+    connect(&m_localServer, &QLocalServer::newConnection, this, [this]
+    {
+        while (QLocalSocket* socket = m_localServer.nextPendingConnection())
+        {
+            connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+            accept(socket);
+        }
+    });
+}
+
+bool MockBridgeServer::listen()
+{
+    if (!m_server.listen(QHostAddress::LocalHost, m_options.port))
+    {
+        m_errorString = m_server.errorString();
+        return false;
+    }
+
+    if (!m_options.pipeName.isEmpty())
+    {
+        // A stale socket file from a killed run would make listen() fail on Unix.
+        QLocalServer::removeServer(m_options.pipeName);
+        if (!m_localServer.listen(m_options.pipeName))
+        {
+            m_errorString = m_localServer.errorString();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void MockBridgeServer::accept(QIODevice* socket)
+{
+    auto* connection = new Connection{.socket = socket};
+
+    connect(socket, &QIODevice::readyRead, this, [this, connection] { onReadyRead(connection); });
+    // Pending timers use the socket as their context, so none fire after this.
+    connect(socket, &QObject::destroyed, this, [connection] { delete connection; });
+}
+
+void MockBridgeServer::onReadyRead(Connection* connection)
+{
+    connection->readBuffer.append(connection->socket->readAll());
+
+    qsizetype newline;
+    while ((newline = connection->readBuffer.indexOf('\n')) >= 0)
+    {
+        const auto frame = bridge::decodeFrame(connection->readBuffer.left(newline));
+        connection->readBuffer.remove(0, newline + 1);
+
+        if (frame.has_value())
+        {
+            handleFrame(connection, frame.value());
+        }
+    }
+
+    startNext(connection);
+}
+
+void MockBridgeServer::handleFrame(Connection* connection, const QJsonObject& frame)
+{
+    const QString type = frame.value("type").toString();
+
+    if (type == bridge::FRAME_RUN)
+    {
+        connection->runs.enqueue(frame);
+    }
+    else if (type == bridge::FRAME_SHM)
+    {
+        auto ring = std::make_unique<SharedMemoryRing>();
+        if (ring->attach(frame.value("key").toString()))
+        {
+            connection->ring = std::move(ring);
+            connection->shmThreshold = frame.value("threshold").toInteger();
+        }
+        else
+        {
+            QTextStream(stderr) << "Could not attach shared memory, answering inline: " << ring->errorString() << "\n";
+        }
+    }
+    else if (type == bridge::FRAME_ACK && connection->ring)
+    {
+        connection->ring->release(frame.value("end").toInteger());
+    }
+}
+
+void MockBridgeServer::startNext(Connection* connection)
+{
+    if (connection->busy || connection->runs.isEmpty())
+    {
+        return;
+    }
+
+    connection->busy = true;
+    const QJsonObject run = connection->runs.dequeue();
+
+    int delay = m_options.latencyMs;
+    if (m_options.jitterMs > 0)
+    {
+        delay += static_cast<int>(m_random.bounded(m_options.jitterMs + 1));
+    }
+
+    QTimer::singleShot(delay, connection->socket, [this, connection, run]
+    {
+        writeResult(connection, run);
+        connection->busy = false;
+        startNext(connection);
+    });
+}
+
+void MockBridgeServer::writeResult(Connection* connection, const QJsonObject& run)
+{
+    m_runsServed++;
+    if (m_options.crashAfter > 0 && m_runsServed > m_options.crashAfter)
+    {
+        QTextStream(stderr) << "Injected crash after " << m_options.crashAfter << " runs\n";
+        std::_Exit(3);
+    }
+
+    if (m_options.dropRate > 0 && m_random.generateDouble() < m_options.dropRate)
+    {
+        connection->runs.clear();
+        connection->socket->close();
+        return;
+    }
+
+    QJsonObject body;
+    if (m_options.failRate > 0 && m_random.generateDouble() < m_options.failRate)
+    {
+        body.insert("output", "");
+        body.insert("error", "System.Management.Automation.RuntimeException: injected failure");
+        body.insert("had_errors", true);
+    }
+    else
+    {
+        body.insert("output", makeOutput(run.value("script").toString()));
+        body.insert("error", "");
+        body.insert("had_errors", false);
+        if (!m_records.isEmpty())
+        {
+            body.insert("records", m_records);
+        }
+    }
+
+    QJsonObject result{
+        {"type", bridge::FRAME_RESULT},
+        {"id", run.value("id")},
+    };
+
+    std::optional<qint64> offset;
+    QByteArray payload;
+    if (connection->ring)
+    {
+        payload = QJsonDocument(body).toJson(QJsonDocument::Compact);
+        if (payload.size() >= connection->shmThreshold)
+        {
+            offset = connection->ring->write(payload);
+        }
+    }
+
+    if (offset.has_value())
+    {
+        result.insert("shm_offset", offset.value());
+        result.insert("shm_length", payload.size());
+    }
+    else
+    {
+        // No ring, a small body, or the ring is full: send it inline.
+        for (auto it = body.constBegin(); it != body.constEnd(); ++it)
+        {
+            result.insert(it.key(), it.value());
+        }
+    }
+
+    writeChunks(connection->socket, bridge::encodeFrame(result));
+}
+
+void MockBridgeServer::writeChunks(QIODevice* socket, QByteArray data)
+{
+    if (m_options.chunkBytes <= 0 || data.size() <= m_options.chunkBytes)
+    {
+        socket->write(data);
+        return;
+    }
+
+    socket->write(data.left(m_options.chunkBytes));
+    data.remove(0, m_options.chunkBytes);
+
+    QTimer::singleShot(m_options.chunkDelayMs, socket, [this, socket, rest = std::move(data)]
+    {
+        writeChunks(socket, rest);
+    });
+}
+
+QString MockBridgeServer::makeOutput(const QString& script) const
+{
+    if (m_options.outputBytes <= 0)
+    {
+        return script;
+    }
+
+    // Line-shaped output, the way PowerShell formats objects.
+    QString output;
+    output.reserve(m_options.outputBytes);
+    for (int line = 0; output.size() < m_options.outputBytes; ++line)
+    {
+        output += QString("mock output line %1\n").arg(line, 8, 10, QChar('0'));
+    }
+    output.truncate(m_options.outputBytes);
+    return output;
+}
+
+QJsonObject MockBridgeServer::makeRecords(const int rows)
+{
+    // Shaped like Get-Process: a mix of strings, integers, doubles and booleans.
+    QJsonArray names, ids, cpu, workingSet, responding;
+    for (int row = 0; row < rows; ++row)
+    {
+        names.append(QString("process-%1").arg(row % 997));
+        ids.append(row + 4);
+        cpu.append(static_cast<double>((row * 7919) % 100000) / 100.0);
+        workingSet.append(static_cast<qint64>(row % 4096) * 4096 + 65536);
+        responding.append(row % 13 != 0);
+    }
+
+    return QJsonObject{
+        {"columns", QJsonArray{"ProcessName", "Id", "CPU", "WorkingSet64", "Responding"}},
+        {"values", QJsonArray{names, ids, cpu, workingSet, responding}},
+    };
+}
@@ -0,0 +1,98 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef MOCK_BRIDGE_SERVER_H
+#define MOCK_BRIDGE_SERVER_H
+
+#include <memory>
+
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QObject>
+#include <QQueue>
+#include <QRandomGenerator>
+#include <QTcpServer>
+
+#include "clients/PSClient/SharedMemoryRing.h"
+
+// Knobs for shaping the mock's behaviour; see main.cpp for the matching command line flags.
+struct MockOptions
+{
+    quint16 port = 12345;
+    // Also serve this local socket name (named pipe / Unix domain socket) when set.
+    QString pipeName;
+    // Time spent "running" each script before the result is written.
+    int latencyMs = 0;
+    // Random extra latency, 0..jitterMs.
+    int jitterMs = 0;
+    // Size of the output returned per run; 0 echoes the script back.
+    qsizetype outputBytes = 0;
+    // Objects (Get-Process shaped records) returned per run.
+    int records = 0;
+    // Write each result in pieces of this size (0 = in one write) ...
+    qsizetype chunkBytes = 0;
+    // ... waiting this long between pieces.
+    int chunkDelayMs = 0;
+    // Fraction of runs answered with an error instead of output.
+    double failRate = 0;
+    // Fraction of runs on which the connection is dropped without answering.
+    double dropRate = 0;
+    // Exit the process (as if it crashed) after this many runs; 0 = never.
+    int crashAfter = 0;
+    // Seed for the failure injection, so a run can be reproduced.
+    quint32 seed = 1;
+};
+
+/**
+ * Stand-in for the C# PowerShell bridge (Buraq.Bridge) that speaks the same protocol
+ * (see BridgeProtocol.h) over TCP and local sockets, including shared memory results,
+ * without running anything. Used to test and benchmark PSClient on machines without
+ * .NET or PowerShell.
+ *
+ * Like the real bridge, the runs of one connection are answered in order.
+ */
+class MockBridgeServer final : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MockBridgeServer(const MockOptions& options, QObject* parent = nullptr);
+
+    bool listen();
+    [[nodiscard]] QString errorString() const { return m_errorString; }
+    [[nodiscard]] quint16 port() const { return m_server.serverPort(); }
+    [[nodiscard]] QString localServerPath() const { return m_localServer.fullServerName(); }
+
+private:
+    struct Connection
+    {
+        QIODevice* socket = nullptr;
+        QByteArray readBuffer;
+        QQueue<QJsonObject> runs;
+        bool busy = false;
+        // Set once the client has sent a shm frame.
+        std::unique_ptr<SharedMemoryRing> ring;
+        qint64 shmThreshold = 0;
+    };
+
+    void accept(QIODevice* socket);
+    void handleFrame(Connection* connection, const QJsonObject& frame);
+
+    void onReadyRead(Connection* connection);
+    void startNext(Connection* connection);
+    void writeResult(Connection* connection, const QJsonObject& run);
+    void writeChunks(QIODevice* socket, QByteArray data);
+    [[nodiscard]] QString makeOutput(const QString& script) const;
+    static QJsonObject makeRecords(int rows);
+
+    MockOptions m_options;
+    QTcpServer m_server;
+    QLocalServer m_localServer;
+    QString m_errorString;
+    QRandomGenerator m_random;
+    QJsonObject m_records;
+    int m_runsServed = 0;
+};
+
+#endif // MOCK_BRIDGE_SERVER_H
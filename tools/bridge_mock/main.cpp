@@ -0,0 +1,129 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+// Mock PowerShell bridge. Examples:
+//
+//   bridge_mock --latency 5 --jitter 5 --output-bytes 65536 --chunk-bytes 1400 --chunk-delay 1
+//   bridge_mock --fail-rate 0.05 --drop-rate 0.01
+//   bridge_mock --pipe buraq-mock --output-bytes 8388608
+//   bridge_mock --records 500000
+//
+// With --control it also behaves like Buraq.Bridge on stdin/stdout (hello frame, ping/pong,
+// shutdown), so it can be dropped in as PS.Bridge/Buraq.Bridge to exercise BridgeSupervisor.
+
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QJsonObject>
+
+#include "MockBridgeServer.h"
+#include "clients/PSClient/BridgeProtocol.h"
+
+namespace
+{
+    std::mutex stdout_mutex;
+
+    void writeControlFrame(const QJsonObject& frame)
+    {
+        std::lock_guard lock(stdout_mutex);
+        std::cout << bridge::encodeFrame(frame).toStdString() << std::flush;
+    }
+
+    // Answers pings until stdin closes or a shutdown frame arrives, then quits the app.
+    void controlLoop()
+    {
+        std::string line;
+        while (std::getline(std::cin, line))
+        {
+            const auto frame = bridge::decodeFrame(QByteArray::fromStdString(line));
+            if (!frame.has_value())
+            {
+                continue;
+            }
+
+            const QString type = frame->value("type").toString();
+            if (type == bridge::FRAME_PING)
+            {
+                writeControlFrame({{"type", bridge::FRAME_PONG}, {"seq", frame->value("seq")}});
+            }
+            else if (type == bridge::FRAME_SHUTDOWN)
+            {
+                break;
+            }
+        }
+
+        QMetaObject::invokeMethod(QCoreApplication::instance(), &QCoreApplication::quit, Qt::QueuedConnection);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("bridge_mock");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Mock PowerShell bridge speaking the Buraq bridge protocol.");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"port", "TCP port to listen on (0 picks a free one).", "port", QString::number(bridge::DEFAULT_PORT)},
+        {"pipe", "Also listen on this local socket name.", "name"},
+        {"latency", "Milliseconds spent on each run.", "ms", "0"},
+        {"jitter", "Random extra milliseconds per run.", "ms", "0"},
+        {"output-bytes", "Output size per run; 0 echoes the script.", "bytes", "0"},
+        {"records", "Objects returned per run, shaped like Get-Process.", "count", "0"},
+        {"chunk-bytes", "Write results in chunks of this size.", "bytes", "0"},
+        {"chunk-delay", "Milliseconds between chunks.", "ms", "0"},
+        {"fail-rate", "Fraction of runs that return an error.", "rate", "0"},
+        {"drop-rate", "Fraction of runs that drop the connection.", "rate", "0"},
+        {"crash-after", "Exit after this many runs.", "runs", "0"},
+        {"seed", "Seed for failure injection.", "seed", "1"},
+        {"control", "Speak the control protocol on stdin/stdout like Buraq.Bridge."},
+    });
+    parser.process(app);
+
+    MockOptions options;
+    options.port = static_cast<quint16>(parser.value("port").toUInt());
+    options.pipeName = parser.value("pipe");
+    options.latencyMs = parser.value("latency").toInt();
+    options.jitterMs = parser.value("jitter").toInt();
+    options.outputBytes = parser.value("output-bytes").toLongLong();
+    options.records = parser.value("records").toInt();
+    options.chunkBytes = parser.value("chunk-bytes").toLongLong();
+    options.chunkDelayMs = parser.value("chunk-delay").toInt();
+    options.failRate = parser.value("fail-rate").toDouble();
+    options.dropRate = parser.value("drop-rate").toDouble();
+    options.crashAfter = parser.value("crash-after").toInt();
+    options.seed = parser.value("seed").toUInt();
+
+    MockBridgeServer server(options);
+    if (!server.listen())
+    {
+        std::cerr << "Could not listen: " << server.errorString().toStdString() << std::endl;
+        return 1;
+    }
+
+    // Diagnostics go to stderr so stdout stays reserved for control frames.
+    std::cerr << "Mock bridge listening on port " << server.port();
+    if (!options.pipeName.isEmpty())
+    {
+        std::cerr << " and " << server.localServerPath().toStdString();
+    }
+    std::cerr << std::endl;
+
+    if (parser.isSet("control"))
+    {
+        writeControlFrame({
+            {"type", bridge::FRAME_HELLO},
+            {"protocol", bridge::PROTOCOL_VERSION},
+            {"pid", QCoreApplication::applicationPid()},
+        });
+        std::thread(controlLoop).detach();
+    }
+
+    return QCoreApplication::exec();
+}
@@ -0,0 +1,349 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#include "StaticHttpServer.h"
+
+#include <algorithm>
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QHostAddress>
+#include <QLocale>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <QTimeZone>
+#include <QTimer>
+
+namespace
+{
+    const QString HTTP_DATE_FORMAT = QStringLiteral("ddd, dd MMM yyyy hh:mm:ss 'GMT'");
+    // Body bytes handed to the socket at once without a rate limit, and how much may wait in
+    // its buffer before more is read from the file.
+    constexpr qint64 SLICE_BYTES = 64 * 1024;
+    constexpr qint64 SEND_BUFFER_BYTES = 256 * 1024;
+    // With a rate limit, a slice of the body goes out this often.
+    constexpr int TICK_MS = 10;
+
+    QByteArray httpDate(const QDateTime& time)
+    {
+        return QLocale::c().toString(time.toUTC(), HTTP_DATE_FORMAT).toLatin1();
+    }
+
+    QByteArray reasonPhrase(const int status)
+    {
+        switch (status)
+        {
+        case 200: return "OK";
+        case 206: return "Partial Content";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 416: return "Range Not Satisfiable";
+        default: return "Unknown";
+        }
+    }
+
+    // The first and last byte of "bytes=a-b", "bytes=a-" or "bytes=-n" within size bytes;
+    // false if it cannot be satisfied. Several ranges are not supported.
+    bool parseRange(const QByteArray& header, const qint64 size, qint64& first, qint64& last)
+    {
+        if (!header.startsWith("bytes=") || header.contains(','))
+        {
+            return false;
+        }
+        const QByteArray spec = header.mid(6).trimmed();
+        const qsizetype dash = spec.indexOf('-');
+        if (dash < 0)
+        {
+            return false;
+        }
+
+        bool firstOk = true, lastOk = true;
+        const QByteArray from = spec.left(dash);
+        const QByteArray to = spec.mid(dash + 1);
+        if (from.isEmpty())
+        {
+            const qint64 suffix = to.toLongLong(&lastOk);
+            first = std::max<qint64>(0, size - suffix);
+            last = size - 1;
+            return lastOk && suffix > 0 && size > 0;
+        }
+        first = from.toLongLong(&firstOk);
+        last = to.isEmpty() ? size - 1 : std::min(to.toLongLong(&lastOk), size - 1);
+        return firstOk && lastOk && first <= last && first < size;
+    }
+}
+
+StaticHttpServer::StaticHttpServer(const HttpStubOptions& options, QObject* parent)
+    : QObject(parent), m_options(options), m_root(options.root)
+{
+    connect(&m_server, &QTcpServer::newConnection, this, [this]
+    {
+        while (QTcpSocket* socket = m_server.nextPendingConnection())
+        {
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            accept(socket);
+        }
+    });
+}
+
+bool StaticHttpServer::listen()
+{
+    if (!m_root.exists())
+    {
+        m_errorString = "No such directory: " + m_root.path();
+        return false;
+    }
+    if (!m_server.listen(QHostAddress::LocalHost, m_options.port))
+    {
+        m_errorString = m_server.errorString();
+        return false;
+    }
+    return true;
+}
+
+void StaticHttpServer::accept(QTcpSocket* socket)
+{
+    auto* connection = new Connection{.socket = socket};
+
+    connect(socket, &QIODevice::readyRead, this, [this, connection] { onReadyRead(connection); });
+    connect(socket, &QIODevice::bytesWritten, this, [this, connection]
+    {
+        if (connection->waitingForDrain)
+        {
+            connection->waitingForDrain = false;
+            sendBody(connection);
+        }
+    });
+    // Pending timers use the socket as their context, so none fire after this.
+    connect(socket, &QObject::destroyed, this, [connection] { delete connection; });
+}
+
+void StaticHttpServer::onReadyRead(Connection* connection)
+{
+    connection->readBuffer.append(connection->socket->readAll());
+
+    // Requests have no body (GET, HEAD), so each ends at the blank line.
+    qsizetype end;
+    while ((end = connection->readBuffer.indexOf("\r\n\r\n")) >= 0)
+    {
+        const QList<QByteArray> lines = connection->readBuffer.left(end).split('\n');
+        connection->readBuffer.remove(0, end + 4);
+
+        Request request;
+        if (const QList<QByteArray> requestLine = lines.first().trimmed().split(' '); requestLine.size() == 3)
+        {
+            request.method = requestLine[0];
+            request.path = requestLine[1];
+        }
+        for (qsizetype i = 1; i < lines.size(); ++i)
+        {
+            if (const qsizetype colon = lines[i].indexOf(':'); colon > 0)
+            {
+                request.headers.insert(lines[i].left(colon).trimmed().toLower(), lines[i].mid(colon + 1).trimmed());
+            }
+        }
+        connection->requests.enqueue(request);
+    }
+
+    startNext(connection);
+}
+
+void StaticHttpServer::startNext(Connection* connection)
+{
+    if (connection->busy || connection->requests.isEmpty())
+    {
+        return;
+    }
+
+    // Answered in order, one at a time, as HTTP/1.1 requires of pipelined requests.
+    connection->busy = true;
+    const Request request = connection->requests.dequeue();
+
+    QTimer::singleShot(m_options.latencyMs, connection->socket, [this, connection, request]
+    {
+        connection->keepAlive = respond(connection, request);
+        sendBody(connection);
+    });
+}
+
+void StaticHttpServer::sendBody(Connection* connection)
+{
+    QTcpSocket* socket = connection->socket;
+    while (connection->body)
+    {
+        if (socket->bytesToWrite() > SEND_BUFFER_BYTES)
+        {
+            connection->waitingForDrain = true;
+            return;
+        }
+
+        qint64 slice = m_options.rateBytesPerSecond > 0
+                           ? std::max<qint64>(1, m_options.rateBytesPerSecond * TICK_MS / 1000)
+                           : SLICE_BYTES;
+        slice = std::min(slice, connection->bodyRemaining);
+        if (m_options.dropAfterBytes > 0)
+        {
+            slice = std::min(slice, m_options.dropAfterBytes - connection->bodyBytesSent);
+        }
+
+        const QByteArray data = connection->body->read(slice);
+        socket->write(data);
+        connection->bodyRemaining -= data.size();
+        connection->bodyBytesSent += data.size();
+
+        if (m_options.dropAfterBytes > 0 && connection->bodyBytesSent >= m_options.dropAfterBytes)
+        {
+            QTextStream(stderr) << "dropping the connection after " << connection->bodyBytesSent << " body bytes\n";
+            socket->flush();
+            socket->abort();
+            return;
+        }
+        if (data.isEmpty() || connection->bodyRemaining == 0)
+        {
+            connection->body.reset();
+        }
+        else if (m_options.rateBytesPerSecond > 0)
+        {
+            QTimer::singleShot(TICK_MS, socket, [this, connection] { sendBody(connection); });
+            return;
+        }
+    }
+
+    connection->busy = false;
+    if (!connection->keepAlive)
+    {
+        connection->requests.clear();
+        socket->disconnectFromHost();
+        return;
+    }
+    startNext(connection);
+}
+
+bool StaticHttpServer::respond(Connection* connection, const Request& request)
+{
+    QTcpSocket* socket = connection->socket;
+    const bool keepAlive = request.headers.value("connection").toLower() != "close";
+    const auto finish = [&request](const int status)
+    {
+        QTextStream(stderr) << request.method << ' ' << request.path << " -> " << status << "\n";
+    };
+
+    if (request.method.isEmpty())
+    {
+        writeHead(socket, 400, {{"Content-Length", "0"}}, false);
+        finish(400);
+        return false;
+    }
+    if (request.method != "GET" && request.method != "HEAD")
+    {
+        writeHead(socket, 405, {{"Allow", "GET, HEAD"}, {"Content-Length", "0"}}, keepAlive);
+        finish(405);
+        return keepAlive;
+    }
+
+    // Only files under the root; "/../x" and symlinks out of it are not found.
+    const QString relative = QString::fromUtf8(QByteArray::fromPercentEncoding(request.path.split('?').first()));
+    const QFileInfo info(m_root.filePath(QDir::cleanPath(relative).mid(1)));
+    if (!info.isFile() || !info.canonicalFilePath().startsWith(m_root.canonicalPath() + '/'))
+    {
+        writeHead(socket, 404, {{"Content-Length", "0"}}, keepAlive);
+        finish(404);
+        return keepAlive;
+    }
+
+    const QDateTime modified = info.lastModified().toUTC();
+    const QByteArray etag = '"' + QByteArray::number(info.size(), 16) + '-' +
+        QByteArray::number(modified.toMSecsSinceEpoch(), 16) + '"';
+    const QByteArray lastModified = httpDate(modified);
+
+    bool notModified = false;
+    if (const QByteArray ifNoneMatch = request.headers.value("if-none-match"); !ifNoneMatch.isEmpty())
+    {
+        notModified = ifNoneMatch == "*" || ifNoneMatch.contains(etag);
+    }
+    else if (const QByteArray ifModifiedSince = request.headers.value("if-modified-since"); !ifModifiedSince.isEmpty())
+    {
+        QDateTime since = QLocale::c().toDateTime(QString::fromLatin1(ifModifiedSince), HTTP_DATE_FORMAT);
+        since.setTimeZone(QTimeZone::utc());
+        notModified = since.isValid() && modified.toSecsSinceEpoch() <= since.toSecsSinceEpoch();
+    }
+
+    if (notModified)
+    {
+        writeHead(socket, 304, {{"ETag", etag}, {"Last-Modified", lastModified}}, keepAlive);
+        finish(304);
+        return keepAlive;
+    }
+
+    auto file = std::make_unique<QFile>(info.filePath());
+    if (!file->open(QIODevice::ReadOnly))
+    {
+        writeHead(socket, 404, {{"Content-Length", "0"}}, keepAlive);
+        finish(404);
+        return keepAlive;
+    }
+
+    // A range is ignored, and the whole file sent, if If-Range names another version.
+    qint64 first = 0;
+    qint64 last = info.size() - 1;
+    int status = 200;
+    const QByteArray ifRange = request.headers.value("if-range");
+    if (const QByteArray range = request.headers.value("range");
+        !range.isEmpty() && (ifRange.isEmpty() || ifRange == etag || ifRange == lastModified))
+    {
+        if (!parseRange(range, info.size(), first, last))
+        {
+            writeHead(socket, 416, {
+                          {"Content-Range", "bytes */" + QByteArray::number(info.size())},
+                          {"Content-Length", "0"},
+                      }, keepAlive);
+            finish(416);
+            return keepAlive;
+        }
+        status = 206;
+    }
+
+    const QByteArray contentType = info.suffix() == "json" ? "application/json" : "application/octet-stream";
+    QList<QPair<QByteArray, QByteArray>> headers = {
+        {"Content-Type", contentType},
+        {"Content-Length", QByteArray::number(last - first + 1)},
+        {"Accept-Ranges", "bytes"},
+        {"ETag", etag},
+        {"Last-Modified", lastModified},
+    };
+    if (status == 206)
+    {
+        headers.append({
+            "Content-Range",
+            "bytes " + QByteArray::number(first) + '-' + QByteArray::number(last) + '/' +
+            QByteArray::number(info.size())
+        });
+    }
+    writeHead(socket, status, headers, keepAlive);
+
+    if (request.method == "GET" && last >= first)
+    {
+        file->seek(first);
+        connection->body = std::move(file);
+        connection->bodyRemaining = last - first + 1;
+    }
+    finish(status);
+    return keepAlive;
+}
+
+void StaticHttpServer::writeHead(QTcpSocket* socket, const int status,
+                                 const QList<QPair<QByteArray, QByteArray>>& headers, const bool keepAlive)
+{
+    QByteArray head = "HTTP/1.1 " + QByteArray::number(status) + ' ' + reasonPhrase(status) + "\r\n";
+    for (const auto& [name, value] : headers)
+    {
+        head += name + ": " + value + "\r\n";
+    }
+    head += keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    head += "\r\n";
+    socket->write(head);
+}
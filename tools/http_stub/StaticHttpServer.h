@@ -0,0 +1,93 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+#ifndef STATIC_HTTP_SERVER_H
+#define STATIC_HTTP_SERVER_H
+
+#include <memory>
+
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QObject>
+#include <QQueue>
+#include <QTcpServer>
+
+class QTcpSocket;
+
+// Knobs for shaping the server's behaviour; see main.cpp for the matching command line flags.
+struct HttpStubOptions
+{
+    quint16 port = 8080;
+    // Files are served from here; /a/b.json is <root>/a/b.json.
+    QString root = ".";
+    // Time spent before each response.
+    int latencyMs = 0;
+    // Bodies are sent at most this fast, per connection; 0 for no limit.
+    qint64 rateBytesPerSecond = 0;
+    // A connection is cut, mid-body, once it has sent this many body bytes; 0 never.
+    qint64 dropAfterBytes = 0;
+};
+
+/**
+ * Serves the files of a directory over HTTP/1.1 on localhost, as a stand-in for the update
+ * endpoints (manifest, installers) so the update path can be exercised offline.
+ *
+ * GET and HEAD only. Responses carry ETag and Last-Modified and honour If-None-Match and
+ * If-Modified-Since with 304, and a single byte range with 206 (If-Range included).
+ * Connections are kept alive unless the client asks otherwise. Bodies can be throttled and
+ * connections dropped part way, to exercise resumable downloads.
+ */
+class StaticHttpServer final : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StaticHttpServer(const HttpStubOptions& options, QObject* parent = nullptr);
+
+    bool listen();
+    [[nodiscard]] QString errorString() const { return m_errorString; }
+    [[nodiscard]] quint16 port() const { return m_server.serverPort(); }
+
+private:
+    struct Request
+    {
+        QByteArray method;
+        QByteArray path;
+        QHash<QByteArray, QByteArray> headers; // names in lower case
+    };
+
+    struct Connection
+    {
+        QTcpSocket* socket = nullptr;
+        QByteArray readBuffer;
+        QQueue<Request> requests;
+        bool busy = false;
+        // Of the response being sent.
+        bool keepAlive = true;
+        std::unique_ptr<QFile> body;
+        qint64 bodyRemaining = 0;
+        // Until the socket's buffer drains.
+        bool waitingForDrain = false;
+        // Over the connection's life, for dropAfterBytes.
+        qint64 bodyBytesSent = 0;
+    };
+
+    void accept(QTcpSocket* socket);
+    void onReadyRead(Connection* connection);
+    void startNext(Connection* connection);
+    // Writes the head, and leaves the body (if any) to sendBody(). Returns false if the
+    // connection is to be closed afterwards.
+    bool respond(Connection* connection, const Request& request);
+    void sendBody(Connection* connection);
+    static void writeHead(QTcpSocket* socket, int status, const QList<QPair<QByteArray, QByteArray>>& headers,
+                          bool keepAlive);
+
+    HttpStubOptions m_options;
+    QDir m_root;
+    QTcpServer m_server;
+    QString m_errorString;
+};
+
+#endif // STATIC_HTTP_SERVER_H
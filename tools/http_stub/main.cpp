@@ -0,0 +1,55 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+// Local stand-in for the update endpoints. Examples:
+//
+//   http_stub --root . --port 8080
+//   BURAQ_UPDATE_MANIFEST_URL=http://127.0.0.1:8080/manifest.json buraq
+//
+//   http_stub --root dist --latency 200
+//
+//   # A slow, flaky mirror: 512 KiB/s per connection, each cut after 3 MiB.
+//   http_stub --root dist --rate 524288 --drop-after 3145728
+
+#include <iostream>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+#include "StaticHttpServer.h"
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("http_stub");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Serves a directory over HTTP on localhost, with ETag and Last-Modified.");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"port", "TCP port to listen on (0 picks a free one).", "port", "8080"},
+        {"root", "Directory to serve.", "dir", "."},
+        {"latency", "Milliseconds spent before each response.", "ms", "0"},
+        {"rate", "Bytes per second a connection sends bodies at (0: no limit).", "bytes", "0"},
+        {"drop-after", "Cut a connection after it has sent this many body bytes (0: never).", "bytes", "0"},
+    });
+    parser.process(app);
+
+    HttpStubOptions options;
+    options.port = static_cast<quint16>(parser.value("port").toUInt());
+    options.root = parser.value("root");
+    options.latencyMs = parser.value("latency").toInt();
+    options.rateBytesPerSecond = parser.value("rate").toLongLong();
+    options.dropAfterBytes = parser.value("drop-after").toLongLong();
+
+    StaticHttpServer server(options);
+    if (!server.listen())
+    {
+        std::cerr << "Could not listen: " << server.errorString().toStdString() << std::endl;
+        return 1;
+    }
+
+    std::cerr << "http_stub serving " << options.root.toStdString() << " on port " << server.port() << std::endl;
+    return QCoreApplication::exec();
+}
@@ -0,0 +1,204 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+// Builds what a delta update is served from: every file of a release, zstd patches from the files
+// of earlier releases, and the "files" list for manifest.json. Example:
+//
+//   make_delta --new dist/v1.3.0 --old dist/v1.2.0 --old dist/v1.2.1 --out site/v1.3.0
+//              --base-url https://example.org/buraq/v1.3.0/
+//
+// site/v1.3.0 then holds files/<path>, patches/<path>.<from>.zst and files.json, whose object
+// goes into manifest.json as "files".
+
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QUrl>
+
+#include "file_delta.h"
+#include "sha256.h"
+
+namespace
+{
+    std::filesystem::path toPath(const QString& path)
+    {
+        return std::filesystem::path(path.toStdU16String());
+    }
+
+    // "sha256:<hex>", or empty if the file cannot be read.
+    std::string hashFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return {};
+        }
+
+        Sha256 hasher;
+        std::vector<char> block(1 << 20);
+        while (file.read(block.data(), static_cast<std::streamsize>(block.size())) || file.gcount() > 0)
+        {
+            hasher.update(block.data(), static_cast<std::size_t>(file.gcount()));
+        }
+        return file.bad() ? std::string() : "sha256:" + hasher.hexDigest();
+    }
+
+    // Relative paths of the files under root, with '/' separators, sorted.
+    QStringList filesUnder(const QString& root)
+    {
+        QStringList files;
+        const QDir dir(root);
+        QDirIterator it(root, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while (it.hasNext())
+        {
+            files.append(dir.relativeFilePath(it.next()));
+        }
+        files.sort();
+        return files;
+    }
+
+    QString urlPath(const QString& path)
+    {
+        return QString::fromLatin1(QUrl::toPercentEncoding(path, "/"));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("make_delta");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Builds the files, patches and file list of a delta update.");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"new", "Directory with the release's files.", "dir"},
+        {"old", "Directory with an earlier release to patch from; repeatable.", "dir"},
+        {"out", "Directory to write files/, patches/ and files.json to.", "dir"},
+        {"base-url", "Where out/ will be served; entry URLs are relative to it.", "url", ""},
+        {"level", "zstd level for the patches (1-22).", "level", "19"},
+    });
+    parser.process(app);
+
+    if (!parser.isSet("new") || !parser.isSet("out"))
+    {
+        std::cerr << "--new and --out are required." << std::endl;
+        return 1;
+    }
+    const QString newRoot = parser.value("new");
+    const QDir out(parser.value("out"));
+    const int level = parser.value("level").toInt();
+
+    const QStringList oldRoots = parser.values("old");
+
+    const QStringList files = filesUnder(newRoot);
+    if (files.isEmpty())
+    {
+        std::cerr << "No files in " << newRoot.toStdString() << std::endl;
+        return 1;
+    }
+
+    qint64 totalBytes = 0;
+    int patchCount = 0;
+    QJsonArray entries;
+    for (const QString& path : files)
+    {
+        const std::filesystem::path source = toPath(QDir(newRoot).filePath(path));
+        const std::filesystem::path target = toPath(out.filePath("files/" + path));
+        const std::string sha = hashFile(source);
+        std::error_code error;
+        std::filesystem::create_directories(target.parent_path(), error);
+        if (sha.empty() ||
+            !std::filesystem::copy_file(source, target, std::filesystem::copy_options::overwrite_existing, error))
+        {
+            std::cerr << "Cannot copy " << source.string() << ": " << error.message() << std::endl;
+            return 1;
+        }
+        const auto size = static_cast<qint64>(std::filesystem::file_size(source));
+        totalBytes += size;
+
+        // One patch per old content: releases often share most of their files.
+        std::set<std::string> patchedFrom;
+        QJsonArray patches;
+        for (const QString& oldRoot : oldRoots)
+        {
+            const std::filesystem::path oldFile = toPath(QDir(oldRoot).filePath(path));
+            const std::string from = std::filesystem::is_regular_file(oldFile) ? hashFile(oldFile) : std::string();
+            if (from.empty() || from == sha || !patchedFrom.insert(from).second)
+            {
+                continue; // new, unchanged, or done for another release
+            }
+
+            // patches/<path>.<first 16 hex digits of the old file's hash>.zst
+            const QString patchName = "patches/" + path + "." + QString::fromStdString(from.substr(7, 16)) + ".zst";
+            const std::filesystem::path patch = toPath(out.filePath(patchName));
+            std::filesystem::create_directories(patch.parent_path(), error);
+            std::string reason;
+            if (!file_delta::create_patch(oldFile, source, patch, reason, level))
+            {
+                std::cerr << "Cannot patch " << path.toStdString() << " from " << oldRoot.toStdString() << ": "
+                    << reason << std::endl;
+                return 1;
+            }
+
+            // Only worth it if it is smaller than the file.
+            const auto patchSize = static_cast<qint64>(std::filesystem::file_size(patch));
+            if (patchSize >= size)
+            {
+                std::filesystem::remove(patch, error);
+                continue;
+            }
+            patches.append(QJsonObject{
+                {"from", QString::fromStdString(from)},
+                {"url", urlPath(patchName)},
+                {"size", patchSize},
+                {"sha", QString::fromStdString(hashFile(patch))},
+            });
+            patchCount++;
+            std::cout << path.toStdString() << ": " << size << " -> " << patchSize << " bytes from "
+                << oldRoot.toStdString() << std::endl;
+        }
+
+        QJsonObject entry{
+            {"path", path},
+            {"url", urlPath("files/" + path)},
+            {"size", size},
+            {"sha", QString::fromStdString(sha)},
+        };
+        if (!patches.isEmpty())
+        {
+            entry.insert("patches", patches);
+        }
+        entries.append(entry);
+    }
+
+    QSaveFile list(out.filePath("files.json"));
+    if (!list.open(QIODevice::WriteOnly))
+    {
+        std::cerr << "Cannot write " << list.fileName().toStdString() << std::endl;
+        return 1;
+    }
+    list.write(QJsonDocument(QJsonObject{
+        {"base_url", parser.value("base-url")},
+        {"entries", entries},
+    }).toJson());
+    if (!list.commit())
+    {
+        std::cerr << "Cannot write " << list.fileName().toStdString() << std::endl;
+        return 1;
+    }
+
+    std::cout << files.size() << " files, " << totalBytes << " bytes, " << patchCount << " patches" << std::endl;
+    return 0;
+}
@@ -0,0 +1,63 @@
+#!/bin/bash
+
+# End-to-end check of the update download (RangedDownload, via `buraq_bench download`)
+# against http_stub throttled and cutting connections: the first attempt is killed part way,
+# the second must resume rather than start over, and the file must come out intact.
+# Usage: tools/test_update_download.sh [dir with http_stub and buraq_bench]
+#
+# Environment: MIB (file size), RATE (bytes per second per connection), DROP_AFTER (body
+# bytes a connection sends before it is cut), KILL_AFTER (seconds into the first attempt).
+
+set -euo pipefail
+
+BIN_DIR="${1:-_gate_build/build}"
+MIB="${MIB:-32}"
+RATE="${RATE:-2097152}"
+DROP_AFTER="${DROP_AFTER:-3145728}"
+KILL_AFTER="${KILL_AFTER:-3}"
+PORT=$((20000 + $$ % 20000))
+
+work=$(mktemp -d)
+trap 'kill $stub 2>/dev/null || true; rm -rf "$work"' EXIT
+
+mkdir "$work/www"
+head -c "$((MIB * 1024 * 1024))" /dev/urandom > "$work/www/setup.bin"
+size=$(wc -c < "$work/www/setup.bin" | tr -d ' ')
+sha=$( (sha256sum "$work/www/setup.bin" 2>/dev/null || shasum -a 256 "$work/www/setup.bin") | cut -d' ' -f1)
+
+"$BIN_DIR/http_stub" --root "$work/www" --port "$PORT" --rate "$RATE" --drop-after "$DROP_AFTER" 2>/dev/null &
+stub=$!
+sleep 0.5
+
+download() {
+  "$BIN_DIR/buraq_bench" download --url "http://127.0.0.1:$PORT/setup.bin" --out "$work/setup.bin" \
+    --size "$size" --sha256 "sha256:$sha" 2>/dev/null
+}
+
+# Killed outright, as a crash would; only the last saved part map survives.
+download > /dev/null &
+first=$!
+sleep "$KILL_AFTER"
+kill -9 "$first" 2>/dev/null || { echo "FAIL: the first attempt finished before it was killed; lower RATE"; exit 1; }
+wait "$first" 2>/dev/null || true
+
+if ! output=$(download); then
+  echo "$output"
+  echo "FAIL: the second attempt did not complete"
+  exit 1
+fi
+echo "$output"
+
+if ! cmp -s "$work/www/setup.bin" "$work/setup.bin"; then
+  echo "FAIL: the downloaded file differs"
+  exit 1
+fi
+if [[ "$output" == *"(resumed 0.0 MiB)"* ]]; then
+  echo "FAIL: the second attempt started over instead of resuming"
+  exit 1
+fi
+if [ -e "$work/setup.bin.parts" ]; then
+  echo "FAIL: the part map was left behind"
+  exit 1
+fi
+echo "PASS"
@@ -0,0 +1,79 @@
+#!/bin/bash
+
+# End-to-end check of the updater's staged switch (`updater --headless`): it waits for a stand-in
+# parent process to exit, swaps a staged version into a fake installation, relaunches the fake
+# app and waits for its readiness handshake. Prints the downtime the updater measured. A second
+# run with an empty staging directory must fail and leave the installation alone.
+# Usage: tools/test_update_swap.sh [dir with updater]
+#
+# The fake app answers the handshake with python3.
+
+set -euo pipefail
+
+BIN_DIR="${1:-_gate_build/build}"
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+# A fake app of the given version: records that it started, then reports ready.
+make_version() {
+  local dir="$1" version="$2"
+  mkdir -p "$dir"
+  echo "$version" > "$dir/version.txt"
+  cat > "$dir/buraq" <<EOF
+#!/bin/bash
+for arg; do
+  case "\$arg" in --update-handshake=*) server="\${arg#--update-handshake=}" ;; esac
+done
+cat "\$(dirname "\$0")/version.txt" > "$work/relaunched"
+python3 -c 'import socket, sys; s = socket.socket(socket.AF_UNIX); s.connect(sys.argv[1]); s.sendall(b"ready\n")' "\$server"
+EOF
+  chmod +x "$dir/buraq"
+}
+
+make_version "$work/Buraq" 1
+echo "only in the old version" > "$work/Buraq/removed.txt"
+make_version "$work/Buraq.staging-v2" 2
+mkdir -p "$work/Buraq.staging-v2/lib"
+echo "new in v2" > "$work/Buraq.staging-v2/lib/added.txt"
+
+# The parent the updater waits for.
+sleep 0.5 &
+parent=$!
+
+if ! output=$("$BIN_DIR/updater" --headless "$work/Buraq.staging-v2" "$work/Buraq" "$parent" 2>&1); then
+  echo "$output"
+  echo "FAIL: the update did not go through"
+  exit 1
+fi
+echo "$output" | grep -E "^(Downtime|Swapped|Moving)" || true
+
+if [ "$(cat "$work/Buraq/version.txt")" != 2 ] || [ ! -f "$work/Buraq/lib/added.txt" ]; then
+  echo "FAIL: the installation is not the staged version"
+  exit 1
+fi
+if [ -e "$work/Buraq/removed.txt" ]; then
+  echo "FAIL: a file the new version does not have was kept"
+  exit 1
+fi
+if [ -e "$work/Buraq.staging-v2" ] || [ -e "$work/Buraq.old" ]; then
+  echo "FAIL: the staging or backup directory was left behind"
+  exit 1
+fi
+if [ "$(cat "$work/relaunched" 2>/dev/null)" != 2 ]; then
+  echo "FAIL: the new version was not relaunched"
+  exit 1
+fi
+
+# Nothing staged: the updater must refuse, and the installation stay as it was.
+mkdir "$work/Buraq.staging-v3"
+rm "$work/relaunched"
+if "$BIN_DIR/updater" --headless "$work/Buraq.staging-v3" "$work/Buraq" "$parent" > /dev/null 2>&1; then
+  echo "FAIL: an empty staging directory was switched to"
+  exit 1
+fi
+if [ "$(cat "$work/Buraq/version.txt")" != 2 ] || [ -e "$work/relaunched" ]; then
+  echo "FAIL: a failed switch changed the installation"
+  exit 1
+fi
+echo "PASS"
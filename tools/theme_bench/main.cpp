@@ -0,0 +1,83 @@
+//
+// Created by talik on 10/19/2026.
+//
+
+// Switches the app's ThemeManager between Light and Dark with `--widgets` widgets alive
+// (labels, buttons and line edits in a grid) and prints the median, min and max time of a
+// switch, repaint included. Runs without a display under QT_QPA_PLATFORM=offscreen.
+//
+//   theme_bench [--widgets 3000] [--switches 20]
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QGridLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+
+#include "Filters/ThemeManager/ThemeManager.h"
+
+int main(int argc, char* argv[])
+{
+    QApplication app(argc, argv);
+    // Not the app's names: the user's settings are neither read nor written.
+    QCoreApplication::setOrganizationName("Buraq");
+    QCoreApplication::setApplicationName("theme_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures Light/Dark theme switches of the app's ThemeManager.");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"widgets", "Widgets alive while switching.", "count", "3000"},
+        {"switches", "Measured switches.", "count", "20"},
+    });
+    parser.process(app);
+
+    const int widgets = std::max(1, parser.value("widgets").toInt());
+    const int switches = std::max(1, parser.value("switches").toInt());
+
+    ThemeManager& themeManager = ThemeManager::instance();
+
+    QWidget holder;
+    QGridLayout* layout = new QGridLayout(&holder);
+    for (int i = 0; i < widgets; ++i)
+    {
+        QWidget* widget;
+        switch (i % 3)
+        {
+        case 0:
+            widget = new QLabel(QString::number(i));
+            break;
+        case 1:
+            widget = new QPushButton(QString::number(i));
+            break;
+        default:
+            widget = new QLineEdit(QString::number(i));
+            break;
+        }
+        layout->addWidget(widget, i / 50, i % 50);
+    }
+    holder.show();
+    QCoreApplication::processEvents();
+
+    std::vector<double> samples;
+    for (int i = 0; i < switches; ++i)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        themeManager.setAppTheme(themeManager.currentTheme() == Dark ? Light : Dark);
+        QCoreApplication::processEvents();
+        holder.repaint();
+        samples.push_back(static_cast<double>(timer.nsecsElapsed()) / 1e6);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    std::printf("theme_switch_ms median %.1f min %.1f max %.1f widgets %d\n", samples[samples.size() / 2],
+                samples.front(), samples.back(), static_cast<int>(QApplication::allWidgets().size()));
+    return 0;
+}